@@ -631,7 +631,9 @@ INSERT INTO `command` VALUES
 ('server info',0,'Syntax: .server info\r\n\r\nDisplay server version and the number of connected players.'),
 ('server log filter',4,'Syntax: .server log filter [($filtername|all) (on|off)]\r\n\r\nShow or set server log filters. If used \"all\" then all filters will be set to on/off state.'),
 ('server log level',4,'Syntax: .server log level [#level]\r\n\r\nShow or set server log level (0 - errors only, 1 - basic, 2 - detail, 3 - debug).'),
+('server memory',3,'Syntax: .server memory\r\n\r\nShow the memory used by static data: records, index and string bytes of each SQL storage table with the number of interned (shared) strings, and the approximate size of the biggest ObjectMgr containers.'),
 ('server motd',0,'Syntax: .server motd\r\n\r\nShow server Message of the day.'),
+('server perf',3,'Syntax: .server perf [reset|opcodes [#count]]\r\n\r\nShow world tick, per stage and per map latency statistics (avg/p50/p99/max) and the slowest maps, opcodes and creature AIs of the last and the slowest tick. With "opcodes" show the #count (default 20) opcode handlers with the highest total time, with call count, max time and received bytes. Statistics are collected only with PerfStats.Enable = 1. With "reset" start a new statistics window.'),
 ('server plimit',3,'Syntax: .server plimit [#num|-1|-2|-3|reset|player|moderator|gamemaster|administrator]\r\n\r\nWithout arg show current player amount and security level limitations for login to server, with arg set player linit ($num > 0) or securiti limitation ($num < 0 or security leme name. With `reset` sets player limit to the one in the config file'),
 ('server restart',3,'Syntax: .server restart #delay\r\n\r\nRestart the server after #delay seconds. Use #exist_code or 2 as program exist code.'),
 ('server restart cancel',3,'Syntax: .server restart cancel\r\n\r\nCancel the restart/shutdown timer if any.'),
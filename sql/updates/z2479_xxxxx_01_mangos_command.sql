@@ -0,0 +1,4 @@
+DELETE FROM command WHERE name IN ('server perf');
+
+INSERT INTO command (name, security, help) VALUES
+('server perf',3,'Syntax: .server perf [reset|opcodes [#count]]\r\n\r\nShow world tick, per stage and per map latency statistics (avg/p50/p99/max) and the slowest maps, opcodes and creature AIs of the last and the slowest tick. With "opcodes" show the #count (default 20) opcode handlers with the highest total time, with call count, max time and received bytes. Statistics are collected only with PerfStats.Enable = 1. With "reset" start a new statistics window.');
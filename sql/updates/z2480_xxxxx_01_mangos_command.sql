@@ -0,0 +1,4 @@
+DELETE FROM command WHERE name IN ('server memory');
+
+INSERT INTO command (name, security, help) VALUES
+('server memory',3,'Syntax: .server memory\r\n\r\nShow the memory used by static data: records, index and string bytes of each SQL storage table with the number of interned (shared) strings, and the approximate size of the biggest ObjectMgr containers.');
@@ -19,6 +19,8 @@
 #ifndef MANGOS_CALLBACK_H
 #define MANGOS_CALLBACK_H
 
+#include "Utilities/SmallObjectPool.h"
+
 // defines to simplify multi param templates code and readablity
 #define TYPENAMES_1 typename T1
 #define TYPENAMES_2 TYPENAMES_1, typename T2
@@ -416,6 +418,10 @@ namespace MaNGOS
             virtual ~IQueryCallback() {}
             virtual void SetResult(QueryResult* result) = 0;
             virtual QueryResult* GetResult() = 0;
+
+            // created for every async query and destroyed in another thread
+            static void* operator new(size_t size) { return SmallObjectPool::Allocate(size); }
+            static void operator delete(void* ptr, size_t size) { SmallObjectPool::Free(ptr, size); }
     };
 
     template<class CB>
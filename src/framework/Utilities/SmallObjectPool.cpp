@@ -0,0 +1,118 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "SmallObjectPool.h"
+
+#include <ace/Thread_Mutex.h>
+#include <ace/Guard_T.h>
+#include <new>
+
+namespace
+{
+    enum
+    {
+        POOL_GRANULARITY = 32,
+        POOL_CLASS_COUNT = 32,                              // up to 1KB
+        POOL_CHUNK_SIZE  = 16 * 1024
+    };
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct SizeClass
+    {
+        SizeClass() : freeList(NULL), chunkBytes(0) {}
+
+        ACE_Thread_Mutex lock;
+        FreeBlock* freeList;
+        size_t chunkBytes;
+    };
+
+    SizeClass s_sizeClasses[POOL_CLASS_COUNT];
+
+    size_t GetSizeClass(size_t size)
+    {
+        return size ? (size - 1) / POOL_GRANULARITY : 0;
+    }
+}
+
+namespace MaNGOS
+{
+    void* SmallObjectPool::Allocate(size_t size)
+    {
+        size_t index = GetSizeClass(size);
+        if (index >= POOL_CLASS_COUNT)
+            return ::operator new(size);
+
+        SizeClass& sizeClass = s_sizeClasses[index];
+        ACE_Guard<ACE_Thread_Mutex> guard(sizeClass.lock);
+
+        if (!sizeClass.freeList)
+        {
+            // carve a new chunk into blocks of this class
+            size_t blockSize = (index + 1) * POOL_GRANULARITY;
+            char* chunk = static_cast<char*>(::operator new(POOL_CHUNK_SIZE));
+            for (size_t offset = 0; offset + blockSize <= POOL_CHUNK_SIZE; offset += blockSize)
+            {
+                FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + offset);
+                block->next = sizeClass.freeList;
+                sizeClass.freeList = block;
+            }
+
+            sizeClass.chunkBytes += POOL_CHUNK_SIZE;
+        }
+
+        FreeBlock* block = sizeClass.freeList;
+        sizeClass.freeList = block->next;
+        return block;
+    }
+
+    void SmallObjectPool::Free(void* ptr, size_t size)
+    {
+        if (!ptr)
+            return;
+
+        size_t index = GetSizeClass(size);
+        if (index >= POOL_CLASS_COUNT)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+
+        SizeClass& sizeClass = s_sizeClasses[index];
+        ACE_Guard<ACE_Thread_Mutex> guard(sizeClass.lock);
+
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->next = sizeClass.freeList;
+        sizeClass.freeList = block;
+    }
+
+    size_t SmallObjectPool::GetChunkBytes()
+    {
+        size_t bytes = 0;
+        for (size_t i = 0; i < POOL_CLASS_COUNT; ++i)
+        {
+            ACE_Guard<ACE_Thread_Mutex> guard(s_sizeClasses[i].lock);
+            bytes += s_sizeClasses[i].chunkBytes;
+        }
+
+        return bytes;
+    }
+}
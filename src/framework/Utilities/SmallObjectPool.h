@@ -0,0 +1,48 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_SMALLOBJECTPOOL_H
+#define MANGOS_SMALLOBJECTPOOL_H
+
+#include "Platform/Define.h"
+
+#include <cstddef>
+
+namespace MaNGOS
+{
+    /**
+     * Free lists for small objects created and destroyed at a high rate, often in different threads
+     * (async query callbacks and their results).
+     *
+     * Sizes are rounded up to classes of 32 bytes up to 1KB, each class has its own lock and carves its
+     * blocks from 16KB chunks. Freed blocks are kept for reuse and never returned to the system, so the
+     * pool holds the peak amount of objects. Larger sizes use the global allocator.
+     * Classes use it by class specific operator new/delete, the size passed to delete selects the class.
+     */
+    class MANGOS_DLL_DECL SmallObjectPool
+    {
+        public:
+            static void* Allocate(size_t size);
+            static void Free(void* ptr, size_t size);
+
+            /// Bytes of all chunks allocated by the pool
+            static size_t GetChunkBytes();
+    };
+}
+
+#endif
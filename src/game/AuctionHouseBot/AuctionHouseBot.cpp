@@ -902,7 +902,7 @@ bool AuctionBotSeller::Initialize()
     sLog.outString();
 
     sLog.outString("Loading npc vendor items for filter..");
-    if (QueryResult* result = WorldDatabase.Query("SELECT DISTINCT item FROM npc_vendor"))
+    if (QueryResult* result = WorldDatabase.QueryRead(SQL_READ_AHBOT, "SELECT DISTINCT item FROM npc_vendor"))
     {
         BarGoLink bar(result->GetRowCount());
         do
@@ -922,7 +922,7 @@ bool AuctionBotSeller::Initialize()
     sLog.outString();
 
     sLog.outString("Loading loot items for filter..");
-    if (QueryResult* result = WorldDatabase.PQuery(
+    if (QueryResult* result = WorldDatabase.PQueryRead(SQL_READ_AHBOT,
         "SELECT item FROM creature_loot_template UNION "
         "SELECT item FROM disenchant_loot_template UNION "
         "SELECT item FROM fishing_loot_template UNION "
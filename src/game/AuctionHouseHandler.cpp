@@ -472,7 +472,7 @@ void WorldSession::HandleAuctionRemoveItem(WorldPacket& recv_data)
     // inform player, that auction is removed
     SendAuctionCommandResult(auction, AUCTION_REMOVED, AUCTION_OK);
     // Now remove the auction
-    CharacterDatabase.BeginTransaction();
+    CharacterDatabase.BeginTransaction(auction->GetOwnerKey(), pl->GetObjectGuid().GetRawValue());
     auction->DeleteFromDB();
     pl->SaveInventoryAndGoldToDB();
     CharacterDatabase.CommitTransaction();
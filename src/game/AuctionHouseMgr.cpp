@@ -680,7 +680,7 @@ AuctionEntry* AuctionHouseObject::AddAuction(AuctionHouseEntry const* auctionHou
     if (pl)
         pl->MoveItemFromInventory(newItem->GetBagSlot(), newItem->GetSlot(), true);
 
-    CharacterDatabase.BeginTransaction();
+    CharacterDatabase.BeginTransaction(AH->GetOwnerKey(), pl ? pl->GetObjectGuid().GetRawValue() : 0);
 
     if (pl)
         newItem->DeleteFromInventoryDB();
@@ -766,7 +766,7 @@ void AuctionEntry::AuctionBidWinning(Player* newbidder)
     sAuctionMgr.RemoveAItem(this->itemGuidLow);
     sAuctionMgr.GetAuctionsMap(this->auctionHouseEntry)->RemoveAuction(this->Id);
 
-    CharacterDatabase.BeginTransaction();
+    CharacterDatabase.BeginTransaction(GetOwnerKey(), newbidder ? newbidder->GetObjectGuid().GetRawValue() : 0);
     this->DeleteFromDB();
     if (newbidder)
         newbidder->SaveInventoryAndGoldToDB();
@@ -805,7 +805,7 @@ bool AuctionEntry::UpdateBid(uint32 newbid, Player* newbidder /*=NULL*/)
             auction_owner->GetSession()->SendAuctionOwnerNotification(this, false);
 
         // after this update we should save player's money ...
-        CharacterDatabase.BeginTransaction();
+        CharacterDatabase.BeginTransaction(GetOwnerKey(), newbidder ? newbidder->GetObjectGuid().GetRawValue() : 0);
         CharacterDatabase.PExecute("UPDATE auction SET buyguid = '%u', lastbid = '%u' WHERE id = '%u'", bidder, bid, Id);
         if (newbidder)
             newbidder->SaveInventoryAndGoldToDB();
@@ -22,6 +22,7 @@
 #include "Common.h"
 #include "SharedDefines.h"
 #include "Policies/Singleton.h"
+#include "Database/DatabaseEnv.h"
 #include "DBCStructure.h"
 
 class Item;
@@ -69,6 +70,7 @@ struct AuctionEntry
 
     // helpers
     uint32 GetHouseId() const { return auctionHouseEntry->houseId; }
+    uint64 GetOwnerKey() const { return MakeSqlOwnerKey(SQL_OWNER_KEY_AUCTION, Id); } // async transactions of this auction
     uint32 GetHouseFaction() const { return auctionHouseEntry->faction; }
     uint32 GetAuctionCut() const;
     uint32 GetAuctionOutBid() const;
@@ -34,6 +34,7 @@
 #include "Formulas.h"
 #include "GridNotifiersImpl.h"
 #include "Chat.h"
+#include "SharedPacket.h"
 
 namespace MaNGOS
 {
@@ -419,13 +420,14 @@ void BattleGround::SetTeamStartLoc(Team team, float X, float Y, float Z, float O
 
 void BattleGround::SendPacketToAll(WorldPacket* packet)
 {
+    SharedPacket sharedPacket(*packet);
     for (BattleGroundPlayerMap::const_iterator itr = m_Players.begin(); itr != m_Players.end(); ++itr)
     {
         if (itr->second.OfflineRemoveTime)
             continue;
 
         if (Player* plr = sObjectMgr.GetPlayer(itr->first))
-            plr->GetSession()->SendPacket(packet);
+            plr->GetSession()->SendPacket(sharedPacket);
         else
             sLog.outError("BattleGround:SendPacketToAll: %s not found!", itr->first.GetString().c_str());
     }
@@ -433,6 +435,7 @@ void BattleGround::SendPacketToAll(WorldPacket* packet)
 
 void BattleGround::SendPacketToTeam(Team teamId, WorldPacket* packet, Player* sender, bool self)
 {
+    SharedPacket sharedPacket(*packet);
     for (BattleGroundPlayerMap::const_iterator itr = m_Players.begin(); itr != m_Players.end(); ++itr)
     {
         if (itr->second.OfflineRemoveTime)
@@ -452,7 +455,7 @@ void BattleGround::SendPacketToTeam(Team teamId, WorldPacket* packet, Player* se
         if (!team) team = plr->GetTeam();
 
         if (team == teamId)
-            plr->GetSession()->SendPacket(packet);
+            plr->GetSession()->SendPacket(sharedPacket);
     }
 }
 
@@ -483,7 +483,9 @@ class MANGOS_DLL_SPEC ChatHandler
         bool HandleServerInfoCommand(char* args);
         bool HandleServerLogFilterCommand(char* args);
         bool HandleServerLogLevelCommand(char* args);
+        bool HandleServerMemoryCommand(char* args);
         bool HandleServerMotdCommand(char* args);
+        bool HandleServerPerfCommand(char* args);
         bool HandleServerPLimitCommand(char* args);
         bool HandleServerRestartCommand(char* args);
         bool HandleServerSetMotdCommand(char* args);
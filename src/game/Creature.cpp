@@ -50,6 +50,7 @@
 #include "movement/MoveSplineInit.h"
 #include "CreatureLinkingMgr.h"
 #include "LuaEngine.h"
+#include "PerfStats.h"
 
 // apply implementation of the singletons
 #include "Policies/Singleton.h"
@@ -550,7 +551,10 @@ void Creature::Update(uint32 update_diff, uint32 diff)
                 {
                     // do not allow the AI to be changed during update
                     m_AI_locked = true;
+                    uint64 perfStart = sPerfStats.IsEnabled() ? PerfStats::GetMicroTime() : 0;
                     AI()->UpdateAI(diff);   // AI not react good at real update delays (while freeze in non-active part of map)
+                    if (perfStart)
+                        sPerfStats.AddCreatureAISample(GetEntry(), GetGUIDLow(), uint32(PerfStats::GetMicroTime() - perfStart));
                     m_AI_locked = false;
                 }
             }
@@ -40,6 +40,7 @@
 #include "SharedDefines.h"
 #include "Creature.h"
 #include "CreatureAI.h"
+#include "Map.h"
 
 INSTANTIATE_SINGLETON_1(CreatureLinkingMgr);
 
@@ -320,6 +321,8 @@ CreatureLinkingInfo const* CreatureLinkingMgr::GetLinkedTriggerInformation(Creat
 // Function to add slave-NPCs to the holder
 void CreatureLinkingHolder::AddSlaveToHolder(Creature* pCreature)
 {
+    MapIslandGuard guard(pCreature->GetMap());
+
     CreatureLinkingInfo const* pInfo = sCreatureLinkingMgr.GetLinkedTriggerInformation(pCreature);
     if (!pInfo)
         return;
@@ -375,6 +378,8 @@ void CreatureLinkingHolder::AddSlaveToHolder(Creature* pCreature)
 // Function to add master-NPCs to the holder
 void CreatureLinkingHolder::AddMasterToHolder(Creature* pCreature)
 {
+    MapIslandGuard guard(pCreature->GetMap());
+
     if (pCreature->IsPet())
         return;
 
@@ -405,6 +410,18 @@ void CreatureLinkingHolder::DoCreatureLinkingEvent(CreatureLinkingEvent eventTyp
     if (eventType == LINKING_EVENT_AGGRO && !pEnemy)
         return;
 
+    // the linked creatures may be in another cell island of the map, the map processes it after its islands
+    Map* map = pSource->GetMap();
+    if (map->IsUpdatingIslands())
+    {
+        MapDeferredAction action(MapDeferredAction::CREATURE_LINKING_EVENT, eventType, 0);
+        action.source = pSource->GetObjectGuid();
+        if (pEnemy)
+            action.enemy = pEnemy->GetObjectGuid();
+        map->DeferIslandAction(action);
+        return;
+    }
+
     uint32 eventFlagFilter = 0;
     uint32 reverseEventFlagFilter = 0;
 
@@ -602,6 +619,8 @@ bool CreatureLinkingHolder::IsSlaveInRangeOfBoss(Creature* pSlave, Creature* pBo
 // Function to check if a passive spawning condition is met
 bool CreatureLinkingHolder::CanSpawn(Creature* pCreature)
 {
+    MapIslandGuard guard(pCreature->GetMap());
+
     CreatureLinkingInfo const*  pInfo = sCreatureLinkingMgr.GetLinkedTriggerInformation(pCreature);
     if (!pInfo)
         return true;
@@ -641,6 +660,8 @@ bool CreatureLinkingHolder::CanSpawn(Creature* pCreature)
 // This function lets a slave refollow his master
 bool CreatureLinkingHolder::TryFollowMaster(Creature* pCreature)
 {
+    MapIslandGuard guard(pCreature->GetMap());
+
     CreatureLinkingInfo const*  pInfo = sCreatureLinkingMgr.GetLinkedTriggerInformation(pCreature);
     if (!pInfo || !(pInfo->linkingFlag & FLAG_FOLLOW))
         return false;
@@ -120,7 +120,13 @@ void MessageDelivererExcept::Visit(CameraMapType& m)
             continue;
 
         if (WorldSession* session = owner->GetSession())
+        {
+            // periodic position updates of others are not needed by clients that fall behind, the next one corrects the position
+            if (i_message.GetOpcode() == MSG_MOVE_HEARTBEAT && session->IsSendCongested())
+                continue;
+
             session->SendPacket(i_message);
+        }
     }
 }
 
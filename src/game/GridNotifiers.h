@@ -29,6 +29,7 @@
 #include "GameObject.h"
 #include "Player.h"
 #include "Unit.h"
+#include "SharedPacket.h"
 
 namespace MaNGOS
 {
@@ -57,20 +58,20 @@ namespace MaNGOS
     struct MANGOS_DLL_DECL MessageDeliverer
     {
         Player const& i_player;
-        WorldPacket* i_message;
+        SharedPacket i_message;
         bool i_toSelf;
-        MessageDeliverer(Player const& pl, WorldPacket* msg, bool to_self) : i_player(pl), i_message(msg), i_toSelf(to_self) {}
+        MessageDeliverer(Player const& pl, WorldPacket* msg, bool to_self) : i_player(pl), i_message(*msg), i_toSelf(to_self) {}
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
 
     struct MessageDelivererExcept
     {
-        WorldPacket*  i_message;
+        SharedPacket  i_message;
         Player const* i_skipped_receiver;
 
         MessageDelivererExcept(WorldPacket* msg, Player const* skipped)
-            : i_message(msg), i_skipped_receiver(skipped) {}
+            : i_message(*msg), i_skipped_receiver(skipped) {}
 
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
@@ -78,8 +79,8 @@ namespace MaNGOS
 
     struct MANGOS_DLL_DECL ObjectMessageDeliverer
     {
-        WorldPacket* i_message;
-        explicit ObjectMessageDeliverer(WorldPacket* msg) : i_message(msg) {}
+        SharedPacket i_message;
+        explicit ObjectMessageDeliverer(WorldPacket* msg) : i_message(*msg) {}
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
@@ -87,13 +88,13 @@ namespace MaNGOS
     struct MANGOS_DLL_DECL MessageDistDeliverer
     {
         Player const& i_player;
-        WorldPacket* i_message;
+        SharedPacket i_message;
         bool i_toSelf;
         bool i_ownTeamOnly;
         float i_dist;
 
         MessageDistDeliverer(Player const& pl, WorldPacket* msg, float dist, bool to_self, bool ownTeamOnly)
-            : i_player(pl), i_message(msg), i_toSelf(to_self), i_ownTeamOnly(ownTeamOnly), i_dist(dist) {}
+            : i_player(pl), i_message(*msg), i_toSelf(to_self), i_ownTeamOnly(ownTeamOnly), i_dist(dist) {}
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
@@ -101,9 +102,9 @@ namespace MaNGOS
     struct MANGOS_DLL_DECL ObjectMessageDistDeliverer
     {
         WorldObject const& i_object;
-        WorldPacket* i_message;
+        SharedPacket i_message;
         float i_dist;
-        ObjectMessageDistDeliverer(WorldObject const& obj, WorldPacket* msg, float dist) : i_object(obj), i_message(msg), i_dist(dist) {}
+        ObjectMessageDistDeliverer(WorldObject const& obj, WorldPacket* msg, float dist) : i_object(obj), i_message(*msg), i_dist(dist) {}
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
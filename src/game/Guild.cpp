@@ -133,7 +133,7 @@ bool Guild::Create(Player* leader, std::string gname)
     CharacterDatabase.escape_string(dbGINFO);
     CharacterDatabase.escape_string(dbMOTD);
 
-    CharacterDatabase.BeginTransaction();
+    CharacterDatabase.BeginTransaction(MakeSqlOwnerKey(SQL_OWNER_KEY_GUILD, m_Id));
     // CharacterDatabase.PExecute("DELETE FROM guild WHERE guildid='%u'", Id); - MAX(guildid)+1 not exist
     CharacterDatabase.PExecute("DELETE FROM guild_member WHERE guildid='%u'", m_Id);
     CharacterDatabase.PExecute("INSERT INTO guild (guildid,name,leaderguid,info,motd,createdate,EmblemStyle,EmblemColor,BorderStyle,BorderColor,BackgroundColor) "
@@ -384,7 +384,7 @@ bool Guild::LoadRanksFromDB(QueryResult* guildRanksResult)
     if (broken_ranks)
     {
         sLog.outError("Guild %u has broken `guild_rank` data, repairing...", m_Id);
-        CharacterDatabase.BeginTransaction();
+        CharacterDatabase.BeginTransaction(MakeSqlOwnerKey(SQL_OWNER_KEY_GUILD, m_Id));
         CharacterDatabase.PExecute("DELETE FROM guild_rank WHERE guildid='%u'", m_Id);
         for (size_t i = 0; i < m_Ranks.size(); ++i)
         {
@@ -712,7 +712,7 @@ void Guild::Disband()
         DelMember(ObjectGuid(HIGHGUID_PLAYER, itr->first), true);
     }
 
-    CharacterDatabase.BeginTransaction();
+    CharacterDatabase.BeginTransaction(MakeSqlOwnerKey(SQL_OWNER_KEY_GUILD, m_Id));
     CharacterDatabase.PExecute("DELETE FROM guild WHERE guildid = '%u'", m_Id);
     CharacterDatabase.PExecute("DELETE FROM guild_rank WHERE guildid = '%u'", m_Id);
     CharacterDatabase.PExecute("DELETE FROM guild_eventlog WHERE guildid = '%u'", m_Id);
@@ -229,6 +229,7 @@ Item::Item() :
     m_container = NULL;
     mb_in_trade = false;
     m_lootState = ITEM_LOOT_NONE;
+    m_clientUpdateMap = NULL;
 }
 
 Item::~Item()
@@ -997,20 +998,45 @@ bool Item::IsBindedNotWith(Player const* player) const
 void Item::AddToClientUpdateList()
 {
     if (Player* pl = GetOwner())
-        pl->GetMap()->AddUpdateObject(this);
+    {
+        m_clientUpdateMap = pl->GetMap();
+        m_clientUpdateMap->AddUpdateObject(this);
+    }
 }
 
 void Item::RemoveFromClientUpdateList()
 {
-    if (Player* pl = GetOwner())
-        pl->GetMap()->RemoveUpdateObject(this);
+    // the queue the item was added to, the owner may be on another map already
+    if (m_clientUpdateMap)
+    {
+        m_clientUpdateMap->RemoveUpdateObject(this);
+        m_clientUpdateMap = NULL;
+    }
 }
 
-void Item::BuildUpdateData(UpdateDataMapType& update_players)
+void Item::BuildUpdateData(UpdatePlayerList& update_players)
 {
-    if (Player* pl = GetOwner())
-        BuildUpdateDataForPlayer(pl, update_players);
+    // taken from the queue by its map (or forced update after RemoveFromClientUpdateList)
+    Map* queueMap = m_clientUpdateMap;
+    m_clientUpdateMap = NULL;
+
+    Player* pl = GetOwner();
+    if (!pl)
+    {
+        ClearUpdateMask(false);
+        return;
+    }
+
+    // GetOwner is a global lookup, an owner on another map is updated by another thread and its update
+    // buffer must not be written here. The changed values are kept, the next change of the item queues
+    // it on the owner's map and sends them from there.
+    if (queueMap && pl->GetMap() != queueMap)
+    {
+        m_objectUpdated = false;
+        return;
+    }
 
+    BuildUpdateDataForPlayer(pl, update_players);
     ClearUpdateMask(false);
 }
 
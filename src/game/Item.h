@@ -26,6 +26,7 @@
 
 struct SpellEntry;
 class Bag;
+class Map;
 class Field;
 class QueryResult;
 class Unit;
@@ -336,7 +337,7 @@ class MANGOS_DLL_SPEC Item : public Object
 
         void AddToClientUpdateList() override;
         void RemoveFromClientUpdateList() override;
-        void BuildUpdateData(UpdateDataMapType& update_players) override;
+        void BuildUpdateData(UpdatePlayerList& update_players) override;
     private:
         uint8 m_slot;
         Bag* m_container;
@@ -344,6 +345,7 @@ class MANGOS_DLL_SPEC Item : public Object
         int16 uQueuePos;
         bool mb_in_trade;                                   // true if item is currently in trade-window
         ItemLootUpdateState m_lootState;
+        Map* m_clientUpdateMap;                             // map whose update queue holds the item, NULL if not queued
 };
 
 #endif
@@ -26,6 +26,7 @@
 #include "Language.h"
 #include "AccountMgr.h"
 #include "ScriptMgr.h"
+#include "PlayerSaveScheduler.h"
 #include "SystemConfig.h"
 #include "revision.h"
 #include "revision_nr.h"
@@ -158,7 +159,7 @@ bool ChatHandler::HandleSaveCommand(char* /*args*/)
     // save or plan save after 20 sec (logout delay) if current next save time more this value and _not_ output any messages to prevent cheat planning
     uint32 save_interval = sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE);
     if (save_interval == 0 || (save_interval > 20 * IN_MILLISECONDS && player->GetSaveTimer() <= save_interval - 20 * IN_MILLISECONDS))
-        player->SaveToDB();
+        sPlayerSaveScheduler.RequestSave(player->GetObjectGuid(), true);
 
     return true;
 }
@@ -55,6 +55,7 @@
 #include "CreatureEventAIMgr.h"
 #include "AuctionHouseBot/AuctionHouseBot.h"
 #include "SQLStorages.h"
+#include "PerfStats.h"
 
 static uint32 ahbotQualityIds[MAX_AUCTION_QUALITY] =
 {
@@ -832,6 +833,7 @@ bool ChatHandler::HandleReloadDBScriptsOnSpellCommand(char* args)
         sLog.outString("Re-Loading Scripts from `dbscripts_on_spell`...");
 
     sScriptMgr.LoadSpellScripts();
+    sScriptMgr.ApplyExploredQuestFlags();
 
     if (*args != 'a')
         SendGlobalSysMessage("DB table `dbscripts_on_spell` reloaded.");
@@ -852,6 +854,7 @@ bool ChatHandler::HandleReloadDBScriptsOnQuestStartCommand(char* args)
         sLog.outString("Re-Loading Scripts from `dbscripts_on_quest_start`...");
 
     sScriptMgr.LoadQuestStartScripts();
+    sScriptMgr.ApplyExploredQuestFlags();
 
     if (*args != 'a')
         SendGlobalSysMessage("DB table `dbscripts_on_quest_start` reloaded.");
@@ -872,6 +875,7 @@ bool ChatHandler::HandleReloadDBScriptsOnQuestEndCommand(char* args)
         sLog.outString("Re-Loading Scripts from `dbscripts_on_quest_end`...");
 
     sScriptMgr.LoadQuestEndScripts();
+    sScriptMgr.ApplyExploredQuestFlags();
 
     if (*args != 'a')
         SendGlobalSysMessage("DB table `dbscripts_on_quest_end` reloaded.");
@@ -892,6 +896,7 @@ bool ChatHandler::HandleReloadDBScriptsOnEventCommand(char* args)
         sLog.outString("Re-Loading Scripts from `dbscripts_on_event`...");
 
     sScriptMgr.LoadEventScripts();
+    sScriptMgr.ApplyExploredQuestFlags();
 
     if (*args != 'a')
         SendGlobalSysMessage("DB table `dbscripts_on_event` reloaded.");
@@ -913,6 +918,7 @@ bool ChatHandler::HandleReloadDBScriptsOnGoUseCommand(char* args)
 
     sScriptMgr.LoadGameObjectScripts();
     sScriptMgr.LoadGameObjectTemplateScripts();
+    sScriptMgr.ApplyExploredQuestFlags();
 
     if (*args != 'a')
         SendGlobalSysMessage("DB table `dbscripts_on_go[_template]_use` reloaded.");
@@ -933,6 +939,7 @@ bool ChatHandler::HandleReloadDBScriptsOnCreatureDeathCommand(char* args)
         sLog.outString("Re-Loading Scripts from `dbscripts_on_creature_death`...");
 
     sScriptMgr.LoadCreatureDeathScripts();
+    sScriptMgr.ApplyExploredQuestFlags();
 
     if (*args != 'a')
         SendGlobalSysMessage("DB table `dbscripts_on_creature_death` reloaded.");
@@ -5641,6 +5648,78 @@ bool ChatHandler::HandleServerPLimitCommand(char* args)
     return true;
 }
 
+bool ChatHandler::HandleServerPerfCommand(char* args)
+{
+    std::vector<std::string> lines;
+
+    if (*args)
+    {
+        if (ExtractLiteralArg(&args, "reset"))
+        {
+            sPerfStats.Reset();
+            SendSysMessage("Performance statistics reset.");
+            return true;
+        }
+
+        if (!ExtractLiteralArg(&args, "opcodes"))
+            return false;
+
+        uint32 limit;
+        if (!ExtractOptUInt32(&args, limit, 20))
+            return false;
+
+        sPerfStats.BuildOpcodeReport(lines, limit);
+    }
+    else
+        sPerfStats.BuildReport(lines);
+
+    for (std::vector<std::string>::const_iterator itr = lines.begin(); itr != lines.end(); ++itr)
+        SendSysMessage(itr->c_str());
+
+    return true;
+}
+
+bool ChatHandler::HandleServerMemoryCommand(char* /*args*/)
+{
+    uint64 storageTotal = 0;
+    uint64 savedTotal = 0;
+
+    SendSysMessage("SQL storages (records/index/data bytes, strings, interned):");
+
+    SQLStorageBase::StorageList const& storages = SQLStorageBase::GetStorages();
+    for (SQLStorageBase::StorageList::const_iterator itr = storages.begin(); itr != storages.end(); ++itr)
+    {
+        SQLStorageBase const* store = *itr;
+        SQLStorageArena const& arena = store->GetArena();
+        if (!store->GetRecordCount())
+            continue;
+
+        uint64 bytes = uint64(arena.GetRecordBytes()) + store->GetIndexBytes() + arena.GetDataBytes();
+        storageTotal += bytes;
+        savedTotal += arena.GetInternedBytes();
+
+        PSendSysMessage("  %s: %u records, " SIZEFMTD "/" SIZEFMTD "/" SIZEFMTD ", %u strings, %u interned (" SIZEFMTD " bytes saved)",
+                        store->GetTableName(), store->GetRecordCount(), arena.GetRecordBytes(), store->GetIndexBytes(),
+                        arena.GetDataBytes(), arena.GetStringCount(), arena.GetInternedCount(), arena.GetInternedBytes());
+    }
+
+    uint64 containerTotal = 0;
+
+    StaticDataMemoryUsageList containers;
+    sObjectMgr.GetMemoryUsage(containers);
+
+    SendSysMessage("Static data containers (approximate):");
+    for (StaticDataMemoryUsageList::const_iterator itr = containers.begin(); itr != containers.end(); ++itr)
+    {
+        containerTotal += itr->bytes;
+        PSendSysMessage("  %s: %u entries, " UI64FMTD " bytes", itr->name, itr->count, itr->bytes);
+    }
+
+    PSendSysMessage("Total: SQL storages " UI64FMTD " KB (" UI64FMTD " KB saved by interning), containers " UI64FMTD " KB",
+                    storageTotal / 1024, savedTotal / 1024, containerTotal / 1024);
+    return true;
+}
+
 bool ChatHandler::HandleCastCommand(char* args)
 {
     if (!*args)
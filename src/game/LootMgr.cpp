@@ -25,6 +25,7 @@
 #include "SharedDefines.h"
 #include "DBCStores.h"
 #include "SQLStorages.h"
+#include "Database/SnapshotFile.h"
 
 static eConfigFloatValues const qualityToRate[MAX_ITEM_QUALITY] =
 {
@@ -96,11 +97,19 @@ void LootStore::LoadLootTable()
 
     sLog.outString("%s :", GetName());
 
+    // rows checked by an earlier load of the same world database
+    SnapshotFile snapshot(GetName(), "entry item chance mincountOrRef group needs_quest maxcount condition");
+    if (snapshot.Open() && LoadLootTableFromSnapshot(snapshot))
+        return;
+    snapshot.Close();
+
     //                                                 0      1     2                    3        4              5         6
     QueryResult* result = WorldDatabase.PQuery("SELECT entry, item, ChanceOrQuestChance, groupid, mincountOrRef, maxcount, condition_id FROM %s", GetName());
 
     if (result)
     {
+        snapshot.BeginWrite();
+
         BarGoLink bar(result->GetRowCount());
 
         do
@@ -161,11 +170,16 @@ void LootStore::LoadLootTable()
             // Adds current row to the template
             tab->second->AddEntry(storeitem);
             ++count;
+
+            if (snapshot.IsWriting())
+                WriteLootSnapshotRow(snapshot, entry, storeitem);
         }
         while (result->NextRow());
 
         delete result;
 
+        snapshot.EndWrite();
+
         Verify();                                           // Checks validity of the loot store
 
         sLog.outString();
@@ -178,6 +192,71 @@ void LootStore::LoadLootTable()
     }
 }
 
+void LootStore::WriteLootSnapshotRow(SnapshotFile& snapshot, uint32 entry, LootStoreItem const& item)
+{
+    snapshot.WriteUInt32(entry);
+    snapshot.WriteUInt32(item.itemid);
+    snapshot.WriteFloat(item.chance);
+    snapshot.WriteInt32(item.mincountOrRef);
+    snapshot.WriteUInt8(item.group);
+    snapshot.WriteUInt8(item.needs_quest ? 1 : 0);
+    snapshot.WriteUInt8(item.maxcount);
+    snapshot.WriteUInt32(item.conditionId);
+    snapshot.EndRecord();
+}
+
+// The accepted rows in the order of the database load, the templates are built the same way
+bool LootStore::LoadLootTableFromSnapshot(SnapshotFile& snapshot)
+{
+    typedef std::vector<std::pair<uint32, LootStoreItem> > LootRowList;
+    LootRowList rows;
+    rows.reserve(snapshot.GetRecordCount());
+
+    for (uint32 i = 0; i < snapshot.GetRecordCount(); ++i)
+    {
+        uint32 entry         = snapshot.ReadUInt32();
+        uint32 item          = snapshot.ReadUInt32();
+        float  chance        = snapshot.ReadFloat();
+        int32  mincountOrRef = snapshot.ReadInt32();
+        uint8  group         = snapshot.ReadUInt8();
+        bool   needsQuest    = snapshot.ReadUInt8() != 0;
+        uint8  maxcount      = snapshot.ReadUInt8();
+        uint16 conditionId   = uint16(snapshot.ReadUInt32());
+
+        // quest drops are stored with a negative chance, never 0
+        rows.push_back(LootRowList::value_type(entry, LootStoreItem(item, needsQuest ? -chance : chance, group, conditionId, mincountOrRef, maxcount)));
+    }
+
+    if (snapshot.HasReadError() || !snapshot.IsEnd())
+    {
+        sLog.outError("Snapshot of `%s` can not be read, loading the table from the database.", GetName());
+        return false;
+    }
+
+    BarGoLink bar(rows.size());
+
+    LootTemplateMap::const_iterator tab = m_LootTemplates.end();
+    for (LootRowList::iterator itr = rows.begin(); itr != rows.end(); ++itr)
+    {
+        bar.step();
+
+        if (tab == m_LootTemplates.end() || tab->first != itr->first)
+        {
+            tab = m_LootTemplates.find(itr->first);
+            if (tab == m_LootTemplates.end())
+                tab = m_LootTemplates.insert(LootTemplateMap::value_type(itr->first, new LootTemplate)).first;
+        }
+
+        tab->second->AddEntry(itr->second);
+    }
+
+    Verify();                                               // only reports, the snapshot holds the checked rows
+
+    sLog.outString();
+    sLog.outString(">> Loaded " SIZEFMTD " loot definitions (" SIZEFMTD " templates) from snapshot", rows.size(), m_LootTemplates.size());
+    return true;
+}
+
 bool LootStore::HaveQuestLootFor(uint32 loot_id) const
 {
     LootTemplateMap::const_iterator itr = m_LootTemplates.find(loot_id);
@@ -29,6 +29,7 @@
 
 class Player;
 class LootStore;
+class SnapshotFile;
 class WorldObject;
 
 #define MAX_NR_LOOT_ITEMS 16
@@ -165,6 +166,9 @@ class LootStore
         void LoadLootTable();
         void Clear();
     private:
+        bool LoadLootTableFromSnapshot(SnapshotFile& snapshot);
+        static void WriteLootSnapshotRow(SnapshotFile& snapshot, uint32 entry, LootStoreItem const& item);
+
         LootTemplateMap m_LootTemplates;
         char const* m_name;
         char const* m_entryName;
@@ -22,6 +22,7 @@ E(_E), events(_events), funcRef(_funcRef), delay(_delay), calls(_calls), obj(_ob
 
 LuaEvent::~LuaEvent()
 {
+    ACE_Guard<ACE_Recursive_Thread_Mutex> guard(E.lock);
     if (events)
     {
         // Attempt to remove the pointer from LuaEvents
@@ -34,6 +35,7 @@ LuaEvent::~LuaEvent()
 
 bool LuaEvent::Execute(uint64 /*time*/, uint32 /*diff*/)
 {
+    ACE_Guard<ACE_Recursive_Thread_Mutex> guard(E.lock);
     bool remove = (calls == 1);
     if (!remove)
         events->AddEvent(this, events->CalculateTime(delay)); // Reschedule before calling incase RemoveEvents used
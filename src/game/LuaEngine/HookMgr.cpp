@@ -46,6 +46,7 @@ ENDCALL();
 #define EVENT_BEGIN(BINDMAP, EVENT, RET) \
     if (!BINDMAP->HasEvents(EVENT)) \
         RET; \
+    ELUNA_GUARD(); \
     lua_State* L = sEluna->L; \
     const char* _LuaBindType = sEluna->BINDMAP->groupName; \
     uint32 _LuaEvent = EVENT; \
@@ -81,6 +82,7 @@ ENDCALL();
     int _Luabind = sEluna->BINDMAP->GetBind(ENTRY, EVENT); \
     if (!_Luabind) \
         RET; \
+    ELUNA_GUARD(); \
     lua_State* L = sEluna->L; \
     const char* _LuaBindType = sEluna->BINDMAP->groupName; \
     uint32 _LuaEvent = EVENT; \
@@ -180,6 +182,11 @@ bool Eluna::OnPacketSend(WorldSession* session, WorldPacket& packet)
     OnPacketSendOne(player, packet, result);
     return result;
 }
+bool Eluna::HasPacketSendHooks(uint16 opcode) const
+{
+    return ServerEventBindings->HasEvents(SERVER_EVENT_ON_PACKET_SEND) ||
+           PacketEventBindings->GetBind(OpcodesList(opcode), PACKET_EVENT_ON_PACKET_SEND);
+}
 void Eluna::OnPacketSendAny(Player* player, WorldPacket& packet, bool& result)
 {
     EVENT_BEGIN(ServerEventBindings, SERVER_EVENT_ON_PACKET_SEND, return);
@@ -336,7 +343,10 @@ void Eluna::OnWorldUpdate(uint32 diff)
         return;
     }
 
-    m_EventMgr->Update(diff);
+    {
+        ELUNA_GUARD();
+        m_EventMgr->Update(diff);
+    }
     EVENT_BEGIN(ServerEventBindings, WORLD_EVENT_ON_UPDATE, return);
     Push(L, diff);
     EVENT_EXECUTE(0);
@@ -310,6 +310,7 @@ void Eluna::RemoveRef(const void* obj)
 {
     if (!sEluna)
         return;
+    ELUNA_GUARD();
     lua_rawgeti(sEluna->L, LUA_REGISTRYINDEX, sEluna->userdata_table);
     lua_pushfstring(sEluna->L, "%p", obj);
     lua_gettable(sEluna->L, -2);
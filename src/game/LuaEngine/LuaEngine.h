@@ -20,6 +20,8 @@
 #include "World.h"
 #include "HookMgr.h"
 
+#include <ace/Recursive_Thread_Mutex.h>
+
 #ifdef TRINITY
 struct ItemTemplate;
 #else
@@ -105,6 +107,9 @@ public:
 
     EventMgr* m_EventMgr;
 
+    // serializes all access to the lua state, hooks can be called from map update threads
+    ACE_Recursive_Thread_Mutex lock;
+
     EventBind<HookMgr::ServerEvents>*       ServerEventBindings;
     EventBind<HookMgr::PlayerEvents>*       PlayerEventBindings;
     EventBind<HookMgr::GuildEvents>*        GuildEventBindings;
@@ -231,6 +236,7 @@ public:
 
     /* Packet */
     bool OnPacketSend(WorldSession* session, WorldPacket& packet);
+    bool HasPacketSendHooks(uint16 opcode) const;
     void OnPacketSendAny(Player* player, WorldPacket& packet, bool& result);
     void OnPacketSendOne(Player* player, WorldPacket& packet, bool& result);
     bool OnPacketReceive(WorldSession* session, WorldPacket& packet);
@@ -343,5 +349,6 @@ template<> GameObject* Eluna::CHECKOBJ<GameObject>(lua_State* L, int narg, bool
 template<> Corpse* Eluna::CHECKOBJ<Corpse>(lua_State* L, int narg, bool error);
 
 #define sEluna Eluna::GEluna
+#define ELUNA_GUARD() ACE_Guard<ACE_Recursive_Thread_Mutex> ELUNA_GUARD_OBJECT(sEluna->lock)
 
 #endif
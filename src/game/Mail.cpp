@@ -251,7 +251,7 @@ void MailDraft::SendReturnToSender(uint32 sender_acc, ObjectGuid sender_guid, Ob
         needItemDelay = sender_acc != rc_account;
 
         // set owner to new receiver (to prevent delete item with sender char deleting)
-        CharacterDatabase.BeginTransaction();
+        CharacterDatabase.BeginTransaction(sender_guid.GetRawValue(), receiver_guid.GetRawValue());
         for (MailItemMap::iterator mailItemIter = m_items.begin(); mailItemIter != m_items.end(); ++mailItemIter)
         {
             Item* item = mailItemIter->second;
@@ -320,18 +320,24 @@ void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sende
     // Add to DB
     std::string safe_subject = GetSubject();
 
-    CharacterDatabase.BeginTransaction();
+    // mails of players are ordered with the saves of both players, other senders keep the global order
+    if (sender.GetMailMessageType() == MAIL_NORMAL)
+        CharacterDatabase.BeginTransaction(receiver.GetPlayerGuid().GetRawValue(), ObjectGuid(HIGHGUID_PLAYER, sender.GetSenderId()).GetRawValue());
+    else
+        CharacterDatabase.BeginTransaction();
     CharacterDatabase.escape_string(safe_subject);
     CharacterDatabase.PExecute("INSERT INTO mail (id,messageType,stationery,mailTemplateId,sender,receiver,subject,itemTextId,has_items,expire_time,deliver_time,money,cod,checked) "
                                "VALUES ('%u', '%u', '%u', '%u', '%u', '%u', '%s', '%u', '%u', '" UI64FMTD "','" UI64FMTD "', '%u', '%u', '%u')",
                                mailId, sender.GetMailMessageType(), sender.GetStationery(), GetMailTemplateId(), sender.GetSenderId(), receiver.GetPlayerGuid().GetCounter(), safe_subject.c_str(), GetBodyId(), (has_items ? 1 : 0), (uint64)expire_time, (uint64)deliver_time, m_money, m_COD, checked);
 
-    for (MailItemMap::const_iterator mailItemIter = m_items.begin(); mailItemIter != m_items.end(); ++mailItemIter)
     {
-        Item* item = mailItemIter->second;
-        CharacterDatabase.PExecute("INSERT INTO mail_items (mail_id,item_guid,item_template,receiver) VALUES ('%u', '%u', '%u','%u')",
-                                   mailId, item->GetGUIDLow(), item->GetEntry(), receiver.GetPlayerGuid().GetCounter());
-    }
+        SqlBatchStatement batchIns(CharacterDatabase, "INSERT INTO mail_items (mail_id,item_guid,item_template,receiver) VALUES (?, ?, ?, ?)");
+        for (MailItemMap::const_iterator mailItemIter = m_items.begin(); mailItemIter != m_items.end(); ++mailItemIter)
+        {
+            Item* item = mailItemIter->second;
+            batchIns.AddRow(mailId, item->GetGUIDLow(), item->GetEntry(), receiver.GetPlayerGuid().GetCounter());
+        }
+    }                                                       // rows are sent before the commit
     CharacterDatabase.CommitTransaction();
 
     // For online receiver update in game mail status and data
@@ -392,7 +398,7 @@ void Mail::prepareTemplateItems(Player* receiver)
     // can be empty
     mailLoot.FillLoot(mailTemplateId, LootTemplates_Mail, receiver, true, true);
 
-    CharacterDatabase.BeginTransaction();
+    CharacterDatabase.BeginTransaction(receiver->GetObjectGuid().GetRawValue());
     CharacterDatabase.PExecute("UPDATE mail SET has_items = 1 WHERE id = %u", messageID);
 
     uint32 max_slot = mailLoot.GetMaxSlotInLootFor(receiver);
@@ -38,6 +38,10 @@
 #include "BattleGround/BattleGroundMgr.h"
 #include "Chat.h"
 #include "LuaEngine.h"
+#include "PerfStats.h"
+#include "PoolManager.h"
+
+#include <ace/TSS_T.h>
 
 Map::~Map()
 {
@@ -76,9 +80,8 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId)
     : i_mapEntry(sMapStore.LookupEntry(id)),
       i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0),
       m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE), m_persistentState(NULL),
-      m_activeNonPlayersIter(m_activeNonPlayers.end()),
       i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
-      i_data(NULL), i_script_id(0)
+      i_data(NULL), i_script_id(0), m_islandsUpdating(false)
 {
     m_CreatureGuids.Set(sObjectMgr.GetFirstTemporaryCreatureLowGuid());
     m_GameObjectGuids.Set(sObjectMgr.GetFirstTemporaryGameObjectLowGuid());
@@ -207,6 +210,8 @@ void Map::DeleteFromWorld(Player* pl)
 void
 Map::EnsureGridCreated(const GridPair& p)
 {
+    MapIslandGuard guard(this);
+
     if (!getNGrid(p.x_coord, p.y_coord))
     {
         setNGrid(new NGridType(p.x_coord * MAX_NUMBER_OF_GRIDS + p.y_coord, p.x_coord, p.y_coord, i_gridExpiry, sWorld.getConfig(CONFIG_BOOL_GRID_UNLOAD)),
@@ -256,6 +261,8 @@ Map::EnsureGridLoadedAtEnter(const Cell& cell, Player* player)
 
 bool Map::EnsureGridLoaded(const Cell& cell)
 {
+    MapIslandGuard guard(this);
+
     EnsureGridCreated(GridPair(cell.GridX(), cell.GridY()));
     NGridType* grid = getNGrid(cell.GridX(), cell.GridY());
 
@@ -318,6 +325,8 @@ template<class T>
 void
 Map::Add(T* obj)
 {
+    MapIslandGuard guard(this);
+
     MANGOS_ASSERT(obj);
 
     CellPair p = MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY());
@@ -441,58 +450,85 @@ bool Map::loaded(const GridPair& p) const
     return (getNGrid(p.x_coord, p.y_coord) && isGridObjectDataLoaded(p.x_coord, p.y_coord));
 }
 
-void Map::Update(const uint32& t_diff)
+static void VisitActiveCell(Map* map, uint32 cell_id, TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer>& grid_object_update,
+                            TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer>& world_object_update)
 {
-    m_dyn_tree.update(t_diff);
+    CellPair pair(cell_id % TOTAL_NUMBER_OF_CELLS_PER_MAP, cell_id / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+    Cell cell(pair);
+    cell.SetNoCreate();
+    map->Visit(cell, grid_object_update);
+    map->Visit(cell, world_object_update);
+}
 
-    /// update worldsessions for existing players
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+void Map::UpdateActiveCells(uint32 diff)
+{
+    resetMarkedCells();
+
+    std::vector<CellArea> areas;
+    areas.reserve(m_mapRefManager.getSize() + m_activeNonPlayers.size());
+
+    // lets update mobs/objects in ALL visible cells around players and active objects!
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
     {
-        Player* plr = m_mapRefIter->getSource();
-        if (plr && plr->IsInWorld())
-        {
-            WorldSession* pSession = plr->GetSession();
-            MapSessionFilter updater(pSession);
+        Player* plr = itr->getSource();
 
-            pSession->Update(updater);
-        }
+        if (!plr->IsInWorld() || !plr->IsPositionValid())
+            continue;
+
+        areas.push_back(Cell::CalculateCellArea(plr->GetPositionX(), plr->GetPositionY(), GetVisibilityDistance()));
     }
 
-    /// update players at tick
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+    for (ActiveNonPlayers::const_iterator itr = m_activeNonPlayers.begin(); itr != m_activeNonPlayers.end(); ++itr)
     {
-        Player* plr = m_mapRefIter->getSource();
-        if (plr && plr->IsInWorld())
+        WorldObject* obj = *itr;
+
+        if (!obj->IsInWorld() || !obj->IsPositionValid())
+            continue;
+
+        areas.push_back(Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance()));
+    }
+
+    MapUpdater& mapUpdater = sMapMgr.GetMapUpdater();
+
+    // only continents are big enough to be split, instances are already updated in parallel as a whole
+    if (areas.size() > 1 && CanUpdateCellIslands())
+    {
+        std::vector<MapCellIsland> islands;
+        BuildCellIslands(areas, islands);
+
+        if (islands.size() > 1)
         {
-            WorldObject::UpdateHelper helper(plr);
-            helper.Update(t_diff);
+            m_islandsUpdating = true;
+
+            MapUpdateBatch batch;
+            for (std::vector<MapCellIsland>::iterator itr = islands.begin(); itr != islands.end(); ++itr)
+                mapUpdater.ScheduleIslandUpdate(*this, *itr, diff, batch);
+            mapUpdater.WaitBatch(batch);
+
+            m_islandsUpdating = false;
+
+            ApplyDeferredIslandActions(islands);
+            return;
         }
-    }
 
-    /// update active cells around players and active objects
-    resetMarkedCells();
+        if (!islands.empty())
+        {
+            UpdateCellIsland(islands.front(), diff);
+            return;
+        }
+    }
 
-    MaNGOS::ObjectUpdater updater(t_diff);
+    MaNGOS::ObjectUpdater updater(diff);
     // for creature
     TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
     // for pets
     TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
 
-    // the player iterator is stored in the map object
-    // to make sure calls to Map::Remove don't invalidate it
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+    for (std::vector<CellArea>::const_iterator itr = areas.begin(); itr != areas.end(); ++itr)
     {
-        Player* plr = m_mapRefIter->getSource();
-
-        if (!plr->IsInWorld() || !plr->IsPositionValid())
-            continue;
-
-        // lets update mobs/objects in ALL visible cells around player!
-        CellArea area = Cell::CalculateCellArea(plr->GetPositionX(), plr->GetPositionY(), GetVisibilityDistance());
-
-        for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+        for (uint32 x = itr->low_bound.x_coord; x <= itr->high_bound.x_coord; ++x)
         {
-            for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+            for (uint32 y = itr->low_bound.y_coord; y <= itr->high_bound.y_coord; ++y)
             {
                 // marked cells are those that have been visited
                 // don't visit the same cell twice
@@ -500,54 +536,226 @@ void Map::Update(const uint32& t_diff)
                 if (!isCellMarked(cell_id))
                 {
                     markCell(cell_id);
-                    CellPair pair(x, y);
-                    Cell cell(pair);
-                    cell.SetNoCreate();
-                    Visit(cell, grid_object_update);
-                    Visit(cell, world_object_update);
+                    VisitActiveCell(this, cell_id, grid_object_update, world_object_update);
                 }
             }
         }
     }
+}
+
+bool Map::CanUpdateCellIslands() const
+{
+    if (!sWorld.getConfig(CONFIG_BOOL_MAP_UPDATE_CELL_ISLANDS) || Instanceable() || !sMapMgr.GetMapUpdater().IsActivated())
+        return false;
+
+    // a world script or a Lua script may reach any object of the map, there is no island they stay in
+    if (i_data || !Eluna::lua_scripts.empty())
+        return false;
+
+    return true;
+}
+
+struct CellAreaLowXOrder
+{
+    explicit CellAreaLowXOrder(std::vector<CellArea> const& areas) : m_areas(areas) {}
+    bool operator()(uint32 a, uint32 b) const { return m_areas[a].low_bound.x_coord < m_areas[b].low_bound.x_coord; }
+
+    std::vector<CellArea> const& m_areas;
+};
+
+static uint32 FindIslandRoot(std::vector<uint32>& parent, uint32 i)
+{
+    while (parent[i] != i)
+        i = parent[i] = parent[parent[i]];
+    return i;
+}
+
+void Map::BuildCellIslands(std::vector<CellArea> const& areas, std::vector<MapCellIsland>& islands)
+{
+    // objects at the border of two areas may interact with each other through up to
+    // one visibility radius on each side, so areas closer than that are merged
+    uint32 radius = uint32(ceil(GetVisibilityDistance() / SIZE_OF_GRID_CELL));
+    uint32 gap = 2 * radius + 1;
 
-    // non-player active objects
-    if (!m_activeNonPlayers.empty())
+    // union-find over the areas, sweep along x to only compare near areas
+    std::vector<uint32> parent(areas.size());
+    std::vector<uint32> order(areas.size());
+    for (uint32 i = 0; i < areas.size(); ++i)
+        parent[i] = order[i] = i;
+
+    std::sort(order.begin(), order.end(), CellAreaLowXOrder(areas));
+
+    for (uint32 i = 0; i < order.size(); ++i)
     {
-        for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
+        CellArea const& a = areas[order[i]];
+        for (uint32 j = i + 1; j < order.size(); ++j)
         {
-            // skip not in world
-            WorldObject* obj = *m_activeNonPlayersIter;
-
-            // step before processing, in this case if Map::Remove remove next object we correctly
-            // step to next-next, and if we step to end() then newly added objects can wait next update.
-            ++m_activeNonPlayersIter;
+            CellArea const& b = areas[order[j]];
+            if (b.low_bound.x_coord > a.high_bound.x_coord + gap)
+                break;
 
-            if (!obj->IsInWorld() || !obj->IsPositionValid())
+            if (b.low_bound.y_coord > a.high_bound.y_coord + gap || a.low_bound.y_coord > b.high_bound.y_coord + gap)
                 continue;
 
-            // lets update mobs/objects in ALL visible cells around player!
-            CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
+            parent[FindIslandRoot(parent, order[i])] = FindIslandRoot(parent, order[j]);
+        }
+    }
+
+    // collect the cells of each island, in the same order the serial update would visit them
+    std::vector<int32> islandOfRoot(areas.size(), -1);
+    for (uint32 i = 0; i < areas.size(); ++i)
+    {
+        uint32 root = FindIslandRoot(parent, i);
+        if (islandOfRoot[root] < 0)
+        {
+            islandOfRoot[root] = int32(islands.size());
+            islands.push_back(MapCellIsland());
+        }
+
+        MapCellIsland& island = islands[islandOfRoot[root]];
+        island.map = this;
 
-            for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+        CellArea const& area = areas[i];
+        for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+        {
+            for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
             {
-                for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+                uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+                if (!isCellMarked(cell_id))
                 {
-                    // marked cells are those that have been visited
-                    // don't visit the same cell twice
-                    uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                    if (!isCellMarked(cell_id))
-                    {
-                        markCell(cell_id);
-                        CellPair pair(x, y);
-                        Cell cell(pair);
-                        cell.SetNoCreate();
-                        Visit(cell, grid_object_update);
-                        Visit(cell, world_object_update);
-                    }
+                    markCell(cell_id);
+                    island.cells.push_back(cell_id);
                 }
             }
         }
     }
+}
+
+/// Cell island updated by the current thread, it takes the deferred actions of its map
+struct MapIslandThreadState
+{
+    MapIslandThreadState() : island(NULL) {}
+
+    MapCellIsland* island;
+};
+
+static ACE_TSS<MapIslandThreadState> islandThreadState;
+
+void Map::UpdateCellIsland(MapCellIsland& island, uint32 diff)
+{
+    MaNGOS::ObjectUpdater updater(diff);
+    // for creature
+    TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
+    // for pets
+    TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
+
+    MapCellIsland* previous = islandThreadState->island;
+    islandThreadState->island = &island;
+
+    for (std::vector<uint32>::const_iterator itr = island.cells.begin(); itr != island.cells.end(); ++itr)
+        VisitActiveCell(this, *itr, grid_object_update, world_object_update);
+
+    islandThreadState->island = previous;
+}
+
+void Map::DeferIslandAction(MapDeferredAction const& action)
+{
+    MapCellIsland* island = islandThreadState->island;
+    if (island && island->map == this)
+    {
+        island->deferred.push_back(action);
+        return;
+    }
+
+    // queued by an update of another map
+    MapIslandGuard guard(this);
+    m_deferredActions.push_back(action);
+}
+
+void Map::ApplyDeferredIslandActions(std::vector<MapCellIsland>& islands)
+{
+    // the islands are applied in the order the serial update would have visited them
+    for (std::vector<MapCellIsland>::const_iterator itr = islands.begin(); itr != islands.end(); ++itr)
+        for (std::vector<MapDeferredAction>::const_iterator action = itr->deferred.begin(); action != itr->deferred.end(); ++action)
+            ApplyDeferredIslandAction(*action);
+
+    std::vector<MapDeferredAction> actions;
+    actions.swap(m_deferredActions);
+
+    for (std::vector<MapDeferredAction>::const_iterator action = actions.begin(); action != actions.end(); ++action)
+        ApplyDeferredIslandAction(*action);
+}
+
+void Map::ApplyDeferredIslandAction(MapDeferredAction const& action)
+{
+    switch (action.type)
+    {
+        case MapDeferredAction::POOL_UPDATE_CREATURE:
+            sPoolMgr.UpdatePool<Creature>(*GetPersistentState(), uint16(action.id), action.lowGuid);
+            break;
+        case MapDeferredAction::POOL_UPDATE_GAMEOBJECT:
+            sPoolMgr.UpdatePool<GameObject>(*GetPersistentState(), uint16(action.id), action.lowGuid);
+            break;
+        case MapDeferredAction::POOL_UPDATE_POOL:
+            sPoolMgr.UpdatePool<Pool>(*GetPersistentState(), uint16(action.id), action.lowGuid);
+            break;
+        case MapDeferredAction::CREATURE_LINKING_EVENT:
+        {
+            // the source or the enemy may have left the map since
+            Creature* source = GetAnyTypeCreature(action.source);
+            if (!source)
+                break;
+
+            Unit* enemy = NULL;
+            if (!action.enemy.IsEmpty())
+            {
+                enemy = GetUnit(action.enemy);
+                if (!enemy)
+                    break;
+            }
+
+            m_creatureLinkingHolder.DoCreatureLinkingEvent(CreatureLinkingEvent(action.id), source, enemy);
+            break;
+        }
+        case MapDeferredAction::CREATURE_RESPAWN_TIME:
+            GetPersistentState()->SaveCreatureRespawnTime(action.lowGuid, action.time);
+            break;
+        case MapDeferredAction::GAMEOBJECT_RESPAWN_TIME:
+            GetPersistentState()->SaveGORespawnTime(action.lowGuid, action.time);
+            break;
+    }
+}
+
+void Map::Update(const uint32& t_diff)
+{
+    m_dyn_tree.update(t_diff);
+
+    /// update worldsessions for existing players
+    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+    {
+        Player* plr = m_mapRefIter->getSource();
+        if (plr && plr->IsInWorld())
+        {
+            WorldSession* pSession = plr->GetSession();
+            MapSessionFilter updater(pSession);
+
+            pSession->Update(updater);
+        }
+    }
+
+    /// update players at tick
+    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+    {
+        Player* plr = m_mapRefIter->getSource();
+        if (plr && plr->IsInWorld())
+        {
+            WorldObject::UpdateHelper helper(plr);
+            helper.Update(t_diff);
+        }
+    }
+
+    /// update active cells around players and active objects
+    UpdateActiveCells(t_diff);
 
     // Send world objects and item update field changes
     SendObjectUpdates();
@@ -634,6 +842,8 @@ template<class T>
 void
 Map::Remove(T* obj, bool remove)
 {
+    MapIslandGuard guard(this);
+
     CellPair p = MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY());
     if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
     {
@@ -713,6 +923,8 @@ Map::PlayerRelocation(Player* player, float x, float y, float z, float orientati
 
 void Map::CreatureRelocation(Creature* creature, float x, float y, float z, float ang)
 {
+    MapIslandGuard guard(this);
+
     MANGOS_ASSERT(CheckGridIntegrity(creature, false));
 
     Cell new_cell(MaNGOS::ComputeCellPair(x, y));
@@ -970,6 +1182,8 @@ inline void Map::setNGrid(NGridType* grid, uint32 x, uint32 y)
 
 void Map::AddObjectToRemoveList(WorldObject* obj)
 {
+    MapIslandGuard guard(this);
+
     MANGOS_ASSERT(obj->GetMapId() == GetId() && obj->GetInstanceId() == GetInstanceId());
 
     if (Creature* creature = obj->ToCreature())
@@ -1034,8 +1248,9 @@ uint32 Map::GetPlayersCountExceptGMs() const
 
 void Map::SendToPlayers(WorldPacket const* data) const
 {
+    SharedPacket packet(*data);
     for (MapRefManager::const_iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
-        itr->getSource()->GetSession()->SendPacket(data);
+        itr->getSource()->GetSession()->SendPacket(packet);
 }
 
 bool Map::ActiveObjectsNearGrid(uint32 x, uint32 y) const
@@ -1080,6 +1295,8 @@ bool Map::ActiveObjectsNearGrid(uint32 x, uint32 y) const
 
 void Map::AddToActive(WorldObject* obj)
 {
+    MapIslandGuard guard(this);
+
     m_activeNonPlayers.insert(obj);
     Cell cell = Cell(MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY()));
     EnsureGridLoaded(cell);
@@ -1108,16 +1325,9 @@ void Map::AddToActive(WorldObject* obj)
 
 void Map::RemoveFromActive(WorldObject* obj)
 {
-    // Map::Update for active object in proccess
-    if (m_activeNonPlayersIter != m_activeNonPlayers.end())
-    {
-        ActiveNonPlayers::iterator itr = m_activeNonPlayers.find(obj);
-        if (itr == m_activeNonPlayersIter)
-            ++m_activeNonPlayersIter;
-        m_activeNonPlayers.erase(itr);
-    }
-    else
-        m_activeNonPlayers.erase(obj);
+    MapIslandGuard guard(this);
+
+    m_activeNonPlayers.erase(obj);
 
     // also allow unloading spawn grid
     if (obj->GetTypeId() == TYPEID_UNIT)
@@ -1587,6 +1797,8 @@ bool Map::CanEnter(Player* player)
 /// Put scripts in the execution queue
 bool Map::ScriptsStart(ScriptMapMapName const& scripts, uint32 id, Object* source, Object* target, ScriptExecutionParam execParams /*=SCRIPT_EXEC_PARAM_UNIQUE_BY_SOURCE_TARGET*/)
 {
+    MapIslandGuard guard(this);
+
     MANGOS_ASSERT(source);
 
     ///- Find the script map
@@ -1629,6 +1841,8 @@ bool Map::ScriptsStart(ScriptMapMapName const& scripts, uint32 id, Object* sourc
 
 void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* source, Object* target)
 {
+    MapIslandGuard guard(this);
+
     // NOTE: script record _must_ exist until command executed
 
     // prepare static data
@@ -1705,6 +1919,7 @@ Player* Map::GetPlayer(ObjectGuid guid)
  */
 Creature* Map::GetCreature(ObjectGuid guid)
 {
+    MapIslandGuard guard(this);
     return m_objectsStore.find<Creature>(guid, (Creature*)NULL);
 }
 
@@ -1715,6 +1930,7 @@ Creature* Map::GetCreature(ObjectGuid guid)
  */
 Pet* Map::GetPet(ObjectGuid guid)
 {
+    MapIslandGuard guard(this);
     return m_objectsStore.find<Pet>(guid, (Pet*)NULL);
 }
 
@@ -1755,6 +1971,7 @@ Creature* Map::GetAnyTypeCreature(ObjectGuid guid)
  */
 GameObject* Map::GetGameObject(ObjectGuid guid)
 {
+    MapIslandGuard guard(this);
     return m_objectsStore.find<GameObject>(guid, (GameObject*)NULL);
 }
 
@@ -1765,6 +1982,7 @@ GameObject* Map::GetGameObject(ObjectGuid guid)
  */
 DynamicObject* Map::GetDynamicObject(ObjectGuid guid)
 {
+    MapIslandGuard guard(this);
     return m_objectsStore.find<DynamicObject>(guid, (DynamicObject*)NULL);
 }
 
@@ -1810,28 +2028,31 @@ WorldObject* Map::GetWorldObject(ObjectGuid guid)
     return NULL;
 }
 
-void Map::SendObjectUpdates()
+void Map::AddUpdateObject(Object* obj)
 {
-    UpdateDataMapType update_players;
+    MapIslandGuard guard(this);
+    i_objectUpdateQueue.Add(obj);
+}
 
-    while (!i_objectsToClientUpdate.empty())
-    {
-        Object* obj = *i_objectsToClientUpdate.begin();
-        i_objectsToClientUpdate.erase(i_objectsToClientUpdate.begin());
-        obj->BuildUpdateData(update_players);
-    }
+void Map::RemoveUpdateObject(Object* obj)
+{
+    MapIslandGuard guard(this);
+    i_objectUpdateQueue.Remove(obj);
+}
 
-    WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
-    for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
-    {
-        iter->second.BuildPacket(&packet);
-        iter->first->GetSession()->SendPacket(&packet);
-        packet.clear();                                     // clean the string
-    }
+void Map::SendObjectUpdates()
+{
+    i_objectUpdateQueue.Send();
+
+    if (sPerfStats.IsEnabled())
+        sPerfStats.AddObjectUpdateSample(i_objectUpdateQueue.GetLastObjectCount(), i_objectUpdateQueue.GetLastPacketCount(),
+                                         i_objectUpdateQueue.GetLastBufferGrowths());
 }
 
 uint32 Map::GenerateLocalLowGuid(HighGuid guidhigh)
 {
+    MapIslandGuard guard(this);
+
     // TODO: for map local guid counters possible force reload map instead shutdown server at guid counter overflow
     switch (guidhigh)
     {
@@ -1954,8 +2175,11 @@ void Map::PlayDirectSoundToMap(uint32 soundId, uint32 zoneId /*=0*/) const
  */
 bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
-           && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ);
+    if (!VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ))
+        return false;
+
+    MapDynTreeGuard guard(this, false);
+    return m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ);
 }
 
 /**
@@ -1975,6 +2199,7 @@ bool Map::GetHitPosition(float srcX, float srcY, float srcZ, float& destX, float
         destZ = tempZ;
     }
     // at second all dynamic objects, if static check has an hit, then we can calculate only to this closer point
+    MapDynTreeGuard guard(this, false);
     bool result1 = m_dyn_tree.getObjectHitPos(srcX, srcY, srcZ, destX, destY, destZ, tempX, tempY, tempZ, modifyDist);
     if (result1)
     {
@@ -1992,20 +2217,26 @@ float Map::GetHeight(float x, float y, float z) const
 
     // Get Dynamic Height around static Height (if valid)
     float dynSearchHeight = 2.0f + (z < staticHeight ? staticHeight : z);
+    MapDynTreeGuard guard(this, false);
     return std::max<float>(staticHeight, m_dyn_tree.getHeight(x, y, dynSearchHeight, dynSearchHeight - staticHeight));
 }
 
 void Map::InsertGameObjectModel(const GameObjectModel& mdl)
 {
+    MapDynTreeGuard guard(this, true);
+
     m_dyn_tree.insert(mdl);
 }
 
 void Map::RemoveGameObjectModel(const GameObjectModel& mdl)
 {
+    MapDynTreeGuard guard(this, true);
+
     m_dyn_tree.remove(mdl);
 }
 
 bool Map::ContainsGameObjectModel(const GameObjectModel& mdl) const
 {
+    MapDynTreeGuard guard(this, false);
     return m_dyn_tree.contains(mdl);
 }
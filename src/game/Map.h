@@ -24,11 +24,13 @@
 #include "Policies/ThreadingModel.h"
 #include "ace/RW_Thread_Mutex.h"
 #include "ace/Thread_Mutex.h"
+#include "ace/Recursive_Thread_Mutex.h"
 
 #include "DBCStructure.h"
 #include "GridDefines.h"
 #include "Cell.h"
 #include "Object.h"
+#include "ObjectUpdateQueue.h"
 #include "Timer.h"
 #include "SharedDefines.h"
 #include "GridMap.h"
@@ -41,6 +43,7 @@
 
 #include <bitset>
 #include <list>
+#include <vector>
 
 struct CreatureInfo;
 class Creature;
@@ -56,6 +59,7 @@ struct ScriptInfo;
 class BattleGround;
 class GridMap;
 class GameObjectModel;
+class Map;
 
 // GCC have alternative #pragma pack(N) syntax and old gcc version not support pack(push,N), also any gcc version not support it at some platform
 #if defined( __GNUC__ )
@@ -93,11 +97,49 @@ struct WorldTemplate
 
 #define MIN_UNLOAD_DELAY      1                             // immediate unload
 
+// Effect of an object update that may reach objects of other cell islands, it is queued while
+// the islands of a map are updated in parallel and applied by the map thread after all of them
+struct MapDeferredAction
+{
+    enum Type
+    {
+        POOL_UPDATE_CREATURE,                               // PoolManager::UpdatePool<Creature>
+        POOL_UPDATE_GAMEOBJECT,                             // PoolManager::UpdatePool<GameObject>
+        POOL_UPDATE_POOL,                                   // PoolManager::UpdatePool<Pool>
+        CREATURE_LINKING_EVENT,                             // CreatureLinkingHolder::DoCreatureLinkingEvent
+        CREATURE_RESPAWN_TIME,                              // MapPersistentState::SaveCreatureRespawnTime
+        GAMEOBJECT_RESPAWN_TIME,                            // MapPersistentState::SaveGORespawnTime
+    };
+
+    MapDeferredAction(Type _type, uint32 _id, uint32 _lowGuid, time_t _time = 0)
+        : type(_type), id(_id), lowGuid(_lowGuid), time(_time) {}
+
+    Type type;
+    uint32 id;                                              // pool id or linking event
+    uint32 lowGuid;                                         // db guid or pool id
+    time_t time;                                            // respawn time
+    ObjectGuid source;                                      // linking event source
+    ObjectGuid enemy;                                       // linking event enemy, may be empty
+};
+
+// Group of active cells of a continent that is far enough from all other groups that
+// objects in it can't see or reach objects of another group during one update
+struct MapCellIsland
+{
+    MapCellIsland() : map(NULL) {}
+
+    Map* map;
+    std::vector<uint32> cells;                              // cell ids in visit order
+    std::vector<MapDeferredAction> deferred;                // in the order the island queued them
+};
+
 class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 {
         friend class MapReference;
         friend class ObjectGridLoader;
         friend class ObjectWorldLoader;
+        friend class MapIslandGuard;
+        friend class MapDynTreeGuard;
 
     protected:
         Map(uint32 id, time_t, uint32 InstanceId);
@@ -122,6 +164,12 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
         static void DeleteFromWorld(Player* player);        // player object will deleted at call
 
         virtual void Update(const uint32&);
+        void UpdateCellIsland(MapCellIsland& island, uint32 diff);
+
+        // true while the cell islands of the map are updated by several threads
+        bool IsUpdatingIslands() const { return m_islandsUpdating; }
+        // queue an effect on other islands, only while IsUpdatingIslands()
+        void DeferIslandAction(MapDeferredAction const& action);
 
         void MessageBroadcast(Player const*, WorldPacket*, bool to_self);
         void MessageBroadcast(WorldObject const*, WorldPacket*);
@@ -231,15 +279,8 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
         typedef TypeUnorderedMapContainer<AllMapStoredObjectTypes, ObjectGuid> MapStoredObjectTypesContainer;
         MapStoredObjectTypesContainer& GetObjectsStore() { return m_objectsStore; }
 
-        void AddUpdateObject(Object* obj)
-        {
-            i_objectsToClientUpdate.insert(obj);
-        }
-
-        void RemoveUpdateObject(Object* obj)
-        {
-            i_objectsToClientUpdate.erase(obj);
-        }
+        void AddUpdateObject(Object* obj);
+        void RemoveUpdateObject(Object* obj);
 
         // DynObjects currently
         uint32 GenerateLocalLowGuid(HighGuid guidhigh);
@@ -303,8 +344,14 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
         void setNGrid(NGridType* grid, uint32 x, uint32 y);
         void ScriptsProcess();
 
+        void UpdateActiveCells(uint32 diff);
+        bool CanUpdateCellIslands() const;
+        void BuildCellIslands(std::vector<CellArea> const& areas, std::vector<MapCellIsland>& islands);
+        void ApplyDeferredIslandActions(std::vector<MapCellIsland>& islands);
+        void ApplyDeferredIslandAction(MapDeferredAction const& action);
+
         void SendObjectUpdates();
-        std::set<Object*> i_objectsToClientUpdate;
+        ObjectUpdateQueue i_objectUpdateQueue;
 
     protected:
         MapEntry const* i_mapEntry;
@@ -319,7 +366,6 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
         typedef std::set<WorldObject*> ActiveNonPlayers;
         ActiveNonPlayers m_activeNonPlayers;
-        ActiveNonPlayers::iterator m_activeNonPlayersIter;
         MapStoredObjectTypesContainer m_objectsStore;
 
     private:
@@ -359,6 +405,69 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
         // Dynamic Map tree object
         DynamicMapTree m_dyn_tree;
+
+        // protects map wide containers while cell islands are updated in parallel, see MapIslandGuard
+        mutable ACE_Recursive_Thread_Mutex m_islandLock;
+        bool m_islandsUpdating;
+
+        // deferred actions queued from outside of the islands of this map, guarded by m_islandLock
+        std::vector<MapDeferredAction> m_deferredActions;
+
+        // height and line of sight queries share the dynamic tree while cell islands are updated, see MapDynTreeGuard
+        mutable ACE_RW_Thread_Mutex m_dynTreeLock;
+};
+
+// Locks the map wide state (object store, update/remove lists, grids, scripts) only while
+// the cell islands of the map are updated by several threads, no-op otherwise
+class MapIslandGuard
+{
+    public:
+        explicit MapIslandGuard(Map const* map) : m_lock(map && map->m_islandsUpdating ? &map->m_islandLock : NULL)
+        {
+            if (m_lock)
+                m_lock->acquire();
+        }
+
+        ~MapIslandGuard()
+        {
+            if (m_lock)
+                m_lock->release();
+        }
+
+    private:
+        MapIslandGuard(MapIslandGuard const&);
+        MapIslandGuard& operator=(MapIslandGuard const&);
+
+        ACE_Recursive_Thread_Mutex* m_lock;
+};
+
+// Read or write lock of the dynamic tree of a map, only taken while its cell islands are updated,
+// so the frequent height and line of sight queries don't serialize on the map wide island lock
+class MapDynTreeGuard
+{
+    public:
+        MapDynTreeGuard(Map const* map, bool write) : m_lock(map->m_islandsUpdating ? &map->m_dynTreeLock : NULL)
+        {
+            if (!m_lock)
+                return;
+
+            if (write)
+                m_lock->acquire_write();
+            else
+                m_lock->acquire_read();
+        }
+
+        ~MapDynTreeGuard()
+        {
+            if (m_lock)
+                m_lock->release();
+        }
+
+    private:
+        MapDynTreeGuard(MapDynTreeGuard const&);
+        MapDynTreeGuard& operator=(MapDynTreeGuard const&);
+
+        ACE_RW_Thread_Mutex* m_lock;
 };
 
 class MANGOS_DLL_SPEC WorldMap : public Map
@@ -27,6 +27,7 @@
 #include "CellImpl.h"
 #include "Corpse.h"
 #include "ObjectMgr.h"
+#include "PerfStats.h"
 
 #define CLASS_LOCK MaNGOS::ClassLevelLockable<MapManager, ACE_Recursive_Thread_Mutex>
 INSTANTIATE_SINGLETON_2(MapManager, CLASS_LOCK);
@@ -40,6 +41,8 @@ MapManager::MapManager()
 
 MapManager::~MapManager()
 {
+    m_updater.Deactivate();
+
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         delete iter->second;
 
@@ -54,6 +57,12 @@ MapManager::Initialize()
 {
     InitStateMachine();
     InitMaxInstanceId();
+
+    if (uint32 numThreads = sWorld.getConfig(CONFIG_UINT32_MAP_UPDATE_THREADS))
+    {
+        if (m_updater.Activate(numThreads))
+            sLog.outString("Using %u threads for map updates", numThreads);
+    }
 }
 
 void MapManager::InitStateMachine()
@@ -174,8 +183,26 @@ void MapManager::Update(uint32 diff)
     if (!i_timer.Passed())
         return;
 
-    for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
-        iter->second->Update((uint32)i_timer.GetCurrent());
+    if (m_updater.IsActivated())
+    {
+        {
+            // maps created by the update threads are added at next tick
+            Guard _guard(*this);
+            for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+                m_updater.ScheduleUpdate(*iter->second, (uint32)i_timer.GetCurrent());
+        }
+
+        // all cross map work below must wait for the map threads
+        m_updater.Wait();
+    }
+    else
+    {
+        for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+        {
+            PerfMapTimer perfTimer(iter->second->GetId(), iter->second->GetInstanceId());
+            iter->second->Update((uint32)i_timer.GetCurrent());
+        }
+    }
 
     for (TransportSet::iterator iter = m_Transports.begin(); iter != m_Transports.end(); ++iter)
     {
@@ -228,6 +255,8 @@ bool MapManager::IsValidMAP(uint32 mapid)
 
 void MapManager::UnloadAll()
 {
+    m_updater.Deactivate();
+
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->UnloadAll(true);
 
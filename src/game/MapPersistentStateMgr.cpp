@@ -70,6 +70,13 @@ bool MapPersistentState::UnloadIfEmpty()
 
 void MapPersistentState::SaveCreatureRespawnTime(uint32 loguid, time_t t)
 {
+    // the respawn times are shared by all cell islands of the map, it saves them after its islands
+    if (m_usedByMap && m_usedByMap->IsUpdatingIslands())
+    {
+        m_usedByMap->DeferIslandAction(MapDeferredAction(MapDeferredAction::CREATURE_RESPAWN_TIME, 0, loguid, t));
+        return;
+    }
+
     SetCreatureRespawnTime(loguid, t);
 
     // BGs/Arenas always reset at server restart/unload, so no reason store in DB
@@ -95,6 +102,13 @@ void MapPersistentState::SaveCreatureRespawnTime(uint32 loguid, time_t t)
 
 void MapPersistentState::SaveGORespawnTime(uint32 loguid, time_t t)
 {
+    // the respawn times are shared by all cell islands of the map, it saves them after its islands
+    if (m_usedByMap && m_usedByMap->IsUpdatingIslands())
+    {
+        m_usedByMap->DeferIslandAction(MapDeferredAction(MapDeferredAction::GAMEOBJECT_RESPAWN_TIME, 0, loguid, t));
+        return;
+    }
+
     SetGORespawnTime(loguid, t);
 
     // BGs/Arenas always reset at server restart/unload, so no reason store in DB
@@ -456,8 +470,22 @@ void DungeonResetScheduler::LoadResetTimes()
     }
 }
 
+time_t DungeonResetScheduler::GetResetTimeFor(uint32 mapid)
+{
+    MapPersistentStateManager::Guard guard(m_InstanceSaves.m_lock);
+    return m_resetTimeByMapId[mapid];
+}
+
+void DungeonResetScheduler::SetResetTimeFor(uint32 mapid, time_t t)
+{
+    MapPersistentStateManager::Guard guard(m_InstanceSaves.m_lock);
+    m_resetTimeByMapId[mapid] = t;
+}
+
 void DungeonResetScheduler::ScheduleReset(bool add, time_t time, DungeonResetEvent event)
 {
+    MapPersistentStateManager::Guard guard(m_InstanceSaves.m_lock);
+
     if (add)
         m_resetTimeQueue.insert(std::pair<time_t, DungeonResetEvent>(time, event));
     else
@@ -494,6 +522,8 @@ void DungeonResetScheduler::ScheduleReset(bool add, time_t time, DungeonResetEve
 
 void DungeonResetScheduler::Update()
 {
+    MapPersistentStateManager::Guard guard(m_InstanceSaves.m_lock);
+
     time_t now = time(NULL), t;
     while (!m_resetTimeQueue.empty() && (t = m_resetTimeQueue.begin()->first) < now)
     {
@@ -564,6 +594,8 @@ MapPersistentStateManager::~MapPersistentStateManager()
 */
 MapPersistentState* MapPersistentStateManager::AddPersistentState(MapEntry const* mapEntry, uint32 instanceId, time_t resetTime, bool canReset, bool load /*=false*/, bool initPools /*= true*/)
 {
+    Guard guard(m_lock);
+
     if (MapPersistentState* old_save = GetPersistentState(mapEntry->MapID, instanceId))
         return old_save;
 
@@ -612,6 +644,8 @@ MapPersistentState* MapPersistentStateManager::AddPersistentState(MapEntry const
 
 MapPersistentState* MapPersistentStateManager::GetPersistentState(uint32 mapId, uint32 instanceId)
 {
+    Guard guard(m_lock);
+
     if (instanceId)
     {
         PersistentStateMap::iterator itr = m_instanceSaveByInstanceId.find(instanceId);
@@ -640,6 +674,8 @@ void MapPersistentStateManager::DeleteInstanceFromDB(uint32 instanceid)
 
 void MapPersistentStateManager::RemovePersistentState(uint32 mapId, uint32 instanceId)
 {
+    Guard guard(m_lock);
+
     if (lock_instLists)
         return;
 
@@ -875,6 +911,8 @@ void MapPersistentStateManager::GetStatistics(uint32& numStates, uint32& numBoun
     numBoundPlayers = 0;
     numBoundGroups = 0;
 
+    Guard guard(m_lock);
+
     // only instanceable maps have bounds
     for (PersistentStateMap::iterator itr = m_instanceSaveByInstanceId.begin(); itr != m_instanceSaveByInstanceId.end(); ++itr)
     {
@@ -23,6 +23,7 @@
 #include "Platform/Define.h"
 #include "Policies/Singleton.h"
 #include "ace/Thread_Mutex.h"
+#include "ace/Recursive_Thread_Mutex.h"
 #include <list>
 #include <map>
 #include "Utilities/UnorderedMapSet.h"
@@ -283,15 +284,12 @@ class DungeonResetScheduler
         void LoadResetTimes();
 
     public:                                                 // accessors
-        time_t GetResetTimeFor(uint32 mapid) { return m_resetTimeByMapId[mapid]; }
+        time_t GetResetTimeFor(uint32 mapid);
 
         static uint32 GetMaxResetTimeFor(InstanceTemplate const* temp);
         static time_t CalculateNextResetTime(InstanceTemplate const* temp, time_t prevResetTime);
     public:                                                 // modifiers
-        void SetResetTimeFor(uint32 mapid, time_t t)
-        {
-            m_resetTimeByMapId[mapid] = t;
-        }
+        void SetResetTimeFor(uint32 mapid, time_t t);
 
         void ScheduleReset(bool add, time_t time, DungeonResetEvent event);
 
@@ -347,6 +345,8 @@ class MANGOS_DLL_DECL MapPersistentStateManager : public MaNGOS::Singleton<MapPe
         void Update() { m_Scheduler.Update(); }
     private:
         typedef UNORDERED_MAP < uint32 /*InstanceId or MapId*/, MapPersistentState* > PersistentStateMap;
+        typedef ACE_Recursive_Thread_Mutex LockType;
+        typedef ACE_Guard<LockType> Guard;
 
         //  called by scheduler for DungeonPersistentStates
         void _ResetOrWarnAll(uint32 mapid, bool warn, uint32 timeleft);
@@ -364,6 +364,9 @@ class MANGOS_DLL_DECL MapPersistentStateManager : public MaNGOS::Singleton<MapPe
         PersistentStateMap m_instanceSaveByMapId;
 
         DungeonResetScheduler m_Scheduler;
+
+        // guards the state lists and the scheduler, maps updated in parallel create, unload and reschedule states
+        LockType m_lock;
 };
 
 template<typename Do>
@@ -373,6 +376,8 @@ inline void MapPersistentStateManager::DoForAllStatesWithMapId(uint32 mapId, Do&
     if (!mapEntry)
         return;
 
+    Guard guard(m_lock);
+
     if (mapEntry->Instanceable())
     {
         for (PersistentStateMap::iterator itr = m_instanceSaveByInstanceId.begin(); itr != m_instanceSaveByInstanceId.end();)
@@ -0,0 +1,173 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MapUpdater.h"
+#include "Map.h"
+#include "Log.h"
+#include "PerfStats.h"
+
+MapUpdater::MapUpdater()
+    : m_requestCondition(m_lock), m_finishedCondition(m_lock),
+      m_pendingRequests(0), m_activated(false), m_stopping(false)
+{
+}
+
+MapUpdater::~MapUpdater()
+{
+    Deactivate();
+}
+
+bool MapUpdater::Activate(uint32 numThreads)
+{
+    if (m_activated || !numThreads)
+        return false;
+
+    m_stopping = false;
+
+    if (activate(THR_NEW_LWP | THR_JOINABLE, int(numThreads)) == -1)
+    {
+        sLog.outError("MapUpdater: can't spawn %u map update threads", numThreads);
+        return false;
+    }
+
+    m_activated = true;
+    return true;
+}
+
+void MapUpdater::Deactivate()
+{
+    if (!m_activated)
+        return;
+
+    Wait();
+
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+        m_stopping = true;
+        m_requestCondition.broadcast();
+    }
+
+    // join all worker threads
+    wait();
+
+    m_activated = false;
+}
+
+void MapUpdater::ScheduleUpdate(Map& map, uint32 diff)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    m_requests.push_back(MapUpdateRequest(&map, diff));
+    ++m_pendingRequests;
+    m_requestCondition.signal();
+}
+
+void MapUpdater::Wait()
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    while (m_pendingRequests > 0)
+        m_finishedCondition.wait();
+}
+
+void MapUpdater::ScheduleIslandUpdate(Map& map, MapCellIsland& island, uint32 diff, MapUpdateBatch& batch)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    m_requests.push_back(MapUpdateRequest(&map, diff, &island, &batch));
+    ++batch.m_pendingRequests;
+    m_requestCondition.signal();
+}
+
+void MapUpdater::WaitBatch(MapUpdateBatch& batch)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    while (batch.m_pendingRequests > 0)
+    {
+        // steal a queued request of our own batch instead of idling, this also
+        // prevents a deadlock when all workers wait for their batches
+        RequestQueue::iterator itr = m_requests.begin();
+        for (; itr != m_requests.end(); ++itr)
+            if (itr->m_batch == &batch)
+                break;
+
+        if (itr == m_requests.end())
+        {
+            m_finishedCondition.wait();
+            continue;
+        }
+
+        MapUpdateRequest request = *itr;
+        m_requests.erase(itr);
+
+        m_lock.release();
+        request.Execute();
+        m_lock.acquire();
+
+        FinishRequest(request);
+    }
+}
+
+void MapUpdater::MapUpdateRequest::Execute() const
+{
+    if (m_island)
+        m_map->UpdateCellIsland(*m_island, m_diff);
+    else
+    {
+        PerfMapTimer perfTimer(m_map->GetId(), m_map->GetInstanceId());
+        m_map->Update(m_diff);
+    }
+}
+
+void MapUpdater::FinishRequest(MapUpdateRequest const& request)
+{
+    uint32& pending = request.m_batch ? request.m_batch->m_pendingRequests : m_pendingRequests;
+    if (--pending == 0)
+        m_finishedCondition.broadcast();
+}
+
+int MapUpdater::svc()
+{
+    for (;;)
+    {
+        MapUpdateRequest request(NULL, 0);
+
+        {
+            ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+            while (m_requests.empty() && !m_stopping)
+                m_requestCondition.wait();
+
+            if (m_requests.empty())
+                break;                                      // stopping and nothing left to do
+
+            request = m_requests.front();
+            m_requests.pop_front();
+        }
+
+        request.Execute();
+
+        {
+            ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+            FinishRequest(request);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPUPDATER_H
+#define MANGOS_MAPUPDATER_H
+
+#include "Common.h"
+#include <ace/Task.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+#include <deque>
+
+class Map;
+struct MapCellIsland;
+
+/// Requests scheduled together, a thread waiting for a batch executes its queued requests itself
+struct MapUpdateBatch
+{
+    MapUpdateBatch() : m_pendingRequests(0) {}
+
+    uint32 m_pendingRequests;                               // guarded by the MapUpdater lock
+};
+
+/**
+ * Thread pool used by MapManager::Update to update independent maps at the same time.
+ *
+ * Rules for code that runs inside Map::Update when the pool is active (MapUpdate.Threads > 0):
+ *  - only the map being updated, its grids and the objects in it may be modified
+ *  - packets are processed through MapSessionFilter, PROCESS_THREADUNSAFE handlers stay in World::UpdateSessions
+ *  - ObjectAccessor and TerrainManager are internally locked and may be used
+ *  - MapPersistentStateManager guards its state lists and reset scheduler, a returned state belongs to its map
+ *  - global guid/id generators (ObjectGuidGenerator, IdGenerator) are atomic and may be used
+ *  - Eluna hooks are serialized by Eluna::lock, Lua scripts never run in parallel
+ *  - static ObjectMgr/SpellMgr stores are read only after startup
+ *  - everything else (World, BattleGroundMgr, OutdoorPvPMgr, GameEventMgr, guilds, groups...) must only be touched
+ *    from the world thread, after MapUpdater::Wait() returned
+ *
+ * With MapUpdate.CellIslands a continent additionally splits its active cells into islands (see Map::BuildCellIslands)
+ * and schedules them as one batch. Map wide containers touched from object updates must then be protected by
+ * MapIslandGuard, effects that may reach other islands (pools, creature linking, respawn times) are queued with
+ * Map::DeferIslandAction and applied by the map thread after the batch. Maps with a world script and servers
+ * with Lua scripts are not split, those scripts may reach any object of the map.
+ */
+class MapUpdater : protected ACE_Task_Base
+{
+    public:
+        MapUpdater();
+        virtual ~MapUpdater();
+
+        /// Start numThreads worker threads, returns false if the threads could not be spawned
+        bool Activate(uint32 numThreads);
+        /// Stop all worker threads, pending requests are finished first
+        void Deactivate();
+        bool IsActivated() const { return m_activated; }
+
+        /// Queue a map for update in the worker threads
+        void ScheduleUpdate(Map& map, uint32 diff);
+        /// Block until all scheduled map updates are finished
+        void Wait();
+
+        /// Queue a cell island of a map, may be called from a worker thread
+        void ScheduleIslandUpdate(Map& map, MapCellIsland& island, uint32 diff, MapUpdateBatch& batch);
+        /// Execute or wait for all requests of the batch, safe to call from a worker thread
+        void WaitBatch(MapUpdateBatch& batch);
+
+    protected:
+        int svc() override;
+
+    private:
+        struct MapUpdateRequest
+        {
+            MapUpdateRequest(Map* map, uint32 diff, MapCellIsland* island = NULL, MapUpdateBatch* batch = NULL)
+                : m_map(map), m_diff(diff), m_island(island), m_batch(batch) {}
+
+            void Execute() const;
+
+            Map* m_map;
+            uint32 m_diff;
+            MapCellIsland* m_island;                        // NULL for full map update
+            MapUpdateBatch* m_batch;                        // NULL for requests counted in m_pendingRequests
+        };
+
+        typedef std::deque<MapUpdateRequest> RequestQueue;
+
+        // must be called with m_lock held
+        void FinishRequest(MapUpdateRequest const& request);
+
+        ACE_Thread_Mutex m_lock;
+        ACE_Condition_Thread_Mutex m_requestCondition;      // signaled when a request is queued or workers must stop
+        ACE_Condition_Thread_Mutex m_finishedCondition;     // signaled when the last pending request of a batch is done
+
+        RequestQueue m_requests;
+        uint32 m_pendingRequests;                           // queued + currently executing full map updates
+        bool m_activated;
+        bool m_stopping;
+};
+
+#endif
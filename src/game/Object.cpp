@@ -44,6 +44,48 @@
 #include "CreatureLinkingMgr.h"
 #include "Chat.h"
 #include "LuaEngine.h"
+#include "ObjectUpdateQueue.h"
+#include <ace/TSS_T.h>
+
+#define MAX_CACHED_RECEIVER_CLASSES 8
+
+/// Values update blocks of the object processed by WorldObject::BuildUpdateData, built once per receiver class
+class ValuesUpdateBlockCache
+{
+    public:
+        ValuesUpdateBlockCache() : m_object(NULL), m_size(0) {}
+
+        void Start(Object const* obj) { m_object = obj; m_size = 0; }
+        Object const* GetObject() const { return m_object; }
+
+        ByteBuffer const* Find(uint32 receiverClass) const
+        {
+            for (uint32 i = 0; i < m_size; ++i)
+                if (m_classes[i] == receiverClass)
+                    return &m_blocks[i];
+            return NULL;
+        }
+
+        /// Empty buffer for a new class, NULL if the cache is full
+        ByteBuffer* Add(uint32 receiverClass)
+        {
+            if (m_size >= MAX_CACHED_RECEIVER_CLASSES)
+                return NULL;
+
+            m_classes[m_size] = receiverClass;
+            m_blocks[m_size].clear();
+            return &m_blocks[m_size++];
+        }
+
+    private:
+        Object const* m_object;
+        uint32 m_classes[MAX_CACHED_RECEIVER_CLASSES];
+        ByteBuffer m_blocks[MAX_CACHED_RECEIVER_CLASSES];   // memory is kept for the next objects
+        uint32 m_size;
+};
+
+// object updates of different maps are built at the same time
+static ACE_TSS<ValuesUpdateBlockCache> valuesUpdateBlockCache;
 
 Object::Object()
 {
@@ -55,6 +97,7 @@ Object::Object()
 
     m_inWorld           = false;
     m_objectUpdated     = false;
+    m_updateQueueIndex  = 0;
 }
 
 Object::~Object()
@@ -82,7 +125,7 @@ void Object::_InitValues()
     m_uint32Values = new uint32[ m_valuesCount ];
     memset(m_uint32Values, 0, m_valuesCount * sizeof(uint32));
 
-    m_changedValues.resize(m_valuesCount, false);
+    m_changedValues.SetCount(m_valuesCount);
 
     m_objectUpdated = false;
 }
@@ -108,18 +151,18 @@ void Object::SendForcedObjectUpdate()
     if (!m_inWorld || !m_objectUpdated)
         return;
 
-    UpdateDataMapType update_players;
+    // receivers' update buffers are not owned by a single cell island
+    MapIslandGuard guard(isType(TYPEMASK_WORLDOBJECT) ? ((WorldObject*)this)->GetMap() : NULL);
 
-    BuildUpdateData(update_players);
+    UpdatePlayerList update_players;
+
+    // removed first, items know their queue only until they are built
     RemoveFromClientUpdateList();
+    BuildUpdateData(update_players);
 
-    WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
-    for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
-    {
-        iter->second.BuildPacket(&packet);
-        iter->first->GetSession()->SendPacket(&packet);
-        packet.clear();                                     // clean the string
-    }
+    WorldPacket packet;
+    ByteBuffer buffer(0);
+    ObjectUpdateQueue::SendPlayerUpdates(update_players, packet, buffer);
 }
 
 void Object::BuildMovementUpdateBlock(UpdateData* data, uint8 flags) const
@@ -206,17 +249,58 @@ void Object::SendCreateUpdateToPlayer(Player* player)
 void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const
 {
     ByteBuffer buf(500);
+    BuildValuesUpdateBlock(&buf, target);
+    data->AddUpdateBlock(buf);
+}
 
-    buf << uint8(UPDATETYPE_VALUES);
-    buf << GetPackGUID();
+void Object::BuildValuesUpdateBlock(ByteBuffer* data, Player* target) const
+{
+    *data << uint8(UPDATETYPE_VALUES);
+    *data << GetPackGUID();
 
     UpdateMask updateMask;
     updateMask.SetCount(m_valuesCount);
 
     _SetUpdateBits(&updateMask, target);
-    BuildValuesUpdate(UPDATETYPE_VALUES, &buf, &updateMask, target);
+    BuildValuesUpdate(UPDATETYPE_VALUES, data, &updateMask, target);
+}
 
-    data->AddUpdateBlock(buf);
+// must match the target dependent cases of _SetUpdateBits and BuildValuesUpdate
+uint32 Object::GetValuesUpdateReceiverClass(Player* target) const
+{
+    uint32 receiverClass = 0;
+
+    if (target == this)
+        receiverClass |= VALUES_RECEIVER_SELF;
+
+    if (isType(TYPEMASK_UNIT))
+    {
+        // only changed fields are sent, other target checks don't make a difference
+        if (m_changedValues.GetBit(UNIT_FIELD_FLAGS) && target->isGameMaster())
+            receiverClass |= VALUES_RECEIVER_GM;
+
+        if (GetTypeId() == TYPEID_UNIT)
+        {
+            if (m_changedValues.GetBit(UNIT_NPC_FLAGS))
+            {
+                uint32 npcFlags = m_uint32Values[UNIT_NPC_FLAGS];
+                if ((npcFlags & UNIT_NPC_FLAG_TRAINER) && ((Creature*)this)->IsTrainerOf(target, false))
+                    receiverClass |= VALUES_RECEIVER_TRAINER;
+                if ((npcFlags & UNIT_NPC_FLAG_STABLEMASTER) && target->getClass() == CLASS_HUNTER)
+                    receiverClass |= VALUES_RECEIVER_STABLE;
+            }
+
+            if (m_changedValues.GetBit(UNIT_DYNAMIC_FLAGS) && target->isAllowedToLoot((Creature*)this))
+                receiverClass |= VALUES_RECEIVER_LOOTER;
+        }
+    }
+    else if (isType(TYPEMASK_GAMEOBJECT) && !((GameObject*)this)->IsTransport())
+    {
+        if (((GameObject*)this)->ActivateToQuest(target) || target->isGameMaster())
+            receiverClass |= VALUES_RECEIVER_QUEST_ACTIVE;
+    }
+
+    return receiverClass;
 }
 
 void Object::BuildOutOfRangeUpdateBlock(UpdateData* data) const
@@ -373,122 +457,109 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
     // 2 specialized loops for speed optimization in non-unit case
     if (isType(TYPEMASK_UNIT))                              // unit (creature/player) case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint32 index = updateMask->FindFirstSetBit(); index < m_valuesCount; index = updateMask->FindNextSetBit(index + 1))
         {
-            if (updateMask->GetBit(index))
+            if (index == UNIT_NPC_FLAGS)
             {
-                if (index == UNIT_NPC_FLAGS)
-                {
-                    uint32 appendValue = m_uint32Values[index];
+                uint32 appendValue = m_uint32Values[index];
 
-                    if (GetTypeId() == TYPEID_UNIT)
+                if (GetTypeId() == TYPEID_UNIT)
+                {
+                    if (appendValue & UNIT_NPC_FLAG_TRAINER)
                     {
-                        if (appendValue & UNIT_NPC_FLAG_TRAINER)
-                        {
-                            if (!((Creature*)this)->IsTrainerOf(target, false))
-                                appendValue &= ~UNIT_NPC_FLAG_TRAINER;
-                        }
-
-                        if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
-                        {
-                            if (target->getClass() != CLASS_HUNTER)
-                                appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
-                        }
+                        if (!((Creature*)this)->IsTrainerOf(target, false))
+                            appendValue &= ~UNIT_NPC_FLAG_TRAINER;
                     }
 
-                    *data << uint32(appendValue);
-                }
-                // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
-                else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
-                {
-                    // convert from float to uint32 and send
-                    *data << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
+                    if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
+                    {
+                        if (target->getClass() != CLASS_HUNTER)
+                            appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
+                    }
                 }
 
-                // there are some float values which may be negative or can't get negative due to other checks
-                else if ((index >= PLAYER_FIELD_NEGSTAT0    && index <= PLAYER_FIELD_NEGSTAT4) ||
-                         (index >= PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
-                         (index >= PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
-                         (index >= PLAYER_FIELD_POSSTAT0    && index <= PLAYER_FIELD_POSSTAT4))
-                {
-                    *data << uint32(m_floatValues[index]);
-                }
+                *data << uint32(appendValue);
+            }
+            // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
+            else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
+            {
+                // convert from float to uint32 and send
+                *data << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
+            }
 
-                // Gamemasters should be always able to select units - remove not selectable flag
-                else if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
-                {
-                    *data << (m_uint32Values[index] & ~UNIT_FLAG_NOT_SELECTABLE);
-                }
-                // hide lootable animation for unallowed players
-                else if (index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_UNIT)
-                {
-                    if (!target->isAllowedToLoot((Creature*)this))
-                        *data << (m_uint32Values[index] & ~UNIT_DYNFLAG_LOOTABLE);
-                    else
-                        *data << (m_uint32Values[index] & ~UNIT_DYNFLAG_TAPPED);
-                }
+            // there are some float values which may be negative or can't get negative due to other checks
+            else if ((index >= PLAYER_FIELD_NEGSTAT0    && index <= PLAYER_FIELD_NEGSTAT4) ||
+                     (index >= PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
+                     (index >= PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
+                     (index >= PLAYER_FIELD_POSSTAT0    && index <= PLAYER_FIELD_POSSTAT4))
+            {
+                *data << uint32(m_floatValues[index]);
+            }
+
+            // Gamemasters should be always able to select units - remove not selectable flag
+            else if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
+            {
+                *data << (m_uint32Values[index] & ~UNIT_FLAG_NOT_SELECTABLE);
+            }
+            // hide lootable animation for unallowed players
+            else if (index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_UNIT)
+            {
+                if (!target->isAllowedToLoot((Creature*)this))
+                    *data << (m_uint32Values[index] & ~UNIT_DYNFLAG_LOOTABLE);
                 else
-                {
-                    // send in current format (float as float, uint32 as uint32)
-                    *data << m_uint32Values[index];
-                }
+                    *data << (m_uint32Values[index] & ~UNIT_DYNFLAG_TAPPED);
+            }
+            else
+            {
+                // send in current format (float as float, uint32 as uint32)
+                *data << m_uint32Values[index];
             }
         }
     }
     else if (isType(TYPEMASK_GAMEOBJECT))                   // gameobject case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint32 index = updateMask->FindFirstSetBit(); index < m_valuesCount; index = updateMask->FindNextSetBit(index + 1))
         {
-            if (updateMask->GetBit(index))
+            // send in current format (float as float, uint32 as uint32)
+            if (index == GAMEOBJECT_DYN_FLAGS)
             {
-                // send in current format (float as float, uint32 as uint32)
-                if (index == GAMEOBJECT_DYN_FLAGS)
+                if (IsActivateToQuest)
                 {
-                    if (IsActivateToQuest)
+                    switch (((GameObject*)this)->GetGoType())
                     {
-                        switch (((GameObject*)this)->GetGoType())
-                        {
-                            case GAMEOBJECT_TYPE_QUESTGIVER:
-                            case GAMEOBJECT_TYPE_CHEST:
-                            case GAMEOBJECT_TYPE_GENERIC:
-                            case GAMEOBJECT_TYPE_SPELL_FOCUS:
-                            case GAMEOBJECT_TYPE_GOOBER:
-                                *data << uint16(GO_DYNFLAG_LO_ACTIVATE);
-                                *data << uint16(0);
-                                break;
-                            default:
-                                *data << uint32(0);         // unknown, not happen.
-                                break;
-                        }
+                        case GAMEOBJECT_TYPE_QUESTGIVER:
+                        case GAMEOBJECT_TYPE_CHEST:
+                        case GAMEOBJECT_TYPE_GENERIC:
+                        case GAMEOBJECT_TYPE_SPELL_FOCUS:
+                        case GAMEOBJECT_TYPE_GOOBER:
+                            *data << uint16(GO_DYNFLAG_LO_ACTIVATE);
+                            *data << uint16(0);
+                            break;
+                        default:
+                            *data << uint32(0);         // unknown, not happen.
+                            break;
                     }
-                    else
-                        *data << uint32(0);                 // disable quest object
                 }
                 else
-                    *data << m_uint32Values[index];         // other cases
+                    *data << uint32(0);                 // disable quest object
             }
+            else
+                *data << m_uint32Values[index];         // other cases
         }
     }
     else                                                    // other objects case (no special index checks)
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint32 index = updateMask->FindFirstSetBit(); index < m_valuesCount; index = updateMask->FindNextSetBit(index + 1))
         {
-            if (updateMask->GetBit(index))
-            {
-                // send in current format (float as float, uint32 as uint32)
-                *data << m_uint32Values[index];
-            }
+            // send in current format (float as float, uint32 as uint32)
+            *data << m_uint32Values[index];
         }
     }
 }
 
 void Object::ClearUpdateMask(bool remove)
 {
-    if (m_uint32Values)
-    {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
-            m_changedValues[index] = false;
-    }
+    m_changedValues.Clear();
 
     if (m_objectUpdated)
     {
@@ -519,9 +590,7 @@ bool Object::LoadValues(const char* data)
 
 void Object::_SetUpdateBits(UpdateMask* updateMask, Player* /*target*/) const
 {
-    for (uint16 index = 0; index < m_valuesCount; ++index)
-        if (m_changedValues[index])
-            updateMask->SetBit(index);
+    *updateMask |= m_changedValues;
 }
 
 void Object::_SetCreateBits(UpdateMask* updateMask, Player* /*target*/) const
@@ -538,7 +607,7 @@ void Object::SetInt32Value(uint16 index, int32 value)
     if (m_int32Values[index] != value)
     {
         m_int32Values[index] = value;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -550,7 +619,7 @@ void Object::SetUInt32Value(uint16 index, uint32 value)
     if (m_uint32Values[index] != value)
     {
         m_uint32Values[index] = value;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -560,7 +629,7 @@ void Object::UpdateUInt32Value(uint16 index, uint32 value)
     MANGOS_ASSERT(index < m_valuesCount || PrintIndexError(index, true));
 
     m_uint32Values[index] = value;
-    m_changedValues[index] = true;
+    m_changedValues.SetBit(index);
 }
 
 void Object::SetUInt64Value(uint16 index, const uint64& value)
@@ -570,8 +639,8 @@ void Object::SetUInt64Value(uint16 index, const uint64& value)
     {
         m_uint32Values[index] = *((uint32*)&value);
         m_uint32Values[index + 1] = *(((uint32*)&value) + 1);
-        m_changedValues[index] = true;
-        m_changedValues[index + 1] = true;
+        m_changedValues.SetBit(index);
+        m_changedValues.SetBit(index + 1);
         MarkForClientUpdate();
     }
 }
@@ -583,7 +652,7 @@ void Object::SetFloatValue(uint16 index, float value)
     if (m_floatValues[index] != value)
     {
         m_floatValues[index] = value;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -602,7 +671,7 @@ void Object::SetByteValue(uint16 index, uint8 offset, uint8 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFF) << (offset * 8));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 8));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -621,7 +690,7 @@ void Object::SetUInt16Value(uint16 index, uint8 offset, uint16 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFFFF) << (offset * 16));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 16));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -683,7 +752,7 @@ void Object::SetFlag(uint16 index, uint32 newFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -697,7 +766,7 @@ void Object::RemoveFlag(uint16 index, uint32 oldFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -715,7 +784,7 @@ void Object::SetByteFlag(uint16 index, uint8 offset, uint8 newFlag)
     if (!(uint8(m_uint32Values[index] >> (offset * 8)) & newFlag))
     {
         m_uint32Values[index] |= uint32(uint32(newFlag) << (offset * 8));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -733,7 +802,7 @@ void Object::RemoveByteFlag(uint16 index, uint8 offset, uint8 oldFlag)
     if (uint8(m_uint32Values[index] >> (offset * 8)) & oldFlag)
     {
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (offset * 8));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -745,7 +814,7 @@ void Object::SetShortFlag(uint16 index, bool highpart, uint16 newFlag)
     if (!(uint16(m_uint32Values[index] >> (highpart ? 16 : 0)) & newFlag))
     {
         m_uint32Values[index] |= uint32(uint32(newFlag) << (highpart ? 16 : 0));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -757,7 +826,7 @@ void Object::RemoveShortFlag(uint16 index, bool highpart, uint16 oldFlag)
     if (uint16(m_uint32Values[index] >> (highpart ? 16 : 0)) & oldFlag)
     {
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (highpart ? 16 : 0));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -779,18 +848,32 @@ bool Object::PrintEntryError(char const* descr) const
 }
 
 
-void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players)
+void Object::BuildUpdateDataForPlayer(Player* pl, UpdatePlayerList& update_players)
 {
-    UpdateDataMapType::iterator iter = update_players.find(pl);
+    UpdateData& data = pl->GetClientUpdateData();
+
+    // player's buffer is empty until it is added to the list
+    bool listed = data.HasData();
 
-    if (iter == update_players.end())
+    ValuesUpdateBlockCache* cache = valuesUpdateBlockCache;
+    if (cache->GetObject() == this)
     {
-        std::pair<UpdateDataMapType::iterator, bool> p = update_players.insert(UpdateDataMapType::value_type(pl, UpdateData()));
-        MANGOS_ASSERT(p.second);
-        iter = p.first;
+        uint32 receiverClass = GetValuesUpdateReceiverClass(pl);
+        if (ByteBuffer const* block = cache->Find(receiverClass))
+            data.AddUpdateBlock(*block);
+        else if (ByteBuffer* newBlock = cache->Add(receiverClass))
+        {
+            BuildValuesUpdateBlock(newBlock, pl);
+            data.AddUpdateBlock(*newBlock);
+        }
+        else
+            BuildValuesUpdateBlockForPlayer(&data, pl);
     }
+    else
+        BuildValuesUpdateBlockForPlayer(&data, pl);
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    if (!listed && data.HasData())
+        update_players.push_back(pl);
 }
 
 void Object::AddToClientUpdateList()
@@ -805,7 +888,7 @@ void Object::RemoveFromClientUpdateList()
     MANGOS_ASSERT(false);
 }
 
-void Object::BuildUpdateData(UpdateDataMapType& /*update_players */)
+void Object::BuildUpdateData(UpdatePlayerList& /*update_players */)
 {
     sLog.outError("Unexpected call of Object::BuildUpdateData for object (TypeId: %u Update fields: %u)", GetTypeId(), m_valuesCount);
     MANGOS_ASSERT(false);
@@ -1818,9 +1901,9 @@ void WorldObject::RemoveFromClientUpdateList()
 
 struct WorldObjectChangeAccumulator
 {
-    UpdateDataMapType& i_updateDatas;
+    UpdatePlayerList& i_updateDatas;
     WorldObject& i_object;
-    WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d) : i_updateDatas(d), i_object(obj)
+    WorldObjectChangeAccumulator(WorldObject& obj, UpdatePlayerList& d) : i_updateDatas(d), i_object(obj)
     {
         // send self fields changes in another way, otherwise
         // with new camera system when player's camera too far from player, camera wouldn't receive packets and changes from player
@@ -1841,10 +1924,18 @@ struct WorldObjectChangeAccumulator
     template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
 };
 
-void WorldObject::BuildUpdateData(UpdateDataMapType& update_players)
+void WorldObject::BuildUpdateData(UpdatePlayerList& update_players)
 {
-    WorldObjectChangeAccumulator notifier(*this, update_players);
-    Cell::VisitWorldObjects(this, notifier, GetMap()->GetVisibilityDistance());
+    // observers share the blocks while the changed fields are known
+    ValuesUpdateBlockCache* cache = valuesUpdateBlockCache;
+    cache->Start(this);
+
+    {
+        WorldObjectChangeAccumulator notifier(*this, update_players);
+        Cell::VisitWorldObjects(this, notifier, GetMap()->GetVisibilityDistance());
+    }
+
+    cache->Start(NULL);
 
     ClearUpdateMask(false);
 }
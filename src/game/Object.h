@@ -23,11 +23,13 @@
 #include "ByteBuffer.h"
 #include "UpdateFields.h"
 #include "UpdateData.h"
+#include "UpdateMask.h"
 #include "ObjectGuid.h"
 #include "Camera.h"
 
 #include <set>
 #include <string>
+#include <vector>
 
 #define CONTACT_DISTANCE            0.5f
 #define INTERACTION_DISTANCE        5.0f
@@ -67,12 +69,22 @@ class Player;
 class Unit;
 class Group;
 class Map;
-class UpdateMask;
 class InstanceData;
 class TerrainInfo;
 struct MangosStringLocale;
 
-typedef UNORDERED_MAP<Player*, UpdateData> UpdateDataMapType;
+// Target dependent parts of a values update block, changed fields are sent differently to receivers with these flags
+enum ValuesUpdateReceiverFlags
+{
+    VALUES_RECEIVER_SELF            = 0x01,                 // player receives own fields, not filtered by visibility
+    VALUES_RECEIVER_GM              = 0x02,                 // UNIT_FIELD_FLAGS without UNIT_FLAG_NOT_SELECTABLE
+    VALUES_RECEIVER_TRAINER         = 0x04,                 // UNIT_NPC_FLAGS with UNIT_NPC_FLAG_TRAINER
+    VALUES_RECEIVER_STABLE          = 0x08,                 // UNIT_NPC_FLAGS with UNIT_NPC_FLAG_STABLEMASTER
+    VALUES_RECEIVER_LOOTER          = 0x10,                 // UNIT_DYNAMIC_FLAGS with UNIT_DYNFLAG_LOOTABLE
+    VALUES_RECEIVER_QUEST_ACTIVE    = 0x20,                 // GAMEOBJECT_DYN_FLAGS with GO_DYNFLAG_LO_ACTIVATE
+};
+
+typedef std::vector<Player*> UpdatePlayerList;          // receivers of update blocks, see Player::GetClientUpdateData
 
 struct Position
 {
@@ -163,7 +175,7 @@ class MANGOS_DLL_SPEC Object
         // must be overwrite in appropriate subclasses (WorldObject, Item currently), or will crash
         virtual void AddToClientUpdateList();
         virtual void RemoveFromClientUpdateList();
-        virtual void BuildUpdateData(UpdateDataMapType& update_players);
+        virtual void BuildUpdateData(UpdatePlayerList& update_players);
         void MarkForClientUpdate();
         void SendForcedObjectUpdate();
 
@@ -388,7 +400,10 @@ class MANGOS_DLL_SPEC Object
 
         void BuildMovementUpdate(ByteBuffer* data, uint8 updateFlags) const;
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const;
-        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players);
+        void BuildValuesUpdateBlock(ByteBuffer* data, Player* target) const;
+        /// Receivers of the same class get byte identical values update blocks, see ValuesUpdateReceiverFlags
+        uint32 GetValuesUpdateReceiverClass(Player* target) const;
+        void BuildUpdateDataForPlayer(Player* pl, UpdatePlayerList& update_players);
 
         uint16 m_objectType;
 
@@ -402,14 +417,17 @@ class MANGOS_DLL_SPEC Object
             float*  m_floatValues;
         };
 
-        std::vector<bool> m_changedValues;
+        UpdateMask m_changedValues;
 
         uint16 m_valuesCount;
 
         bool m_objectUpdated;
 
     private:
+        friend class ObjectUpdateQueue;
+
         bool m_inWorld;
+        uint32 m_updateQueueIndex;                          // position in the ObjectUpdateQueue of the map while queued
 
         PackedGuid m_PackGUID;
 
@@ -614,7 +632,7 @@ class MANGOS_DLL_SPEC WorldObject : public Object
 
         void AddToClientUpdateList() override;
         void RemoveFromClientUpdateList() override;
-        void BuildUpdateData(UpdateDataMapType&) override;
+        void BuildUpdateData(UpdatePlayerList&) override;
 
         Creature* SummonCreature(uint32 id, float x, float y, float z, float ang, TempSummonType spwtype, uint32 despwtime, bool asActiveObject = false);
         GameObject* SummonGameObject(uint32 id, float x, float y, float z, float angle, uint32 despwtime);
@@ -22,6 +22,8 @@
 #include "Common.h"
 #include "ByteBuffer.h"
 
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
 #include <functional>
 
 enum TypeID
@@ -230,10 +232,10 @@ class ObjectGuidGenerator
         uint32 Generate();
 
     public:                                                 // accessors
-        uint32 GetNextAfterMaxUsed() const { return m_nextGuid; }
+        uint32 GetNextAfterMaxUsed() const { return m_nextGuid.value(); }
 
     private:                                                // fields
-        uint32 m_nextGuid;
+        ACE_Atomic_Op<ACE_Thread_Mutex, uint32> m_nextGuid; // atomic, generators are used from map update threads
 };
 
 ByteBuffer& operator<< (ByteBuffer& buf, ObjectGuid const& guid);
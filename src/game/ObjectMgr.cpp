@@ -18,6 +18,7 @@
 
 #include "ObjectMgr.h"
 #include "Database/DatabaseEnv.h"
+#include "Database/SnapshotFile.h"
 #include "Policies/Singleton.h"
 
 #include "SQLStorages.h"
@@ -104,12 +105,13 @@ LanguageDesc const* GetLanguageDescByID(uint32 lang)
 template<typename T>
 T IdGenerator<T>::Generate()
 {
-    if (m_nextGuid >= std::numeric_limits<T>::max() - 1)
+    T guid = m_nextGuid++;
+    if (guid >= std::numeric_limits<T>::max() - 1)
     {
         sLog.outError("%s guid overflow!! Can't continue, shutting down server. ", m_name);
         World::StopNow(ERROR_EXIT_CODE);
     }
-    return m_nextGuid++;
+    return guid;
 }
 
 template uint32 IdGenerator<uint32>::Generate();
@@ -579,8 +581,35 @@ void ObjectMgr::LoadCreatureTemplates()
     }
 }
 
-void ObjectMgr::ConvertCreatureAddonAuras(CreatureDataAddon* addon, char const* table, char const* guidEntryStr)
+// a node and a bucket pointer per element plus the element's own allocation, strings of locales are not included
+template<class M>
+static void AddContainerMemoryUsage(StaticDataMemoryUsageList& list, char const* name, M const& container, size_t elementBytes = 0)
+{
+    uint64 bytes = uint64(container.size()) * (sizeof(typename M::value_type) + 3 * sizeof(void*) + elementBytes);
+    list.push_back(StaticDataMemoryUsage(name, container.size(), bytes));
+}
+
+void ObjectMgr::GetMemoryUsage(StaticDataMemoryUsageList& list) const
+{
+    AddContainerMemoryUsage(list, "creature", mCreatureDataMap);
+    AddContainerMemoryUsage(list, "gameobject", mGameObjectDataMap);
+    AddContainerMemoryUsage(list, "quest_template", mQuestTemplates, sizeof(Quest));
+    AddContainerMemoryUsage(list, "npc_text", mGossipText);
+    AddContainerMemoryUsage(list, "locales_creature", mCreatureLocaleMap);
+    AddContainerMemoryUsage(list, "locales_gameobject", mGameObjectLocaleMap);
+    AddContainerMemoryUsage(list, "locales_item", mItemLocaleMap);
+    AddContainerMemoryUsage(list, "locales_quest", mQuestLocaleMap);
+    AddContainerMemoryUsage(list, "locales_npc_text", mNpcTextLocaleMap);
+    AddContainerMemoryUsage(list, "locales_page_text", mPageTextLocaleMap);
+    AddContainerMemoryUsage(list, "locales_gossip_menu_option", mGossipMenuItemsLocaleMap);
+    AddContainerMemoryUsage(list, "locales_points_of_interest", mPointOfInterestLocaleMap);
+    AddContainerMemoryUsage(list, "mangos_string", mMangosStringLocaleMap);
+}
+
+void ObjectMgr::ConvertCreatureAddonAuras(SQLStorage& creatureaddons, CreatureDataAddon* addon, char const* guidEntryStr)
 {
+    char const* table = creatureaddons.GetTableName();
+
     // Now add the auras, format "spell1 spell2 ..."
     char* p, *s;
     std::vector<int> val;
@@ -598,9 +627,6 @@ void ObjectMgr::ConvertCreatureAddonAuras(CreatureDataAddon* addon, char const*
         }
         if (p != s)
             val.push_back(atoi(s));
-
-        // free char* loaded memory
-        delete[](char*)reinterpret_cast<char const*>(addon->auras);
     }
 
     // empty list
@@ -610,8 +636,8 @@ void ObjectMgr::ConvertCreatureAddonAuras(CreatureDataAddon* addon, char const*
         return;
     }
 
-    // replace by new structures array
-    const_cast<uint32*&>(addon->auras) = new uint32[val.size() + 1];
+    // replace by new structures array, the loaded string stays in the storage (it may be shared with other records)
+    const_cast<uint32*&>(addon->auras) = static_cast<uint32*>(creatureaddons.AllocateData((val.size() + 1) * sizeof(uint32)));
 
     uint32 i = 0;
     for (uint32 j = 0; j < val.size(); ++j)
@@ -685,7 +711,7 @@ void ObjectMgr::LoadCreatureAddons(SQLStorage& creatureaddons, char const* entry
             const_cast<CreatureDataAddon*>(addon)->emote = 0;
         }
 
-        ConvertCreatureAddonAuras(const_cast<CreatureDataAddon*>(addon), creatureaddons.GetTableName(), entryName);
+        ConvertCreatureAddonAuras(creatureaddons, const_cast<CreatureDataAddon*>(addon), entryName);
     }
 }
 
@@ -978,6 +1004,12 @@ void ObjectMgr::LoadCreatureModelInfo()
 
 void ObjectMgr::LoadCreatures()
 {
+    // spawns validated by an earlier load of the same world database
+    SnapshotFile snapshot("creature_spawns", "guid id map model equipment x y z o spawntime spawndist waypoint health mana dead movement grid");
+    if (snapshot.Open() && LoadCreaturesFromSnapshot(snapshot))
+        return;
+    snapshot.Close();
+
     uint32 count = 0;
     //                                                0                       1   2    3
     QueryResult* result = WorldDatabase.Query("SELECT creature.guid, creature.id, map, modelid,"
@@ -1005,6 +1037,9 @@ void ObjectMgr::LoadCreatures()
 
     // build single time for check creature data
 
+    std::set<uint32> gridGuids;                             // for the snapshot
+    snapshot.BeginWrite();
+
     BarGoLink bar(result->GetRowCount());
 
     do
@@ -1114,7 +1149,11 @@ void ObjectMgr::LoadCreatures()
         }
 
         if (gameEvent == 0 && GuidPoolId == 0 && EntryPoolId == 0) // if not this is to be managed by GameEvent System or Pool system
+        {
             AddCreatureToGrid(guid, &data);
+            if (snapshot.IsWriting())
+                gridGuids.insert(guid);
+        }
 
         ++count;
     }
@@ -1122,10 +1161,97 @@ void ObjectMgr::LoadCreatures()
 
     delete result;
 
+    if (snapshot.IsWriting())
+        WriteCreaturesSnapshot(snapshot, gridGuids);
+
     sLog.outString();
     sLog.outString(">> Loaded " SIZEFMTD " creatures", mCreatureDataMap.size());
 }
 
+// The map is written as it is after the load, including the data of skipped rows that were added before the check failed
+void ObjectMgr::WriteCreaturesSnapshot(SnapshotFile& snapshot, std::set<uint32> const& gridGuids)
+{
+    for (CreatureDataMap::const_iterator itr = mCreatureDataMap.begin(); itr != mCreatureDataMap.end(); ++itr)
+    {
+        CreatureData const& data = itr->second;
+
+        snapshot.WriteUInt32(itr->first);
+        snapshot.WriteUInt32(data.id);
+        snapshot.WriteUInt32(data.mapid);
+        snapshot.WriteUInt32(data.modelid_override);
+        snapshot.WriteInt32(data.equipmentId);
+        snapshot.WriteFloat(data.posX);
+        snapshot.WriteFloat(data.posY);
+        snapshot.WriteFloat(data.posZ);
+        snapshot.WriteFloat(data.orientation);
+        snapshot.WriteUInt32(data.spawntimesecs);
+        snapshot.WriteFloat(data.spawndist);
+        snapshot.WriteUInt32(data.currentwaypoint);
+        snapshot.WriteUInt32(data.curhealth);
+        snapshot.WriteUInt32(data.curmana);
+        snapshot.WriteUInt8(data.is_dead ? 1 : 0);
+        snapshot.WriteUInt8(data.movementType);
+        snapshot.WriteUInt8(gridGuids.find(itr->first) != gridGuids.end() ? 1 : 0);
+        snapshot.EndRecord();
+    }
+
+    snapshot.EndWrite();
+}
+
+bool ObjectMgr::LoadCreaturesFromSnapshot(SnapshotFile& snapshot)
+{
+    // read everything first, a damaged snapshot leaves nothing behind for the database load
+    typedef std::vector<std::pair<uint32, CreatureData> > CreatureDataList;
+    CreatureDataList dataList(snapshot.GetRecordCount());
+    std::vector<bool> inGrid(snapshot.GetRecordCount());
+
+    for (uint32 i = 0; i < snapshot.GetRecordCount(); ++i)
+    {
+        uint32& guid = dataList[i].first;
+        CreatureData& data = dataList[i].second;
+
+        guid                    = snapshot.ReadUInt32();
+        data.id                 = snapshot.ReadUInt32();
+        data.mapid              = snapshot.ReadUInt32();
+        data.modelid_override   = snapshot.ReadUInt32();
+        data.equipmentId        = snapshot.ReadInt32();
+        data.posX               = snapshot.ReadFloat();
+        data.posY               = snapshot.ReadFloat();
+        data.posZ               = snapshot.ReadFloat();
+        data.orientation        = snapshot.ReadFloat();
+        data.spawntimesecs      = snapshot.ReadUInt32();
+        data.spawndist          = snapshot.ReadFloat();
+        data.currentwaypoint    = snapshot.ReadUInt32();
+        data.curhealth          = snapshot.ReadUInt32();
+        data.curmana            = snapshot.ReadUInt32();
+        data.is_dead            = snapshot.ReadUInt8() != 0;
+        data.movementType       = snapshot.ReadUInt8();
+        inGrid[i]               = snapshot.ReadUInt8() != 0;
+    }
+
+    if (snapshot.HasReadError() || !snapshot.IsEnd())
+    {
+        sLog.outError("Snapshot of `creature` can not be read, loading the spawns from the database.");
+        return false;
+    }
+
+    BarGoLink bar(dataList.size());
+    for (size_t i = 0; i < dataList.size(); ++i)
+    {
+        bar.step();
+
+        CreatureData& data = mCreatureDataMap[dataList[i].first];
+        data = dataList[i].second;
+
+        if (inGrid[i])
+            AddCreatureToGrid(dataList[i].first, &data);
+    }
+
+    sLog.outString();
+    sLog.outString(">> Loaded " SIZEFMTD " creatures from snapshot", mCreatureDataMap.size());
+    return true;
+}
+
 void ObjectMgr::AddCreatureToGrid(uint32 guid, CreatureData const* data)
 {
     CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
@@ -1146,6 +1272,12 @@ void ObjectMgr::RemoveCreatureFromGrid(uint32 guid, CreatureData const* data)
 
 void ObjectMgr::LoadGameObjects()
 {
+    // spawns validated by an earlier load of the same world database
+    SnapshotFile snapshot("gameobject_spawns", "guid id map x y z o rotation0-3 spawntime animprogress state grid");
+    if (snapshot.Open() && LoadGameObjectsFromSnapshot(snapshot))
+        return;
+    snapshot.Close();
+
     uint32 count = 0;
 
     //                                                0                           1   2    3           4           5           6
@@ -1170,6 +1302,9 @@ void ObjectMgr::LoadGameObjects()
         return;
     }
 
+    std::set<uint32> gridGuids;                             // for the snapshot
+    snapshot.BeginWrite();
+
     BarGoLink bar(result->GetRowCount());
 
     do
@@ -1262,7 +1397,11 @@ void ObjectMgr::LoadGameObjects()
         }
 
         if (gameEvent == 0 && GuidPoolId == 0 && EntryPoolId == 0) // if not this is to be managed by GameEvent System or Pool system
+        {
             AddGameobjectToGrid(guid, &data);
+            if (snapshot.IsWriting())
+                gridGuids.insert(guid);
+        }
 
         //uint32 zoneId, areaId;
         //sTerrainMgr.LoadTerrain(data.mapid)->GetZoneAndAreaId(zoneId, areaId, data.posX, data.posY, data.posZ);
@@ -1274,10 +1413,93 @@ void ObjectMgr::LoadGameObjects()
 
     delete result;
 
+    if (snapshot.IsWriting())
+        WriteGameObjectsSnapshot(snapshot, gridGuids);
+
     sLog.outString();
     sLog.outString(">> Loaded " SIZEFMTD " gameobjects", mGameObjectDataMap.size());
 }
 
+// The map is written as it is after the load, including the data of skipped rows that were added before the check failed
+void ObjectMgr::WriteGameObjectsSnapshot(SnapshotFile& snapshot, std::set<uint32> const& gridGuids)
+{
+    for (GameObjectDataMap::const_iterator itr = mGameObjectDataMap.begin(); itr != mGameObjectDataMap.end(); ++itr)
+    {
+        GameObjectData const& data = itr->second;
+
+        snapshot.WriteUInt32(itr->first);
+        snapshot.WriteUInt32(data.id);
+        snapshot.WriteUInt32(data.mapid);
+        snapshot.WriteFloat(data.posX);
+        snapshot.WriteFloat(data.posY);
+        snapshot.WriteFloat(data.posZ);
+        snapshot.WriteFloat(data.orientation);
+        snapshot.WriteFloat(data.rotation0);
+        snapshot.WriteFloat(data.rotation1);
+        snapshot.WriteFloat(data.rotation2);
+        snapshot.WriteFloat(data.rotation3);
+        snapshot.WriteInt32(data.spawntimesecs);
+        snapshot.WriteUInt32(data.animprogress);
+        snapshot.WriteUInt32(data.go_state);
+        snapshot.WriteUInt8(gridGuids.find(itr->first) != gridGuids.end() ? 1 : 0);
+        snapshot.EndRecord();
+    }
+
+    snapshot.EndWrite();
+}
+
+bool ObjectMgr::LoadGameObjectsFromSnapshot(SnapshotFile& snapshot)
+{
+    // read everything first, a damaged snapshot leaves nothing behind for the database load
+    typedef std::vector<std::pair<uint32, GameObjectData> > GameObjectDataList;
+    GameObjectDataList dataList(snapshot.GetRecordCount());
+    std::vector<bool> inGrid(snapshot.GetRecordCount());
+
+    for (uint32 i = 0; i < snapshot.GetRecordCount(); ++i)
+    {
+        uint32& guid = dataList[i].first;
+        GameObjectData& data = dataList[i].second;
+
+        guid                = snapshot.ReadUInt32();
+        data.id             = snapshot.ReadUInt32();
+        data.mapid          = snapshot.ReadUInt32();
+        data.posX           = snapshot.ReadFloat();
+        data.posY           = snapshot.ReadFloat();
+        data.posZ           = snapshot.ReadFloat();
+        data.orientation    = snapshot.ReadFloat();
+        data.rotation0      = snapshot.ReadFloat();
+        data.rotation1      = snapshot.ReadFloat();
+        data.rotation2      = snapshot.ReadFloat();
+        data.rotation3      = snapshot.ReadFloat();
+        data.spawntimesecs  = snapshot.ReadInt32();
+        data.animprogress   = snapshot.ReadUInt32();
+        data.go_state       = GOState(snapshot.ReadUInt32());
+        inGrid[i]           = snapshot.ReadUInt8() != 0;
+    }
+
+    if (snapshot.HasReadError() || !snapshot.IsEnd())
+    {
+        sLog.outError("Snapshot of `gameobject` can not be read, loading the spawns from the database.");
+        return false;
+    }
+
+    BarGoLink bar(dataList.size());
+    for (size_t i = 0; i < dataList.size(); ++i)
+    {
+        bar.step();
+
+        GameObjectData& data = mGameObjectDataMap[dataList[i].first];
+        data = dataList[i].second;
+
+        if (inGrid[i])
+            AddGameobjectToGrid(dataList[i].first, &data);
+    }
+
+    sLog.outString();
+    sLog.outString(">> Loaded " SIZEFMTD " gameobjects from snapshot", mGameObjectDataMap.size());
+    return true;
+}
+
 void ObjectMgr::AddGameobjectToGrid(uint32 guid, GameObjectData const* data)
 {
     CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
@@ -3090,6 +3312,12 @@ void ObjectMgr::LoadQuests()
 
     m_ExclusiveQuestGroups.clear();
 
+    // quests checked by an earlier load of the same world database
+    SnapshotFile snapshot("quest_template", "quest fields, load counts, previous quests, previous chain quests");
+    if (snapshot.Open() && LoadQuestsFromSnapshot(snapshot))
+        return;
+    snapshot.Close();
+
     //                                                0      1       2           3         4           5     6                7              8              9
     QueryResult* result = WorldDatabase.Query("SELECT entry, Method, ZoneOrSort, MinLevel, QuestLevel, Type, RequiredClasses, RequiredRaces, RequiredSkill, RequiredSkillValue,"
                           //   10                   11                 12                     13                   14                     15                   16                17
@@ -3136,6 +3364,8 @@ void ObjectMgr::LoadQuests()
         return;
     }
 
+    snapshot.BeginWrite();
+
     // create multimap previous quest for each existing quest
     // some quests can have many previous maps set by NextQuestId in previous quest
     // for example set of race quests can lead to single not race specific quest
@@ -3723,10 +3953,55 @@ void ObjectMgr::LoadQuests()
         }
     }
 
+    if (snapshot.IsWriting())
+        WriteQuestsSnapshot(snapshot);
+
     sLog.outString();
     sLog.outString(">> Loaded " SIZEFMTD " quests definitions", mQuestTemplates.size());
 }
 
+void ObjectMgr::WriteQuestsSnapshot(SnapshotFile& snapshot)
+{
+    for (QuestMap::const_iterator itr = mQuestTemplates.begin(); itr != mQuestTemplates.end(); ++itr)
+    {
+        itr->second->WriteSnapshot(snapshot);
+        snapshot.EndRecord();
+    }
+
+    snapshot.EndWrite();
+}
+
+bool ObjectMgr::LoadQuestsFromSnapshot(SnapshotFile& snapshot)
+{
+    BarGoLink bar(snapshot.GetRecordCount());
+    for (uint32 i = 0; i < snapshot.GetRecordCount(); ++i)
+    {
+        bar.step();
+
+        Quest* newQuest = new Quest(snapshot);
+        mQuestTemplates[newQuest->GetQuestId()] = newQuest;
+    }
+
+    if (snapshot.HasReadError() || !snapshot.IsEnd())
+    {
+        sLog.outError("Snapshot of `quest_template` can not be read, loading the quests from the database.");
+
+        for (QuestMap::const_iterator itr = mQuestTemplates.begin(); itr != mQuestTemplates.end(); ++itr)
+            delete itr->second;
+        mQuestTemplates.clear();
+        return false;
+    }
+
+    // the only other data of the checks
+    for (QuestMap::const_iterator itr = mQuestTemplates.begin(); itr != mQuestTemplates.end(); ++itr)
+        if (itr->second->ExclusiveGroup)
+            m_ExclusiveQuestGroups.insert(ExclusiveQuestGroupsMap::value_type(itr->second->ExclusiveGroup, itr->second->GetQuestId()));
+
+    sLog.outString();
+    sLog.outString(">> Loaded " SIZEFMTD " quests definitions from snapshot", mQuestTemplates.size());
+    return true;
+}
+
 void ObjectMgr::LoadQuestLocales()
 {
     mQuestLocaleMap.clear();                                // need for reload case
@@ -409,6 +409,7 @@ extern LanguageDesc lang_description[LANGUAGES_COUNT];
 MANGOS_DLL_SPEC LanguageDesc const* GetLanguageDescByID(uint32 lang);
 
 class PlayerDumpReader;
+class SnapshotFile;
 
 class HonorStanding
 {
@@ -448,13 +449,25 @@ class IdGenerator
         T Generate();
 
     public:                                                 // accessors
-        T GetNextAfterMaxUsed() const { return m_nextGuid; }
+        T GetNextAfterMaxUsed() const { return m_nextGuid.value(); }
 
     private:                                                // fields
         char const* m_name;
-        T m_nextGuid;
+        ACE_Atomic_Op<ACE_Thread_Mutex, T> m_nextGuid;      // atomic, generators are used from map update threads
 };
 
+/// Static data container entry of the memory report (.server memory)
+struct StaticDataMemoryUsage
+{
+    StaticDataMemoryUsage(char const* _name, uint32 _count, uint64 _bytes) : name(_name), count(_count), bytes(_bytes) {}
+
+    char const* name;
+    uint32 count;                                           // elements
+    uint64 bytes;                                           // approximation, see ObjectMgr::GetMemoryUsage
+};
+
+typedef std::vector<StaticDataMemoryUsage> StaticDataMemoryUsageList;
+
 class ObjectMgr
 {
         friend class PlayerDumpReader;
@@ -528,6 +541,9 @@ class ObjectMgr
         }
         QuestMap const& GetQuestTemplates() const { return mQuestTemplates; }
 
+        /// Memory of the biggest static data containers not held in SQL storages
+        void GetMemoryUsage(StaticDataMemoryUsageList& list) const;
+
         uint32 GetQuestForAreaTrigger(uint32 Trigger_ID) const
         {
             QuestAreaTriggerMap::const_iterator itr = mQuestAreaTriggerMap.find(Trigger_ID);
@@ -1124,8 +1140,17 @@ class ObjectMgr
 
     private:
         void LoadCreatureAddons(SQLStorage& creatureaddons, char const* entryName, char const* comment);
-        void ConvertCreatureAddonAuras(CreatureDataAddon* addon, char const* table, char const* guidEntryStr);
+        void ConvertCreatureAddonAuras(SQLStorage& creatureaddons, CreatureDataAddon* addon, char const* guidEntryStr);
         void LoadQuestRelationsHelper(QuestRelationsMap& map, char const* table);
+
+        // validated data of an earlier load, see SnapshotFile
+        bool LoadCreaturesFromSnapshot(SnapshotFile& snapshot);
+        void WriteCreaturesSnapshot(SnapshotFile& snapshot, std::set<uint32> const& gridGuids);
+        bool LoadGameObjectsFromSnapshot(SnapshotFile& snapshot);
+        void WriteGameObjectsSnapshot(SnapshotFile& snapshot, std::set<uint32> const& gridGuids);
+        bool LoadQuestsFromSnapshot(SnapshotFile& snapshot);
+        void WriteQuestsSnapshot(SnapshotFile& snapshot);
+
         void LoadVendors(char const* tableName, bool isTemplates);
         void LoadTrainers(char const* tableName, bool isTemplates);
 
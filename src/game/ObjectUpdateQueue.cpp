@@ -0,0 +1,114 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ObjectUpdateQueue.h"
+#include "Player.h"
+#include "WorldSession.h"
+
+ObjectUpdateQueue::ObjectUpdateQueue() : m_packet(), m_buffer(0),
+    m_bufferGrowths(0), m_lastObjects(0), m_lastPackets(0), m_lastBufferGrowths(0)
+{
+}
+
+void ObjectUpdateQueue::Add(Object* obj)
+{
+    if (IsQueued(obj))
+        return;
+
+    size_t capacity = m_objects.capacity();
+
+    obj->m_updateQueueIndex = m_objects.size();
+    m_objects.push_back(obj);
+
+    if (m_objects.capacity() != capacity)
+        ++m_bufferGrowths;
+}
+
+void ObjectUpdateQueue::Remove(Object* obj)
+{
+    // an item may be removed through a different map than the one it was queued in
+    if (!IsQueued(obj))
+        return;
+
+    // move the last object into the freed slot
+    Object* last = m_objects.back();
+    m_objects[obj->m_updateQueueIndex] = last;
+    last->m_updateQueueIndex = obj->m_updateQueueIndex;
+    m_objects.pop_back();
+
+    obj->m_updateQueueIndex = 0;
+}
+
+bool ObjectUpdateQueue::IsQueued(Object const* obj) const
+{
+    return obj->m_updateQueueIndex < m_objects.size() && m_objects[obj->m_updateQueueIndex] == obj;
+}
+
+void ObjectUpdateQueue::Send()
+{
+    m_lastObjects = m_objects.size();
+
+    size_t capacity = m_players.capacity();
+
+    // objects may be queued again while the update data is built, take them from the back
+    while (!m_objects.empty())
+    {
+        Object* obj = m_objects.back();
+        m_objects.pop_back();
+        obj->m_updateQueueIndex = 0;
+        obj->BuildUpdateData(m_players);
+    }
+
+    if (m_players.capacity() != capacity)
+        ++m_bufferGrowths;
+
+    m_lastPackets = m_players.size();
+    m_bufferGrowths += SendPlayerUpdates(m_players, m_packet, m_buffer);
+
+    m_lastBufferGrowths = m_bufferGrowths;
+    m_bufferGrowths = 0;
+}
+
+uint32 ObjectUpdateQueue::SendPlayerUpdates(UpdatePlayerList& players, WorldPacket& packet, ByteBuffer& buffer)
+{
+    uint32 growths = 0;
+
+    for (UpdatePlayerList::const_iterator itr = players.begin(); itr != players.end(); ++itr)
+    {
+        Player* player = *itr;
+        UpdateData& data = player->GetClientUpdateData();
+
+        size_t packetCapacity = packet.capacity();
+        size_t bufferCapacity = buffer.capacity();
+
+        data.BuildPacket(&packet, buffer);
+        player->GetSession()->SendPacket(&packet);
+        packet.clear();
+
+        growths += data.GetBufferGrowths();
+        if (packet.capacity() != packetCapacity)
+            ++growths;
+        if (buffer.capacity() != bufferCapacity)
+            ++growths;
+
+        data.Clear();
+    }
+
+    players.clear();
+    return growths;
+}
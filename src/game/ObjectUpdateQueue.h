@@ -0,0 +1,68 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_OBJECTUPDATEQUEUE_H
+#define MANGOS_OBJECTUPDATEQUEUE_H
+
+#include "Common.h"
+#include "Object.h"
+#include "WorldPacket.h"
+
+/**
+ * Objects of a map with changed update fields, sent to the clients once per map update.
+ *
+ * Queued objects store their position in the queue (intrusive index) so add and remove are O(1).
+ * Update blocks are collected in UpdateData buffers owned by the receiving players, all buffers
+ * (queue, receiver list, players' UpdateData, packet) keep their memory between ticks and are
+ * only reset, so the update path does not allocate once the buffers have grown to the map's load.
+ */
+class ObjectUpdateQueue
+{
+    public:
+        ObjectUpdateQueue();
+
+        void Add(Object* obj);
+        void Remove(Object* obj);
+        bool IsQueued(Object const* obj) const;
+
+        /// Build the update blocks of all queued objects and send them to the receivers
+        void Send();
+
+        /// Send and reset the collected UpdateData of each player in the list, returns the number of grown buffers
+        static uint32 SendPlayerUpdates(UpdatePlayerList& players, WorldPacket& packet, ByteBuffer& buffer);
+
+        uint32 GetLastObjectCount() const { return m_lastObjects; }
+        uint32 GetLastPacketCount() const { return m_lastPackets; }
+        /// Number of buffers that had to grow during the last Send (heap allocations in the update path)
+        uint32 GetLastBufferGrowths() const { return m_lastBufferGrowths; }
+
+    private:
+        typedef std::vector<Object*> ObjectList;
+
+        ObjectList m_objects;
+        UpdatePlayerList m_players;
+        WorldPacket m_packet;
+        ByteBuffer m_buffer;                                // uncompressed packet data
+
+        uint32 m_bufferGrowths;                             // since the last Send
+        uint32 m_lastObjects;
+        uint32 m_lastPackets;
+        uint32 m_lastBufferGrowths;
+};
+
+#endif
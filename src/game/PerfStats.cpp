@@ -0,0 +1,635 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "PerfStats.h"
+#include "Opcodes.h"
+#include "ObjectMgr.h"
+#include "Log.h"
+#include "Database/DatabaseEnv.h"
+#include "PlayerSaveScheduler.h"
+#include "Config/Config.h"
+#include "Policies/Singleton.h"
+#include <ace/High_Res_Timer.h>
+#include <ace/TSS_T.h>
+
+#if PLATFORM != PLATFORM_WINDOWS
+#include <sys/resource.h>
+#endif
+
+INSTANTIATE_SINGLETON_1(PerfStats);
+
+/// Opcode counters of one thread, registered in PerfStats for the thread lifetime
+class PerfThreadOpcodes
+{
+    public:
+        PerfThreadOpcodes() : m_used(false) { sPerfStats.RegisterThreadOpcodes(this); }
+        ~PerfThreadOpcodes() { sPerfStats.UnregisterThreadOpcodes(this); }
+
+        void Add(uint16 opcode, uint32 time, uint32 bytes)
+        {
+            PerfOpcodeCounter& counter = m_counters[opcode];
+            ++counter.count;
+            counter.totalTime += time;
+            counter.bytes += bytes;
+            if (time > counter.maxTime)
+                counter.maxTime = time;
+            m_used = true;
+        }
+
+        PerfOpcodeCounter m_counters[NUM_MSG_TYPES];
+        bool m_used;                                        // any counter changed since last merge
+};
+
+static ACE_TSS<PerfThreadOpcodes> perfThreadOpcodes;
+
+static char const* const perfStageNames[MAX_PERF_STAGES] =
+{
+    "tick",
+    "auctions",
+    "ahbot",
+    "sessions",
+    "weathers",
+    "maps",
+    "battlegrounds",
+    "outdoorpvp",
+    "eluna",
+    "resultqueue",
+    "gameevents",
+    "removelist",
+    "clicommands",
+    "terrain",
+    "playersaves",
+};
+
+#define PERF_REPORT_MAX_MAPS      10                        // maps listed in report, ordered by max time
+
+enum PerfTopKind
+{
+    PERF_TOP_MAPS,
+    PERF_TOP_OPCODES,
+    PERF_TOP_CREATURE_AIS,
+};
+
+static void AddTopListLines(std::vector<std::string>& lines, PerfTopList const& list, PerfTopKind kind)
+{
+    char buf[256];
+    for (uint32 i = 0; i < list.GetSize(); ++i)
+    {
+        PerfSample const& sample = list[i];
+        switch (kind)
+        {
+            case PERF_TOP_MAPS:
+                snprintf(buf, sizeof(buf), "  map %u instance %u: %u us", sample.id, sample.param, sample.time);
+                break;
+            case PERF_TOP_OPCODES:
+                snprintf(buf, sizeof(buf), "  opcode %s (account %u): %u us", LookupOpcodeName(uint16(sample.id)), sample.param, sample.time);
+                break;
+            case PERF_TOP_CREATURE_AIS:
+            {
+                CreatureInfo const* cInfo = ObjectMgr::GetCreatureTemplate(sample.id);
+                snprintf(buf, sizeof(buf), "  creature AI %s (entry %u, guid %u): %u us", cInfo ? cInfo->Name : "<unknown>", sample.id, sample.param, sample.time);
+                break;
+            }
+        }
+        lines.push_back(buf);
+    }
+}
+
+static void GetProcessUsage(PerfProcessUsage& usage)
+{
+#if PLATFORM != PLATFORM_WINDOWS
+    rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0)
+        return;
+
+    usage.userTime = uint64(ru.ru_utime.tv_sec) * 1000000 + ru.ru_utime.tv_usec;
+    usage.systemTime = uint64(ru.ru_stime.tv_sec) * 1000000 + ru.ru_stime.tv_usec;
+    usage.voluntarySwitches = uint64(ru.ru_nvcsw);
+    usage.involuntarySwitches = uint64(ru.ru_nivcsw);
+#else
+    (void)usage;
+#endif
+}
+
+/// Syscalls and sends of the network threads and CPU use of the process since the window start
+static void AddNetworkLines(std::vector<std::string>& lines, std::vector<NetworkThreadStats> const& networkBase,
+                            PerfProcessUsage const& processBase, uint64 windowTime)
+{
+    if (!windowTime)
+        return;
+
+    char buf[256];
+    double seconds = double(windowTime) / 1000000.0;
+
+    std::vector<NetworkThreadStats> network;
+    sWorldSocketMgr->GetNetworkStats(network);
+
+    uint32 connections = 0;
+    uint64 syscalls = 0;
+    uint64 receives = 0;
+    uint64 packets = 0;
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+        // the threads are started after the first window began
+        if (i < networkBase.size())
+        {
+            network[i].syscalls -= networkBase[i].syscalls;
+            network[i].receives -= networkBase[i].receives;
+            network[i].packets -= networkBase[i].packets;
+            network[i].writes -= networkBase[i].writes;
+            network[i].sentBytes -= networkBase[i].sentBytes;
+        }
+
+        connections += network[i].connections;
+        syscalls += network[i].syscalls;
+        receives += network[i].receives;
+        packets += network[i].packets;
+    }
+
+    if (!network.empty())
+    {
+        snprintf(buf, sizeof(buf), "Network threads (%s): %u connections, %.0f syscalls/s, %.0f reads/s, %.0f packets/s, %.0f syscalls/s per 1000 connections",
+                 sWorldSocketMgr->UsesIoUring() ? "io_uring" : "reactor", connections, syscalls / seconds, receives / seconds,
+                 packets / seconds, connections ? syscalls / seconds * 1000.0 / connections : 0.0);
+        lines.push_back(buf);
+
+        lines.push_back("  thread  connections  syscalls/s     reads/s   packets/s    writes/s      KB/s");
+        for (size_t i = 0; i < network.size(); ++i)
+        {
+            snprintf(buf, sizeof(buf), "  %-6u %12u %11.0f %11.0f %11.0f %11.0f %9.0f", uint32(i), network[i].connections,
+                     network[i].syscalls / seconds, network[i].receives / seconds, network[i].packets / seconds,
+                     network[i].writes / seconds, network[i].sentBytes / seconds / 1024.0);
+            lines.push_back(buf);
+        }
+    }
+
+    PerfProcessUsage usage;
+    GetProcessUsage(usage);
+    if (usage.userTime || usage.systemTime)
+    {
+        // percent of one core, more than 100 with several busy threads
+        snprintf(buf, sizeof(buf), "Process CPU: user %.1f%% system %.1f%%, %.0f voluntary and %.0f involuntary context switches/s",
+                 (usage.userTime - processBase.userTime) * 100.0 / windowTime, (usage.systemTime - processBase.systemTime) * 100.0 / windowTime,
+                 (usage.voluntarySwitches - processBase.voluntarySwitches) / seconds, (usage.involuntarySwitches - processBase.involuntarySwitches) / seconds);
+        lines.push_back(buf);
+    }
+}
+
+void PerfHistogram::Add(uint32 time)
+{
+    uint32 bucket = 0;
+    while (bucket + 1 < PERF_HISTOGRAM_BUCKETS && (time >> (bucket + 1)))
+        ++bucket;
+
+    ++m_buckets[bucket];
+    ++m_count;
+    m_total += time;
+    if (time > m_max)
+        m_max = time;
+}
+
+void PerfHistogram::Reset()
+{
+    memset(m_buckets, 0, sizeof(m_buckets));
+    m_count = 0;
+    m_max = 0;
+    m_total = 0;
+}
+
+uint32 PerfHistogram::GetPercentile(uint32 percent) const
+{
+    if (!m_count)
+        return 0;
+
+    uint32 needed = uint32((uint64(m_count) * percent + 99) / 100);
+    uint32 found = 0;
+    for (uint32 bucket = 0; bucket < PERF_HISTOGRAM_BUCKETS; ++bucket)
+    {
+        found += m_buckets[bucket];
+        if (found >= needed)
+        {
+            // upper bound of the bucket, but never more than really seen
+            uint32 bound = bucket + 1 < 32 ? (uint32(2) << bucket) - 1 : 0xFFFFFFFF;
+            return std::min(bound, m_max);
+        }
+    }
+
+    return m_max;
+}
+
+void PerfTopList::Add(PerfSample const& sample)
+{
+    if (m_size == PERF_TOP_COUNT && m_samples[PERF_TOP_COUNT - 1].time >= sample.time)
+        return;
+
+    uint32 pos = m_size < PERF_TOP_COUNT ? m_size++ : PERF_TOP_COUNT - 1;
+    for (; pos > 0 && m_samples[pos - 1].time < sample.time; --pos)
+        m_samples[pos] = m_samples[pos - 1];
+
+    m_samples[pos] = sample;
+}
+
+PerfStats::PerfStats() : m_enabled(false), m_dumpInterval(0), m_lastDumpTime(0), m_windowStart(0), m_tickStart(0)
+{
+}
+
+void PerfStats::Initialize(bool enabled, uint32 dumpInterval, std::string const& dumpFile)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    if (enabled && !m_enabled)
+    {
+        m_windowStart = GetMicroTime();
+        sWorldSocketMgr->GetNetworkStats(m_networkBase);
+        GetProcessUsage(m_processBase);
+    }
+
+    m_enabled = enabled;
+    m_dumpInterval = dumpInterval;
+    m_lastDumpTime = 0;
+
+    m_dumpFile.clear();
+    if (!dumpFile.empty())
+    {
+        m_dumpFile = sConfig.GetStringDefault("LogsDir", "");
+        if (!m_dumpFile.empty() && m_dumpFile[m_dumpFile.length() - 1] != '/' && m_dumpFile[m_dumpFile.length() - 1] != '\\')
+            m_dumpFile.append("/");
+        m_dumpFile.append(dumpFile);
+    }
+}
+
+uint64 PerfStats::GetMicroTime()
+{
+    ACE_Time_Value now = ACE_High_Res_Timer::gettimeofday_hr();
+    return uint64(now.sec()) * 1000000 + now.usec();
+}
+
+void PerfStats::StartTick()
+{
+    if (!m_enabled)
+        return;
+
+    m_tickStart = GetMicroTime();
+}
+
+void PerfStats::FinishTick()
+{
+    if (!m_enabled || !m_tickStart)
+        return;
+
+    uint64 now = GetMicroTime();
+    uint32 tickTime = uint32(now - m_tickStart);
+    m_tickStart = 0;
+
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+        m_stages[PERF_STAGE_TICK].Add(tickTime);
+
+        for (ThreadOpcodesList::const_iterator itr = m_threadOpcodes.begin(); itr != m_threadOpcodes.end(); ++itr)
+            MergeThreadOpcodes(**itr);
+
+        m_currentTick.tickTime = tickTime;
+        m_lastTick = m_currentTick;
+        if (tickTime >= m_worstTick.tickTime)
+            m_worstTick = m_currentTick;
+        m_currentTick.Clear();
+    }
+
+    if (m_dumpInterval && !m_dumpFile.empty())
+    {
+        if (!m_lastDumpTime)
+            m_lastDumpTime = now;
+        else if (now - m_lastDumpTime >= uint64(m_dumpInterval) * IN_MILLISECONDS)
+        {
+            m_lastDumpTime = now;
+            WriteDump();
+        }
+    }
+}
+
+void PerfStats::AddStageSample(PerfStage stage, uint32 time)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    m_stages[stage].Add(time);
+}
+
+void PerfStats::AddMapSample(uint32 mapId, uint32 instanceId, uint32 time)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    m_maps[(uint64(mapId) << 32) | instanceId].Add(time);
+    m_currentTick.maps.Add(PerfSample(mapId, instanceId, time));
+}
+
+void PerfStats::AddOpcodeSample(uint16 opcode, uint32 accountId, uint32 time, uint32 bytes)
+{
+    if (opcode < NUM_MSG_TYPES)
+        perfThreadOpcodes->Add(opcode, time, bytes);
+
+    if (time < PERF_TOP_MIN_TIME)
+        return;
+
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    m_currentTick.opcodes.Add(PerfSample(opcode, accountId, time));
+}
+
+void PerfStats::AddCreatureAISample(uint32 entry, uint32 lowGuid, uint32 time)
+{
+    if (time < PERF_TOP_MIN_TIME)
+        return;
+
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    m_currentTick.creatureAIs.Add(PerfSample(entry, lowGuid, time));
+}
+
+void PerfStats::AddObjectUpdateSample(uint32 objects, uint32 packets, uint32 bufferGrowths)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    ++m_objectUpdates.sends;
+    m_objectUpdates.objects += objects;
+    m_objectUpdates.packets += packets;
+    m_objectUpdates.bufferGrowths += bufferGrowths;
+}
+
+void PerfStats::AddCompressionSample(bool createObject, uint32 rawSize, uint32 compressedSize, uint32 time)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    PerfCompression& compression = m_compression[createObject ? 1 : 0];
+    ++compression.packets;
+    compression.rawBytes += rawSize;
+    compression.compressedBytes += compressedSize;
+    compression.time += time;
+}
+
+void PerfStats::AddPlayerSaveSample(uint32 statements)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    ++m_playerSaves.saves;
+    m_playerSaves.statements += statements;
+    if (statements > m_playerSaves.maxStatements)
+        m_playerSaves.maxStatements = statements;
+}
+
+void PerfStats::AddHeaderCryptoSample(uint32 packets, uint32 time)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    ++m_headerCrypto.flushes;
+    m_headerCrypto.packets += packets;
+    m_headerCrypto.time += time;
+}
+
+void PerfStats::RegisterThreadOpcodes(PerfThreadOpcodes* counters)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    m_threadOpcodes.push_back(counters);
+}
+
+void PerfStats::UnregisterThreadOpcodes(PerfThreadOpcodes* counters)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    MergeThreadOpcodes(*counters);
+    m_threadOpcodes.erase(std::remove(m_threadOpcodes.begin(), m_threadOpcodes.end(), counters), m_threadOpcodes.end());
+}
+
+void PerfStats::MergeThreadOpcodes(PerfThreadOpcodes& counters)
+{
+    if (!counters.m_used)
+        return;
+
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        if (!counters.m_counters[i].count)
+            continue;
+
+        m_opcodes[i].Add(counters.m_counters[i]);
+        counters.m_counters[i] = PerfOpcodeCounter();
+    }
+
+    counters.m_used = false;
+}
+
+void PerfStats::BuildOpcodeReport(std::vector<std::string>& lines, uint32 limit)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    std::multimap<uint64, uint32> byTime;
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+        if (m_opcodes[i].count)
+            byTime.insert(std::pair<uint64, uint32>(m_opcodes[i].totalTime, i));
+
+    if (byTime.empty())
+    {
+        lines.push_back("No opcode handler statistics collected.");
+        return;
+    }
+
+    char buf[256];
+    snprintf(buf, sizeof(buf), "Opcode handler cost of the last %u seconds (times in microseconds):",
+             m_windowStart ? uint32((GetMicroTime() - m_windowStart) / 1000000) : 0);
+    lines.push_back(buf);
+
+    lines.push_back("  opcode                              count      total      avg      max      bytes");
+    uint32 count = 0;
+    for (std::multimap<uint64, uint32>::reverse_iterator itr = byTime.rbegin(); itr != byTime.rend() && (!limit || count < limit); ++itr, ++count)
+    {
+        PerfOpcodeCounter const& counter = m_opcodes[itr->second];
+
+        // UI64FMTD contains the '%', the 64 bit columns are formatted first and padded as strings
+        char totalTime[24];
+        char bytes[24];
+        snprintf(totalTime, sizeof(totalTime), UI64FMTD, counter.totalTime);
+        snprintf(bytes, sizeof(bytes), UI64FMTD, counter.bytes);
+
+        snprintf(buf, sizeof(buf), "  %-32s %8u %10s %8u %8u %10s", LookupOpcodeName(uint16(itr->second)), counter.count,
+                 totalTime, uint32(counter.totalTime / counter.count), counter.maxTime, bytes);
+        lines.push_back(buf);
+    }
+}
+
+void PerfStats::BuildReport(std::vector<std::string>& lines)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    char buf[256];
+
+    if (!m_enabled)
+        lines.push_back("Performance statistics are disabled (PerfStats.Enable = 0), showing old data");
+
+    snprintf(buf, sizeof(buf), "Performance statistics of the last %u seconds (times in microseconds):",
+             m_windowStart ? uint32((GetMicroTime() - m_windowStart) / 1000000) : 0);
+    lines.push_back(buf);
+
+    lines.push_back("  stage          count      avg      p50      p99      max");
+    for (uint32 i = 0; i < MAX_PERF_STAGES; ++i)
+    {
+        PerfHistogram const& hist = m_stages[i];
+        if (!hist.GetCount())
+            continue;
+
+        snprintf(buf, sizeof(buf), "  %-13s %6u %8u %8u %8u %8u", perfStageNames[i], hist.GetCount(),
+                 hist.GetAverage(), hist.GetPercentile(50), hist.GetPercentile(99), hist.GetMax());
+        lines.push_back(buf);
+    }
+
+    if (!m_maps.empty())
+    {
+        // slowest maps first
+        std::multimap<uint32, MapHistograms::const_iterator> byMax;
+        for (MapHistograms::const_iterator itr = m_maps.begin(); itr != m_maps.end(); ++itr)
+            byMax.insert(std::pair<uint32, MapHistograms::const_iterator>(itr->second.GetMax(), itr));
+
+        lines.push_back("  map   instance  count      avg      p50      p99      max");
+        uint32 count = 0;
+        for (std::multimap<uint32, MapHistograms::const_iterator>::reverse_iterator itr = byMax.rbegin(); itr != byMax.rend() && count < PERF_REPORT_MAX_MAPS; ++itr, ++count)
+        {
+            PerfHistogram const& hist = itr->second->second;
+            snprintf(buf, sizeof(buf), "  %-5u %8u %6u %8u %8u %8u %8u", uint32(itr->second->first >> 32), uint32(itr->second->first & 0xFFFFFFFF),
+                     hist.GetCount(), hist.GetAverage(), hist.GetPercentile(50), hist.GetPercentile(99), hist.GetMax());
+            lines.push_back(buf);
+        }
+    }
+
+    if (m_objectUpdates.sends)
+    {
+        snprintf(buf, sizeof(buf), "Object updates: %u map sends, %u objects and %u packets per send, " UI64FMTD " buffer growths",
+                 m_objectUpdates.sends, uint32(m_objectUpdates.objects / m_objectUpdates.sends),
+                 uint32(m_objectUpdates.packets / m_objectUpdates.sends), m_objectUpdates.bufferGrowths);
+        lines.push_back(buf);
+    }
+
+    char const* compressionNames[2] = { "update", "create object" };
+    for (uint32 i = 0; i < 2; ++i)
+    {
+        PerfCompression const& compression = m_compression[i];
+        if (!compression.packets)
+            continue;
+
+        snprintf(buf, sizeof(buf), "Compressed %s packets: %u, avg %u -> %u bytes (%u%%), avg %u us",
+                 compressionNames[i], compression.packets, uint32(compression.rawBytes / compression.packets),
+                 uint32(compression.compressedBytes / compression.packets),
+                 compression.rawBytes ? uint32(compression.compressedBytes * 100 / compression.rawBytes) : 0,
+                 uint32(compression.time / compression.packets));
+        lines.push_back(buf);
+    }
+
+    if (m_playerSaves.saves)
+    {
+        snprintf(buf, sizeof(buf), "Player saves: %u, avg %u max %u SQL writes per save", m_playerSaves.saves,
+                 uint32(m_playerSaves.statements / m_playerSaves.saves), m_playerSaves.maxStatements);
+        lines.push_back(buf);
+    }
+
+    if (m_headerCrypto.packets)
+    {
+        snprintf(buf, sizeof(buf), "Header crypto: " UI64FMTD " packets in %u socket writes, avg %u ns per packet",
+                 m_headerCrypto.packets, m_headerCrypto.flushes, uint32(m_headerCrypto.time / m_headerCrypto.packets));
+        lines.push_back(buf);
+    }
+
+    PlayerSaveStats saveStats;
+    sPlayerSaveScheduler.GetStatistic(saveStats);
+    if (saveStats.scheduledSaves || saveStats.directSaves || saveStats.backlog)
+    {
+        snprintf(buf, sizeof(buf), "Player save queue: %u queued (oldest %u ms), %u scheduled and %u direct saves, " UI64FMTD " bytes, lag avg %u max %u ms",
+                 saveStats.backlog, saveStats.lag, saveStats.scheduledSaves, saveStats.directSaves, saveStats.bytes,
+                 saveStats.scheduledSaves ? uint32(saveStats.totalLag / saveStats.scheduledSaves) : 0, saveStats.maxLag);
+        lines.push_back(buf);
+    }
+
+    AddNetworkLines(lines, m_networkBase, m_processBase, m_windowStart ? GetMicroTime() - m_windowStart : 0);
+
+    Database* databases[3] = { &WorldDatabase, &CharacterDatabase, &LoginDatabase };
+    char const* databaseNames[3] = { "World", "Character", "Login" };
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        SqlDelayQueueStats stats;
+        databases[i]->GetAsyncStats(stats);
+        if (!stats.executed)
+            continue;
+
+        snprintf(buf, sizeof(buf), "%s DB async: %u connections, %u executed, queue %u (max %u), wait avg %u max %u ms, exec avg %u max %u ms",
+                 databaseNames[i], databases[i]->GetAsyncConnectionCount(), stats.executed, stats.depth, stats.maxDepth,
+                 uint32(stats.totalWait / stats.executed), stats.maxWait, uint32(stats.totalExec / stats.executed), stats.maxExec);
+        lines.push_back(buf);
+    }
+
+    PerfTickTop const* ticks[2] = { &m_worstTick, &m_lastTick };
+    char const* tickNames[2] = { "Slowest tick", "Last tick" };
+    for (uint32 t = 0; t < 2; ++t)
+    {
+        PerfTickTop const& tick = *ticks[t];
+        if (!tick.tickTime)
+            continue;
+
+        snprintf(buf, sizeof(buf), "%s: %u us", tickNames[t], tick.tickTime);
+        lines.push_back(buf);
+
+        AddTopListLines(lines, tick.maps, PERF_TOP_MAPS);
+        AddTopListLines(lines, tick.opcodes, PERF_TOP_OPCODES);
+        AddTopListLines(lines, tick.creatureAIs, PERF_TOP_CREATURE_AIS);
+    }
+}
+
+void PerfStats::Reset()
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    for (uint32 i = 0; i < MAX_PERF_STAGES; ++i)
+        m_stages[i].Reset();
+
+    m_maps.clear();
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+        m_opcodes[i] = PerfOpcodeCounter();
+    m_objectUpdates = PerfObjectUpdates();
+    m_compression[0] = PerfCompression();
+    m_compression[1] = PerfCompression();
+    m_playerSaves = PerfPlayerSaves();
+    m_headerCrypto = PerfHeaderCrypto();
+    sPlayerSaveScheduler.ResetStatistic();
+    WorldDatabase.ResetAsyncStats();
+    CharacterDatabase.ResetAsyncStats();
+    LoginDatabase.ResetAsyncStats();
+    m_lastTick.Clear();
+    m_worstTick.Clear();
+    m_windowStart = GetMicroTime();
+    sWorldSocketMgr->GetNetworkStats(m_networkBase);
+    GetProcessUsage(m_processBase);
+}
+
+void PerfStats::WriteDump()
+{
+    std::vector<std::string> lines;
+    BuildReport(lines);
+    BuildOpcodeReport(lines, 0);
+    Reset();
+
+    FILE* file = fopen(m_dumpFile.c_str(), "a");
+    if (!file)
+    {
+        sLog.outError("PerfStats: can't open dump file %s", m_dumpFile.c_str());
+        return;
+    }
+
+    fprintf(file, "=== %s ===\n", Log::GetTimestampStr().c_str());
+    for (std::vector<std::string>::const_iterator itr = lines.begin(); itr != lines.end(); ++itr)
+        fprintf(file, "%s\n", itr->c_str());
+    fprintf(file, "\n");
+
+    fclose(file);
+}
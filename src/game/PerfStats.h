@@ -0,0 +1,312 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PERFSTATS_H
+#define MANGOS_PERFSTATS_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "Opcodes.h"
+#include "WorldSocketMgr.h"
+#include <ace/Thread_Mutex.h>
+#include <map>
+#include <string>
+#include <vector>
+
+/// Parts of World::Update that are timed separately
+enum PerfStage
+{
+    PERF_STAGE_TICK             = 0,                        // whole World::Update
+    PERF_STAGE_AUCTIONS         = 1,
+    PERF_STAGE_AHBOT            = 2,
+    PERF_STAGE_SESSIONS         = 3,
+    PERF_STAGE_WEATHERS         = 4,
+    PERF_STAGE_MAPS             = 5,
+    PERF_STAGE_BATTLEGROUNDS    = 6,
+    PERF_STAGE_OUTDOORPVP       = 7,
+    PERF_STAGE_ELUNA            = 8,
+    PERF_STAGE_RESULT_QUEUE     = 9,
+    PERF_STAGE_GAME_EVENTS      = 10,
+    PERF_STAGE_REMOVE_LIST      = 11,
+    PERF_STAGE_CLI_COMMANDS     = 12,
+    PERF_STAGE_TERRAIN          = 13,
+    PERF_STAGE_PLAYER_SAVES     = 14,
+};
+
+#define MAX_PERF_STAGES           15
+
+#define PERF_HISTOGRAM_BUCKETS    32                        // power of two microsecond buckets, up to ~35 minutes
+#define PERF_TOP_COUNT            5                         // slowest maps/opcodes/creature AIs kept per tick
+#define PERF_TOP_MIN_TIME         100                       // microseconds, faster opcodes/AI updates are not tracked
+
+/// Log2 bucketed latency histogram in microseconds, percentiles are accurate to a factor of two
+class PerfHistogram
+{
+    public:
+        PerfHistogram() { Reset(); }
+
+        void Add(uint32 time);
+        void Reset();
+
+        uint32 GetCount() const { return m_count; }
+        uint32 GetMax() const { return m_max; }
+        uint32 GetAverage() const { return m_count ? uint32(m_total / m_count) : 0; }
+        uint32 GetPercentile(uint32 percent) const;
+
+    private:
+        uint32 m_buckets[PERF_HISTOGRAM_BUCKETS];
+        uint32 m_count;
+        uint32 m_max;
+        uint64 m_total;
+};
+
+struct PerfSample
+{
+    PerfSample() : id(0), param(0), time(0) {}
+    PerfSample(uint32 _id, uint32 _param, uint32 _time) : id(_id), param(_param), time(_time) {}
+
+    uint32 id;                                              // map id, opcode or creature entry
+    uint32 param;                                           // instance id, account id or creature low guid
+    uint32 time;                                            // microseconds
+};
+
+/// The PERF_TOP_COUNT slowest samples, ordered slowest first
+class PerfTopList
+{
+    public:
+        PerfTopList() : m_size(0) {}
+
+        void Add(PerfSample const& sample);
+        void Clear() { m_size = 0; }
+
+        uint32 GetSize() const { return m_size; }
+        PerfSample const& operator[](uint32 idx) const { return m_samples[idx]; }
+
+    private:
+        PerfSample m_samples[PERF_TOP_COUNT];
+        uint32 m_size;
+};
+
+/// Cost of one opcode handler
+struct PerfOpcodeCounter
+{
+    PerfOpcodeCounter() : count(0), maxTime(0), totalTime(0), bytes(0) {}
+
+    void Add(PerfOpcodeCounter const& other)
+    {
+        count += other.count;
+        totalTime += other.totalTime;
+        bytes += other.bytes;
+        if (other.maxTime > maxTime)
+            maxTime = other.maxTime;
+    }
+
+    uint32 count;
+    uint32 maxTime;                                         // microseconds
+    uint64 totalTime;                                       // microseconds
+    uint64 bytes;                                           // received packet body bytes
+};
+
+/// Totals of Map::SendObjectUpdates
+struct PerfObjectUpdates
+{
+    PerfObjectUpdates() : sends(0), objects(0), packets(0), bufferGrowths(0) {}
+
+    uint32 sends;
+    uint64 objects;                                         // objects with changed update fields
+    uint64 packets;                                         // update packets sent to players
+    uint64 bufferGrowths;                                   // heap allocations of the update buffers
+};
+
+/// Totals of Player::SaveToDB transactions
+struct PerfPlayerSaves
+{
+    PerfPlayerSaves() : saves(0), statements(0), maxStatements(0) {}
+
+    uint32 saves;
+    uint64 statements;                                      // SQL writes in the save transactions
+    uint32 maxStatements;
+};
+
+/// Totals of compressed update packets
+struct PerfCompression
+{
+    PerfCompression() : packets(0), rawBytes(0), compressedBytes(0), time(0) {}
+
+    uint32 packets;
+    uint64 rawBytes;
+    uint64 compressedBytes;
+    uint64 time;                                            // microseconds
+};
+
+/// Totals of the send header encryption of the network threads
+struct PerfHeaderCrypto
+{
+    PerfHeaderCrypto() : flushes(0), packets(0), time(0) {}
+
+    uint32 flushes;                                         // batches encrypted before a socket write
+    uint64 packets;
+    uint64 time;                                            // nanoseconds
+};
+
+/// CPU use of the whole process, from getrusage
+struct PerfProcessUsage
+{
+    PerfProcessUsage() : userTime(0), systemTime(0), voluntarySwitches(0), involuntarySwitches(0) {}
+
+    uint64 userTime;                                        // microseconds
+    uint64 systemTime;                                      // microseconds
+    uint64 voluntarySwitches;                               // context switches while waiting
+    uint64 involuntarySwitches;                             // context switches by the scheduler
+};
+
+class PerfThreadOpcodes;
+
+/// Slowest samples of one tick
+struct PerfTickTop
+{
+    PerfTickTop() : tickTime(0) {}
+
+    void Clear()
+    {
+        tickTime = 0;
+        maps.Clear();
+        opcodes.Clear();
+        creatureAIs.Clear();
+    }
+
+    uint32 tickTime;
+    PerfTopList maps;
+    PerfTopList opcodes;
+    PerfTopList creatureAIs;
+};
+
+/**
+ * Latency statistics of the world tick, collected when PerfStats.Enable is set.
+ *
+ * Histograms are collected for a window that is reset at every dump to PerfStats.DumpFile
+ * (each PerfStats.DumpInterval) and by ".server perf reset". Map, opcode and creature AI
+ * samples may be added from map update threads.
+ *
+ * Opcode handler counters are collected without locks in a per thread table and merged into
+ * the window at the end of each tick, when no session is updated by any thread.
+ */
+class PerfStats
+{
+    public:
+        PerfStats();
+
+        void Initialize(bool enabled, uint32 dumpInterval, std::string const& dumpFile);
+        bool IsEnabled() const { return m_enabled; }
+
+        /// Monotonic time in microseconds
+        static uint64 GetMicroTime();
+
+        void StartTick();
+        void FinishTick();
+
+        void AddStageSample(PerfStage stage, uint32 time);
+        void AddMapSample(uint32 mapId, uint32 instanceId, uint32 time);
+        void AddOpcodeSample(uint16 opcode, uint32 accountId, uint32 time, uint32 bytes);
+        void AddCreatureAISample(uint32 entry, uint32 lowGuid, uint32 time);
+        void AddObjectUpdateSample(uint32 objects, uint32 packets, uint32 bufferGrowths);
+        void AddCompressionSample(bool createObject, uint32 rawSize, uint32 compressedSize, uint32 time);
+        void AddPlayerSaveSample(uint32 statements);
+        void AddHeaderCryptoSample(uint32 packets, uint32 time);
+
+        void BuildReport(std::vector<std::string>& lines);
+        /// Opcodes ordered by total handler time, limit 0 for all opcodes
+        void BuildOpcodeReport(std::vector<std::string>& lines, uint32 limit);
+        void Reset();
+
+    private:
+        friend class PerfThreadOpcodes;
+
+        typedef std::vector<PerfThreadOpcodes*> ThreadOpcodesList;
+
+        void RegisterThreadOpcodes(PerfThreadOpcodes* counters);
+        void UnregisterThreadOpcodes(PerfThreadOpcodes* counters);
+        // must be called with m_lock held
+        void MergeThreadOpcodes(PerfThreadOpcodes& counters);
+
+        typedef std::map<uint64, PerfHistogram> MapHistograms;  // (mapId << 32 | instanceId) -> histogram
+
+        void WriteDump();
+
+        bool m_enabled;
+        uint32 m_dumpInterval;
+        uint64 m_lastDumpTime;                              // GetMicroTime() at last dump
+        std::string m_dumpFile;
+
+        ACE_Thread_Mutex m_lock;
+        uint64 m_windowStart;                               // GetMicroTime() at last reset
+        uint64 m_tickStart;
+        PerfHistogram m_stages[MAX_PERF_STAGES];
+        MapHistograms m_maps;
+        PerfTickTop m_currentTick;
+        PerfTickTop m_lastTick;
+        PerfTickTop m_worstTick;                            // slowest tick of the window
+        PerfOpcodeCounter m_opcodes[NUM_MSG_TYPES];
+        PerfObjectUpdates m_objectUpdates;
+        PerfCompression m_compression[2];                   // other packets, packets with create object blocks
+        PerfPlayerSaves m_playerSaves;
+        PerfHeaderCrypto m_headerCrypto;
+        ThreadOpcodesList m_threadOpcodes;
+
+        // counters that are never reset, the report shows the change since the window start
+        std::vector<NetworkThreadStats> m_networkBase;
+        PerfProcessUsage m_processBase;
+};
+
+#define sPerfStats MaNGOS::Singleton<PerfStats>::Instance()
+
+/// Adds the time until the end of the scope to a PerfStats stage
+class PerfStageTimer
+{
+    public:
+        explicit PerfStageTimer(PerfStage stage) : m_stage(stage), m_start(sPerfStats.IsEnabled() ? PerfStats::GetMicroTime() : 0) {}
+        ~PerfStageTimer()
+        {
+            if (m_start)
+                sPerfStats.AddStageSample(m_stage, uint32(PerfStats::GetMicroTime() - m_start));
+        }
+
+    private:
+        PerfStage m_stage;
+        uint64 m_start;
+};
+
+/// Adds the time until the end of the scope to the map statistics
+class PerfMapTimer
+{
+    public:
+        PerfMapTimer(uint32 mapId, uint32 instanceId) : m_mapId(mapId), m_instanceId(instanceId),
+            m_start(sPerfStats.IsEnabled() ? PerfStats::GetMicroTime() : 0) {}
+        ~PerfMapTimer()
+        {
+            if (m_start)
+                sPerfStats.AddMapSample(m_mapId, m_instanceId, uint32(PerfStats::GetMicroTime() - m_start));
+        }
+
+    private:
+        uint32 m_mapId;
+        uint32 m_instanceId;
+        uint64 m_start;
+};
+
+#endif
@@ -253,7 +253,7 @@ bool Pet::LoadPetFromDB(Player* owner, uint32 petentry, uint32 petnumber, bool c
     // PET_SAVE_NOT_IN_SLOT(100) = not stable slot (summoning))
     if (fields[10].GetUInt32() != 0)
     {
-        CharacterDatabase.BeginTransaction();
+        CharacterDatabase.BeginTransaction(owner->GetObjectGuid().GetRawValue());
 
         static SqlStatementID id_1;
         static SqlStatementID id_2;
@@ -387,8 +387,8 @@ void Pet::SavePetToDB(PetSaveMode mode)
         if (mode != PET_SAVE_AS_CURRENT)
             RemoveAllAuras();
 
-        // save pet's data as one single transaction
-        CharacterDatabase.BeginTransaction();
+        // save pet's data as one single transaction, ordered with the owner's saves
+        CharacterDatabase.BeginTransaction(pOwner->GetObjectGuid().GetRawValue());
         _SaveSpells();
         _SaveSpellCooldowns();
         _SaveAuras();
@@ -475,14 +475,14 @@ void Pet::SavePetToDB(PetSaveMode mode)
     else
     {
         RemoveAllAuras(AURA_REMOVE_BY_DELETE);
-        DeleteFromDB(m_charmInfo->GetPetNumber());
+        DeleteFromDB(m_charmInfo->GetPetNumber(), true, pOwner->GetObjectGuid());
     }
 }
 
-void Pet::DeleteFromDB(uint32 guidlow, bool separate_transaction)
+void Pet::DeleteFromDB(uint32 guidlow, bool separate_transaction, ObjectGuid ownerGuid)
 {
     if (separate_transaction)
-        CharacterDatabase.BeginTransaction();
+        CharacterDatabase.BeginTransaction(ownerGuid.GetRawValue());
 
     static SqlStatementID delPet ;
     static SqlStatementID delAuras ;
@@ -1355,11 +1355,12 @@ void Pet::_LoadSpellCooldowns()
 void Pet::_SaveSpellCooldowns()
 {
     static SqlStatementID delSpellCD ;
-    static SqlStatementID insSpellCD ;
 
     SqlStatement stmt = CharacterDatabase.CreateStatement(delSpellCD, "DELETE FROM pet_spell_cooldown WHERE guid = ?");
     stmt.PExecute(m_charmInfo->GetPetNumber());
 
+    SqlBatchStatement batchIns(CharacterDatabase, "INSERT INTO pet_spell_cooldown (guid,spell,time) VALUES (?, ?, ?)");
+
     time_t curTime = time(NULL);
 
     // remove oudated and save active
@@ -1369,8 +1370,7 @@ void Pet::_SaveSpellCooldowns()
             m_CreatureSpellCooldowns.erase(itr++);
         else
         {
-            stmt = CharacterDatabase.CreateStatement(insSpellCD, "INSERT INTO pet_spell_cooldown (guid,spell,time) VALUES (?, ?, ?)");
-            stmt.PExecute(m_charmInfo->GetPetNumber(), itr->first, uint64(itr->second));
+            batchIns.AddRow(m_charmInfo->GetPetNumber(), itr->first, uint64(itr->second));
             ++itr;
         }
     }
@@ -1397,7 +1397,9 @@ void Pet::_LoadSpells()
 void Pet::_SaveSpells()
 {
     static SqlStatementID delSpell ;
-    static SqlStatementID insSpell ;
+
+    // rows are sent after the deletes of changed spells
+    SqlBatchStatement batchIns(CharacterDatabase, "INSERT INTO pet_spell (guid,spell,active) VALUES (?, ?, ?)");
 
     for (PetSpellMap::iterator itr = m_spells.begin(), next = m_spells.begin(); itr != m_spells.end(); itr = next)
     {
@@ -1421,16 +1423,12 @@ void Pet::_SaveSpells()
                 SqlStatement stmt = CharacterDatabase.CreateStatement(delSpell, "DELETE FROM pet_spell WHERE guid = ? and spell = ?");
                 stmt.PExecute(m_charmInfo->GetPetNumber(), itr->first);
 
-                stmt = CharacterDatabase.CreateStatement(insSpell, "INSERT INTO pet_spell (guid,spell,active) VALUES (?, ?, ?)");
-                stmt.PExecute(m_charmInfo->GetPetNumber(), itr->first, uint32(itr->second.active));
+                batchIns.AddRow(m_charmInfo->GetPetNumber(), itr->first, uint32(itr->second.active));
             }
             break;
             case PETSPELL_NEW:
-            {
-                SqlStatement stmt = CharacterDatabase.CreateStatement(insSpell, "INSERT INTO pet_spell (guid,spell,active) VALUES (?, ?, ?)");
-                stmt.PExecute(m_charmInfo->GetPetNumber(), itr->first, uint32(itr->second.active));
-            }
-            break;
+                batchIns.AddRow(m_charmInfo->GetPetNumber(), itr->first, uint32(itr->second.active));
+                break;
             case PETSPELL_UNCHANGED:
                 continue;
         }
@@ -1532,7 +1530,6 @@ void Pet::_LoadAuras(uint32 timediff)
 void Pet::_SaveAuras()
 {
     static SqlStatementID delAuras ;
-    static SqlStatementID insAuras ;
 
     SqlStatement stmt = CharacterDatabase.CreateStatement(delAuras, "DELETE FROM pet_aura WHERE guid = ?");
     stmt.PExecute(m_charmInfo->GetPetNumber());
@@ -1542,9 +1539,9 @@ void Pet::_SaveAuras()
     if (auraHolders.empty())
         return;
 
-    stmt = CharacterDatabase.CreateStatement(insAuras, "INSERT INTO pet_aura (guid, caster_guid, item_guid, spell, stackcount, remaincharges, "
-            "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask) "
-            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    SqlBatchStatement batchIns(CharacterDatabase, "INSERT INTO pet_aura (guid, caster_guid, item_guid, spell, stackcount, remaincharges, "
+                               "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask) "
+                               "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
 
     for (SpellAuraHolderMap::const_iterator itr = auraHolders.begin(); itr != auraHolders.end(); ++itr)
     {
@@ -1590,23 +1587,22 @@ void Pet::_SaveAuras()
             if (!effIndexMask)
                 continue;
 
-            stmt.addUInt32(m_charmInfo->GetPetNumber());
-            stmt.addUInt64(holder->GetCasterGuid().GetRawValue());
-            stmt.addUInt32(holder->GetCastItemGuid().GetCounter());
-            stmt.addUInt32(holder->GetId());
-            stmt.addUInt32(holder->GetStackAmount());
-            stmt.addUInt8(holder->GetAuraCharges());
+            batchIns.addUInt32(m_charmInfo->GetPetNumber());
+            batchIns.addUInt64(holder->GetCasterGuid().GetRawValue());
+            batchIns.addUInt32(holder->GetCastItemGuid().GetCounter());
+            batchIns.addUInt32(holder->GetId());
+            batchIns.addUInt32(holder->GetStackAmount());
+            batchIns.addUInt8(holder->GetAuraCharges());
 
             for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
-                stmt.addInt32(damage[i]);
+                batchIns.addInt32(damage[i]);
 
             for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
-                stmt.addUInt32(periodicTime[i]);
+                batchIns.addUInt32(periodicTime[i]);
 
-            stmt.addInt32(holder->GetAuraMaxDuration());
-            stmt.addInt32(holder->GetAuraDuration());
-            stmt.addUInt32(effIndexMask);
-            stmt.Execute();
+            batchIns.addInt32(holder->GetAuraMaxDuration());
+            batchIns.addInt32(holder->GetAuraDuration());
+            batchIns.addUInt32(effIndexMask);
         }
     }
 }
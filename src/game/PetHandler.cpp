@@ -485,7 +485,7 @@ void WorldSession::HandlePetRename(WorldPacket& recv_data)
 
     pet->RemoveFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_RENAME);
 
-    CharacterDatabase.BeginTransaction();
+    CharacterDatabase.BeginTransaction(_player->GetObjectGuid().GetRawValue());
     CharacterDatabase.escape_string(name);
     CharacterDatabase.PExecute("UPDATE character_pet SET name = '%s', renamed = '1' WHERE owner = '%u' AND id = '%u'", name.c_str(), _player->GetGUIDLow(), pet->GetCharmInfo()->GetPetNumber());
     CharacterDatabase.CommitTransaction();
@@ -61,6 +61,8 @@
 #include "DBCStores.h"
 #include "SQLStorages.h"
 #include "LuaEngine.h"
+#include "PerfStats.h"
+#include "PlayerSaveScheduler.h"
 
 #include <cmath>
 
@@ -403,6 +405,11 @@ Player::Player(WorldSession* session): Unit(), m_mover(this), m_camera(this), m_
     // this must help in case next save after mass player load after server startup
     m_nextSave = urand(m_nextSave / 2, m_nextSave * 3 / 2);
 
+    m_characterRowSaved = false;
+    m_savedAurasValid = true;
+    m_statsSaved = false;
+    memset(m_savedStats, 0, sizeof(m_savedStats));
+
     clearResurrectRequestData();
 
     m_SpellModRemoveCount = 0;
@@ -1229,11 +1236,9 @@ void Player::Update(uint32 update_diff, uint32 p_time)
     {
         if (update_diff >= m_nextSave)
         {
-            // m_nextSave reseted in SaveToDB call
-            // used by eluna
-            sEluna->OnSave(this);
-            SaveToDB();
-            DETAIL_LOG("Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
+            // the save is done by the scheduler to spread the DB load, m_nextSave reseted in SaveToDB call
+            m_nextSave = sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE);
+            sPlayerSaveScheduler.RequestSave(GetObjectGuid());
         }
         else
             m_nextSave -= update_diff;
@@ -3306,11 +3311,12 @@ void Player::_LoadSpellCooldowns(QueryResult* result)
 void Player::_SaveSpellCooldowns()
 {
     static SqlStatementID deleteSpellCooldown ;
-    static SqlStatementID insertSpellCooldown ;
 
     SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldown, "DELETE FROM character_spell_cooldown WHERE guid = ?");
     stmt.PExecute(GetGUIDLow());
 
+    SqlBatchStatement batchIns(CharacterDatabase, "INSERT INTO character_spell_cooldown (guid,spell,item,time) VALUES( ?, ?, ?, ?)");
+
     time_t curTime = time(NULL);
     time_t infTime = curTime + infinityCooldownDelayCheck;
 
@@ -3321,8 +3327,7 @@ void Player::_SaveSpellCooldowns()
             m_spellCooldowns.erase(itr++);
         else if (itr->second.end <= infTime)                // not save locked cooldowns, it will be reset or set at reload
         {
-            stmt = CharacterDatabase.CreateStatement(insertSpellCooldown, "INSERT INTO character_spell_cooldown (guid,spell,item,time) VALUES( ?, ?, ?, ?)");
-            stmt.PExecute(GetGUIDLow(), itr->first, itr->second.itemid, uint64(itr->second.end));
+            batchIns.AddRow(GetGUIDLow(), itr->first, itr->second.itemid, uint64(itr->second.end));
             ++itr;
         }
         else
@@ -13273,6 +13278,8 @@ bool Player::LoadFromDB(ObjectGuid guid, SqlQueryHolder* holder)
     // overwrite possible wrong/corrupted guid
     SetGuidValue(OBJECT_FIELD_GUID, guid);
 
+    m_characterRowSaved = true;
+
     // overwrite some data fields
     SetByteValue(UNIT_FIELD_BYTES_0, 0, fields[3].GetUInt8()); // race
     SetByteValue(UNIT_FIELD_BYTES_0, 1, fields[4].GetUInt8()); // class
@@ -13846,6 +13853,16 @@ void Player::_LoadAuras(QueryResult* result, uint32 timediff)
             int32 remaintime = fields[12].GetInt32();
             uint32 effIndexMask = fields[13].GetUInt32();
 
+            // remember the row as stored, the next save only writes the differences
+            SavedAuraData& saved = m_savedAuras[SavedAuraKey(caster_guid.GetRawValue(), item_lowguid, spellid)];
+            saved.stackCount = stackcount;
+            saved.charges = uint8(remaincharges);
+            memcpy(saved.basePoints, damage, sizeof(saved.basePoints));
+            memcpy(saved.periodicTime, periodicTime, sizeof(saved.periodicTime));
+            saved.maxDuration = maxduration;
+            saved.remainTime = remaintime;
+            saved.effIndexMask = effIndexMask;
+
             SpellEntry const* spellproto = sSpellStore.LookupEntry(spellid);
             if (!spellproto)
             {
@@ -14718,127 +14735,151 @@ void Player::SaveToDB()
     DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "The value of player %s at save: ", m_name.c_str());
     outDebugStatsValues();
 
-    CharacterDatabase.BeginTransaction();
+    // the baselines advance when the save is queued, after a rolled back save the rows are unknown
+    if (CharacterDatabase.TakeFailedTransaction(GetObjectGuid().GetRawValue()))
+    {
+        sLog.outError("Player::SaveToDB: a save of %s failed, writing all character rows again.", GetGuidStr().c_str());
+        ResetSaveBaselines();
+    }
+
+    // only this character's rows, saves of different characters may be written in parallel
+    CharacterDatabase.BeginTransaction(GetObjectGuid().GetRawValue());
 
     UpdateHonor();
 
     static SqlStatementID delChar ;
     static SqlStatementID insChar ;
-
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delChar, "DELETE FROM characters WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
-
-    SqlStatement uberInsert = CharacterDatabase.CreateStatement(insChar, "INSERT INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
-                              "map, position_x, position_y, position_z, orientation, "
-                              "taximask, online, cinematic, "
-                              "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
-                              "trans_x, trans_y, trans_z, trans_o, transguid, extra_flags, stable_slots, at_login, zone, "
-                              "death_expire_time, taxi_path, "
-                              "honor_highest_rank, honor_standing, stored_honor_rating , stored_dishonorable_kills, stored_honorable_kills, "
-                              "watchedFaction, drunk, health, power1, power2, power3, "
-                              "power4, power5, exploredZones, equipmentCache, ammoId, actionBars) "
-                              "VALUES ( ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?,"
-                              "?, ?, ?, ?, ?, "
-                              "?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, "
-                              "?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?) ");
-
-    uberInsert.addUInt32(GetGUIDLow());
-    uberInsert.addUInt32(GetSession()->GetAccountId());
-    uberInsert.addString(m_name);
-    uberInsert.addUInt8(getRace());
-    uberInsert.addUInt8(getClass());
-    uberInsert.addUInt8(getGender());
-    uberInsert.addUInt32(getLevel());
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_XP));
-    uberInsert.addUInt32(GetMoney());
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_BYTES));
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_BYTES_2));
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FLAGS));
+    static SqlStatementID updChar ;
+
+    // the row is only (re)created for a new character, later saves update it in place
+    SqlStatement uberSave = CharacterDatabase.CreateStatement(updChar, "UPDATE characters SET account = ?, name = ?, race = ?, class = ?, gender = ?, level = ?, xp = ?, money = ?, playerBytes = ?, playerBytes2 = ?, playerFlags = ?,"
+                            "map = ?, position_x = ?, position_y = ?, position_z = ?, orientation = ?, "
+                            "taximask = ?, online = ?, cinematic = ?, "
+                            "totaltime = ?, leveltime = ?, rest_bonus = ?, logout_time = ?, is_logout_resting = ?, resettalents_cost = ?, resettalents_time = ?, "
+                            "trans_x = ?, trans_y = ?, trans_z = ?, trans_o = ?, transguid = ?, extra_flags = ?, stable_slots = ?, at_login = ?, zone = ?, "
+                            "death_expire_time = ?, taxi_path = ?, "
+                            "honor_highest_rank = ?, honor_standing = ?, stored_honor_rating = ?, stored_dishonorable_kills = ?, stored_honorable_kills = ?, "
+                            "watchedFaction = ?, drunk = ?, health = ?, power1 = ?, power2 = ?, power3 = ?, "
+                            "power4 = ?, power5 = ?, exploredZones = ?, equipmentCache = ?, ammoId = ?, actionBars = ? "
+                            "WHERE guid = ?");
+
+    if (!m_characterRowSaved)
+    {
+        SqlStatement stmt = CharacterDatabase.CreateStatement(delChar, "DELETE FROM characters WHERE guid = ?");
+        stmt.PExecute(GetGUIDLow());
+
+        uberSave = CharacterDatabase.CreateStatement(insChar, "INSERT INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
+                   "map, position_x, position_y, position_z, orientation, "
+                   "taximask, online, cinematic, "
+                   "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
+                   "trans_x, trans_y, trans_z, trans_o, transguid, extra_flags, stable_slots, at_login, zone, "
+                   "death_expire_time, taxi_path, "
+                   "honor_highest_rank, honor_standing, stored_honor_rating , stored_dishonorable_kills, stored_honorable_kills, "
+                   "watchedFaction, drunk, health, power1, power2, power3, "
+                   "power4, power5, exploredZones, equipmentCache, ammoId, actionBars) "
+                   "VALUES ( ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?,"
+                   "?, ?, ?, ?, ?, "
+                   "?, ?, ?, "
+                   "?, ?, ?, ?, ?, ?, ?, "
+                   "?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                   "?, ?, "
+                   "?, ?, ?, ?, ?, "
+                   "?, ?, ?, ?, ?, ?, "
+                   "?, ?, ?, ?, ?, ?) ");
+
+        uberSave.addUInt32(GetGUIDLow());
+    }
+    uberSave.addUInt32(GetSession()->GetAccountId());
+    uberSave.addString(m_name);
+    uberSave.addUInt8(getRace());
+    uberSave.addUInt8(getClass());
+    uberSave.addUInt8(getGender());
+    uberSave.addUInt32(getLevel());
+    uberSave.addUInt32(GetUInt32Value(PLAYER_XP));
+    uberSave.addUInt32(GetMoney());
+    uberSave.addUInt32(GetUInt32Value(PLAYER_BYTES));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_BYTES_2));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_FLAGS));
 
     if (!IsBeingTeleported())
     {
-        uberInsert.addUInt32(GetMapId());
-        uberInsert.addFloat(finiteAlways(GetPositionX()));
-        uberInsert.addFloat(finiteAlways(GetPositionY()));
-        uberInsert.addFloat(finiteAlways(GetPositionZ()));
-        uberInsert.addFloat(finiteAlways(GetOrientation()));
+        uberSave.addUInt32(GetMapId());
+        uberSave.addFloat(finiteAlways(GetPositionX()));
+        uberSave.addFloat(finiteAlways(GetPositionY()));
+        uberSave.addFloat(finiteAlways(GetPositionZ()));
+        uberSave.addFloat(finiteAlways(GetOrientation()));
     }
     else
     {
-        uberInsert.addUInt32(GetTeleportDest().mapid);
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_x));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_y));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_z));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().orientation));
+        uberSave.addUInt32(GetTeleportDest().mapid);
+        uberSave.addFloat(finiteAlways(GetTeleportDest().coord_x));
+        uberSave.addFloat(finiteAlways(GetTeleportDest().coord_y));
+        uberSave.addFloat(finiteAlways(GetTeleportDest().coord_z));
+        uberSave.addFloat(finiteAlways(GetTeleportDest().orientation));
     }
 
     std::ostringstream ss;
     ss << m_taxi;                                   // string with TaxiMaskSize numbers
-    uberInsert.addString(ss);
+    uberSave.addString(ss);
 
-    uberInsert.addUInt32(IsInWorld() ? 1 : 0);
+    uberSave.addUInt32(IsInWorld() ? 1 : 0);
 
-    uberInsert.addUInt32(m_cinematic);
+    uberSave.addUInt32(m_cinematic);
 
-    uberInsert.addUInt32(m_Played_time[PLAYED_TIME_TOTAL]);
-    uberInsert.addUInt32(m_Played_time[PLAYED_TIME_LEVEL]);
+    uberSave.addUInt32(m_Played_time[PLAYED_TIME_TOTAL]);
+    uberSave.addUInt32(m_Played_time[PLAYED_TIME_LEVEL]);
 
-    uberInsert.addFloat(finiteAlways(m_rest_bonus));
-    uberInsert.addUInt64(uint64(time(NULL)));
-    uberInsert.addUInt32(HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING) ? 1 : 0);
+    uberSave.addFloat(finiteAlways(m_rest_bonus));
+    uberSave.addUInt64(uint64(time(NULL)));
+    uberSave.addUInt32(HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING) ? 1 : 0);
     // save, far from tavern/city
     // save, but in tavern/city
-    uberInsert.addUInt32(m_resetTalentsCost);
-    uberInsert.addUInt64(uint64(m_resetTalentsTime));
+    uberSave.addUInt32(m_resetTalentsCost);
+    uberSave.addUInt64(uint64(m_resetTalentsTime));
 
-    uberInsert.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->x));
-    uberInsert.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->y));
-    uberInsert.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->z));
-    uberInsert.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->o));
+    uberSave.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->x));
+    uberSave.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->y));
+    uberSave.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->z));
+    uberSave.addFloat(finiteAlways(m_movementInfo.GetTransportPos()->o));
     if (m_transport)
-        uberInsert.addUInt32(m_transport->GetGUIDLow());
+        uberSave.addUInt32(m_transport->GetGUIDLow());
     else
-        uberInsert.addUInt32(0);
+        uberSave.addUInt32(0);
 
-    uberInsert.addUInt32(m_ExtraFlags);
+    uberSave.addUInt32(m_ExtraFlags);
 
-    uberInsert.addUInt32(uint32(m_stableSlots));            // to prevent save uint8 as char
+    uberSave.addUInt32(uint32(m_stableSlots));            // to prevent save uint8 as char
 
-    uberInsert.addUInt32(uint32(m_atLoginFlags));
+    uberSave.addUInt32(uint32(m_atLoginFlags));
 
-    uberInsert.addUInt32(IsInWorld() ? GetZoneId() : GetCachedZoneId());
+    uberSave.addUInt32(IsInWorld() ? GetZoneId() : GetCachedZoneId());
 
-    uberInsert.addUInt64(uint64(m_deathExpireTime));
+    uberSave.addUInt64(uint64(m_deathExpireTime));
 
     ss << m_taxi.SaveTaxiDestinationsToString();       // string
-    uberInsert.addString(ss);
+    uberSave.addString(ss);
 
-    uberInsert.addUInt32(uint32(m_highest_rank.rank));
-    uberInsert.addInt32(m_standing_pos);
-    uberInsert.addFloat(finiteAlways(m_stored_honor));
-    uberInsert.addUInt32(m_stored_dishonorableKills);
-    uberInsert.addUInt32(m_stored_honorableKills);
+    uberSave.addUInt32(uint32(m_highest_rank.rank));
+    uberSave.addInt32(m_standing_pos);
+    uberSave.addFloat(finiteAlways(m_stored_honor));
+    uberSave.addUInt32(m_stored_dishonorableKills);
+    uberSave.addUInt32(m_stored_honorableKills);
 
     // FIXME: at this moment send to DB as unsigned, including unit32(-1)
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_WATCHED_FACTION_INDEX));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_FIELD_WATCHED_FACTION_INDEX));
 
-    uberInsert.addUInt16(uint16(GetUInt32Value(PLAYER_BYTES_3) & 0xFFFE));
+    uberSave.addUInt16(uint16(GetUInt32Value(PLAYER_BYTES_3) & 0xFFFE));
 
-    uberInsert.addUInt32(GetHealth());
+    uberSave.addUInt32(GetHealth());
 
     for (uint32 i = 0; i < MAX_POWERS; ++i)
-        uberInsert.addUInt32(GetPower(Powers(i)));
+        uberSave.addUInt32(GetPower(Powers(i)));
 
     for (uint32 i = 0; i < PLAYER_EXPLORED_ZONES_SIZE; ++i) // string
     {
         ss << GetUInt32Value(PLAYER_EXPLORED_ZONES_1 + i) << " ";
     }
-    uberInsert.addString(ss);
+    uberSave.addString(ss);
 
     for (uint32 i = 0; i < EQUIPMENT_SLOT_END; ++i)         // string: item id, ench (perm/temp)
     {
@@ -14848,13 +14889,17 @@ void Player::SaveToDB()
         uint32 ench2 = GetUInt32Value(PLAYER_VISIBLE_ITEM_1_0 + i * MAX_VISIBLE_ITEM_OFFSET + 1 + TEMP_ENCHANTMENT_SLOT);
         ss << uint32(MAKE_PAIR32(ench1, ench2)) << " ";
     }
-    uberInsert.addString(ss);
+    uberSave.addString(ss);
+
+    uberSave.addUInt32(GetUInt32Value(PLAYER_AMMO_ID));
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_AMMO_ID));
+    uberSave.addUInt32(uint32(GetByteValue(PLAYER_FIELD_BYTES, 2)));
 
-    uberInsert.addUInt32(uint32(GetByteValue(PLAYER_FIELD_BYTES, 2)));
+    if (m_characterRowSaved)
+        uberSave.addUInt32(GetGUIDLow());
 
-    uberInsert.Execute();
+    uberSave.Execute();
+    m_characterRowSaved = true;
 
     if (m_mailsUpdated)                                     // save mails only when needed
         _SaveMail();
@@ -14871,8 +14916,16 @@ void Player::SaveToDB()
     _SaveHonorCP();
     GetSession()->SaveTutorialsData();                      // changed only while character in game
 
+    uint32 writes = CharacterDatabase.GetTransactionSize();
+    uint32 bytes = CharacterDatabase.GetTransactionDataSize();
     CharacterDatabase.CommitTransaction();
 
+    sPlayerSaveScheduler.OnPlayerSaved(GetObjectGuid(), bytes);
+
+    DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "Player %s saved with %u SQL writes", m_name.c_str(), writes);
+    if (sPerfStats.IsEnabled())
+        sPerfStats.AddPlayerSaveSample(writes);
+
     // check if stats should only be saved on logout
     // save stats can be out of transaction
     if (m_session->isLogingOut() || !sWorld.getConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT))
@@ -14948,23 +15001,33 @@ void Player::_SaveActions()
     }
 }
 
-void Player::_SaveAuras()
+void Player::ResetSaveBaselines()
 {
-    static SqlStatementID deleteAuras ;
-    static SqlStatementID insertAuras ;
+    m_characterRowSaved = false;
+    m_savedAurasValid = false;
+    m_statsSaved = false;
+}
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAuras, "DELETE FROM character_aura WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
+void Player::_SaveAuras()
+{
+    static SqlStatementID deleteAura ;
+    static SqlStatementID deleteAllAuras ;
+    static SqlStatementID updateAura ;
 
-    SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
+    // rows unknown, remove them all and insert the current ones
+    if (!m_savedAurasValid)
+    {
+        SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAllAuras, "DELETE FROM character_aura WHERE guid = ?");
+        stmt.PExecute(GetGUIDLow());
 
-    if (auraHolders.empty())
-        return;
+        m_savedAuras.clear();
+        m_savedAurasValid = true;
+    }
 
-    stmt = CharacterDatabase.CreateStatement(insertAuras, "INSERT INTO character_aura (guid, caster_guid, item_guid, spell, stackcount, remaincharges, "
-            "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask) "
-            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    // rows the DB should hold after this save
+    SavedAuraMap auras;
 
+    SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
     for (SpellAuraHolderMap::const_iterator itr = auraHolders.begin(); itr != auraHolders.end(); ++itr)
     {
         SpellAuraHolder* holder = itr->second;
@@ -14975,14 +15038,13 @@ void Player::_SaveAuras()
         if (!holder->IsPassive() && !IsChanneledSpell(holder->GetSpellProto()) &&
                 (trackedType == TRACK_AURA_TYPE_NOT_TRACKED || (trackedType == TRACK_AURA_TYPE_SINGLE_TARGET && selfCastHolder)))
         {
-            int32  damage[MAX_EFFECT_INDEX];
-            uint32 periodicTime[MAX_EFFECT_INDEX];
-            uint32 effIndexMask = 0;
+            SavedAuraData data;
+            data.effIndexMask = 0;
 
             for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
             {
-                damage[i] = 0;
-                periodicTime[i] = 0;
+                data.basePoints[i] = 0;
+                data.periodicTime[i] = 0;
 
                 if (Aura* aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
                 {
@@ -14990,34 +15052,94 @@ void Player::_SaveAuras()
                     if (aur->IsAreaAura() && holder->GetCasterGuid() != GetObjectGuid())
                         continue;
 
-                    damage[i] = aur->GetModifier()->m_amount;
-                    periodicTime[i] = aur->GetModifier()->periodictime;
-                    effIndexMask |= (1 << i);
+                    data.basePoints[i] = aur->GetModifier()->m_amount;
+                    data.periodicTime[i] = aur->GetModifier()->periodictime;
+                    data.effIndexMask |= (1 << i);
                 }
             }
 
-            if (!effIndexMask)
+            if (!data.effIndexMask)
                 continue;
 
-            stmt.addUInt32(GetGUIDLow());
-            stmt.addUInt64(holder->GetCasterGuid().GetRawValue());
-            stmt.addUInt32(holder->GetCastItemGuid().GetCounter());
-            stmt.addUInt32(holder->GetId());
-            stmt.addUInt32(holder->GetStackAmount());
-            stmt.addUInt8(holder->GetAuraCharges());
+            data.stackCount = holder->GetStackAmount();
+            data.charges = uint8(holder->GetAuraCharges());
+            data.maxDuration = holder->GetAuraMaxDuration();
+            data.remainTime = holder->GetAuraDuration();
+
+            auras.insert(SavedAuraMap::value_type(SavedAuraKey(holder->GetCasterGuid().GetRawValue(), holder->GetCastItemGuid().GetCounter(), holder->GetId()), data));
+        }
+    }
+
+    // remove rows of auras that are gone
+    for (SavedAuraMap::const_iterator itr = m_savedAuras.begin(); itr != m_savedAuras.end(); ++itr)
+    {
+        if (auras.find(itr->first) != auras.end())
+            continue;
+
+        SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAura, "DELETE FROM character_aura WHERE guid = ? AND caster_guid = ? AND item_guid = ? AND spell = ?");
+        stmt.addUInt32(GetGUIDLow());
+        stmt.addUInt64(itr->first.casterGuid);
+        stmt.addUInt32(itr->first.itemGuid);
+        stmt.addUInt32(itr->first.spellId);
+        stmt.Execute();
+    }
+
+    SqlBatchStatement batchIns(CharacterDatabase, "INSERT INTO character_aura (guid, caster_guid, item_guid, spell, stackcount, remaincharges, "
+                               "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask) "
+                               "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+
+    // insert new and update changed rows
+    for (SavedAuraMap::const_iterator itr = auras.begin(); itr != auras.end(); ++itr)
+    {
+        SavedAuraData const& data = itr->second;
+
+        SavedAuraMap::const_iterator saved = m_savedAuras.find(itr->first);
+        if (saved == m_savedAuras.end())
+        {
+            batchIns.addUInt32(GetGUIDLow());
+            batchIns.addUInt64(itr->first.casterGuid);
+            batchIns.addUInt32(itr->first.itemGuid);
+            batchIns.addUInt32(itr->first.spellId);
+            batchIns.addUInt32(data.stackCount);
+            batchIns.addUInt8(uint8(data.charges));
+
+            for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
+                batchIns.addInt32(data.basePoints[i]);
+
+            for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
+                batchIns.addUInt32(data.periodicTime[i]);
+
+            batchIns.addInt32(data.maxDuration);
+            batchIns.addInt32(data.remainTime);
+            batchIns.addUInt32(data.effIndexMask);
+        }
+        else if (saved->second != data)
+        {
+            SqlStatement stmt = CharacterDatabase.CreateStatement(updateAura, "UPDATE character_aura SET stackcount = ?, remaincharges = ?, "
+                                "basepoints0 = ?, basepoints1 = ?, basepoints2 = ?, periodictime0 = ?, periodictime1 = ?, periodictime2 = ?, maxduration = ?, remaintime = ?, effIndexMask = ? "
+                                "WHERE guid = ? AND caster_guid = ? AND item_guid = ? AND spell = ?");
+
+            stmt.addUInt32(data.stackCount);
+            stmt.addUInt8(uint8(data.charges));
 
             for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
-                stmt.addInt32(damage[i]);
+                stmt.addInt32(data.basePoints[i]);
 
             for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
-                stmt.addUInt32(periodicTime[i]);
+                stmt.addUInt32(data.periodicTime[i]);
 
-            stmt.addInt32(holder->GetAuraMaxDuration());
-            stmt.addInt32(holder->GetAuraDuration());
-            stmt.addUInt32(effIndexMask);
+            stmt.addInt32(data.maxDuration);
+            stmt.addInt32(data.remainTime);
+            stmt.addUInt32(data.effIndexMask);
+            stmt.addUInt32(GetGUIDLow());
+            stmt.addUInt64(itr->first.casterGuid);
+            stmt.addUInt32(itr->first.itemGuid);
+            stmt.addUInt32(itr->first.spellId);
             stmt.Execute();
         }
     }
+
+    m_savedAuras.swap(auras);
 }
 
 void Player::_SaveInventory()
@@ -15077,10 +15199,11 @@ void Player::_SaveInventory()
         return;
     }
 
-    static SqlStatementID insertInventory ;
     static SqlStatementID updateInventory ;
     static SqlStatementID deleteInventory ;
 
+    SqlBatchStatement batchIns(CharacterDatabase, "INSERT INTO character_inventory (guid,bag,slot,item,item_template) VALUES (?, ?, ?, ?, ?)");
+
     for (size_t i = 0; i < m_itemUpdateQueue.size(); ++i)
     {
         Item* item = m_itemUpdateQueue[i];
@@ -15093,13 +15216,11 @@ void Player::_SaveInventory()
         {
             case ITEM_NEW:
             {
-                SqlStatement stmt = CharacterDatabase.CreateStatement(insertInventory, "INSERT INTO character_inventory (guid,bag,slot,item,item_template) VALUES (?, ?, ?, ?, ?)");
-                stmt.addUInt32(GetGUIDLow());
-                stmt.addUInt32(bag_guid);
-                stmt.addUInt8(item->GetSlot());
-                stmt.addUInt32(item->GetGUIDLow());
-                stmt.addUInt32(item->GetEntry());
-                stmt.Execute();
+                batchIns.addUInt32(GetGUIDLow());
+                batchIns.addUInt32(bag_guid);
+                batchIns.addUInt8(item->GetSlot());
+                batchIns.addUInt32(item->GetGUIDLow());
+                batchIns.addUInt32(item->GetEntry());
             }
             break;
             case ITEM_CHANGED:
@@ -15238,10 +15359,11 @@ void Player::_SaveMail()
 
 void Player::_SaveQuestStatus()
 {
-    static SqlStatementID insertQuestStatus ;
-
     static SqlStatementID updateQuestStatus ;
 
+    SqlBatchStatement batchIns(CharacterDatabase, "INSERT INTO character_queststatus (guid,quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4) "
+                               "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+
     // we don't need transactions here.
     for (QuestStatusMap::iterator i = mQuestStatus.begin(); i != mQuestStatus.end(); ++i)
     {
@@ -15249,20 +15371,16 @@ void Player::_SaveQuestStatus()
         {
             case QUEST_NEW :
             {
-                SqlStatement stmt = CharacterDatabase.CreateStatement(insertQuestStatus, "INSERT INTO character_queststatus (guid,quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4) "
-                                    "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
-
-                stmt.addUInt32(GetGUIDLow());
-                stmt.addUInt32(i->first);
-                stmt.addUInt8(i->second.m_status);
-                stmt.addUInt8(i->second.m_rewarded);
-                stmt.addUInt8(i->second.m_explored);
-                stmt.addUInt64(uint64(i->second.m_timer / IN_MILLISECONDS + sWorld.GetGameTime()));
+                batchIns.addUInt32(GetGUIDLow());
+                batchIns.addUInt32(i->first);
+                batchIns.addUInt8(i->second.m_status);
+                batchIns.addUInt8(i->second.m_rewarded);
+                batchIns.addUInt8(i->second.m_explored);
+                batchIns.addUInt64(uint64(i->second.m_timer / IN_MILLISECONDS + sWorld.GetGameTime()));
                 for (int k = 0; k < QUEST_OBJECTIVES_COUNT; ++k)
-                    stmt.addUInt32(i->second.m_creatureOrGOcount[k]);
+                    batchIns.addUInt32(i->second.m_creatureOrGOcount[k]);
                 for (int k = 0; k < QUEST_OBJECTIVES_COUNT; ++k)
-                    stmt.addUInt32(i->second.m_itemcount[k]);
-                stmt.Execute();
+                    batchIns.addUInt32(i->second.m_itemcount[k]);
             }
             break;
             case QUEST_CHANGED :
@@ -15345,10 +15463,10 @@ void Player::_SaveSkills()
 void Player::_SaveSpells()
 {
     static SqlStatementID delSpells ;
-    static SqlStatementID insSpells ;
 
     SqlStatement stmtDel = CharacterDatabase.CreateStatement(delSpells, "DELETE FROM character_spell WHERE guid = ? and spell = ?");
-    SqlStatement stmtIns = CharacterDatabase.CreateStatement(insSpells, "INSERT INTO character_spell (guid,spell,active,disabled) VALUES (?, ?, ?, ?)");
+    // rows are sent after the deletes of changed spells
+    SqlBatchStatement batchIns(CharacterDatabase, "INSERT INTO character_spell (guid,spell,active,disabled) VALUES (?, ?, ?, ?)");
 
     for (PlayerSpellMap::iterator itr = m_spells.begin(), next = m_spells.begin(); itr != m_spells.end();)
     {
@@ -15357,7 +15475,7 @@ void Player::_SaveSpells()
 
         // add only changed/new not dependent spells
         if (!itr->second.dependent && (itr->second.state == PLAYERSPELL_NEW || itr->second.state == PLAYERSPELL_CHANGED))
-            stmtIns.PExecute(GetGUIDLow(), itr->first, uint8(itr->second.active ? 1 : 0), uint8(itr->second.disabled ? 1 : 0));
+            batchIns.AddRow(GetGUIDLow(), itr->first, uint8(itr->second.active ? 1 : 0), uint8(itr->second.disabled ? 1 : 0));
 
         if (itr->second.state == PLAYERSPELL_REMOVED)
             m_spells.erase(itr++);
@@ -15369,6 +15487,21 @@ void Player::_SaveSpells()
     }
 }
 
+// float stats are kept as their bits, so an unchanged stat compares equal (memcpy, no type punning through pointers)
+static inline uint32 StatFloatToBits(float value)
+{
+    uint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline float StatBitsToFloat(uint32 bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
 // save player stats -- only for external usage
 // real stats will be recalculated on player login
 void Player::_SaveStats()
@@ -15377,35 +15510,74 @@ void Player::_SaveStats()
     if (!sWorld.getConfig(CONFIG_UINT32_MIN_LEVEL_STAT_SAVE) || getLevel() < sWorld.getConfig(CONFIG_UINT32_MIN_LEVEL_STAT_SAVE))
         return;
 
+    uint32 stats[PLAYER_SAVED_STATS_COUNT];
+    uint32 n = 0;
+
+    stats[n++] = GetMaxHealth();
+    for (int i = 0; i < MAX_POWERS; ++i)
+        stats[n++] = GetMaxPower(Powers(i));
+    for (int i = 0; i < MAX_STATS; ++i)
+        stats[n++] = StatFloatToBits(GetStat(Stats(i)));
+    // armor + school resistances
+    for (int i = 0; i < MAX_SPELL_SCHOOL; ++i)
+        stats[n++] = GetResistance(SpellSchools(i));
+    stats[n++] = StatFloatToBits(GetFloatValue(PLAYER_BLOCK_PERCENTAGE));
+    stats[n++] = StatFloatToBits(GetFloatValue(PLAYER_DODGE_PERCENTAGE));
+    stats[n++] = StatFloatToBits(GetFloatValue(PLAYER_PARRY_PERCENTAGE));
+    stats[n++] = StatFloatToBits(GetFloatValue(PLAYER_CRIT_PERCENTAGE));
+    stats[n++] = StatFloatToBits(GetFloatValue(PLAYER_RANGED_CRIT_PERCENTAGE));
+    stats[n++] = GetUInt32Value(UNIT_FIELD_ATTACK_POWER);
+    stats[n++] = GetUInt32Value(UNIT_FIELD_RANGED_ATTACK_POWER);
+
+    MANGOS_ASSERT(n == PLAYER_SAVED_STATS_COUNT);
+
+    // nothing changed since the last save
+    if (m_statsSaved && memcmp(stats, m_savedStats, sizeof(stats)) == 0)
+        return;
+
     static SqlStatementID delStats ;
     static SqlStatementID insertStats ;
+    static SqlStatementID updateStats ;
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delStats, "DELETE FROM character_stats WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
+    SqlStatement stmt = CharacterDatabase.CreateStatement(updateStats, "UPDATE character_stats SET maxhealth = ?, maxpower1 = ?, maxpower2 = ?, maxpower3 = ?, maxpower4 = ?, maxpower5 = ?, "
+                        "strength = ?, agility = ?, stamina = ?, intellect = ?, spirit = ?, armor = ?, resHoly = ?, resFire = ?, resNature = ?, resFrost = ?, resShadow = ?, resArcane = ?, "
+                        "blockPct = ?, dodgePct = ?, parryPct = ?, critPct = ?, rangedCritPct = ?, attackPower = ?, rangedAttackPower = ? "
+                        "WHERE guid = ?");
+
+    // the row is recreated once per session, it may be missing or outdated
+    if (!m_statsSaved)
+    {
+        stmt = CharacterDatabase.CreateStatement(delStats, "DELETE FROM character_stats WHERE guid = ?");
+        stmt.PExecute(GetGUIDLow());
 
-    stmt = CharacterDatabase.CreateStatement(insertStats, "INSERT INTO character_stats (guid, maxhealth, maxpower1, maxpower2, maxpower3, maxpower4, maxpower5, "
-            "strength, agility, stamina, intellect, spirit, armor, resHoly, resFire, resNature, resFrost, resShadow, resArcane, "
-            "blockPct, dodgePct, parryPct, critPct, rangedCritPct, attackPower, rangedAttackPower) "
-            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+        stmt = CharacterDatabase.CreateStatement(insertStats, "INSERT INTO character_stats (guid, maxhealth, maxpower1, maxpower2, maxpower3, maxpower4, maxpower5, "
+                "strength, agility, stamina, intellect, spirit, armor, resHoly, resFire, resNature, resFrost, resShadow, resArcane, "
+                "blockPct, dodgePct, parryPct, critPct, rangedCritPct, attackPower, rangedAttackPower) "
+                "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
 
-    stmt.addUInt32(GetGUIDLow());
-    stmt.addUInt32(GetMaxHealth());
+        stmt.addUInt32(GetGUIDLow());
+    }
+
+    n = 0;
+    stmt.addUInt32(stats[n++]);
     for (int i = 0; i < MAX_POWERS; ++i)
-        stmt.addUInt32(GetMaxPower(Powers(i)));
+        stmt.addUInt32(stats[n++]);
     for (int i = 0; i < MAX_STATS; ++i)
-        stmt.addFloat(GetStat(Stats(i)));
-    // armor + school resistances
+        stmt.addFloat(StatBitsToFloat(stats[n++]));
     for (int i = 0; i < MAX_SPELL_SCHOOL; ++i)
-        stmt.addUInt32(GetResistance(SpellSchools(i)));
-    stmt.addFloat(GetFloatValue(PLAYER_BLOCK_PERCENTAGE));
-    stmt.addFloat(GetFloatValue(PLAYER_DODGE_PERCENTAGE));
-    stmt.addFloat(GetFloatValue(PLAYER_PARRY_PERCENTAGE));
-    stmt.addFloat(GetFloatValue(PLAYER_CRIT_PERCENTAGE));
-    stmt.addFloat(GetFloatValue(PLAYER_RANGED_CRIT_PERCENTAGE));
-    stmt.addUInt32(GetUInt32Value(UNIT_FIELD_ATTACK_POWER));
-    stmt.addUInt32(GetUInt32Value(UNIT_FIELD_RANGED_ATTACK_POWER));
+        stmt.addUInt32(stats[n++]);
+    for (int i = 0; i < 5; ++i)                             // block, dodge, parry, crit, ranged crit
+        stmt.addFloat(StatBitsToFloat(stats[n++]));
+    stmt.addUInt32(stats[n++]);
+    stmt.addUInt32(stats[n++]);
+
+    if (m_statsSaved)
+        stmt.addUInt32(GetGUIDLow());
 
     stmt.Execute();
+
+    memcpy(m_savedStats, stats, sizeof(stats));
+    m_statsSaved = true;
 }
 
 void Player::outDebugStatsValues() const
@@ -17706,7 +17878,7 @@ void Player::AutoUnequipOffhandIfNeed()
     else
     {
         MoveItemFromInventory(INVENTORY_SLOT_BAG_0, EQUIPMENT_SLOT_OFFHAND, true);
-        CharacterDatabase.BeginTransaction();
+        CharacterDatabase.BeginTransaction(GetObjectGuid().GetRawValue());
         offItem->DeleteFromInventoryDB();                   // deletes item from character's inventory
         offItem->SaveToDB();                                // recursive and not have transaction guard into self, item not in inventory and can be save standalone
         CharacterDatabase.CommitTransaction();
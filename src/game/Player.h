@@ -145,6 +145,44 @@ struct SpellCooldown
 
 typedef std::map<uint32, SpellCooldown> SpellCooldowns;
 
+// primary key of a character_aura row (without the character guid)
+struct SavedAuraKey
+{
+    SavedAuraKey(uint64 _casterGuid, uint32 _itemGuid, uint32 _spellId) : casterGuid(_casterGuid), itemGuid(_itemGuid), spellId(_spellId) {}
+
+    bool operator<(SavedAuraKey const& other) const
+    {
+        if (casterGuid != other.casterGuid)
+            return casterGuid < other.casterGuid;
+        if (itemGuid != other.itemGuid)
+            return itemGuid < other.itemGuid;
+        return spellId < other.spellId;
+    }
+
+    uint64 casterGuid;
+    uint32 itemGuid;
+    uint32 spellId;
+};
+
+// values of a character_aura row as stored in the DB
+struct SavedAuraData
+{
+    bool operator==(SavedAuraData const& other) const { return memcmp(this, &other, sizeof(SavedAuraData)) == 0; }
+    bool operator!=(SavedAuraData const& other) const { return !(*this == other); }
+
+    uint32 stackCount;
+    uint32 charges;
+    int32  basePoints[MAX_EFFECT_INDEX];
+    uint32 periodicTime[MAX_EFFECT_INDEX];
+    int32  maxDuration;
+    int32  remainTime;
+    uint32 effIndexMask;
+};
+
+typedef std::map<SavedAuraKey, SavedAuraData> SavedAuraMap;
+
+#define PLAYER_SAVED_STATS_COUNT 25                         // value columns of character_stats
+
 enum TrainerSpellState
 {
     TRAINER_SPELL_GREEN         = 0,
@@ -1246,6 +1284,8 @@ class MANGOS_DLL_SPEC Player : public Unit
         /*********************************************************/
 
         void SaveToDB();
+        // next SaveToDB rewrites the rows it normally only updates for the changes since the last save
+        void ResetSaveBaselines();
         void SaveInventoryAndGoldToDB();                    // fast save function for item/money cheating preventing
         void SaveGoldToDB();
         static void SetUInt32ValueInArray(Tokens& data, uint16 index, uint32 value);
@@ -1953,6 +1993,9 @@ class MANGOS_DLL_SPEC Player : public Unit
         // currently visible objects at player client
         GuidSet m_clientGUIDs;
 
+        /// Values update blocks collected for this player by the ObjectUpdateQueue of the map, empty between map updates
+        UpdateData& GetClientUpdateData() { return m_clientUpdateData; }
+
         bool HaveAtClient(WorldObject const* u) { return u == this || m_clientGUIDs.find(u->GetObjectGuid()) != m_clientGUIDs.end(); }
 
         bool IsVisibleInGridForPlayer(Player* pl) const override;
@@ -2137,6 +2180,13 @@ class MANGOS_DLL_SPEC Player : public Unit
 
         Team m_team;
         uint32 m_nextSave;
+
+        // DB state of the last save (or load), used to write only what changed since
+        bool m_characterRowSaved;                           // characters row exists
+        SavedAuraMap m_savedAuras;                          // character_aura rows
+        bool m_savedAurasValid;                             // false if the character_aura rows are unknown
+        bool m_statsSaved;                                  // character_stats row written in this session
+        uint32 m_savedStats[PLAYER_SAVED_STATS_COUNT];      // character_stats values, floats as raw bits
         time_t m_speakTime;
         uint32 m_speakCount;
         uint32 m_atLoginFlags;
@@ -2182,6 +2232,7 @@ class MANGOS_DLL_SPEC Player : public Unit
         uint32 m_resurrectHealth, m_resurrectMana;
 
         WorldSession* m_session;
+        UpdateData m_clientUpdateData;
 
         typedef std::list<Channel*> JoinedChannelsList;
         JoinedChannelsList m_channels;
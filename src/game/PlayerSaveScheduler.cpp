@@ -0,0 +1,211 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "PlayerSaveScheduler.h"
+#include "Player.h"
+#include "ObjectMgr.h"
+#include "World.h"
+#include "LuaEngine.h"
+#include "Timer.h"
+#include "Log.h"
+
+INSTANTIATE_SINGLETON_1(PlayerSaveScheduler);
+
+PlayerSaveScheduler::PlayerSaveScheduler() : m_saveCredit(0.0f), m_byteCredit(0)
+{
+}
+
+void PlayerSaveScheduler::RequestSave(ObjectGuid guid, bool urgent /*= false*/)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    if (!m_queued.insert(guid).second)
+    {
+        // already queued, only an urgent request has to move to the front
+        if (!urgent)
+            return;
+
+        for (RequestQueue::iterator itr = m_queue.begin(); itr != m_queue.end(); ++itr)
+        {
+            if (itr->guid == guid)
+            {
+                m_queue.erase(itr);
+                break;
+            }
+        }
+    }
+
+    SaveRequest request(guid, WorldTimer::getMSTime(), urgent);
+    if (urgent)
+        m_queue.push_front(request);
+    else
+        m_queue.push_back(request);
+}
+
+void PlayerSaveScheduler::OnPlayerSaved(ObjectGuid guid, uint32 bytes)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    m_byteCredit -= bytes;
+    m_stats.bytes += bytes;
+
+    if (guid == m_currentSave)
+        ++m_stats.scheduledSaves;
+    else
+    {
+        // saved outside the scheduler, a queued request is not needed anymore
+        ++m_stats.directSaves;
+        m_queued.erase(guid);
+    }
+}
+
+void PlayerSaveScheduler::Update(uint32 diff)
+{
+    uint32 interval = sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE);
+    uint32 maxPerTick = sWorld.getConfig(CONFIG_UINT32_PLAYER_SAVE_MAX_PER_TICK);
+    uint32 bytesPerSecond = sWorld.getConfig(CONFIG_UINT32_PLAYER_SAVE_BYTES_PER_SECOND);
+    uint32 online = std::max(sWorld.GetActiveSessionCount(), uint32(1));
+
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+        if (m_queue.empty())
+        {
+            // no credit is collected while idle, it would allow a burst later
+            m_saveCredit = 0.0f;
+            m_byteCredit = std::min(m_byteCredit, int64(0));
+            return;
+        }
+
+        // twice the rate needed to save every online player once per interval
+        if (interval)
+            m_saveCredit += 2.0f * online * diff / interval;
+        else
+            m_saveCredit = float(m_queue.size());
+
+        m_saveCredit = std::min(m_saveCredit, float(m_queue.size()));
+
+        // at most one second of byte budget is collected
+        if (bytesPerSecond)
+            m_byteCredit = std::min(m_byteCredit + int64(bytesPerSecond) * diff / IN_MILLISECONDS, int64(bytesPerSecond));
+    }
+
+    uint32 saved = 0;
+    RequestQueue deferred;
+    for (;;)
+    {
+        SaveRequest request;
+
+        {
+            ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+            if (m_queue.empty())
+                break;
+
+            request = m_queue.front();
+            if (m_queued.find(request.guid) == m_queued.end())
+            {
+                // player was saved directly or logged out
+                m_queue.pop_front();
+                continue;
+            }
+
+            if (!request.urgent && (m_saveCredit < 1.0f || (maxPerTick && saved >= maxPerTick) || (bytesPerSecond && m_byteCredit <= 0)))
+                break;
+
+            m_queue.pop_front();
+            m_queued.erase(request.guid);
+            m_currentSave = request.guid;
+        }
+
+        // a player at a far teleport is not in the world until the new map is entered,
+        // the request is kept for a later tick, the logout save drops it by OnPlayerSaved
+        Player* player = sObjectMgr.GetPlayer(request.guid, false);
+        if (player && !player->IsInWorld())
+        {
+            deferred.push_back(request);
+
+            ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+            m_currentSave.Clear();
+            continue;
+        }
+
+        if (player)
+        {
+            // used by eluna
+            sEluna->OnSave(player);
+            player->SaveToDB();
+            DETAIL_LOG("Player '%s' (GUID: %u) saved", player->GetName(), player->GetGUIDLow());
+        }
+
+        ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+        m_currentSave.Clear();
+
+        uint32 lag = WorldTimer::getMSTimeDiff(request.requestTime, WorldTimer::getMSTime());
+        m_stats.totalLag += lag;
+        if (lag > m_stats.maxLag)
+            m_stats.maxLag = lag;
+
+        if (!request.urgent)
+        {
+            m_saveCredit -= 1.0f;
+            ++saved;
+        }
+    }
+
+    if (deferred.empty())
+        return;
+
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    for (RequestQueue::const_iterator itr = deferred.begin(); itr != deferred.end(); ++itr)
+    {
+        // requested again meanwhile, the new request is already queued
+        if (!m_queued.insert(itr->guid).second)
+            continue;
+
+        // the original request time and urgency are kept, an urgent save is tried again first
+        if (itr->urgent)
+            m_queue.push_front(*itr);
+        else
+            m_queue.push_back(*itr);
+    }
+}
+
+void PlayerSaveScheduler::GetStatistic(PlayerSaveStats& stats) const
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    stats = m_stats;
+    stats.backlog = m_queued.size();
+    stats.lag = 0;
+
+    for (RequestQueue::const_iterator itr = m_queue.begin(); itr != m_queue.end(); ++itr)
+    {
+        if (m_queued.find(itr->guid) != m_queued.end())
+        {
+            stats.lag = WorldTimer::getMSTimeDiff(itr->requestTime, WorldTimer::getMSTime());
+            break;
+        }
+    }
+}
+
+void PlayerSaveScheduler::ResetStatistic()
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    m_stats = PlayerSaveStats();
+}
@@ -0,0 +1,99 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PLAYERSAVESCHEDULER_H
+#define MANGOS_PLAYERSAVESCHEDULER_H
+
+#include "Common.h"
+#include "ObjectGuid.h"
+#include "Policies/Singleton.h"
+
+#include <ace/Thread_Mutex.h>
+#include <deque>
+#include <set>
+
+/// Counters of the player save scheduler, times in milliseconds
+struct PlayerSaveStats
+{
+    PlayerSaveStats() : backlog(0), lag(0), maxLag(0), totalLag(0), scheduledSaves(0), directSaves(0), bytes(0) {}
+
+    uint32 backlog;                                         // queued save requests
+    uint32 lag;                                             // age of the oldest queued request
+    uint32 maxLag;                                          // longest wait of a saved request
+    uint64 totalLag;
+    uint32 scheduledSaves;                                  // saves done by the scheduler
+    uint32 directSaves;                                     // other saves (logout, commands, ...)
+    uint64 bytes;                                           // approximate SQL data of all saves
+};
+
+/**
+ * Global queue of player autosaves.
+ *
+ * Players request their autosave when their save timer expires, the saves are done in the world
+ * thread at a rate that saves every online player about twice per PlayerSave.Interval, so a burst
+ * of requests (server start, mass login) is spread over the interval instead of hitting the
+ * character DB in one tick. PlayerSave.MaxPerTick and PlayerSave.MaxBytesPerSecond cap the rate.
+ * Urgent requests are queued first and not rate limited. Saves done outside the scheduler
+ * (logout, trade, mail) drop a queued request and are charged to the byte budget.
+ * A request of a player outside the world (far teleport) is kept until the player is back in the world.
+ */
+class PlayerSaveScheduler
+{
+    public:
+        PlayerSaveScheduler();
+
+        /// Queue a save of the player, thread safe
+        void RequestSave(ObjectGuid guid, bool urgent = false);
+        /// Called for every Player::SaveToDB, thread safe
+        void OnPlayerSaved(ObjectGuid guid, uint32 bytes);
+
+        /// Save queued players within the budget, world thread only while maps are not updated
+        void Update(uint32 diff);
+
+        void GetStatistic(PlayerSaveStats& stats) const;
+        void ResetStatistic();
+
+    private:
+        struct SaveRequest
+        {
+            SaveRequest() : requestTime(0), urgent(false) {}
+            SaveRequest(ObjectGuid _guid, uint32 _requestTime, bool _urgent) : guid(_guid), requestTime(_requestTime), urgent(_urgent) {}
+
+            ObjectGuid guid;
+            uint32 requestTime;                             // getMSTime()
+            bool urgent;
+        };
+
+        typedef std::deque<SaveRequest> RequestQueue;
+        typedef std::set<ObjectGuid> GuidSet;
+
+        mutable ACE_Thread_Mutex m_lock;
+
+        RequestQueue m_queue;                               // may hold requests of already saved players
+        GuidSet m_queued;                                   // players with a pending request
+        ObjectGuid m_currentSave;                           // player saved by Update right now
+
+        float m_saveCredit;                                 // saves allowed by the even rate
+        int64 m_byteCredit;                                 // bytes allowed by PlayerSave.MaxBytesPerSecond
+
+        PlayerSaveStats m_stats;
+};
+
+#define sPlayerSaveScheduler MaNGOS::Singleton<PlayerSaveScheduler>::Instance()
+
+#endif
@@ -1119,9 +1119,29 @@ void PoolManager::SetExcludeObject<GameObject>(uint16 pool_id, uint32 db_guid_or
 // Call to update the pool when a gameobject/creature part of pool [pool_id] is ready to respawn
 // Here we cache only the creature/gameobject whose guid is passed as parameter
 // Then the spawn pool call will use this cache to decide
+template<typename T>
+struct PoolUpdateAction;
+
+template<>
+struct PoolUpdateAction<Creature> { static MapDeferredAction::Type const type = MapDeferredAction::POOL_UPDATE_CREATURE; };
+
+template<>
+struct PoolUpdateAction<GameObject> { static MapDeferredAction::Type const type = MapDeferredAction::POOL_UPDATE_GAMEOBJECT; };
+
+template<>
+struct PoolUpdateAction<Pool> { static MapDeferredAction::Type const type = MapDeferredAction::POOL_UPDATE_POOL; };
+
 template<typename T>
 void PoolManager::UpdatePool(MapPersistentState& mapState, uint16 pool_id, uint32 db_guid_or_pool_id)
 {
+    // the pool may spawn in another cell island of the map, the map updates it after its islands
+    Map* map = mapState.GetMap();
+    if (map && map->IsUpdatingIslands())
+    {
+        map->DeferIslandAction(MapDeferredAction(PoolUpdateAction<T>::type, pool_id, db_guid_or_pool_id));
+        return;
+    }
+
     if (uint16 motherpoolid = IsPartOfAPool<Pool>(pool_id))
         SpawnPoolGroup<Pool>(mapState, motherpoolid, pool_id, false);
     else
@@ -19,6 +19,7 @@
 #include "QuestDef.h"
 #include "Player.h"
 #include "World.h"
+#include "Database/SnapshotFile.h"
 
 Quest::Quest(Field* questRecord)
 {
@@ -156,6 +157,193 @@ Quest::Quest(Field* questRecord)
     }
 }
 
+static std::string ReadSnapshotString(SnapshotFile& snapshot)
+{
+    char const* value = snapshot.ReadString();
+    return value ? value : "";
+}
+
+Quest::Quest(SnapshotFile& snapshot)
+{
+    QuestId = snapshot.ReadUInt32();
+    QuestMethod = snapshot.ReadUInt32();
+    ZoneOrSort = snapshot.ReadInt32();
+    MinLevel = snapshot.ReadUInt32();
+    QuestLevel = snapshot.ReadUInt32();
+    Type = snapshot.ReadUInt32();
+    RequiredClasses = snapshot.ReadUInt32();
+    RequiredRaces = snapshot.ReadUInt32();
+    RequiredSkill = snapshot.ReadUInt32();
+    RequiredSkillValue = snapshot.ReadUInt32();
+    RepObjectiveFaction = snapshot.ReadUInt32();
+    RepObjectiveValue = snapshot.ReadInt32();
+    RequiredMinRepFaction = snapshot.ReadUInt32();
+    RequiredMinRepValue = snapshot.ReadInt32();
+    RequiredMaxRepFaction = snapshot.ReadUInt32();
+    RequiredMaxRepValue = snapshot.ReadInt32();
+    SuggestedPlayers = snapshot.ReadUInt32();
+    LimitTime = snapshot.ReadUInt32();
+    m_QuestFlags = snapshot.ReadUInt32();
+    m_SpecialFlags = snapshot.ReadUInt32();
+    PrevQuestId = snapshot.ReadInt32();
+    NextQuestId = snapshot.ReadInt32();
+    ExclusiveGroup = snapshot.ReadInt32();
+    NextQuestInChain = snapshot.ReadUInt32();
+    SrcItemId = snapshot.ReadUInt32();
+    SrcItemCount = snapshot.ReadUInt32();
+    SrcSpell = snapshot.ReadUInt32();
+    Title = ReadSnapshotString(snapshot);
+    Details = ReadSnapshotString(snapshot);
+    Objectives = ReadSnapshotString(snapshot);
+    OfferRewardText = ReadSnapshotString(snapshot);
+    RequestItemsText = ReadSnapshotString(snapshot);
+    EndText = ReadSnapshotString(snapshot);
+
+    for (int i = 0; i < QUEST_OBJECTIVES_COUNT; ++i)
+        ObjectiveText[i] = ReadSnapshotString(snapshot);
+
+    snapshot.Read(ReqItemId, sizeof(ReqItemId));
+    snapshot.Read(ReqItemCount, sizeof(ReqItemCount));
+    snapshot.Read(ReqSourceId, sizeof(ReqSourceId));
+    snapshot.Read(ReqSourceCount, sizeof(ReqSourceCount));
+    snapshot.Read(ReqCreatureOrGOId, sizeof(ReqCreatureOrGOId));
+    snapshot.Read(ReqCreatureOrGOCount, sizeof(ReqCreatureOrGOCount));
+    snapshot.Read(ReqSpell, sizeof(ReqSpell));
+    snapshot.Read(RewChoiceItemId, sizeof(RewChoiceItemId));
+    snapshot.Read(RewChoiceItemCount, sizeof(RewChoiceItemCount));
+    snapshot.Read(RewItemId, sizeof(RewItemId));
+    snapshot.Read(RewItemCount, sizeof(RewItemCount));
+    snapshot.Read(RewRepFaction, sizeof(RewRepFaction));
+    snapshot.Read(RewRepValue, sizeof(RewRepValue));
+
+    RewOrReqMoney = snapshot.ReadInt32();
+    RewMoneyMaxLevel = snapshot.ReadUInt32();
+    RewSpell = snapshot.ReadUInt32();
+    RewSpellCast = snapshot.ReadUInt32();
+    RewMailTemplateId = snapshot.ReadUInt32();
+    RewMailDelaySecs = snapshot.ReadUInt32();
+    PointMapId = snapshot.ReadUInt32();
+    PointX = snapshot.ReadFloat();
+    PointY = snapshot.ReadFloat();
+    PointOpt = snapshot.ReadUInt32();
+
+    snapshot.Read(DetailsEmote, sizeof(DetailsEmote));
+    snapshot.Read(DetailsEmoteDelay, sizeof(DetailsEmoteDelay));
+    IncompleteEmote = snapshot.ReadUInt32();
+    CompleteEmote = snapshot.ReadUInt32();
+    snapshot.Read(OfferRewardEmote, sizeof(OfferRewardEmote));
+    snapshot.Read(OfferRewardEmoteDelay, sizeof(OfferRewardEmoteDelay));
+
+    QuestStartScript = snapshot.ReadUInt32();
+    QuestCompleteScript = snapshot.ReadUInt32();
+
+    m_isActive = snapshot.ReadUInt8() != 0;
+
+    // the counts of the load, the checks may have cleared requirements and rewards since
+    m_reqitemscount = snapshot.ReadUInt32();
+    m_reqCreatureOrGOcount = snapshot.ReadUInt32();
+    m_rewitemscount = snapshot.ReadUInt32();
+    m_rewchoiceitemscount = snapshot.ReadUInt32();
+
+    prevQuests.resize(snapshot.ReadUInt32());
+    for (size_t i = 0; i < prevQuests.size() && !snapshot.HasReadError(); ++i)
+        prevQuests[i] = snapshot.ReadInt32();
+
+    prevChainQuests.resize(snapshot.ReadUInt32());
+    for (size_t i = 0; i < prevChainQuests.size() && !snapshot.HasReadError(); ++i)
+        prevChainQuests[i] = snapshot.ReadUInt32();
+}
+
+void Quest::WriteSnapshot(SnapshotFile& snapshot) const
+{
+    snapshot.WriteUInt32(QuestId);
+    snapshot.WriteUInt32(QuestMethod);
+    snapshot.WriteInt32(ZoneOrSort);
+    snapshot.WriteUInt32(MinLevel);
+    snapshot.WriteUInt32(QuestLevel);
+    snapshot.WriteUInt32(Type);
+    snapshot.WriteUInt32(RequiredClasses);
+    snapshot.WriteUInt32(RequiredRaces);
+    snapshot.WriteUInt32(RequiredSkill);
+    snapshot.WriteUInt32(RequiredSkillValue);
+    snapshot.WriteUInt32(RepObjectiveFaction);
+    snapshot.WriteInt32(RepObjectiveValue);
+    snapshot.WriteUInt32(RequiredMinRepFaction);
+    snapshot.WriteInt32(RequiredMinRepValue);
+    snapshot.WriteUInt32(RequiredMaxRepFaction);
+    snapshot.WriteInt32(RequiredMaxRepValue);
+    snapshot.WriteUInt32(SuggestedPlayers);
+    snapshot.WriteUInt32(LimitTime);
+    snapshot.WriteUInt32(m_QuestFlags);
+    snapshot.WriteUInt32(m_SpecialFlags);
+    snapshot.WriteInt32(PrevQuestId);
+    snapshot.WriteInt32(NextQuestId);
+    snapshot.WriteInt32(ExclusiveGroup);
+    snapshot.WriteUInt32(NextQuestInChain);
+    snapshot.WriteUInt32(SrcItemId);
+    snapshot.WriteUInt32(SrcItemCount);
+    snapshot.WriteUInt32(SrcSpell);
+    snapshot.WriteString(Title.c_str());
+    snapshot.WriteString(Details.c_str());
+    snapshot.WriteString(Objectives.c_str());
+    snapshot.WriteString(OfferRewardText.c_str());
+    snapshot.WriteString(RequestItemsText.c_str());
+    snapshot.WriteString(EndText.c_str());
+
+    for (int i = 0; i < QUEST_OBJECTIVES_COUNT; ++i)
+        snapshot.WriteString(ObjectiveText[i].c_str());
+
+    snapshot.Write(ReqItemId, sizeof(ReqItemId));
+    snapshot.Write(ReqItemCount, sizeof(ReqItemCount));
+    snapshot.Write(ReqSourceId, sizeof(ReqSourceId));
+    snapshot.Write(ReqSourceCount, sizeof(ReqSourceCount));
+    snapshot.Write(ReqCreatureOrGOId, sizeof(ReqCreatureOrGOId));
+    snapshot.Write(ReqCreatureOrGOCount, sizeof(ReqCreatureOrGOCount));
+    snapshot.Write(ReqSpell, sizeof(ReqSpell));
+    snapshot.Write(RewChoiceItemId, sizeof(RewChoiceItemId));
+    snapshot.Write(RewChoiceItemCount, sizeof(RewChoiceItemCount));
+    snapshot.Write(RewItemId, sizeof(RewItemId));
+    snapshot.Write(RewItemCount, sizeof(RewItemCount));
+    snapshot.Write(RewRepFaction, sizeof(RewRepFaction));
+    snapshot.Write(RewRepValue, sizeof(RewRepValue));
+
+    snapshot.WriteInt32(RewOrReqMoney);
+    snapshot.WriteUInt32(RewMoneyMaxLevel);
+    snapshot.WriteUInt32(RewSpell);
+    snapshot.WriteUInt32(RewSpellCast);
+    snapshot.WriteUInt32(RewMailTemplateId);
+    snapshot.WriteUInt32(RewMailDelaySecs);
+    snapshot.WriteUInt32(PointMapId);
+    snapshot.WriteFloat(PointX);
+    snapshot.WriteFloat(PointY);
+    snapshot.WriteUInt32(PointOpt);
+
+    snapshot.Write(DetailsEmote, sizeof(DetailsEmote));
+    snapshot.Write(DetailsEmoteDelay, sizeof(DetailsEmoteDelay));
+    snapshot.WriteUInt32(IncompleteEmote);
+    snapshot.WriteUInt32(CompleteEmote);
+    snapshot.Write(OfferRewardEmote, sizeof(OfferRewardEmote));
+    snapshot.Write(OfferRewardEmoteDelay, sizeof(OfferRewardEmoteDelay));
+
+    snapshot.WriteUInt32(QuestStartScript);
+    snapshot.WriteUInt32(QuestCompleteScript);
+
+    snapshot.WriteUInt8(m_isActive ? 1 : 0);
+
+    snapshot.WriteUInt32(m_reqitemscount);
+    snapshot.WriteUInt32(m_reqCreatureOrGOcount);
+    snapshot.WriteUInt32(m_rewitemscount);
+    snapshot.WriteUInt32(m_rewchoiceitemscount);
+
+    snapshot.WriteUInt32(prevQuests.size());
+    for (PrevQuests::const_iterator itr = prevQuests.begin(); itr != prevQuests.end(); ++itr)
+        snapshot.WriteInt32(*itr);
+
+    snapshot.WriteUInt32(prevChainQuests.size());
+    for (PrevChainQuests::const_iterator itr = prevChainQuests.begin(); itr != prevChainQuests.end(); ++itr)
+        snapshot.WriteUInt32(*itr);
+}
+
 uint32 Quest::XPValue(Player* pPlayer) const
 {
     if (pPlayer)
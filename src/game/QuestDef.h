@@ -26,6 +26,7 @@
 #include <vector>
 
 class Player;
+class SnapshotFile;
 
 class ObjectMgr;
 
@@ -179,6 +180,9 @@ class Quest
         friend class ObjectMgr;
     public:
         Quest(Field* questRecord);
+        /// Quest as written by WriteSnapshot, with the changes of the ObjectMgr checks
+        explicit Quest(SnapshotFile& snapshot);
+        void WriteSnapshot(SnapshotFile& snapshot) const;
         uint32 XPValue(Player* pPlayer) const;
 
         uint32 GetQuestFlags() const { return m_QuestFlags; }
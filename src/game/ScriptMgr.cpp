@@ -322,8 +322,12 @@ void ScriptMgr::LoadScripts(ScriptMapMapName& scripts, const char* tablename)
                 {
                     sLog.outErrorDb("Table `%s` has quest (ID: %u) in SCRIPT_COMMAND_QUEST_EXPLORED in `datalong` for script id %u, but quest not have flag QUEST_SPECIAL_FLAG_EXPLORATION_OR_EVENT in quest flags. Script command or quest flags wrong. Quest modified to require objective.", tablename, tmp.questExplored.questId, tmp.id);
 
-                    // this will prevent quest completing without objective
-                    const_cast<Quest*>(quest)->SetSpecialFlag(QUEST_SPECIAL_FLAG_EXPLORATION_OR_EVENT);
+                    // this will prevent quest completing without objective, set by ApplyExploredQuestFlags
+                    // other script tables may be loaded at the same time and read the quest flags
+                    {
+                        ACE_Guard<ACE_Thread_Mutex> guard(m_exploredQuestsLock);
+                        m_exploredQuests.insert(quest->GetQuestId());
+                    }
 
                     // continue; - quest objective requirement set and command can be allowed
                 }
@@ -799,6 +803,9 @@ void ScriptMgr::LoadGossipScripts()
     LoadScripts(sGossipScripts, "dbscripts_on_gossip");
 
     // checks are done in LoadGossipMenuItems and LoadGossipMenu
+
+    // not loaded in parallel with other script tables
+    ApplyExploredQuestFlags();
 }
 
 void ScriptMgr::LoadCreatureMovementScripts()
@@ -806,6 +813,9 @@ void ScriptMgr::LoadCreatureMovementScripts()
     LoadScripts(sCreatureMovementScripts, "dbscripts_on_creature_movement");
 
     // checks are done in WaypointManager::Load
+
+    // not loaded in parallel with other script tables
+    ApplyExploredQuestFlags();
 }
 
 void ScriptMgr::LoadCreatureDeathScripts()
@@ -820,6 +830,17 @@ void ScriptMgr::LoadCreatureDeathScripts()
     }
 }
 
+void ScriptMgr::ApplyExploredQuestFlags()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_exploredQuestsLock);
+
+    for (std::set<uint32>::const_iterator itr = m_exploredQuests.begin(); itr != m_exploredQuests.end(); ++itr)
+        if (Quest const* quest = sObjectMgr.GetQuestTemplate(*itr))
+            const_cast<Quest*>(quest)->SetSpecialFlag(QUEST_SPECIAL_FLAG_EXPLORATION_OR_EVENT);
+
+    m_exploredQuests.clear();
+}
+
 void ScriptMgr::LoadDbScriptStrings()
 {
     sObjectMgr.LoadMangosStrings(WorldDatabase, "db_script_string", MIN_DB_SCRIPT_STRING_ID, MAX_DB_SCRIPT_STRING_ID, true);
@@ -469,6 +469,8 @@ class ScriptMgr
         void LoadCreatureMovementScripts();
 
         void LoadDbScriptStrings();
+        /// Set the quest flags requested by SCRIPT_COMMAND_QUEST_EXPLORED, after the script loaders that may run in parallel
+        void ApplyExploredQuestFlags();
 
         void LoadScriptNames();
         void LoadAreaTriggerScripts();
@@ -540,6 +542,10 @@ class ScriptMgr
         // atomic op counter for active scripts amount
         ACE_Atomic_Op<ACE_Thread_Mutex, long> m_scheduledScripts;
 
+        // quests missing QUEST_SPECIAL_FLAG_EXPLORATION_OR_EVENT, the quest templates are not changed while loading
+        std::set<uint32> m_exploredQuests;
+        ACE_Thread_Mutex m_exploredQuestsLock;
+
         void (MANGOS_IMPORT* m_pOnInitScriptLibrary)();
         void (MANGOS_IMPORT* m_pOnFreeScriptLibrary)();
         const char* (MANGOS_IMPORT* m_pGetScriptLibraryVersion)();
@@ -0,0 +1,80 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_SHAREDPACKET_H
+#define MANGOS_SHAREDPACKET_H
+
+#include "Common.h"
+#include "WorldPacket.h"
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+
+/// Copy of a packet body referenced by the output of many sockets, deleted with the last reference
+class SharedPacketBody
+{
+    public:
+        SharedPacketBody(uint8 const* data, size_t size) : m_data(data, data + size), m_refs(1) {}
+
+        char const* GetData() const { return (char const*)&m_data[0]; }
+        size_t GetSize() const { return m_data.size(); }
+
+        void AddReference() { ++m_refs; }
+        /// the references are released by the network threads, the count is atomic
+        void RemoveReference()
+        {
+            if (--m_refs == 0)
+                delete this;
+        }
+
+    private:
+        ~SharedPacketBody() {}
+        SharedPacketBody(SharedPacketBody const&);
+        SharedPacketBody& operator=(SharedPacketBody const&);
+
+        std::vector<uint8> m_data;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_refs;
+};
+
+/**
+ * Immutable view of a packet that is sent unchanged to many sessions.
+ *
+ * WorldSocket writes only the encrypted header per receiver. When a socket has to queue the
+ * packet, it keeps a reference to one body block shared by all receivers, created on first need,
+ * instead of copying the packet. The wrapped packet must not be changed while this object exists.
+ */
+class SharedPacket
+{
+    public:
+        explicit SharedPacket(WorldPacket const& packet) : m_packet(packet), m_body(NULL) {}
+        ~SharedPacket();
+
+        WorldPacket const& GetPacket() const { return m_packet; }
+        uint16 GetOpcode() const { return m_packet.GetOpcode(); }
+
+        /// New reference to the shared body, must be released by the caller, NULL for empty packets
+        SharedPacketBody* DuplicateBody() const;
+
+    private:
+        SharedPacket(SharedPacket const&);
+        SharedPacket& operator=(SharedPacket const&);
+
+        WorldPacket const& m_packet;
+        mutable SharedPacketBody* m_body;
+};
+
+#endif
@@ -0,0 +1,205 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "StartupLoader.h"
+#include "Database/DatabaseEnv.h"
+#include "ProgressBar.h"
+#include "Threading.h"
+#include "Timer.h"
+#include "Log.h"
+
+#include <algorithm>
+
+class StartupLoaderThread : public ACE_Based::Runnable
+{
+    public:
+        explicit StartupLoaderThread(StartupLoader& loader) : m_loader(loader) {}
+
+        void run() override
+        {
+            WorldDatabase.ThreadStart();                    // let thread do safe mySQL requests
+            m_loader.RunTasks();
+            WorldDatabase.ThreadEnd();
+        }
+
+    private:
+        StartupLoader& m_loader;
+};
+
+StartupLoader::StartupLoader() : m_lastStep(0), m_hasStep(false), m_cond(m_lock),
+    m_finished(0), m_runStart(0), m_runTime(0), m_threads(1)
+{
+}
+
+StartupLoader::~StartupLoader()
+{
+    for (TaskList::iterator itr = m_tasks.begin(); itr != m_tasks.end(); ++itr)
+        delete itr->task;
+}
+
+uint32 StartupLoader::AddTask(char const* name, StartupLoadTask* task, bool parallel)
+{
+    uint32 id = m_tasks.size();
+    m_tasks.push_back(Task(name, task));
+
+    if (parallel)
+    {
+        if (m_hasStep)
+            AddDependency(id, m_lastStep);
+
+        m_sinceStep.push_back(id);
+        return id;
+    }
+
+    // a step waits for everything registered before it
+    if (m_sinceStep.empty())
+    {
+        if (m_hasStep)
+            AddDependency(id, m_lastStep);
+    }
+    else
+    {
+        for (std::vector<uint32>::const_iterator itr = m_sinceStep.begin(); itr != m_sinceStep.end(); ++itr)
+            AddDependency(id, *itr);
+        m_sinceStep.clear();
+    }
+
+    m_lastStep = id;
+    m_hasStep = true;
+    return id;
+}
+
+void StartupLoader::After(uint32 id, uint32 dependency)
+{
+    MANGOS_ASSERT(id < m_tasks.size() && dependency < id);
+    AddDependency(id, dependency);
+}
+
+void StartupLoader::AddDependency(uint32 id, uint32 dependency)
+{
+    m_tasks[dependency].dependents.push_back(id);
+    ++m_tasks[id].waiting;
+}
+
+void StartupLoader::Run(uint32 threads)
+{
+    m_threads = threads ? threads : 1;
+    m_runStart = WorldTimer::getMSTime();
+    m_finished = 0;
+
+    for (uint32 id = 0; id < m_tasks.size(); ++id)
+        if (!m_tasks[id].waiting)
+            m_ready.insert(id);
+
+    if (m_threads == 1)
+        RunTasks();
+    else
+    {
+        // progress bars of loaders running at the same time would overwrite each other
+        bool showProgress = BarGoLink::GetOutputState();
+        BarGoLink::SetOutputState(false);
+
+        std::vector<ACE_Based::Thread*> workers;
+        for (uint32 i = 1; i < m_threads; ++i)
+            workers.push_back(new ACE_Based::Thread(new StartupLoaderThread(*this)));
+
+        RunTasks();
+
+        for (size_t i = 0; i < workers.size(); ++i)
+        {
+            workers[i]->wait();
+            delete workers[i];
+        }
+
+        BarGoLink::SetOutputState(showProgress);
+    }
+
+    m_runTime = WorldTimer::getMSTimeDiff(m_runStart, WorldTimer::getMSTime());
+}
+
+void StartupLoader::RunTasks()
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+    while (m_finished < m_tasks.size())
+    {
+        if (m_ready.empty())
+        {
+            m_cond.wait();
+            continue;
+        }
+
+        uint32 id = *m_ready.begin();
+        m_ready.erase(m_ready.begin());
+
+        Task& task = m_tasks[id];
+        task.startTime = WorldTimer::getMSTimeDiff(m_runStart, WorldTimer::getMSTime());
+
+        m_lock.release();
+        sLog.outString("%s...", task.name);
+        uint32 startTime = WorldTimer::getMSTime();
+        task.task->Load();
+        uint32 loadTime = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+        m_lock.acquire();
+
+        task.loadTime = loadTime;
+        ++m_finished;
+
+        for (std::vector<uint32>::const_iterator itr = task.dependents.begin(); itr != task.dependents.end(); ++itr)
+            if (!--m_tasks[*itr].waiting)
+                m_ready.insert(*itr);
+
+        m_cond.broadcast();
+    }
+}
+
+struct StartupTaskTimeOrder
+{
+    StartupTaskTimeOrder(std::vector<uint32> const& times) : m_times(times) {}
+    bool operator()(uint32 a, uint32 b) const { return m_times[a] > m_times[b]; }
+
+    std::vector<uint32> const& m_times;
+};
+
+void StartupLoader::LogReport() const
+{
+    std::vector<uint32> order(m_tasks.size());
+    std::vector<uint32> times(m_tasks.size());
+    uint64 totalTime = 0;
+    for (uint32 id = 0; id < m_tasks.size(); ++id)
+    {
+        order[id] = id;
+        times[id] = m_tasks[id].loadTime;
+        totalTime += m_tasks[id].loadTime;
+    }
+
+    std::stable_sort(order.begin(), order.end(), StartupTaskTimeOrder(times));
+
+    sLog.outString();
+    sLog.outString(">> Startup loaders: %u loaders in %u ms with %u thread(s), " UI64FMTD " ms loader time",
+                   uint32(m_tasks.size()), m_runTime, m_threads, totalTime);
+
+    for (std::vector<uint32>::const_iterator itr = order.begin(); itr != order.end(); ++itr)
+    {
+        Task const& task = m_tasks[*itr];
+        sLog.outString("   %7u ms  (started at %7u ms)  %s", task.loadTime, task.startTime, task.name);
+    }
+
+    sLog.outString();
+}
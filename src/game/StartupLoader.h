@@ -0,0 +1,131 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef MANGOS_STARTUPLOADER_H
+#define MANGOS_STARTUPLOADER_H
+
+#include "Common.h"
+
+#include <vector>
+#include "ace/Thread_Mutex.h"
+#include "ace/Condition_Thread_Mutex.h"
+
+/// One step of the startup loading
+class StartupLoadTask
+{
+    public:
+        virtual ~StartupLoadTask() {}
+        virtual void Load() = 0;
+};
+
+template<class T, class R>
+class StartupLoadMethod : public StartupLoadTask
+{
+    public:
+        StartupLoadMethod(T& object, R(T::*method)()) : m_object(object), m_method(method) {}
+        void Load() override { (m_object.*m_method)(); }
+
+    private:
+        T& m_object;
+        R(T::*m_method)();
+};
+
+template<class R>
+class StartupLoadFunction : public StartupLoadTask
+{
+    public:
+        explicit StartupLoadFunction(R(*function)()) : m_function(function) {}
+        void Load() override { (*m_function)(); }
+
+    private:
+        R(*m_function)();
+};
+
+/**
+ * Dependency graph of the loaders run at server startup.
+ *
+ * Add() registers a step that runs after every earlier step and before every later one, so a list
+ * of Add() calls keeps the classic sequential order. AddParallel() registers a loader that only
+ * waits for the last Add() step and the loaders named with After(); loaders registered this way
+ * may run at the same time on different threads and must not write data another one of them reads.
+ * The next Add() step waits for all of them.
+ *
+ * With one thread the steps run in registration order. Run time of each step is kept for the report.
+ */
+class StartupLoader
+{
+    public:
+        StartupLoader();
+        ~StartupLoader();
+
+        template<class T, class R>
+        uint32 Add(char const* name, T& object, R(T::*method)()) { return AddTask(name, new StartupLoadMethod<T, R>(object, method), false); }
+        template<class R>
+        uint32 Add(char const* name, R(*function)()) { return AddTask(name, new StartupLoadFunction<R>(function), false); }
+
+        template<class T, class R>
+        uint32 AddParallel(char const* name, T& object, R(T::*method)()) { return AddTask(name, new StartupLoadMethod<T, R>(object, method), true); }
+        template<class R>
+        uint32 AddParallel(char const* name, R(*function)()) { return AddTask(name, new StartupLoadFunction<R>(function), true); }
+
+        /// Parallel loader id must not start before loader dependency is done
+        void After(uint32 id, uint32 dependency);
+
+        /// Run all registered loaders with up to threads threads (the calling thread included)
+        void Run(uint32 threads);
+
+        /// Log the run time of each loader, slowest first
+        void LogReport() const;
+
+        /// Worker loop, public for the worker threads
+        void RunTasks();
+
+    private:
+        struct Task
+        {
+            Task(char const* _name, StartupLoadTask* _task) : name(_name), task(_task), waiting(0), startTime(0), loadTime(0) {}
+
+            char const* name;
+            StartupLoadTask* task;
+            std::vector<uint32> dependents;                 // tasks waiting for this one
+            uint32 waiting;                                 // unfinished dependencies
+            uint32 startTime;                               // ms since Run
+            uint32 loadTime;                                // ms
+        };
+
+        typedef std::vector<Task> TaskList;
+
+        uint32 AddTask(char const* name, StartupLoadTask* task, bool parallel);
+        void AddDependency(uint32 id, uint32 dependency);
+
+        TaskList m_tasks;
+        uint32 m_lastStep;                                  // last Add() step, valid if m_hasStep
+        bool m_hasStep;
+        std::vector<uint32> m_sinceStep;                    // AddParallel() loaders since the last step
+
+        ACE_Thread_Mutex m_lock;
+        ACE_Condition_Thread_Mutex m_cond;
+        std::set<uint32> m_ready;                           // lowest id first keeps the registration order
+        uint32 m_finished;
+        uint32 m_runStart;
+        uint32 m_runTime;
+        uint32 m_threads;
+};
+
+#endif
@@ -477,7 +477,7 @@ void WorldSession::HandleAcceptTradeOpcode(WorldPacket& recvPacket)
         trader->m_trade = NULL;
 
         // desynchronized with the other saves here (SaveInventoryAndGoldToDB() not have own transaction guards)
-        CharacterDatabase.BeginTransaction();
+        CharacterDatabase.BeginTransaction(_player->GetObjectGuid().GetRawValue(), trader->GetObjectGuid().GetRawValue());
         _player->SaveInventoryAndGoldToDB();
         trader->SaveInventoryAndGoldToDB();
         CharacterDatabase.CommitTransaction();
@@ -24,9 +24,67 @@
 #include "Opcodes.h"
 #include "World.h"
 #include "ObjectGuid.h"
+#include "PerfStats.h"
 #include <zlib/zlib.h>
+#include <ace/TSS_T.h>
 
-UpdateData::UpdateData() : m_blockCount(0)
+/// Deflate streams of one thread, created at first use of a level and reused with deflateReset
+class UpdateCompressor
+{
+    public:
+        UpdateCompressor()
+        {
+            for (int i = 0; i <= Z_BEST_COMPRESSION; ++i)
+                m_initialized[i] = false;
+        }
+
+        ~UpdateCompressor()
+        {
+            for (int i = 0; i <= Z_BEST_COMPRESSION; ++i)
+                if (m_initialized[i])
+                    deflateEnd(&m_streams[i]);
+        }
+
+        /// Stream ready for a new packet, NULL on error
+        z_stream* GetStream(int level)
+        {
+            z_stream& c_stream = m_streams[level];
+
+            if (m_initialized[level])
+            {
+                int z_res = deflateReset(&c_stream);
+                if (z_res == Z_OK)
+                    return &c_stream;
+
+                sLog.outError("Can't compress update packet (zlib: deflateReset) Error code: %i (%s)", z_res, zError(z_res));
+                deflateEnd(&c_stream);
+                m_initialized[level] = false;
+            }
+
+            c_stream.zalloc = (alloc_func)0;
+            c_stream.zfree = (free_func)0;
+            c_stream.opaque = (voidpf)0;
+
+            int z_res = deflateInit(&c_stream, level);
+            if (z_res != Z_OK)
+            {
+                sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+                return NULL;
+            }
+
+            m_initialized[level] = true;
+            return &c_stream;
+        }
+
+    private:
+        z_stream m_streams[Z_BEST_COMPRESSION + 1];
+        bool m_initialized[Z_BEST_COMPRESSION + 1];
+};
+
+// update packets are built in all map update threads
+static ACE_TSS<UpdateCompressor> updateCompressor;
+
+UpdateData::UpdateData() : m_blockCount(0), m_createBlockCount(0), m_bufferGrowths(0)
 {
 }
 
@@ -42,33 +100,32 @@ void UpdateData::AddOutOfRangeGUID(ObjectGuid const& guid)
 
 void UpdateData::AddUpdateBlock(const ByteBuffer& block)
 {
+    size_t capacity = m_data.capacity();
     m_data.append(block);
     ++m_blockCount;
-}
 
-void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
-{
-    z_stream c_stream;
+    if (!block.empty() && (block[0] == UPDATETYPE_CREATE_OBJECT || block[0] == UPDATETYPE_CREATE_OBJECT2))
+        ++m_createBlockCount;
 
-    c_stream.zalloc = (alloc_func)0;
-    c_stream.zfree = (free_func)0;
-    c_stream.opaque = (voidpf)0;
+    if (m_data.capacity() != capacity)
+        ++m_bufferGrowths;
+}
 
-    // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
-    if (z_res != Z_OK)
+void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size, int level)
+{
+    z_stream* c_stream = updateCompressor->GetStream(level);
+    if (!c_stream)
     {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
         *dst_size = 0;
         return;
     }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+    c_stream->next_out = (Bytef*)dst;
+    c_stream->avail_out = *dst_size;
+    c_stream->next_in = (Bytef*)src;
+    c_stream->avail_in = (uInt)src_size;
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
+    int z_res = deflate(c_stream, Z_NO_FLUSH);
     if (z_res != Z_OK)
     {
         sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
@@ -76,14 +133,14 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
         return;
     }
 
-    if (c_stream.avail_in != 0)
+    if (c_stream->avail_in != 0)
     {
         sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
         *dst_size = 0;
         return;
     }
 
-    z_res = deflate(&c_stream, Z_FINISH);
+    z_res = deflate(c_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
         sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
@@ -91,22 +148,21 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    *dst_size = c_stream.total_out;
+    *dst_size = c_stream->total_out;
 }
 
 bool UpdateData::BuildPacket(WorldPacket* packet, bool hasTransport)
+{
+    ByteBuffer buf(0);
+    return BuildPacket(packet, buf, hasTransport);
+}
+
+bool UpdateData::BuildPacket(WorldPacket* packet, ByteBuffer& buf, bool hasTransport)
 {
     MANGOS_ASSERT(packet->empty());                         // shouldn't happen
 
-    ByteBuffer buf(4 + 1 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + m_data.wpos());
+    buf.clear();
+    buf.reserve(4 + 1 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + m_data.wpos());
 
     buf << (uint32)(!m_outOfRangeGUIDs.empty() ? m_blockCount + 1 : m_blockCount);
     buf << (uint8)(hasTransport ? 1 : 0);
@@ -124,16 +180,27 @@ bool UpdateData::BuildPacket(WorldPacket* packet, bool hasTransport)
 
     size_t pSize = buf.wpos();                              // use real used data size
 
-    if (pSize > 100)                                        // compress large packets
+    if (pSize > sWorld.getConfig(CONFIG_UINT32_COMPRESSION_THRESHOLD))  // compress large packets
     {
+        // create object packets (login, teleport) are the largest ones, they may use a faster level
+        bool createObject = m_createBlockCount > 0;
+        uint32 level = createObject ? sWorld.getConfig(CONFIG_UINT32_COMPRESSION_CREATE_OBJECT) : 0;
+        if (!level)
+            level = sWorld.getConfig(CONFIG_UINT32_COMPRESSION);
+
+        uint64 startTime = sPerfStats.IsEnabled() ? PerfStats::GetMicroTime() : 0;
+
         uint32 destsize = compressBound(pSize);
         packet->resize(destsize + sizeof(uint32));
 
         packet->put<uint32>(0, pSize);
-        Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, (void*)buf.contents(), pSize);
+        Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, (void*)buf.contents(), pSize, int(level));
         if (destsize == 0)
             return false;
 
+        if (startTime)
+            sPerfStats.AddCompressionSample(createObject, pSize, destsize, uint32(PerfStats::GetMicroTime() - startTime));
+
         packet->resize(destsize + sizeof(uint32));
         packet->SetOpcode(SMSG_COMPRESSED_UPDATE_OBJECT);
     }
@@ -151,4 +218,6 @@ void UpdateData::Clear()
     m_data.clear();
     m_outOfRangeGUIDs.clear();
     m_blockCount = 0;
+    m_createBlockCount = 0;
+    m_bufferGrowths = 0;
 }
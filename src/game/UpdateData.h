@@ -56,16 +56,24 @@ class UpdateData
         void AddOutOfRangeGUID(ObjectGuid const& guid);
         void AddUpdateBlock(const ByteBuffer& block);
         bool BuildPacket(WorldPacket* packet, bool hasTransport = false);
-        bool HasData() { return m_blockCount > 0 || !m_outOfRangeGUIDs.empty(); }
+        /// Same as above, buf is used for the uncompressed data and can be reused between calls
+        bool BuildPacket(WorldPacket* packet, ByteBuffer& buf, bool hasTransport = false);
+        bool HasData() const { return m_blockCount > 0 || !m_outOfRangeGUIDs.empty(); }
+        /// Clear the data, the allocated buffer is kept for reuse
         void Clear();
 
+        /// Number of times the block buffer had to grow since the last Clear
+        uint32 GetBufferGrowths() const { return m_bufferGrowths; }
+
         GuidSet const& GetOutOfRangeGUIDs() const { return m_outOfRangeGUIDs; }
 
     protected:
         uint32 m_blockCount;
+        uint32 m_createBlockCount;
         GuidSet m_outOfRangeGUIDs;
         ByteBuffer m_data;
+        uint32 m_bufferGrowths;
 
-        void Compress(void* dst, uint32* dst_size, void* src, int src_size);
+        void Compress(void* dst, uint32* dst_size, void* src, int src_size, int level);
 };
 #endif
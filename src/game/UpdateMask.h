@@ -22,6 +22,24 @@
 #include "UpdateFields.h"
 #include "Errors.h"
 
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#  define UPDATEMASK_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define UPDATEMASK_SSE2
+#endif
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+/**
+ * Bit per update field, stored in 32 bit blocks exactly as sent to the client.
+ *
+ * Also used by Object to track changed fields, so a values update mask is built
+ * with whole block operations and set bits are visited without testing every field.
+ */
 class UpdateMask
 {
     public:
@@ -48,6 +66,28 @@ class UpdateMask
             return (((uint8*)mUpdateMask)[ index >> 3 ] & (1 << (index & 0x7))) != 0;
         }
 
+        /// Index of the first set bit at or after index, GetCount() if there is none
+        uint32 FindNextSetBit(uint32 index) const
+        {
+            uint32 block = index >> 5;
+            if (block >= mBlocks)
+                return mCount;
+
+            uint32 bits = mUpdateMask[block] & (0xFFFFFFFF << (index & 0x1F));
+            while (!bits)
+            {
+                block = SkipEmptyBlocks(block + 1);
+                if (block >= mBlocks)
+                    return mCount;
+
+                bits = mUpdateMask[block];
+            }
+
+            return (block << 5) + CountTrailingZeros(bits);
+        }
+
+        uint32 FindFirstSetBit() const { return FindNextSetBit(0); }
+
         uint32 GetBlockCount() const { return mBlocks; }
         uint32 GetLength() const { return mBlocks << 2; }
         uint32 GetCount() const { return mCount; }
@@ -115,6 +155,47 @@ class UpdateMask
         }
 
     private:
+        /// First block at or after block that has any bit set, may return a value >= mBlocks
+        uint32 SkipEmptyBlocks(uint32 block) const
+        {
+#if defined(UPDATEMASK_AVX2)
+            for (; block + 8 <= mBlocks; block += 8)
+            {
+                __m256i bits = _mm256_loadu_si256((__m256i const*)(mUpdateMask + block));
+                if (!_mm256_testz_si256(bits, bits))
+                    break;
+            }
+#elif defined(UPDATEMASK_SSE2)
+            __m128i const zero = _mm_setzero_si128();
+            for (; block + 4 <= mBlocks; block += 4)
+            {
+                __m128i bits = _mm_loadu_si128((__m128i const*)(mUpdateMask + block));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(bits, zero)) != 0xFFFF)
+                    break;
+            }
+#endif
+            while (block < mBlocks && !mUpdateMask[block])
+                ++block;
+
+            return block;
+        }
+
+        static uint32 CountTrailingZeros(uint32 bits)
+        {
+#if defined(__GNUC__)
+            return __builtin_ctz(bits);
+#elif defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward(&index, bits);
+            return index;
+#else
+            uint32 count = 0;
+            for (; !(bits & 1); bits >>= 1)
+                ++count;
+            return count;
+#endif
+        }
+
         uint32 mCount;
         uint32 mBlocks;
         uint32* mUpdateMask;
@@ -54,6 +54,7 @@
 #include "GameEventMgr.h"
 #include "PoolManager.h"
 #include "Database/DatabaseImpl.h"
+#include "Database/SnapshotFile.h"
 #include "GridNotifiersImpl.h"
 #include "CellImpl.h"
 #include "MapPersistentStateMgr.h"
@@ -64,6 +65,11 @@
 #include "CharacterDatabaseCleaner.h"
 #include "CreatureLinkingMgr.h"
 #include "LuaEngine.h"
+#include "PerfStats.h"
+#include "PlayerSaveScheduler.h"
+#include "StartupLoader.h"
+#include "revision.h"
+#include "revision_nr.h"
 
 INSTANTIATE_SINGLETON_1(World);
 
@@ -511,12 +517,17 @@ void World::LoadConfigSettings(bool reload)
 
     ///- Read other configuration items from the config file
     setConfigMinMax(CONFIG_UINT32_COMPRESSION, "Compression", 1, 1, 9);
+    setConfig(CONFIG_UINT32_COMPRESSION_THRESHOLD, "Compression.Threshold", 100);
+    setConfigMinMax(CONFIG_UINT32_COMPRESSION_CREATE_OBJECT, "Compression.CreateObjectLevel", 0, 0, 9);
     setConfig(CONFIG_BOOL_ADDON_CHANNEL, "AddonChannel", true);
     setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB, "CleanCharacterDB", true);
     setConfig(CONFIG_BOOL_GRID_UNLOAD, "GridUnload", true);
     setConfig(CONFIG_UINT32_INTERVAL_SAVE, "PlayerSave.Interval", 15 * MINUTE * IN_MILLISECONDS);
+    setConfig(CONFIG_UINT32_PLAYER_SAVE_MAX_PER_TICK, "PlayerSave.MaxPerTick", 20);
+    setConfig(CONFIG_UINT32_PLAYER_SAVE_BYTES_PER_SECOND, "PlayerSave.MaxBytesPerSecond", 0);
     setConfigMinMax(CONFIG_UINT32_MIN_LEVEL_STAT_SAVE, "PlayerSave.Stats.MinLevel", 0, 0, MAX_LEVEL);
     setConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT, "PlayerSave.Stats.SaveOnlyOnLogout", true);
+    setConfig(CONFIG_UINT32_RESULT_QUEUE_MAX_TIME, "ResultQueue.MaxTime", 20);
 
     setConfigMin(CONFIG_UINT32_INTERVAL_GRIDCLEAN, "GridCleanUpDelay", 5 * MINUTE * IN_MILLISECONDS, MIN_GRID_DELAY);
     if (reload)
@@ -526,6 +537,17 @@ void World::LoadConfigSettings(bool reload)
     if (reload)
         sMapMgr.SetMapUpdateInterval(getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 
+    if (configNoReload(reload, CONFIG_UINT32_MAP_UPDATE_THREADS, "MapUpdate.Threads", 0))
+        setConfig(CONFIG_UINT32_MAP_UPDATE_THREADS, "MapUpdate.Threads", 0);
+    setConfig(CONFIG_BOOL_MAP_UPDATE_CELL_ISLANDS, "MapUpdate.CellIslands", false);
+
+    setConfig(CONFIG_BOOL_PERF_STATS_ENABLE, "PerfStats.Enable", false);
+    setConfig(CONFIG_UINT32_PERF_STATS_DUMP_INTERVAL, "PerfStats.DumpInterval", 0);
+    sPerfStats.Initialize(getConfig(CONFIG_BOOL_PERF_STATS_ENABLE), getConfig(CONFIG_UINT32_PERF_STATS_DUMP_INTERVAL),
+                          sConfig.GetStringDefault("PerfStats.DumpFile", "PerfStats.log"));
+
+    setConfigMinMax(CONFIG_UINT32_STARTUP_LOAD_THREADS, "Startup.LoadThreads", 1, 1, 16);
+
     setConfig(CONFIG_UINT32_INTERVAL_CHANGEWEATHER, "ChangeWeatherInterval", 10 * MINUTE * IN_MILLISECONDS);
 
     if (configNoReload(reload, CONFIG_UINT32_PORT_WORLD, "WorldServerPort", DEFAULT_WORLDSERVER_PORT))
@@ -820,6 +842,14 @@ void World::LoadConfigSettings(bool reload)
         sLog.outString("Using DataDir %s", m_dataPath.c_str());
     }
 
+    ///- Snapshots of the static world tables, also used by table reloads
+    ///  the validated data depends on the build and the client data too
+    std::string snapshotDir = sConfig.GetStringDefault("SnapshotDir", "");
+    SnapshotFile::SetDirectory(snapshotDir);
+    SnapshotFile::SetEnvironment(_FULLVERSION(REVISION_DATE, REVISION_TIME, REVISION_NR, REVISION_ID), m_dataPath + "dbc/");
+    if (!snapshotDir.empty() && !reload)
+        sLog.outString("Using SnapshotDir %s", snapshotDir.c_str());
+
     setConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK, "vmap.enableIndoorCheck", true);
     bool enableLOS = sConfig.GetBoolDefault("vmap.enableLOS", false);
     bool enableHeight = sConfig.GetBoolDefault("vmap.enableHeight", false);
@@ -843,6 +873,22 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_ELUNA_ENABLED, "Eluna.Enabled", false);
 }
 
+/// Startup loaders with arguments, see World::SetInitialWorldSettings
+static void ReturnOldMails()
+{
+    sObjectMgr.ReturnOrDeleteOldMails(false);
+}
+
+static void LoadCreatureEventAITexts()
+{
+    sEventAIMgr.LoadCreatureEventAI_Texts(false);           // false, will checked in LoadCreatureEventAI_Scripts
+}
+
+static void LoadCreatureEventAISummons()
+{
+    sEventAIMgr.LoadCreatureEventAI_Summons(false);         // false, will checked in LoadCreatureEventAI_Scripts
+}
+
 /// Initialize the World
 void World::SetInitialWorldSettings()
 {
@@ -926,297 +972,171 @@ void World::SetInitialWorldSettings()
     sObjectMgr.SetHighestGuids();                           // must be after packing instances
     sLog.outString();
 
-    sLog.outString("Loading Page Texts...");
-    sObjectMgr.LoadPageTexts();
-
-    sLog.outString("Loading Game Object Templates...");     // must be after LoadPageTexts
-    sObjectMgr.LoadGameobjectInfo();
-
-    sLog.outString("Loading GameObject models...");
-    LoadGameObjectModelList();
-
-    sLog.outString("Loading Spell Chain Data...");
-    sSpellMgr.LoadSpellChains();
-
-    sLog.outString("Loading Spell Elixir types...");
-    sSpellMgr.LoadSpellElixirs();
-
-    sLog.outString("Loading Spell Facing Flags...");
-    sSpellMgr.LoadFacingCasterFlags();
-
-    sLog.outString("Loading Spell Learn Skills...");
-    sSpellMgr.LoadSpellLearnSkills();                       // must be after LoadSpellChains
-
-    sLog.outString("Loading Spell Learn Spells...");
-    sSpellMgr.LoadSpellLearnSpells();
-
-    sLog.outString("Loading Spell Proc Event conditions...");
-    sSpellMgr.LoadSpellProcEvents();
-
-    sLog.outString("Loading Spell Bonus Data...");
-    sSpellMgr.LoadSpellBonuses();
-
-    sLog.outString("Loading Spell Proc Item Enchant...");
-    sSpellMgr.LoadSpellProcItemEnchant();                   // must be after LoadSpellChains
-
-    sLog.outString("Loading Aggro Spells Definitions...");
-    sSpellMgr.LoadSpellThreats();
-
-    sLog.outString("Loading NPC Texts...");
-    sObjectMgr.LoadGossipText();
-
-    sLog.outString("Loading Item Random Enchantments Table...");
-    LoadRandomEnchantmentsTable();
-
-    sLog.outString("Loading Items...");                     // must be after LoadRandomEnchantmentsTable and LoadPageTexts
-    sObjectMgr.LoadItemPrototypes();
-
-    sLog.outString("Loading Item Texts...");
-    sObjectMgr.LoadItemTexts();
-
-    sLog.outString("Loading Creature Model Based Info Data...");
-    sObjectMgr.LoadCreatureModelInfo();
-
-    sLog.outString("Loading Equipment templates...");
-    sObjectMgr.LoadEquipmentTemplates();
-
-    sLog.outString("Loading Creature Stats...");
-    sObjectMgr.LoadCreatureClassLvlStats();
-
-    sLog.outString("Loading Creature templates...");
-    sObjectMgr.LoadCreatureTemplates();
-
-    sLog.outString("Loading Creature template spells...");
-    sObjectMgr.LoadCreatureTemplateSpells();
-
-    sLog.outString("Loading SpellsScriptTarget...");
-    sSpellMgr.LoadSpellScriptTarget();                      // must be after LoadCreatureTemplates and LoadGameobjectInfo
-
-    sLog.outString("Loading ItemRequiredTarget...");
-    sObjectMgr.LoadItemRequiredTarget();
-
-    sLog.outString("Loading Reputation Reward Rates...");
-    sObjectMgr.LoadReputationRewardRate();
-
-    sLog.outString("Loading Creature Reputation OnKill Data...");
-    sObjectMgr.LoadReputationOnKill();
-
-    sLog.outString("Loading Reputation Spillover Data...");
-    sObjectMgr.LoadReputationSpilloverTemplate();
-
-    sLog.outString("Loading Points Of Interest Data...");
-    sObjectMgr.LoadPointsOfInterest();
-
-    sLog.outString("Loading Pet Create Spells...");
-    sObjectMgr.LoadPetCreateSpells();
-
-    sLog.outString("Loading Creature Data...");
-    sObjectMgr.LoadCreatures();
-
-    sLog.outString("Loading Creature Addon Data...");
-    sLog.outString();
-    sObjectMgr.LoadCreatureAddons();                        // must be after LoadCreatureTemplates() and LoadCreatures()
-    sLog.outString(">>> Creature Addon Data loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Gameobject Data...");
-    sObjectMgr.LoadGameObjects();
-
-    sLog.outString("Loading CreatureLinking Data...");      // must be after Creatures
-    sCreatureLinkingMgr.LoadFromDB();
-
-    sLog.outString("Loading Objects Pooling Data...");
-    sPoolMgr.LoadFromDB();
-
-    sLog.outString("Loading Weather Data...");
-    sObjectMgr.LoadWeatherZoneChances();
-
-    sLog.outString("Loading Quests...");
-    sObjectMgr.LoadQuests();                                // must be loaded after DBCs, creature_template, item_template, gameobject tables
-
-    sLog.outString("Loading Quests Relations...");
-    sLog.outString();
-    sObjectMgr.LoadQuestRelations();                        // must be after quest load
-    sLog.outString(">>> Quests Relations loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Game Event Data...");           // must be after sPoolMgr.LoadFromDB and quests to properly load pool events and quests for events
-    sLog.outString();
-    sGameEventMgr.LoadFromDB();
-    sLog.outString(">>> Game Event Data loaded");
-    sLog.outString();
-
-    // Load Conditions
-    sLog.outString("Loading Conditions...");
-    sObjectMgr.LoadConditions();
-
-    sLog.outString("Creating map persistent states for non-instanceable maps...");     // must be after PackInstances(), LoadCreatures(), sPoolMgr.LoadFromDB(), sGameEventMgr.LoadFromDB();
-    sMapPersistentStateMgr.InitWorldMaps();
-
-    sLog.outString("Loading Creature Respawn Data...");     // must be after LoadCreatures(), and sMapPersistentStateMgr.InitWorldMaps()
-    sMapPersistentStateMgr.LoadCreatureRespawnTimes();
-
-    sLog.outString("Loading Gameobject Respawn Data...");   // must be after LoadGameObjects(), and sMapPersistentStateMgr.InitWorldMaps()
-    sMapPersistentStateMgr.LoadGameobjectRespawnTimes();
-
-    sLog.outString("Loading SpellArea Data...");            // must be after quest load
-    sSpellMgr.LoadSpellAreas();
-
-    sLog.outString("Loading AreaTrigger definitions...");
-    sObjectMgr.LoadAreaTriggerTeleports();                  // must be after item template load
-
-    sLog.outString("Loading Quest Area Triggers...");
-    sObjectMgr.LoadQuestAreaTriggers();                     // must be after LoadQuests
-
-    sLog.outString("Loading Tavern Area Triggers...");
-    sObjectMgr.LoadTavernAreaTriggers();
-
-    sLog.outString("Loading AreaTrigger script names...");
-    sScriptMgr.LoadAreaTriggerScripts();
-
-    sLog.outString("Loading event id script names...");
-    sScriptMgr.LoadEventIdScripts();
-
-    sLog.outString("Loading Graveyard-zone links...");
-    sObjectMgr.LoadGraveyardZones();
-
-    sLog.outString("Loading spell target destination coordinates...");
-    sSpellMgr.LoadSpellTargetPositions();
-
-    sLog.outString("Loading SpellAffect definitions...");
-    sSpellMgr.LoadSpellAffects();
-
-    sLog.outString("Loading spell pet auras...");
-    sSpellMgr.LoadSpellPetAuras();
-
-    sLog.outString("Loading Player Create Info & Level Stats...");
-    sLog.outString();
-    sObjectMgr.LoadPlayerInfo();
-    sLog.outString(">>> Player Create Info & Level Stats loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Exploration BaseXP Data...");
-    sObjectMgr.LoadExplorationBaseXP();
-
-    sLog.outString("Loading Pet Name Parts...");
-    sObjectMgr.LoadPetNames();
-
-    CharacterDatabaseCleaner::CleanDatabase();
-
-    sLog.outString("Loading the max pet number...");
-    sObjectMgr.LoadPetNumber();
-
-    sLog.outString("Loading pet level stats...");
-    sObjectMgr.LoadPetLevelInfo();
-
-    sLog.outString("Loading Player Corpses...");
-    sObjectMgr.LoadCorpses();
-
-    sLog.outString("Loading Loot Tables...");
-    sLog.outString();
-    LoadLootTables();
-    sLog.outString(">>> Loot Tables loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Skill Fishing base level requirements...");
-    sObjectMgr.LoadFishingBaseSkillLevel();
-
-    sLog.outString("Loading Npc Text Id...");
-    sObjectMgr.LoadNpcGossips();                            // must be after load Creature and LoadGossipText
-
-    sLog.outString("Loading Gossip scripts...");
-    sScriptMgr.LoadGossipScripts();                         // must be before gossip menu options
-
-    sObjectMgr.LoadGossipMenus();
-
-    sLog.outString("Loading Vendors...");
-    sObjectMgr.LoadVendorTemplates();                       // must be after load ItemTemplate
-    sObjectMgr.LoadVendors();                               // must be after load CreatureTemplate, VendorTemplate, and ItemTemplate
-
-    sLog.outString("Loading Trainers...");
-    sObjectMgr.LoadTrainerTemplates();                      // must be after load CreatureTemplate
-    sObjectMgr.LoadTrainers();                              // must be after load CreatureTemplate, TrainerTemplate
-
-    sLog.outString("Loading Waypoint scripts...");          // before loading from creature_movement
-    sScriptMgr.LoadCreatureMovementScripts();
-
-    sLog.outString("Loading Waypoints...");
-    sLog.outString();
-    sWaypointMgr.Load();
+    ///- Load the world data, loaders registered with AddParallel may run at the same time (see Startup.LoadThreads)
+    StartupLoader loader;
+
+    uint32 pageTexts = loader.AddParallel("Loading Page Texts", sObjectMgr, &ObjectMgr::LoadPageTexts);
+    uint32 goInfo = loader.AddParallel("Loading Game Object Templates", sObjectMgr, &ObjectMgr::LoadGameobjectInfo);
+    loader.After(goInfo, pageTexts);
+    loader.AddParallel("Loading GameObject models", &LoadGameObjectModelList);
+
+    // spell data loaders only depend on the spell chains, they run in sequence as one lane
+    uint32 spellLane = loader.AddParallel("Loading Spell Chain Data", sSpellMgr, &SpellMgr::LoadSpellChains);
+    uint32 spellLoader = loader.AddParallel("Loading Spell Elixir types", sSpellMgr, &SpellMgr::LoadSpellElixirs);
+    loader.After(spellLoader, spellLane);
+    spellLane = spellLoader;
+    spellLoader = loader.AddParallel("Loading Spell Facing Flags", sSpellMgr, &SpellMgr::LoadFacingCasterFlags);
+    loader.After(spellLoader, spellLane);
+    spellLane = spellLoader;
+    spellLoader = loader.AddParallel("Loading Spell Learn Skills", sSpellMgr, &SpellMgr::LoadSpellLearnSkills);
+    loader.After(spellLoader, spellLane);
+    spellLane = spellLoader;
+    spellLoader = loader.AddParallel("Loading Spell Learn Spells", sSpellMgr, &SpellMgr::LoadSpellLearnSpells);
+    loader.After(spellLoader, spellLane);
+    spellLane = spellLoader;
+    spellLoader = loader.AddParallel("Loading Spell Proc Event conditions", sSpellMgr, &SpellMgr::LoadSpellProcEvents);
+    loader.After(spellLoader, spellLane);
+    spellLane = spellLoader;
+    spellLoader = loader.AddParallel("Loading Spell Bonus Data", sSpellMgr, &SpellMgr::LoadSpellBonuses);
+    loader.After(spellLoader, spellLane);
+    spellLane = spellLoader;
+    spellLoader = loader.AddParallel("Loading Spell Proc Item Enchant", sSpellMgr, &SpellMgr::LoadSpellProcItemEnchant);
+    loader.After(spellLoader, spellLane);
+    spellLane = spellLoader;
+    spellLoader = loader.AddParallel("Loading Aggro Spells Definitions", sSpellMgr, &SpellMgr::LoadSpellThreats);
+    loader.After(spellLoader, spellLane);
+
+    loader.AddParallel("Loading NPC Texts", sObjectMgr, &ObjectMgr::LoadGossipText);
+
+    uint32 randomEnchants = loader.AddParallel("Loading Item Random Enchantments Table", &LoadRandomEnchantmentsTable);
+    uint32 items = loader.AddParallel("Loading Items", sObjectMgr, &ObjectMgr::LoadItemPrototypes);
+    loader.After(items, randomEnchants);
+    loader.After(items, pageTexts);
+    loader.AddParallel("Loading Item Texts", sObjectMgr, &ObjectMgr::LoadItemTexts);
+
+    uint32 modelInfo = loader.AddParallel("Loading Creature Model Based Info Data", sObjectMgr, &ObjectMgr::LoadCreatureModelInfo);
+    uint32 equipment = loader.AddParallel("Loading Equipment templates", sObjectMgr, &ObjectMgr::LoadEquipmentTemplates);
+    loader.After(equipment, items);
+    uint32 classLvlStats = loader.AddParallel("Loading Creature Stats", sObjectMgr, &ObjectMgr::LoadCreatureClassLvlStats);
+    uint32 creatureTemplates = loader.AddParallel("Loading Creature templates", sObjectMgr, &ObjectMgr::LoadCreatureTemplates);
+    loader.After(creatureTemplates, modelInfo);
+    loader.After(creatureTemplates, equipment);
+    loader.After(creatureTemplates, classLvlStats);
+    uint32 templateSpells = loader.AddParallel("Loading Creature template spells", sObjectMgr, &ObjectMgr::LoadCreatureTemplateSpells);
+    loader.After(templateSpells, creatureTemplates);
+
+    uint32 scriptTargets = loader.AddParallel("Loading SpellsScriptTarget", sSpellMgr, &SpellMgr::LoadSpellScriptTarget);
+    loader.After(scriptTargets, creatureTemplates);
+    loader.After(scriptTargets, goInfo);
+    uint32 itemTargets = loader.AddParallel("Loading ItemRequiredTarget", sObjectMgr, &ObjectMgr::LoadItemRequiredTarget);
+    loader.After(itemTargets, scriptTargets);
+    loader.After(itemTargets, items);
+
+    loader.AddParallel("Loading Reputation Reward Rates", sObjectMgr, &ObjectMgr::LoadReputationRewardRate);
+    uint32 repOnKill = loader.AddParallel("Loading Creature Reputation OnKill Data", sObjectMgr, &ObjectMgr::LoadReputationOnKill);
+    loader.After(repOnKill, creatureTemplates);
+    loader.AddParallel("Loading Reputation Spillover Data", sObjectMgr, &ObjectMgr::LoadReputationSpilloverTemplate);
+    loader.AddParallel("Loading Points Of Interest Data", sObjectMgr, &ObjectMgr::LoadPointsOfInterest);
+    uint32 petSpells = loader.AddParallel("Loading Pet Create Spells", sObjectMgr, &ObjectMgr::LoadPetCreateSpells);
+    loader.After(petSpells, creatureTemplates);
+
+    loader.Add("Loading Creature Data", sObjectMgr, &ObjectMgr::LoadCreatures);
+    loader.Add("Loading Creature Addon Data", sObjectMgr, &ObjectMgr::LoadCreatureAddons);                 // must be after LoadCreatureTemplates() and LoadCreatures()
+    loader.Add("Loading Gameobject Data", sObjectMgr, &ObjectMgr::LoadGameObjects);
+    loader.Add("Loading CreatureLinking Data", sCreatureLinkingMgr, &CreatureLinkingMgr::LoadFromDB);      // must be after Creatures
+    loader.Add("Loading Objects Pooling Data", sPoolMgr, &PoolManager::LoadFromDB);
+    loader.Add("Loading Weather Data", sObjectMgr, &ObjectMgr::LoadWeatherZoneChances);
+    loader.Add("Loading Quests", sObjectMgr, &ObjectMgr::LoadQuests);                                      // must be loaded after DBCs, creature_template, item_template, gameobject tables
+    loader.Add("Loading Quests Relations", sObjectMgr, &ObjectMgr::LoadQuestRelations);                     // must be after quest load
+    loader.Add("Loading Game Event Data", sGameEventMgr, &GameEventMgr::LoadFromDB);                        // must be after sPoolMgr.LoadFromDB and quests to properly load pool events and quests for events
+    loader.Add("Loading Conditions", sObjectMgr, &ObjectMgr::LoadConditions);
+    // must be after PackInstances(), LoadCreatures(), sPoolMgr.LoadFromDB(), sGameEventMgr.LoadFromDB();
+    loader.Add("Creating map persistent states for non-instanceable maps", sMapPersistentStateMgr, &MapPersistentStateManager::InitWorldMaps);
+    // must be after LoadCreatures()/LoadGameObjects(), and sMapPersistentStateMgr.InitWorldMaps()
+    loader.Add("Loading Creature Respawn Data", sMapPersistentStateMgr, &MapPersistentStateManager::LoadCreatureRespawnTimes);
+    loader.Add("Loading Gameobject Respawn Data", sMapPersistentStateMgr, &MapPersistentStateManager::LoadGameobjectRespawnTimes);
+    loader.Add("Loading SpellArea Data", sSpellMgr, &SpellMgr::LoadSpellAreas);                            // must be after quest load
+    loader.Add("Loading AreaTrigger definitions", sObjectMgr, &ObjectMgr::LoadAreaTriggerTeleports);        // must be after item template load
+    loader.Add("Loading Quest Area Triggers", sObjectMgr, &ObjectMgr::LoadQuestAreaTriggers);              // must be after LoadQuests
+    loader.Add("Loading Tavern Area Triggers", sObjectMgr, &ObjectMgr::LoadTavernAreaTriggers);
+    loader.Add("Loading AreaTrigger script names", sScriptMgr, &ScriptMgr::LoadAreaTriggerScripts);
+    loader.Add("Loading event id script names", sScriptMgr, &ScriptMgr::LoadEventIdScripts);
+    loader.Add("Loading Graveyard-zone links", sObjectMgr, &ObjectMgr::LoadGraveyardZones);
+    loader.Add("Loading spell target destination coordinates", sSpellMgr, &SpellMgr::LoadSpellTargetPositions);
+    loader.Add("Loading SpellAffect definitions", sSpellMgr, &SpellMgr::LoadSpellAffects);
+    loader.Add("Loading spell pet auras", sSpellMgr, &SpellMgr::LoadSpellPetAuras);
+    loader.Add("Loading Player Create Info & Level Stats", sObjectMgr, &ObjectMgr::LoadPlayerInfo);
+    loader.Add("Loading Exploration BaseXP Data", sObjectMgr, &ObjectMgr::LoadExplorationBaseXP);
+    loader.Add("Loading Pet Name Parts", sObjectMgr, &ObjectMgr::LoadPetNames);
+    loader.Add("Cleaning character database", &CharacterDatabaseCleaner::CleanDatabase);
+    loader.Add("Loading the max pet number", sObjectMgr, &ObjectMgr::LoadPetNumber);
+    loader.Add("Loading pet level stats", sObjectMgr, &ObjectMgr::LoadPetLevelInfo);
+    loader.Add("Loading Player Corpses", sObjectMgr, &ObjectMgr::LoadCorpses);
+
+    // loot stores only read the templates loaded above, the reference loot check needs all of them
+    loader.AddParallel("Loading Creature Loot Tables", &LoadLootTemplates_Creature);
+    loader.AddParallel("Loading Fishing Loot Tables", &LoadLootTemplates_Fishing);
+    loader.AddParallel("Loading Gameobject Loot Tables", &LoadLootTemplates_Gameobject);
+    loader.AddParallel("Loading Item Loot Tables", &LoadLootTemplates_Item);
+    loader.AddParallel("Loading Mail Loot Tables", &LoadLootTemplates_Mail);
+    loader.AddParallel("Loading Pickpocketing Loot Tables", &LoadLootTemplates_Pickpocketing);
+    loader.AddParallel("Loading Skinning Loot Tables", &LoadLootTemplates_Skinning);
+    loader.AddParallel("Loading Disenchant Loot Tables", &LoadLootTemplates_Disenchant);
+    loader.Add("Loading Reference Loot Tables", &LoadLootTemplates_Reference);
+
+    loader.Add("Loading Skill Fishing base level requirements", sObjectMgr, &ObjectMgr::LoadFishingBaseSkillLevel);
+    loader.Add("Loading Npc Text Id", sObjectMgr, &ObjectMgr::LoadNpcGossips);                              // must be after load Creature and LoadGossipText
+    loader.Add("Loading Gossip scripts", sScriptMgr, &ScriptMgr::LoadGossipScripts);                        // must be before gossip menu options
+    loader.Add("Loading Gossip menus", sObjectMgr, &ObjectMgr::LoadGossipMenus);
+    loader.Add("Loading Vendor templates", sObjectMgr, &ObjectMgr::LoadVendorTemplates);                    // must be after load ItemTemplate
+    loader.Add("Loading Vendors", sObjectMgr, &ObjectMgr::LoadVendors);                                     // must be after load CreatureTemplate, VendorTemplate, and ItemTemplate
+    loader.Add("Loading Trainer templates", sObjectMgr, &ObjectMgr::LoadTrainerTemplates);                  // must be after load CreatureTemplate
+    loader.Add("Loading Trainers", sObjectMgr, &ObjectMgr::LoadTrainers);                                   // must be after load CreatureTemplate, TrainerTemplate
+    loader.Add("Loading Waypoint scripts", sScriptMgr, &ScriptMgr::LoadCreatureMovementScripts);            // before loading from creature_movement
+    loader.Add("Loading Waypoints", sWaypointMgr, &WaypointManager::Load);
 
     ///- Loading localization data
-    sLog.outString("Loading Localization strings...");
-    sObjectMgr.LoadCreatureLocales();                       // must be after CreatureInfo loading
-    sObjectMgr.LoadGameObjectLocales();                     // must be after GameobjectInfo loading
-    sObjectMgr.LoadItemLocales();                           // must be after ItemPrototypes loading
-    sObjectMgr.LoadQuestLocales();                          // must be after QuestTemplates loading
-    sObjectMgr.LoadGossipTextLocales();                     // must be after LoadGossipText
-    sObjectMgr.LoadPageTextLocales();                       // must be after PageText loading
-    sObjectMgr.LoadGossipMenuItemsLocales();                // must be after gossip menu items loading
-    sObjectMgr.LoadPointOfInterestLocales();                // must be after POI loading
-    sLog.outString(">>> Localization strings loaded");
-    sLog.outString();
+    loader.Add("Loading Creature Localization strings", sObjectMgr, &ObjectMgr::LoadCreatureLocales);       // must be after CreatureInfo loading
+    loader.Add("Loading GameObject Localization strings", sObjectMgr, &ObjectMgr::LoadGameObjectLocales);   // must be after GameobjectInfo loading
+    loader.Add("Loading Item Localization strings", sObjectMgr, &ObjectMgr::LoadItemLocales);               // must be after ItemPrototypes loading
+    loader.Add("Loading Quest Localization strings", sObjectMgr, &ObjectMgr::LoadQuestLocales);             // must be after QuestTemplates loading
+    loader.Add("Loading NPC Text Localization strings", sObjectMgr, &ObjectMgr::LoadGossipTextLocales);     // must be after LoadGossipText
+    loader.Add("Loading Page Text Localization strings", sObjectMgr, &ObjectMgr::LoadPageTextLocales);      // must be after PageText loading
+    loader.Add("Loading Gossip Menu Localization strings", sObjectMgr, &ObjectMgr::LoadGossipMenuItemsLocales); // must be after gossip menu items loading
+    loader.Add("Loading Points Of Interest Localization strings", sObjectMgr, &ObjectMgr::LoadPointOfInterestLocales); // must be after POI loading
 
     ///- Load dynamic data tables from the database
-    sLog.outString("Loading Auctions...");
-    sLog.outString();
-    sAuctionMgr.LoadAuctionItems();
-    sAuctionMgr.LoadAuctions();
-    sLog.outString(">>> Auctions loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Guilds...");
-    sGuildMgr.LoadGuilds();
-
-    sLog.outString("Loading Groups...");
-    sObjectMgr.LoadGroups();
-
-    sLog.outString("Loading ReservedNames...");
-    sObjectMgr.LoadReservedPlayersNames();
-
-    sLog.outString("Loading GameObjects for quests...");
-    sObjectMgr.LoadGameObjectForQuests();
-
-    sLog.outString("Loading BattleMasters...");
-    sBattleGroundMgr.LoadBattleMastersEntry();
-
-    sLog.outString("Loading BattleGround event indexes...");
-    sBattleGroundMgr.LoadBattleEventIndexes();
-
-    sLog.outString("Loading GameTeleports...");
-    sObjectMgr.LoadGameTele();
-
-    sLog.outString("Loading GM tickets...");
-    sTicketMgr.LoadGMTickets();
+    loader.Add("Loading Auction Items", sAuctionMgr, &AuctionHouseMgr::LoadAuctionItems);
+    loader.Add("Loading Auctions", sAuctionMgr, &AuctionHouseMgr::LoadAuctions);
+    loader.Add("Loading Guilds", sGuildMgr, &GuildMgr::LoadGuilds);
+    loader.Add("Loading Groups", sObjectMgr, &ObjectMgr::LoadGroups);
+    loader.Add("Loading ReservedNames", sObjectMgr, &ObjectMgr::LoadReservedPlayersNames);
+    loader.Add("Loading GameObjects for quests", sObjectMgr, &ObjectMgr::LoadGameObjectForQuests);
+    loader.Add("Loading BattleMasters", sBattleGroundMgr, &BattleGroundMgr::LoadBattleMastersEntry);
+    loader.Add("Loading BattleGround event indexes", sBattleGroundMgr, &BattleGroundMgr::LoadBattleEventIndexes);
+    loader.Add("Loading GameTeleports", sObjectMgr, &ObjectMgr::LoadGameTele);
+    loader.Add("Loading GM tickets", sTicketMgr, &GMTicketMgr::LoadGMTickets);
 
     ///- Handle outdated emails (delete/return)
-    sLog.outString("Returning old mails...");
-    sObjectMgr.ReturnOrDeleteOldMails(false);
-
-    ///- Load and initialize scripts
-    sLog.outString("Loading Scripts...");
-    sLog.outString();
-    sScriptMgr.LoadQuestStartScripts();                     // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
-    sScriptMgr.LoadQuestEndScripts();                       // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
-    sScriptMgr.LoadSpellScripts();                          // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadGameObjectScripts();                     // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadGameObjectTemplateScripts();             // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadEventScripts();                          // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadCreatureDeathScripts();                  // must be after load Creature/Gameobject(Template/Data)
-    sLog.outString(">>> Scripts loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Scripts text locales...");      // must be after Load*Scripts calls
-    sScriptMgr.LoadDbScriptStrings();
-
-    sLog.outString("Loading CreatureEventAI Texts...");
-    sEventAIMgr.LoadCreatureEventAI_Texts(false);           // false, will checked in LoadCreatureEventAI_Scripts
-
-    sLog.outString("Loading CreatureEventAI Summons...");
-    sEventAIMgr.LoadCreatureEventAI_Summons(false);         // false, will checked in LoadCreatureEventAI_Scripts
-
-    sLog.outString("Loading CreatureEventAI Scripts...");
-    sEventAIMgr.LoadCreatureEventAI_Scripts();
+    loader.Add("Returning old mails", &ReturnOldMails);
+
+    ///- Load scripts, the script tables are independent of each other
+    // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
+    loader.AddParallel("Loading Quest Start Scripts", sScriptMgr, &ScriptMgr::LoadQuestStartScripts);
+    loader.AddParallel("Loading Quest End Scripts", sScriptMgr, &ScriptMgr::LoadQuestEndScripts);
+    loader.AddParallel("Loading Spell Scripts", sScriptMgr, &ScriptMgr::LoadSpellScripts);
+    loader.AddParallel("Loading GameObject Scripts", sScriptMgr, &ScriptMgr::LoadGameObjectScripts);
+    loader.AddParallel("Loading GameObject Template Scripts", sScriptMgr, &ScriptMgr::LoadGameObjectTemplateScripts);
+    loader.AddParallel("Loading Event Scripts", sScriptMgr, &ScriptMgr::LoadEventScripts);
+    loader.AddParallel("Loading Creature Death Scripts", sScriptMgr, &ScriptMgr::LoadCreatureDeathScripts);
+    loader.Add("Applying quest flags of the scripts", sScriptMgr, &ScriptMgr::ApplyExploredQuestFlags);     // must be after the parallel Load*Scripts calls
+
+    loader.Add("Loading Scripts text locales", sScriptMgr, &ScriptMgr::LoadDbScriptStrings);                // must be after Load*Scripts calls
+    loader.Add("Loading CreatureEventAI Texts", &LoadCreatureEventAITexts);
+    loader.Add("Loading CreatureEventAI Summons", &LoadCreatureEventAISummons);
+    loader.Add("Loading CreatureEventAI Scripts", sEventAIMgr, &CreatureEventAIMgr::LoadCreatureEventAI_Scripts);
+
+    loader.Run(getConfig(CONFIG_UINT32_STARTUP_LOAD_THREADS));
 
     sLog.outString("Initializing Scripts...");
     switch (sScriptMgr.LoadScriptLibrary(MANGOS_SCRIPT_NAME))
@@ -1312,6 +1232,8 @@ void World::SetInitialWorldSettings()
     sLog.outString("Initialize AuctionHouseBot...");
     sAuctionBot.Initialize();
 
+    loader.LogReport();
+
     sLog.outString("WORLD: World initialized");
 
     uint32 uStartInterval = WorldTimer::getMSTimeDiff(uStartTime, WorldTimer::getMSTime());
@@ -1367,6 +1289,8 @@ void World::DetectDBCLang()
 /// Update the World !
 void World::Update(uint32 diff)
 {
+    sPerfStats.StartTick();
+
     ///- Update the different timers
     for (int i = 0; i < WUPDATE_COUNT; ++i)
     {
@@ -1385,6 +1309,7 @@ void World::Update(uint32 diff)
     /// <ul><li> Handle auctions when the timer has passed
     if (m_timers[WUPDATE_AUCTIONS].Passed())
     {
+        PerfStageTimer perfTimer(PERF_STAGE_AUCTIONS);
         m_timers[WUPDATE_AUCTIONS].Reset();
 
         ///- Update mails (return old mails with item, or delete them)
@@ -1402,16 +1327,22 @@ void World::Update(uint32 diff)
     /// <li> Handle AHBot operations
     if (m_timers[WUPDATE_AHBOT].Passed())
     {
+        PerfStageTimer perfTimer(PERF_STAGE_AHBOT);
         sAuctionBot.Update();
         m_timers[WUPDATE_AHBOT].Reset();
     }
 
     /// <li> Handle session updates
-    UpdateSessions(diff);
+    {
+        PerfStageTimer perfTimer(PERF_STAGE_SESSIONS);
+        UpdateSessions(diff);
+    }
 
     /// <li> Handle weather updates when the timer has passed
     if (m_timers[WUPDATE_WEATHERS].Passed())
     {
+        PerfStageTimer perfTimer(PERF_STAGE_WEATHERS);
+
         ///- Send an update signal to Weather objects
         for (WeatherMap::iterator itr = m_weathers.begin(); itr != m_weathers.end();)
         {
@@ -1440,12 +1371,28 @@ void World::Update(uint32 diff)
 
     /// <li> Handle all other objects
     ///- Update objects (maps, transport, creatures,...)
-    sMapMgr.Update(diff);
-    sBattleGroundMgr.Update(diff);
-    sOutdoorPvPMgr.Update(diff);
+    {
+        PerfStageTimer perfTimer(PERF_STAGE_MAPS);
+        sMapMgr.Update(diff);
+    }
+    {
+        PerfStageTimer perfTimer(PERF_STAGE_PLAYER_SAVES);
+        sPlayerSaveScheduler.Update(diff);
+    }
+    {
+        PerfStageTimer perfTimer(PERF_STAGE_BATTLEGROUNDS);
+        sBattleGroundMgr.Update(diff);
+    }
+    {
+        PerfStageTimer perfTimer(PERF_STAGE_OUTDOORPVP);
+        sOutdoorPvPMgr.Update(diff);
+    }
 
     ///- used by eluna
-    sEluna->OnWorldUpdate(diff);
+    {
+        PerfStageTimer perfTimer(PERF_STAGE_ELUNA);
+        sEluna->OnWorldUpdate(diff);
+    }
 
     ///- Delete all characters which have been deleted X days before
     if (m_timers[WUPDATE_DELETECHARS].Passed())
@@ -1455,7 +1402,10 @@ void World::Update(uint32 diff)
     }
 
     // execute callbacks from sql queries that were queued recently
-    UpdateResultQueue();
+    {
+        PerfStageTimer perfTimer(PERF_STAGE_RESULT_QUEUE);
+        UpdateResultQueue();
+    }
 
     ///- Erase corpses once every 20 minutes
     if (m_timers[WUPDATE_CORPSES].Passed())
@@ -1468,6 +1418,7 @@ void World::Update(uint32 diff)
     ///- Process Game events when necessary
     if (m_timers[WUPDATE_EVENTS].Passed())
     {
+        PerfStageTimer perfTimer(PERF_STAGE_GAME_EVENTS);
         m_timers[WUPDATE_EVENTS].Reset();                   // to give time for Update() to be processed
         uint32 nextGameEvent = sGameEventMgr.Update();
         m_timers[WUPDATE_EVENTS].SetInterval(nextGameEvent);
@@ -1476,7 +1427,10 @@ void World::Update(uint32 diff)
 
     /// </ul>
     ///- Move all creatures with "delayed move" and remove and delete all objects with "delayed remove"
-    sMapMgr.RemoveAllObjectsInRemoveList();
+    {
+        PerfStageTimer perfTimer(PERF_STAGE_REMOVE_LIST);
+        sMapMgr.RemoveAllObjectsInRemoveList();
+    }
 
     // update the instance reset times
     sMapPersistentStateMgr.Update();
@@ -1494,10 +1448,18 @@ void World::Update(uint32 diff)
         m_MaintenanceTimeChecker -= diff;
 
     // And last, but not least handle the issued cli commands
-    ProcessCliCommands();
+    {
+        PerfStageTimer perfTimer(PERF_STAGE_CLI_COMMANDS);
+        ProcessCliCommands();
+    }
 
     // cleanup unused GridMap objects as well as VMaps
-    sTerrainMgr.Update(diff);
+    {
+        PerfStageTimer perfTimer(PERF_STAGE_TERRAIN);
+        sTerrainMgr.Update(diff);
+    }
+
+    sPerfStats.FinishTick();
 }
 
 namespace MaNGOS
@@ -1567,13 +1529,14 @@ void World::SendWorldText(int32 string_id, ...)
 /// Sends a packet to all players with optional team and instance restrictions
 void World::SendGlobalMessage(WorldPacket* packet)
 {
+    SharedPacket sharedPacket(*packet);
     for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
         if (itr->second &&
                 itr->second->GetPlayer() &&
                 itr->second->GetPlayer()->IsInWorld())
         {
-            itr->second->SendPacket(packet);
+            itr->second->SendPacket(sharedPacket);
         }
     }
 }
@@ -1926,10 +1889,23 @@ void World::InitResultQueue()
 
 void World::UpdateResultQueue()
 {
-    // process async result queues
-    CharacterDatabase.ProcessResultQueue();
-    WorldDatabase.ProcessResultQueue();
-    LoginDatabase.ProcessResultQueue();
+    // process async result queues, callbacks left by the time limit are executed in the next update
+    uint32 maxTime = getConfig(CONFIG_UINT32_RESULT_QUEUE_MAX_TIME);
+    uint32 startTime = WorldTimer::getMSTime();
+
+    CharacterDatabase.ProcessResultQueue(maxTime);
+    WorldDatabase.ProcessResultQueue(GetResultQueueTimeLeft(maxTime, startTime));
+    LoginDatabase.ProcessResultQueue(GetResultQueueTimeLeft(maxTime, startTime));
+}
+
+uint32 World::GetResultQueueTimeLeft(uint32 maxTime, uint32 startTime)
+{
+    if (!maxTime)
+        return 0;
+
+    // each queue executes at least one callback
+    uint32 diff = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+    return diff < maxTime ? maxTime - diff : 1;
 }
 
 void World::UpdateRealmCharCount(uint32 accountId)
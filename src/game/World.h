@@ -81,9 +81,17 @@ enum WorldTimers
 enum eConfigUInt32Values
 {
     CONFIG_UINT32_COMPRESSION = 0,
+    CONFIG_UINT32_COMPRESSION_THRESHOLD,
+    CONFIG_UINT32_COMPRESSION_CREATE_OBJECT,
     CONFIG_UINT32_INTERVAL_SAVE,
+    CONFIG_UINT32_PLAYER_SAVE_MAX_PER_TICK,
+    CONFIG_UINT32_PLAYER_SAVE_BYTES_PER_SECOND,
+    CONFIG_UINT32_RESULT_QUEUE_MAX_TIME,
     CONFIG_UINT32_INTERVAL_GRIDCLEAN,
     CONFIG_UINT32_INTERVAL_MAPUPDATE,
+    CONFIG_UINT32_MAP_UPDATE_THREADS,
+    CONFIG_UINT32_PERF_STATS_DUMP_INTERVAL,
+    CONFIG_UINT32_STARTUP_LOAD_THREADS,
     CONFIG_UINT32_INTERVAL_CHANGEWEATHER,
     CONFIG_UINT32_PORT_WORLD,
     CONFIG_UINT32_GAME_TYPE,
@@ -307,6 +315,8 @@ enum eConfigBoolValues
     CONFIG_BOOL_VMAP_INDOOR_CHECK,
     CONFIG_BOOL_PET_UNSUMMON_AT_MOUNT,
     CONFIG_BOOL_MMAP_ENABLED,
+    CONFIG_BOOL_MAP_UPDATE_CELL_ISLANDS,
+    CONFIG_BOOL_PERF_STATS_ENABLE,
     CONFIG_BOOL_ELUNA_ENABLED,
     CONFIG_BOOL_PLAYER_COMMANDS,
     CONFIG_BOOL_VALUE_COUNT
@@ -541,6 +551,7 @@ class World
         void QueueCliCommand(CliCommandHolder* commandHolder) { cliCmdQueue.add(commandHolder); }
 
         void UpdateResultQueue();
+        static uint32 GetResultQueueTimeLeft(uint32 maxTime, uint32 startTime);
         void InitResultQueue();
 
         void UpdateRealmCharCount(uint32 accid);
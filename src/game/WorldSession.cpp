@@ -38,6 +38,7 @@
 #include "MapManager.h"
 #include "SocialMgr.h"
 #include "LuaEngine.h"
+#include "PerfStats.h"
 
 // select opcodes appropriate for processing in Map::Update context for current session state
 static bool MapSessionFilterHelper(WorldSession* session, OpcodeHandler const& opHandle)
@@ -83,7 +84,7 @@ bool WorldSessionFilter::Process(WorldPacket* packet)
 WorldSession::WorldSession(uint32 id, WorldSocket* sock, AccountTypes sec, time_t mute_time, LocaleConstant locale) :
     m_muteTime(mute_time),
     _player(NULL), m_Socket(sock), _security(sec), _accountId(id), _logoutTime(0),
-    m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_playerSave(false),
+    m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_playerSave(false), m_charactersChanged(false),
     m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(sObjectMgr.GetIndexForLocale(locale)),
     m_latency(0), m_tutorialState(TUTORIALDATA_UNCHANGED)
 {
@@ -173,6 +174,29 @@ void WorldSession::SendPacket(WorldPacket const* packet)
         m_Socket->CloseSocket();
 }
 
+void WorldSession::SendPacket(SharedPacket const& packet)
+{
+    if (!m_Socket)
+        return;
+
+    if (m_Socket->SendPacket(packet) == -1)
+        m_Socket->CloseSocket();
+}
+
+bool WorldSession::GetSocketStats(WorldSocketStats& stats) const
+{
+    if (!m_Socket)
+        return false;
+
+    m_Socket->GetStats(stats);
+    return true;
+}
+
+bool WorldSession::IsSendCongested() const
+{
+    return m_Socket && m_Socket->IsCongested();
+}
+
 /// Add an incoming packet to the queue
 void WorldSession::QueuePacket(WorldPacket* new_packet)
 {
@@ -331,6 +355,9 @@ void WorldSession::LogoutPlayer(bool Save)
     m_playerLogout = true;
     m_playerSave = Save;
 
+    // the character list shows the level and zone of the save
+    m_charactersChanged = true;
+
     if (_player)
     {
         sLog.outChar("Account: %d (IP: %s) Logout Character:[%s] (guid: %u)", GetAccountId(), GetRemoteAddress().c_str(), _player->GetName() , _player->GetGUIDLow());
@@ -442,7 +469,11 @@ void WorldSession::LogoutPlayer(bool Save)
         ///- empty buyback items and save the player in the database
         // some save parts only correctly work in case player present in map/player_lists (pets, etc)
         if (Save)
+        {
+            // the last save of the session writes all rows, a failed save that was not noticed yet can't leave them outdated
+            _player->ResetSaveBaselines();
             _player->SaveToDB();
+        }
 
         ///- Leave all channels before player delete...
         _player->CleanupChannels();
@@ -705,8 +736,13 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* pac
     if (_player)
         _player->SetCanDelayTeleport(true);
 
+    uint64 perfStart = sPerfStats.IsEnabled() ? PerfStats::GetMicroTime() : 0;
+
     (this->*opHandle.handler)(*packet);
 
+    if (perfStart)
+        sPerfStats.AddOpcodeSample(packet->GetOpcode(), GetAccountId(), uint32(PerfStats::GetMicroTime() - perfStart), uint32(packet->size()));
+
     if (_player)
     {
         // can be not set in fact for login opcode, but this not create porblems.
@@ -29,6 +29,10 @@
 #include "AuctionHouseMgr.h"
 #include "Item.h"
 
+#ifdef USE_LOCKFREE_RECV_QUEUE
+#include "MPSCQueue.h"
+#endif
+
 struct ItemPrototype;
 struct AuctionEntry;
 struct AuctionHouseEntry;
@@ -40,7 +44,9 @@ class Object;
 class Player;
 class Unit;
 class WorldPacket;
+class SharedPacket;
 class WorldSocket;
+struct WorldSocketStats;
 class QueryResult;
 class LoginQueryHolder;
 class CharacterHandler;
@@ -132,6 +138,8 @@ class MANGOS_DLL_SPEC WorldSession
         void SizeError(WorldPacket const& packet, uint32 size) const;
 
         void SendPacket(WorldPacket const* packet);
+        /// Send a packet built once for many receivers, see SharedPacket
+        void SendPacket(SharedPacket const& packet);
         void SendNotification(const char* format, ...) ATTR_PRINTF(2, 3);
         void SendNotification(int32 string_id, ...);
         void SendPetNameInvalid(uint32 error, const std::string& name);
@@ -273,6 +281,10 @@ class MANGOS_DLL_SPEC WorldSession
         const char* GetMangosString(int32 entry) const;
 
         uint32 GetLatency() const { return m_latency; }
+        /// Output counters of the connection, false if the session has no socket
+        bool GetSocketStats(WorldSocketStats& stats) const;
+        /// The client does not read its data in time, packets it can do without should not be sent
+        bool IsSendCongested() const;
         void SetLatency(uint32 latency) { m_latency = latency; }
         uint32 getDialogStatus(Player* pPlayer, Object* questgiver, uint32 defstatus);
 
@@ -682,12 +694,17 @@ class MANGOS_DLL_SPEC WorldSession
         bool m_playerLogout;                                // code processed in LogoutPlayer
         bool m_playerRecentlyLogout;
         bool m_playerSave;                                  // code processed in LogoutPlayer with save request
+        bool m_charactersChanged;                           // character list is read from the primary database, the replica may lag
         LocaleConstant m_sessionDbcLocale;
         int m_sessionDbLocaleIndex;
         uint32 m_latency;
         uint32 m_Tutorials[8];
         TutorialDataState m_tutorialState;
+#ifdef USE_LOCKFREE_RECV_QUEUE
+        ACE_Based::MPSCQueue<WorldPacket*> _recvQueue;      // filled by network threads, read by one updating thread
+#else
         ACE_Based::LockedQueue<WorldPacket*, ACE_Thread_Mutex> _recvQueue;
+#endif
 };
 #endif
 /// @}
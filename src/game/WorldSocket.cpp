@@ -19,6 +19,7 @@
 #include <ace/Message_Block.h>
 #include <ace/OS_NS_string.h>
 #include <ace/OS_NS_unistd.h>
+#include <ace/OS_NS_sys_socket.h>
 #include <ace/os_include/arpa/os_inet.h>
 #include <ace/os_include/netinet/os_tcp.h>
 #include <ace/os_include/sys/os_types.h>
@@ -26,6 +27,7 @@
 #include <ace/OS_NS_string.h>
 #include <ace/Reactor.h>
 #include <ace/Auto_Ptr.h>
+#include <ace/High_Res_Timer.h>
 
 #include "WorldSocket.h"
 #include "Common.h"
@@ -45,6 +47,9 @@
 #include "Log.h"
 #include "DBCStores.h"
 #include "LuaEngine.h"
+#include "SharedPacket.h"
+#include "WorldSocketUring.h"
+#include "PerfStats.h"
 
 #if defined( __GNUC__ )
 #pragma pack(1)
@@ -70,6 +75,9 @@ struct ClientPktHeader
 #pragma pack(pop)
 #endif
 
+/// Packet bodies from this size are referenced by the output chain when possible instead of copied
+static const size_t MIN_REFERENCED_BODY_SIZE = 1024;
+
 WorldSocket::WorldSocket(void) :
     WorldHandler(),
     m_LastPingTime(ACE_Time_Value::zero),
@@ -80,7 +88,10 @@ WorldSocket::WorldSocket(void) :
     m_Header(sizeof(ClientPktHeader)),
     m_OutBuffer(0),
     m_OutBufferSize(65536),
+    m_OutQueueLimit(0),
+    m_OutCongestion(0),
     m_OutActive(false),
+    m_UringThread(NULL),
     m_Seed(static_cast<uint32>(rand32()))
 {
     reference_counting_policy().value(ACE_Event_Handler::Reference_Counting_Policy::ENABLED);
@@ -90,16 +101,15 @@ WorldSocket::~WorldSocket(void)
 {
     delete m_RecvWPct;
 
-    if (m_OutBuffer)
-        m_OutBuffer->release();
-
     closing_ = true;
 
     peer().close();
 
-    WorldPacket* pct;
-    while (m_PacketQueue.dequeue_head(pct) == 0)
-        delete pct;
+    for (OutChainT::iterator itr = m_OutChain.begin(); itr != m_OutChain.end(); ++itr)
+        iReleaseOutChunk(*itr);
+
+    if (m_OutBuffer && --m_OutBuffer->refs == 0)
+        sWorldSocketMgr->ReleaseSendBuffer(m_OutBuffer);
 }
 
 bool WorldSocket::IsClosed(void) const
@@ -138,31 +148,59 @@ int WorldSocket::SendPacket(const WorldPacket& pkt)
     if (closing_)
         return -1;
 
-    WorldPacket pct = pkt;
-
     // Dump outgoing packet.
-    sLog.outWorldPacketDump(uint32(get_handle()), pct.GetOpcode(), pct.GetOpcodeName(), &pct, false);
+    sLog.outWorldPacketDump(uint32(get_handle()), pkt.GetOpcode(), pkt.GetOpcodeName(), &pkt, false);
 
-    if (!sEluna->OnPacketSend(m_Session, pct))
-        return 0;
-
-    if (iSendPacket(pct) == -1)
+    // hooks may change the packet, only then a private copy is needed
+    if (sEluna->HasPacketSendHooks(pkt.GetOpcode()))
     {
-        WorldPacket* npct;
+        WorldPacket* copy = new WorldPacket(pkt);
+        if (!sEluna->OnPacketSend(m_Session, *copy))
+        {
+            delete copy;
+            return 0;
+        }
 
-        ACE_NEW_RETURN(npct, WorldPacket(pct), -1);
+        return iSendPacket(copy);
+    }
 
-        // NOTE maybe check of the size of the queue can be good ?
-        // to make it bounded instead of unbounded
-        if (m_PacketQueue.enqueue_tail(npct) == -1)
+    return iSendPacket(pkt, NULL);
+}
+
+int WorldSocket::SendPacket(const SharedPacket& pct)
+{
+    ACE_GUARD_RETURN(LockType, Guard, m_OutBufferLock, -1);
+
+    if (closing_)
+        return -1;
+
+    WorldPacket const& pkt = pct.GetPacket();
+
+    // Dump outgoing packet.
+    sLog.outWorldPacketDump(uint32(get_handle()), pkt.GetOpcode(), pkt.GetOpcodeName(), &pkt, false);
+
+    // hooks may change the packet for this receiver, only then a private copy is needed
+    if (sEluna->HasPacketSendHooks(pkt.GetOpcode()))
+    {
+        WorldPacket* copy = new WorldPacket(pkt);
+        if (!sEluna->OnPacketSend(m_Session, *copy))
         {
-            delete npct;
-            sLog.outError("WorldSocket::SendPacket: m_PacketQueue.enqueue_tail failed");
-            return -1;
+            delete copy;
+            return 0;
         }
+
+        return iSendPacket(copy);
     }
 
-    return 0;
+    // small bodies are cheaper to copy than to reference
+    return iSendPacket(pkt, pkt.size() >= MIN_REFERENCED_BODY_SIZE ? pct.DuplicateBody() : NULL);
+}
+
+void WorldSocket::GetStats(WorldSocketStats& stats)
+{
+    ACE_GUARD(LockType, Guard, m_OutBufferLock);
+
+    stats = m_Stats;
 }
 
 long WorldSocket::AddReference(void)
@@ -191,8 +229,8 @@ int WorldSocket::open(void* a)
     if (sWorldSocketMgr->OnSocketOpen(this) == -1)
         return -1;
 
-    // Allocate the buffer.
-    ACE_NEW_RETURN(m_OutBuffer, ACE_Message_Block(m_OutBufferSize), -1);
+    // Take the first send buffer.
+    m_OutBuffer = sWorldSocketMgr->AcquireSendBuffer();
 
     // Store peer address.
     ACE_INET_Addr remote_addr;
@@ -212,6 +250,15 @@ int WorldSocket::open(void* a)
     if (SendPacket(packet) == -1)
         return -1;
 
+#ifdef USE_IO_URING
+    // io_uring network threads do not use the reactor
+    if (m_UringThread)
+    {
+        if (m_UringThread->AddSocket(this) == -1)
+            return -1;
+    }
+    else
+#endif
     // Register with ACE Reactor
     if (reactor()->register_handler(this, ACE_Event_Handler::READ_MASK | ACE_Event_Handler::WRITE_MASK) == -1)
     {
@@ -279,17 +326,28 @@ int WorldSocket::handle_output(ACE_HANDLE)
     if (closing_)
         return -1;
 
-    const size_t send_len = m_OutBuffer->length();
-
-    if (send_len == 0)
+    if (m_OutChain.empty())
         return cancel_wakeup_output(Guard);
 
+    iEncryptHeaders();
+
+    iovec iov[MAX_OUT_IOV];
+    int count = iFillOutIov(iov);
+
 #ifdef MSG_NOSIGNAL
-    ssize_t n = peer().send(m_OutBuffer->rd_ptr(), send_len, MSG_NOSIGNAL);
+    msghdr msg;
+    ACE_OS::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+
+    ssize_t n = ACE_OS::sendmsg(get_handle(), &msg, MSG_NOSIGNAL);
 #else
-    ssize_t n = peer().send(m_OutBuffer->rd_ptr(), send_len);
+    ssize_t n = peer().sendv(iov, count);
 #endif // MSG_NOSIGNAL
 
+    if (NetworkThreadStats* stats = WorldSocketMgr::GetThreadStats())
+        ++stats->syscalls;
+
     if (n == 0)
         return -1;
     else if (n == -1)
@@ -299,26 +357,22 @@ int WorldSocket::handle_output(ACE_HANDLE)
 
         return -1;
     }
-    else if (n < (ssize_t)send_len) // now n > 0
-    {
-        m_OutBuffer->rd_ptr(static_cast<size_t>(n));
 
-        // move the data to the base of the buffer
-        m_OutBuffer->crunch();
+    m_Stats.sentBytes += uint64(n);
 
-        return schedule_wakeup_output(Guard);
-    }
-    else // now n == send_len
+    if (NetworkThreadStats* stats = WorldSocketMgr::GetThreadStats())
     {
-        m_OutBuffer->reset();
-
-        if (!iFlushPacketQueue())
-            return cancel_wakeup_output(Guard);
-        else
-            return schedule_wakeup_output(Guard);
+        ++stats->writes;
+        stats->sentBytes += uint64(n);
     }
 
-    ACE_NOTREACHED(return 0);
+    iConsumeOut(static_cast<size_t>(n));
+
+    if (m_OutChain.empty())
+        return cancel_wakeup_output(Guard);
+
+    // the kernel buffer is full or more chunks are left than one write takes
+    return schedule_wakeup_output(Guard);
 }
 
 int WorldSocket::handle_close(ACE_HANDLE h, ACE_Reactor_Mask)
@@ -349,7 +403,7 @@ int WorldSocket::Update(void)
     if (closing_)
         return -1;
 
-    if (m_OutActive || m_OutBuffer->length() == 0)
+    if (m_OutActive || m_Stats.pendingBytes == 0)
         return 0;
 
     return handle_output(get_handle());
@@ -438,11 +492,26 @@ int WorldSocket::handle_input_missing_data(void)
     const ssize_t n = peer().recv(message_block.wr_ptr(),
                                   recv_size);
 
+    if (NetworkThreadStats* stats = WorldSocketMgr::GetThreadStats())
+    {
+        ++stats->syscalls;
+        if (n > 0)
+            ++stats->receives;
+    }
+
     if (n <= 0)
         return (int)n;
 
     message_block.wr_ptr(n);
 
+    if (handle_input_data(message_block) == -1)
+        return -1;
+
+    return size_t(n) == recv_size ? 1 : 2;
+}
+
+int WorldSocket::handle_input_data(ACE_Message_Block& message_block)
+{
     while (message_block.length() > 0)
     {
         if (m_Header.space() > 0)
@@ -456,8 +525,7 @@ int WorldSocket::handle_input_missing_data(void)
             {
                 // Couldn't receive the whole header this time.
                 MANGOS_ASSERT(message_block.length() == 0);
-                errno = EWOULDBLOCK;
-                return -1;
+                return 0;
             }
 
             // We just received nice new header
@@ -490,8 +558,7 @@ int WorldSocket::handle_input_missing_data(void)
             {
                 // Couldn't receive the whole data this time.
                 MANGOS_ASSERT(message_block.length() == 0);
-                errno = EWOULDBLOCK;
-                return -1;
+                return 0;
             }
         }
 
@@ -503,7 +570,66 @@ int WorldSocket::handle_input_missing_data(void)
         }
     }
 
-    return size_t(n) == recv_size ? 1 : 2;
+    return 0;
+}
+
+int WorldSocket::HandleUringInput(const char* data, size_t size)
+{
+    if (closing_)
+        return -1;
+
+    ACE_Data_Block db(size,
+                      ACE_Message_Block::MB_DATA,
+                      const_cast<char*>(data),
+                      0,
+                      0,
+                      ACE_Message_Block::DONT_DELETE,
+                      0);
+
+    ACE_Message_Block message_block(&db,
+                                    ACE_Message_Block::DONT_DELETE,
+                                    0);
+
+    message_block.wr_ptr(size);
+
+    return handle_input_data(message_block);
+}
+
+int WorldSocket::PrepareUringOutput(iovec* iov)
+{
+    ACE_GUARD_RETURN(LockType, Guard, m_OutBufferLock, -1);
+
+    if (closing_)
+        return -1;
+
+    iEncryptHeaders();
+
+    return iFillOutIov(iov);
+}
+
+int WorldSocket::HandleUringOutput(int result)
+{
+    ACE_GUARD_RETURN(LockType, Guard, m_OutBufferLock, -1);
+
+    if (closing_)
+        return -1;
+
+    if (result == -EAGAIN || result == -EINTR)
+        return 0;
+
+    if (result <= 0)
+        return -1;
+
+    m_Stats.sentBytes += uint64(result);
+
+    if (NetworkThreadStats* stats = WorldSocketMgr::GetThreadStats())
+    {
+        ++stats->writes;
+        stats->sentBytes += uint64(result);
+    }
+
+    iConsumeOut(static_cast<size_t>(result));
+    return 0;
 }
 
 int WorldSocket::cancel_wakeup_output(GuardType& g)
@@ -515,6 +641,10 @@ int WorldSocket::cancel_wakeup_output(GuardType& g)
 
     g.release();
 
+    // epoll_ctl with the Dev_Poll reactor
+    if (NetworkThreadStats* stats = WorldSocketMgr::GetThreadStats())
+        ++stats->syscalls;
+
     if (reactor()->cancel_wakeup
             (this, ACE_Event_Handler::WRITE_MASK) == -1)
     {
@@ -535,6 +665,10 @@ int WorldSocket::schedule_wakeup_output(GuardType& g)
 
     g.release();
 
+    // epoll_ctl with the Dev_Poll reactor
+    if (NetworkThreadStats* stats = WorldSocketMgr::GetThreadStats())
+        ++stats->syscalls;
+
     if (reactor()->schedule_wakeup
             (this, ACE_Event_Handler::WRITE_MASK) == -1)
     {
@@ -903,59 +1037,230 @@ int WorldSocket::HandlePing(WorldPacket& recvPacket)
     return SendPacket(packet);
 }
 
-int WorldSocket::iSendPacket(const WorldPacket& pct)
+int WorldSocket::iSendPacket(const WorldPacket& pct, SharedPacketBody* sharedBody)
 {
-    if (m_OutBuffer->space() < pct.size() + sizeof(ServerPktHeader))
+    if (!iCheckOutLimit(pct.size()))
     {
-        errno = ENOBUFS;
+        if (sharedBody)
+            sharedBody->RemoveReference();
+
+        return -1;
+    }
+
+    iWriteHeader(pct.GetOpcode(), pct.size());
+
+    if (sharedBody)
+        iAddOutReference(sharedBody->GetData(), sharedBody->GetSize(), sharedBody, NULL);
+    else if (!pct.empty())
+        iWriteOut((const char*)pct.contents(), pct.size());
+
+    return 0;
+}
+
+int WorldSocket::iSendPacket(WorldPacket* pct)
+{
+    if (!iCheckOutLimit(pct->size()))
+    {
+        delete pct;
         return -1;
     }
 
+    iWriteHeader(pct->GetOpcode(), pct->size());
+
+    if (pct->size() >= MIN_REFERENCED_BODY_SIZE)
+        iAddOutReference((const char*)pct->contents(), pct->size(), NULL, pct);
+    else
+    {
+        if (!pct->empty())
+            iWriteOut((const char*)pct->contents(), pct->size());
+
+        delete pct;
+    }
+
+    return 0;
+}
+
+bool WorldSocket::iCheckOutLimit(size_t size)
+{
+    if (!m_OutQueueLimit || m_Stats.pendingBytes + size + sizeof(ServerPktHeader) <= m_OutQueueLimit)
+        return true;
+
+    ++m_Stats.droppedPackets;
+
+    // the client misses data from now on, it can only reconnect
+    if (!closing_)
+    {
+        sLog.outError("WorldSocket::SendPacket: output of %s reached " SIZEFMTD " bytes, closing connection",
+                      GetRemoteAddress().c_str(), m_OutQueueLimit);
+
+        closing_ = true;
+        peer().close_writer();
+    }
+
+    return false;
+}
+
+void WorldSocket::iWriteHeader(uint16 opcode, size_t size)
+{
     ServerPktHeader header;
 
-    header.cmd = pct.GetOpcode();
+    header.cmd = opcode;
 
-    header.size = (uint16) pct.size() + 2;
+    header.size = (uint16) size + 2;
 
     EndianConvertReverse(header.size);
     EndianConvert(header.cmd);
 
-    m_Crypt.EncryptSend((uint8*) & header, sizeof(header));
+    // the header is encrypted in place later, it must not be split between two buffers
+    if (m_OutBufferSize - m_OutBuffer->used < sizeof(header))
+        iNextOutBuffer();
 
-    if (m_OutBuffer->copy((char*) & header, sizeof(header)) == -1)
-        ACE_ASSERT(false);
+    if (m_Crypt.IsInitialized())
+        m_OutHeaders.push_back(reinterpret_cast<uint8*>(m_OutBuffer->Data() + m_OutBuffer->used));
 
-    if (!pct.empty())
-        if (m_OutBuffer->copy((char*) pct.contents(), pct.size()) == -1)
-            ACE_ASSERT(false);
+    iWriteOut((const char*) & header, sizeof(header));
 
-    return 0;
+    ++m_Stats.sentPackets;
 }
 
-bool WorldSocket::iFlushPacketQueue()
+void WorldSocket::iEncryptHeaders()
 {
-    WorldPacket* pct;
-    bool haveone = false;
+    if (m_OutHeaders.empty())
+        return;
+
+    if (NetworkThreadStats* stats = WorldSocketMgr::GetThreadStats())
+        stats->packets += m_OutHeaders.size();
 
-    while (m_PacketQueue.dequeue_head(pct) == 0)
+    if (sPerfStats.IsEnabled())
     {
-        if (iSendPacket(*pct) == -1)
-        {
-            if (m_PacketQueue.enqueue_head(pct) == -1)
-            {
-                delete pct;
-                sLog.outError("WorldSocket::iFlushPacketQueue m_PacketQueue->enqueue_head");
-                return false;
-            }
+        ACE_High_Res_Timer timer;
+        timer.start();
 
-            break;
-        }
+        m_Crypt.EncryptSendHeaders(&m_OutHeaders[0], m_OutHeaders.size());
+
+        timer.stop();
+        ACE_hrtime_t time;
+        timer.elapsed_time(time);
+
+        sPerfStats.AddHeaderCryptoSample(m_OutHeaders.size(), uint32(time));
+    }
+    else
+        m_Crypt.EncryptSendHeaders(&m_OutHeaders[0], m_OutHeaders.size());
+
+    m_OutHeaders.clear();
+}
+
+void WorldSocket::iWriteOut(const char* data, size_t size)
+{
+    while (size)
+    {
+        if (m_OutBuffer->used == m_OutBufferSize)
+            iNextOutBuffer();
+
+        char* dest = m_OutBuffer->Data() + m_OutBuffer->used;
+        size_t count = std::min(size, m_OutBufferSize - m_OutBuffer->used);
+
+        ACE_OS::memcpy(dest, data, count);
+        m_OutBuffer->used += count;
+
+        // continue the last chunk if it ends where the data was written
+        if (!m_OutChain.empty() && m_OutChain.back().buffer == m_OutBuffer && m_OutChain.back().data + m_OutChain.back().size == dest)
+            m_OutChain.back().size += count;
         else
         {
-            haveone = true;
-            delete pct;
+            OutChunk chunk;
+            chunk.data = dest;
+            chunk.size = count;
+            chunk.buffer = m_OutBuffer;
+            chunk.body = NULL;
+            chunk.packet = NULL;
+
+            ++m_OutBuffer->refs;
+            m_OutChain.push_back(chunk);
         }
+
+        m_Stats.pendingBytes += count;
+        data += count;
+        size -= count;
     }
 
-    return haveone;
+    m_Stats.pendingChunks = m_OutChain.size();
+    if (m_Stats.pendingBytes > m_Stats.peakPendingBytes)
+        m_Stats.peakPendingBytes = m_Stats.pendingBytes;
+}
+
+void WorldSocket::iNextOutBuffer()
+{
+    WorldSocketSendBuffer* buffer = sWorldSocketMgr->AcquireSendBuffer();
+    if (--m_OutBuffer->refs == 0)
+        sWorldSocketMgr->ReleaseSendBuffer(m_OutBuffer);
+    m_OutBuffer = buffer;
+}
+
+void WorldSocket::iAddOutReference(const char* data, size_t size, SharedPacketBody* body, WorldPacket* packet)
+{
+    OutChunk chunk;
+    chunk.data = data;
+    chunk.size = size;
+    chunk.buffer = NULL;
+    chunk.body = body;
+    chunk.packet = packet;
+
+    m_OutChain.push_back(chunk);
+
+    m_Stats.pendingBytes += size;
+    m_Stats.pendingChunks = m_OutChain.size();
+    if (m_Stats.pendingBytes > m_Stats.peakPendingBytes)
+        m_Stats.peakPendingBytes = m_Stats.pendingBytes;
+}
+
+int WorldSocket::iFillOutIov(iovec* iov) const
+{
+    int count = 0;
+
+    for (OutChainT::const_iterator itr = m_OutChain.begin(); itr != m_OutChain.end() && count < MAX_OUT_IOV; ++itr, ++count)
+    {
+        iov[count].iov_base = const_cast<char*>(itr->data);
+        iov[count].iov_len = itr->size;
+    }
+
+    return count;
+}
+
+void WorldSocket::iConsumeOut(size_t size)
+{
+    m_Stats.pendingBytes -= size;
+
+    while (size)
+    {
+        OutChunk& chunk = m_OutChain.front();
+
+        if (size < chunk.size)
+        {
+            chunk.data += size;
+            chunk.size -= size;
+            break;
+        }
+
+        size -= chunk.size;
+        iReleaseOutChunk(chunk);
+        m_OutChain.pop_front();
+    }
+
+    m_Stats.pendingChunks = m_OutChain.size();
+
+    // everything in the send buffer is sent, write to it from the start again
+    if (m_OutBuffer->refs == 1)
+        m_OutBuffer->used = 0;
+}
+
+void WorldSocket::iReleaseOutChunk(OutChunk& chunk)
+{
+    if (chunk.buffer && --chunk.buffer->refs == 0)
+        sWorldSocketMgr->ReleaseSendBuffer(chunk.buffer);
+
+    if (chunk.body)
+        chunk.body->RemoveReference();
+
+    delete chunk.packet;
 }
@@ -33,7 +33,6 @@
 #include <ace/Acceptor.h>
 #include <ace/Thread_Mutex.h>
 #include <ace/Guard_T.h>
-#include <ace/Unbounded_Queue.h>
 #include <ace/Message_Block.h>
 
 #if !defined (ACE_LACKS_PRAGMA_ONCE)
@@ -43,9 +42,40 @@
 #include "Common.h"
 #include "Auth/AuthCrypt.h"
 
+#include <deque>
+
 class ACE_Message_Block;
 class WorldPacket;
 class WorldSession;
+class SharedPacket;
+class SharedPacketBody;
+class UringRunnable;
+
+/// Maximum number of output chunks sent by one vectored write
+#define MAX_OUT_IOV 64
+
+/// Output counters of a socket
+struct WorldSocketStats
+{
+    WorldSocketStats() : sentBytes(0), sentPackets(0), pendingChunks(0), pendingBytes(0),
+        peakPendingBytes(0), droppedPackets(0) {}
+
+    uint64 sentBytes;                                       // written to the kernel
+    uint32 sentPackets;                                     // added to the output chain
+    uint32 pendingChunks;                                   // current length of the output chain
+    uint32 pendingBytes;
+    uint32 peakPendingBytes;
+    uint32 droppedPackets;                                  // output limit reached
+};
+
+/// Fixed size buffer for packet headers and copied packet bodies, pooled by WorldSocketMgr
+struct WorldSocketSendBuffer
+{
+    uint32 refs;                                            // output chunks in the buffer, +1 while sockets write to it
+    size_t used;
+
+    char* Data() { return reinterpret_cast<char*>(this + 1); }
+};
 
 /// Handler that can communicate over stream sockets.
 typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
@@ -58,26 +88,35 @@ typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
  * Most methods return -1 on failure.
  * The class uses reference counting.
  *
- * For output the class uses one buffer (64K usually) and
- * a queue where it stores packet if there is no place on
- * the queue. The reason this is done, is because the server
- * does really a lot of small-size writes to it, and it doesn't
- * scale well to allocate memory for every. When something is
- * written to the output buffer the socket is not immediately
- * activated for output (again for the same reason), there
- * is 10ms celling (thats why there is Update() override method).
- * This concept is similar to TCP_CORK, but TCP_CORK
- * uses 200ms celling. As result overhead generated by
- * sending packets from "producer" threads is minimal,
- * and doing a lot of writes with small size is tolerated.
+ * For output the class uses a chain of chunks that is sent
+ * with one vectored write. The packet headers and small packet
+ * bodies are copied to fixed size send buffers (4K usually)
+ * taken from a pool shared by all sockets, so the many small
+ * packets of the server need no allocation each. Bodies of
+ * 1024 bytes or more that are sent to many sockets or changed
+ * by script hooks are referenced instead of copied, the
+ * reference keeps the body alive until it is written.
+ *
+ * Producers only append to the chain, the headers are
+ * encrypted in one batch right before the write. Adding a
+ * packet does not activate the socket for output, the chain
+ * is written by the network thread at the next Update() call
+ * (at most Network.Timeout later), or when the kernel accepts
+ * more data after a partial write. Many packets are sent with
+ * one system call this way, similar to TCP_CORK.
+ *
+ * The chain is bounded by Network.OutQueueLimit bytes, a
+ * client that does not read its data in time is disconnected.
+ * Before that, the game can check IsCongested() and skip
+ * packets that are not needed.
  *
  * The calls to Update () method are managed by WorldSocketMgr
- * and ReactorRunnable.
+ * and ReactorRunnable. With io_uring the network thread sends
+ * the chain by PrepareUringOutput() instead.
  *
- * For input ,the class uses one 1024 bytes buffer on stack
+ * For input ,the class uses one 4096 bytes buffer on stack
  * to which it does recv() calls. And then received data is
- * distributed where its needed. 1024 matches pretty well the
- * traffic generated by client for now.
+ * distributed where its needed.
  *
  * The input/output do speculative reads/writes (AKA it tryes
  * to read all data available in the kernel buffer or tryes to
@@ -93,6 +132,7 @@ class WorldSocket : protected WorldHandler
         friend class ACE_Acceptor< WorldSocket, ACE_SOCK_ACCEPTOR >;
         friend class WorldSocketMgr;
         friend class ReactorRunnable;
+        friend class UringRunnable;
 
         /// Declare the acceptor for this class
         typedef ACE_Acceptor< WorldSocket, ACE_SOCK_ACCEPTOR > Acceptor;
@@ -101,8 +141,18 @@ class WorldSocket : protected WorldHandler
         typedef ACE_Thread_Mutex LockType;
         typedef ACE_Guard<LockType> GuardType;
 
-        /// Queue for storing packets for which there is no space.
-        typedef ACE_Unbounded_Queue< WorldPacket* > PacketQueueT;
+        /// Part of the output that is not sent yet.
+        struct OutChunk
+        {
+            const char* data;
+            size_t size;
+            WorldSocketSendBuffer* buffer;                  // send buffer the data is in
+            SharedPacketBody* body;                         // referenced packet body, may be shared by many sockets
+            WorldPacket* packet;                            // referenced packet changed by hooks, owned by the chunk
+        };
+
+        /// Output waiting to be sent, in order.
+        typedef std::deque<OutChunk> OutChainT;
 
         /// Check if socket is closed.
         bool IsClosed(void) const;
@@ -118,6 +168,18 @@ class WorldSocket : protected WorldHandler
         /// @return -1 of failure
         int SendPacket(const WorldPacket& pct);
 
+        /// Send a packet that is sent unchanged to many sockets, the body is
+        /// shared instead of copied if it has to be queued.
+        /// @return -1 of failure
+        int SendPacket(const SharedPacket& pct);
+
+        /// Get the output counters of the socket.
+        void GetStats(WorldSocketStats& stats);
+
+        /// True if the client does not read its data in time, packets that are not needed should be skipped.
+        /// Checked without the output lock, the result may be one send late.
+        bool IsCongested() const { return m_OutCongestion && m_Stats.pendingBytes >= m_OutCongestion; }
+
         /// Add reference to this object.
         long AddReference(void);
 
@@ -148,11 +210,22 @@ class WorldSocket : protected WorldHandler
         /// Called by WorldSocketMgr/ReactorRunnable.
         int Update(void);
 
+        /// Called by UringRunnable instead of handle_input, -1 if the connection has to be closed.
+        int HandleUringInput(const char* data, size_t size);
+
+        /// Called by UringRunnable to send the output, fills iov with up to MAX_OUT_IOV chunks.
+        /// @return number of chunks, -1 if the connection has to be closed
+        int PrepareUringOutput(iovec* iov);
+
+        /// Called by UringRunnable when the send is done, result is the sent bytes or -errno.
+        int HandleUringOutput(int result);
+
     private:
         /// Helper functions for processing incoming data.
         int handle_input_header(void);
         int handle_input_payload(void);
         int handle_input_missing_data(void);
+        int handle_input_data(ACE_Message_Block& message_block);
 
         /// Help functions to mark/unmark the socket for output.
         /// @param g the guard is for m_OutBufferLock, the function will release it
@@ -169,15 +242,42 @@ class WorldSocket : protected WorldHandler
         /// Called by ProcessIncoming() on CMSG_PING.
         int HandlePing(WorldPacket& recvPacket);
 
-        /// Try to write WorldPacket to m_OutBuffer ,return -1 if no space
+        /// Add header and body to m_OutChain, a not NULL sharedBody is a reference to the packet
+        /// body that is sent instead of a copy, the reference is always consumed.
         /// Need to be called with m_OutBufferLock lock held
-        int iSendPacket(const WorldPacket& pct);
+        int iSendPacket(const WorldPacket& pct, SharedPacketBody* sharedBody);
 
-        /// Flush m_PacketQueue if there are packets in it
+        /// Add a packet that was changed by hooks to m_OutChain, takes ownership of the packet.
         /// Need to be called with m_OutBufferLock lock held
-        /// @return true if it wrote to the buffer ( AKA you need
-        /// to mark the socket for output ).
-        bool iFlushPacketQueue();
+        int iSendPacket(WorldPacket* pct);
+
+        /// Check Network.OutQueueLimit for a new packet, closes the socket if it is reached.
+        /// Need to be called with m_OutBufferLock lock held
+        bool iCheckOutLimit(size_t size);
+
+        /// Copy the header to the send buffers, it is encrypted by iEncryptHeaders.
+        void iWriteHeader(uint16 opcode, size_t size);
+
+        /// Encrypt the headers of m_OutHeaders in one pass, called before the output is sent.
+        void iEncryptHeaders();
+
+        /// Copy data to the send buffers, taking new buffers from the pool as needed.
+        void iWriteOut(const char* data, size_t size);
+
+        /// Continue the output in a new send buffer from the pool.
+        void iNextOutBuffer();
+
+        /// Add a referenced packet body to m_OutChain.
+        void iAddOutReference(const char* data, size_t size, SharedPacketBody* body, WorldPacket* packet);
+
+        /// Fill iov with the first chunks of m_OutChain, returns their number.
+        int iFillOutIov(iovec* iov) const;
+
+        /// Remove sent bytes from the front of m_OutChain.
+        void iConsumeOut(size_t size);
+
+        /// Release what a chunk references.
+        void iReleaseOutChunk(OutChunk& chunk);
 
     private:
         /// Time in which the last ping was received
@@ -212,19 +312,34 @@ class WorldSocket : protected WorldHandler
         /// Mutex for protecting output related data.
         LockType m_OutBufferLock;
 
-        /// Buffer used for writing output.
-        ACE_Message_Block* m_OutBuffer;
+        /// Send buffer new output is copied to, part of m_OutChain may point into it.
+        WorldSocketSendBuffer* m_OutBuffer;
 
-        /// Size of the m_OutBuffer.
+        /// Size of the send buffers.
         size_t m_OutBufferSize;
 
-        /// Here are stored packets for which there was no space on m_OutBuffer,
-        /// this allows not-to kick player if its buffer is overflowed.
-        PacketQueueT m_PacketQueue;
+        /// Output that is not sent yet, this allows not-to kick player
+        /// if the client does not read fast enough for a moment.
+        OutChainT m_OutChain;
+
+        /// Headers in m_OutChain that are not encrypted yet, in order.
+        std::vector<uint8*> m_OutHeaders;
+
+        /// Maximum size of m_OutChain, 0 for unbounded.
+        size_t m_OutQueueLimit;
+
+        /// Size of m_OutChain from which the socket is congested, 0 to disable.
+        size_t m_OutCongestion;
+
+        /// Output counters, protected by m_OutBufferLock.
+        WorldSocketStats m_Stats;
 
         /// True if the socket is registered with the reactor for output
         bool m_OutActive;
 
+        /// io_uring network thread of the socket, NULL if it is handled by a reactor
+        UringRunnable* m_UringThread;
+
         uint32 m_Seed;
 };
 
@@ -31,6 +31,7 @@
 #include <ace/Dev_Poll_Reactor.h>
 #include <ace/Guard_T.h>
 #include <ace/Atomic_Op.h>
+#include <ace/TSS_T.h>
 #include <ace/os_include/arpa/os_inet.h>
 #include <ace/os_include/netinet/os_tcp.h>
 #include <ace/os_include/sys/os_types.h>
@@ -43,6 +44,29 @@
 #include "Config/Config.h"
 #include "Database/DatabaseEnv.h"
 #include "WorldSocket.h"
+#include "WorldSocketUring.h"
+
+/// Free send buffers kept for reuse, 4M with the default buffer size
+#define MAX_FREE_SEND_BUFFERS 1024
+
+/// Network thread running the calling code
+struct NetworkThreadState
+{
+    NetworkThreadState() : stats(NULL) {}
+
+    NetworkThreadStats* stats;
+};
+
+static ACE_TSS<NetworkThreadState> networkThreadState;
+
+/// Called by the reactor after each wait for events
+static int CountReactorWait(ACE_Reactor*)
+{
+    if (NetworkThreadStats* stats = networkThreadState->stats)
+        ++stats->syscalls;
+
+    return 0;
+}
 
 /**
 * This is a helper class to WorldSocketMgr ,that manages
@@ -121,6 +145,14 @@ class ReactorRunnable : protected ACE_Task_Base
             return m_Reactor;
         }
 
+        /// Read without lock, the values may be a moment old
+        NetworkThreadStats GetStats()
+        {
+            NetworkThreadStats stats = m_Stats;
+            stats.connections = uint32(Connections());
+            return stats;
+        }
+
     protected:
         void AddNewSockets()
         {
@@ -153,6 +185,8 @@ class ReactorRunnable : protected ACE_Task_Base
 
             MANGOS_ASSERT(m_Reactor);
 
+            networkThreadState->stats = &m_Stats;
+
             SocketSet::iterator i, t;
             const int timeout = sConfig.GetIntDefault("Network.Timeout", 100000);
 
@@ -162,7 +196,7 @@ class ReactorRunnable : protected ACE_Task_Base
                 // the run_reactor_event_loop will modify interval
                 ACE_Time_Value interval(0, timeout);
 
-                if (m_Reactor->run_reactor_event_loop(interval) == -1)
+                if (m_Reactor->run_reactor_event_loop(interval, &CountReactorWait) == -1)
                     break;
 
                 AddNewSockets();
@@ -202,13 +236,19 @@ class ReactorRunnable : protected ACE_Task_Base
 
         SocketSet m_NewSockets;
         ACE_Thread_Mutex m_NewSockets_Lock;
+
+        NetworkThreadStats m_Stats;
 };
 
 WorldSocketMgr::WorldSocketMgr():
     m_NetThreads(0),
     m_NetThreadsCount(0),
+    m_UringThreads(0),
+    m_UringThreadsCount(0),
     m_SockOutKBuff(-1),
-    m_SockOutUBuff(65536),
+    m_SockOutUBuff(4096),
+    m_SockOutQueueLimit(0),
+    m_SockOutCongestion(0),
     m_UseNoDelay(true),
     m_Acceptor(0)
 {
@@ -216,8 +256,14 @@ WorldSocketMgr::WorldSocketMgr():
 
 WorldSocketMgr::~WorldSocketMgr()
 {
+#ifdef USE_IO_URING
+    delete[] m_UringThreads;
+#endif
     delete[] m_NetThreads;
     delete m_Acceptor;
+
+    for (SendBufferList::const_iterator itr = m_FreeSendBuffers.begin(); itr != m_FreeSendBuffers.end(); ++itr)
+        delete[] reinterpret_cast<char*>(*itr);
 }
 
 int WorldSocketMgr::StartReactiveIO(ACE_UINT16 port, const char* address)
@@ -234,6 +280,37 @@ int WorldSocketMgr::StartReactiveIO(ACE_UINT16 port, const char* address)
 
     m_NetThreadsCount = static_cast<size_t>(num_threads + 1);
 
+#ifdef USE_IO_URING
+    if (sConfig.GetBoolDefault("Network.IoUring", false))
+    {
+        uint32 buffers = uint32(sConfig.GetIntDefault("Network.IoUringBuffers", 1024));
+        int timeout = sConfig.GetIntDefault("Network.Timeout", 100000);
+
+        m_UringThreadsCount = static_cast<size_t>(num_threads);
+        m_UringThreads = new UringRunnable[m_UringThreadsCount];
+
+        for (size_t i = 0; i < m_UringThreadsCount; ++i)
+        {
+            if (!m_UringThreads[i].Initialize(buffers, timeout))
+            {
+                sLog.outError("io_uring network threads need Linux 6.1 or newer, using the ACE reactor");
+
+                delete[] m_UringThreads;
+                m_UringThreads = 0;
+                m_UringThreadsCount = 0;
+                break;
+            }
+        }
+
+        // the reactor thread only accepts connections
+        if (m_UringThreads)
+        {
+            m_NetThreadsCount = 1;
+            sLog.outString("Network threads use io_uring");
+        }
+    }
+#endif
+
     m_NetThreads = new ReactorRunnable[m_NetThreadsCount];
 
     BASIC_LOG("Max allowed socket connections %d", ACE::max_handles());
@@ -241,14 +318,32 @@ int WorldSocketMgr::StartReactiveIO(ACE_UINT16 port, const char* address)
     // -1 means use default
     m_SockOutKBuff = sConfig.GetIntDefault("Network.OutKBuff", -1);
 
-    m_SockOutUBuff = sConfig.GetIntDefault("Network.OutUBuff", 65536);
+    m_SockOutUBuff = sConfig.GetIntDefault("Network.OutUBuff", 4096);
 
-    if (m_SockOutUBuff <= 0)
+    if (m_SockOutUBuff < 256)
     {
         sLog.outError("Network.OutUBuff is wrong in your config file");
         return -1;
     }
 
+    // 0 means unbounded
+    m_SockOutQueueLimit = sConfig.GetIntDefault("Network.OutQueueLimit", 8388608);
+
+    if (m_SockOutQueueLimit < 0)
+    {
+        sLog.outError("Network.OutQueueLimit is wrong in your config file");
+        return -1;
+    }
+
+    // 0 means never congested
+    m_SockOutCongestion = sConfig.GetIntDefault("Network.OutCongestion", 262144);
+
+    if (m_SockOutCongestion < 0)
+    {
+        sLog.outError("Network.OutCongestion is wrong in your config file");
+        return -1;
+    }
+
     WorldSocket::Acceptor* acc = new WorldSocket::Acceptor;
     m_Acceptor = acc;
 
@@ -263,6 +358,11 @@ int WorldSocketMgr::StartReactiveIO(ACE_UINT16 port, const char* address)
     for (size_t i = 0; i < m_NetThreadsCount; ++i)
         m_NetThreads[i].Start();
 
+#ifdef USE_IO_URING
+    for (size_t i = 0; i < m_UringThreadsCount; ++i)
+        m_UringThreads[i].Start();
+#endif
+
     return 0;
 }
 
@@ -293,6 +393,11 @@ void WorldSocketMgr::StopNetwork()
             m_NetThreads[i].Stop();
     }
 
+#ifdef USE_IO_URING
+    for (size_t i = 0; i < m_UringThreadsCount; ++i)
+        m_UringThreads[i].Stop();
+#endif
+
     Wait();
 }
 
@@ -303,6 +408,11 @@ void WorldSocketMgr::Wait()
         for (size_t i = 0; i < m_NetThreadsCount; ++i)
             m_NetThreads[i].Wait();
     }
+
+#ifdef USE_IO_URING
+    for (size_t i = 0; i < m_UringThreadsCount; ++i)
+        m_UringThreads[i].Wait();
+#endif
 }
 
 int WorldSocketMgr::OnSocketOpen(WorldSocket* sock)
@@ -330,6 +440,23 @@ int WorldSocketMgr::OnSocketOpen(WorldSocket* sock)
     }
 
     sock->m_OutBufferSize = static_cast<size_t>(m_SockOutUBuff);
+    sock->m_OutQueueLimit = static_cast<size_t>(m_SockOutQueueLimit);
+    sock->m_OutCongestion = static_cast<size_t>(m_SockOutCongestion);
+
+#ifdef USE_IO_URING
+    // the socket is handed to the thread at the end of WorldSocket::open
+    if (m_UringThreads)
+    {
+        size_t min = 0;
+
+        for (size_t i = 1; i < m_UringThreadsCount; ++i)
+            if (m_UringThreads[i].Connections() < m_UringThreads[min].Connections())
+                min = i;
+
+        sock->m_UringThread = &m_UringThreads[min];
+        return 0;
+    }
+#endif
 
     // we skip the Acceptor Thread
     size_t min = 1;
@@ -343,6 +470,71 @@ int WorldSocketMgr::OnSocketOpen(WorldSocket* sock)
     return m_NetThreads[min].AddSocket(sock);
 }
 
+WorldSocketSendBuffer* WorldSocketMgr::AcquireSendBuffer()
+{
+    WorldSocketSendBuffer* buffer = NULL;
+
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, Guard, m_SendBufferLock, NULL);
+
+        if (!m_FreeSendBuffers.empty())
+        {
+            buffer = m_FreeSendBuffers.back();
+            m_FreeSendBuffers.pop_back();
+        }
+    }
+
+    if (!buffer)
+        buffer = reinterpret_cast<WorldSocketSendBuffer*>(new char[sizeof(WorldSocketSendBuffer) + m_SockOutUBuff]);
+
+    buffer->refs = 1;
+    buffer->used = 0;
+    return buffer;
+}
+
+void WorldSocketMgr::ReleaseSendBuffer(WorldSocketSendBuffer* buffer)
+{
+    {
+        ACE_GUARD(ACE_Thread_Mutex, Guard, m_SendBufferLock);
+
+        if (m_FreeSendBuffers.size() < MAX_FREE_SEND_BUFFERS)
+        {
+            m_FreeSendBuffers.push_back(buffer);
+            return;
+        }
+    }
+
+    delete[] reinterpret_cast<char*>(buffer);
+}
+
+void WorldSocketMgr::GetNetworkStats(std::vector<NetworkThreadStats>& stats)
+{
+    stats.clear();
+
+#ifdef USE_IO_URING
+    if (m_UringThreads)
+    {
+        for (size_t i = 0; i < m_UringThreadsCount; ++i)
+            stats.push_back(m_UringThreads[i].GetStats());
+        return;
+    }
+#endif
+
+    // the first thread only accepts connections
+    for (size_t i = 1; i < m_NetThreadsCount; ++i)
+        stats.push_back(m_NetThreads[i].GetStats());
+}
+
+NetworkThreadStats* WorldSocketMgr::GetThreadStats()
+{
+    return networkThreadState->stats;
+}
+
+void WorldSocketMgr::SetThreadStats(NetworkThreadStats* stats)
+{
+    networkThreadState->stats = stats;
+}
+
 WorldSocketMgr* WorldSocketMgr::Instance()
 {
     return ACE_Singleton<WorldSocketMgr, ACE_Thread_Mutex>::instance();
@@ -30,16 +30,33 @@
 #include <ace/Thread_Mutex.h>
 
 #include <string>
+#include <vector>
 
 class WorldSocket;
+struct WorldSocketSendBuffer;
 class ReactorRunnable;
+class UringRunnable;
 class ACE_Event_Handler;
 
+/// Counters of one network thread, only written by the thread itself
+struct NetworkThreadStats
+{
+    NetworkThreadStats() : connections(0), syscalls(0), receives(0), packets(0), writes(0), sentBytes(0) {}
+
+    ACE_UINT32 connections;
+    ACE_UINT64 syscalls;                                    // reactor: epoll_wait, recv, sendmsg, epoll_ctl; io_uring: io_uring_enter
+    ACE_UINT64 receives;                                    // reads that returned data
+    ACE_UINT64 packets;                                     // packets flushed to the sockets
+    ACE_UINT64 writes;                                      // socket writes that sent data, one write sends many packets
+    ACE_UINT64 sentBytes;
+};
+
 /// Manages all sockets connected to peers and network threads
 class WorldSocketMgr
 {
     public:
         friend class WorldSocket;
+        friend class UringRunnable;
         friend class ACE_Singleton<WorldSocketMgr, ACE_Thread_Mutex>;
 
         /// Start network, listen at address:port .
@@ -54,20 +71,42 @@ class WorldSocketMgr
         /// Make this class singleton .
         static WorldSocketMgr* Instance();
 
+        /// Counters of the threads that run the sockets, the acceptor thread is not included
+        void GetNetworkStats(std::vector<NetworkThreadStats>& stats);
+        bool UsesIoUring() const { return m_UringThreadsCount != 0; }
+
     private:
         int OnSocketOpen(WorldSocket* sock);
         int StartReactiveIO(ACE_UINT16 port, const char* address);
 
+        /// Send buffers of Network.OutUBuff bytes shared by all sockets
+        WorldSocketSendBuffer* AcquireSendBuffer();
+        void ReleaseSendBuffer(WorldSocketSendBuffer* buffer);
+
+        /// Counters of the calling network thread, NULL in other threads
+        static NetworkThreadStats* GetThreadStats();
+        static void SetThreadStats(NetworkThreadStats* stats);
+
         WorldSocketMgr();
         virtual ~WorldSocketMgr();
 
         ReactorRunnable* m_NetThreads;
         size_t m_NetThreadsCount;
 
+        /// io_uring network threads, the reactor threads only accept then
+        UringRunnable* m_UringThreads;
+        size_t m_UringThreadsCount;
+
         int m_SockOutKBuff;
         int m_SockOutUBuff;
+        int m_SockOutQueueLimit;
+        int m_SockOutCongestion;
         bool m_UseNoDelay;
 
+        typedef std::vector<WorldSocketSendBuffer*> SendBufferList;
+        SendBufferList m_FreeSendBuffers;
+        ACE_Thread_Mutex m_SendBufferLock;
+
         std::string m_addr;
         ACE_UINT16 m_port;
 
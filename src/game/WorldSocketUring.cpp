@@ -0,0 +1,559 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file WorldSocketUring.cpp
+ *  \ingroup u2w
+ */
+
+#include "WorldSocket.h"                                    // must be first to make ACE happy with ACE includes in it
+#include "WorldSocketUring.h"
+
+#ifdef USE_IO_URING
+
+#include "Log.h"
+#include "Database/DatabaseEnv.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#define URING_ENTRIES           1024                        // submission queue, the completion queue is 8 times larger
+#define URING_BUFFER_SIZE       4096                        // same as the reactor receive buffer
+#define URING_BUFFER_GROUP      0
+
+// request kind in the low bits of the user data, the rest is the SocketState pointer
+#define URING_OP_RECV           1
+#define URING_OP_SEND           2
+#define URING_OP_MASK           3
+
+struct UringRunnable::SocketState
+{
+    WorldSocket* sock;
+    int fd;
+    uint32 inflight;                                        // requests of the socket the kernel has not completed
+    bool recvArmed;
+    bool cancelQueued;
+    bool sending;
+    bool closing;
+
+    // kept until the send completes
+    iovec iov[MAX_OUT_IOV];
+    msghdr msg;
+};
+
+static inline uint64 MakeUserData(void* state, uint32 op)
+{
+    return uint64(reinterpret_cast<uintptr_t>(state)) | op;
+}
+
+UringRunnable::UringRunnable() :
+    m_RingFd(-1), m_ThreadId(-1), m_Timeout(100000), m_Stopping(0), m_Connections(0),
+    m_SqRing(MAP_FAILED), m_SqRingSize(0), m_SqHead(NULL), m_SqTail(NULL), m_SqMask(0), m_SqEntries(0),
+    m_SqLocalTail(0), m_ToSubmit(0), m_Sqes(NULL), m_SqesSize(0),
+    m_CqRing(MAP_FAILED), m_CqRingSize(0), m_CqHead(NULL), m_CqTail(NULL), m_CqMask(0), m_Cqes(NULL),
+    m_BufRing(NULL), m_BufRingSize(0), m_Buffers(NULL), m_BufferCount(0), m_BufTail(0)
+{
+}
+
+UringRunnable::~UringRunnable()
+{
+    Stop();
+    Wait();
+
+    Release();
+}
+
+bool UringRunnable::Initialize(uint32 bufferCount, int timeout)
+{
+    m_Timeout = timeout;
+
+    // the ring is enabled by the network thread, the only one submitting to it
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN | IORING_SETUP_R_DISABLED;
+    params.cq_entries = URING_ENTRIES * 8;
+
+    m_RingFd = syscall(__NR_io_uring_setup, URING_ENTRIES, &params);
+    if (m_RingFd < 0)
+    {
+        sLog.outError("UringRunnable: io_uring_setup failed errno = %s", ACE_OS::strerror(errno));
+        return false;
+    }
+
+    m_SqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32);
+    m_CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        m_SqRingSize = m_CqRingSize = std::max(m_SqRingSize, m_CqRingSize);
+
+    m_SqRing = mmap(NULL, m_SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_SQ_RING);
+    if (m_SqRing == MAP_FAILED)
+    {
+        sLog.outError("UringRunnable: mmap of the submission queue failed errno = %s", ACE_OS::strerror(errno));
+        Release();
+        return false;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        m_CqRing = m_SqRing;
+    else
+    {
+        m_CqRing = mmap(NULL, m_CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_CQ_RING);
+        if (m_CqRing == MAP_FAILED)
+        {
+            sLog.outError("UringRunnable: mmap of the completion queue failed errno = %s", ACE_OS::strerror(errno));
+            Release();
+            return false;
+        }
+    }
+
+    m_SqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(NULL, m_SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        sLog.outError("UringRunnable: mmap of the submission entries failed errno = %s", ACE_OS::strerror(errno));
+        Release();
+        return false;
+    }
+
+    m_Sqes = static_cast<io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(m_SqRing);
+    m_SqHead = reinterpret_cast<uint32*>(sq + params.sq_off.head);
+    m_SqTail = reinterpret_cast<uint32*>(sq + params.sq_off.tail);
+    m_SqMask = *reinterpret_cast<uint32*>(sq + params.sq_off.ring_mask);
+    m_SqEntries = params.sq_entries;
+    m_SqLocalTail = *m_SqTail;
+
+    // entries are always used in ring order
+    uint32* sqArray = reinterpret_cast<uint32*>(sq + params.sq_off.array);
+    for (uint32 i = 0; i < m_SqEntries; ++i)
+        sqArray[i] = i;
+
+    char* cq = static_cast<char*>(m_CqRing);
+    m_CqHead = reinterpret_cast<uint32*>(cq + params.cq_off.head);
+    m_CqTail = reinterpret_cast<uint32*>(cq + params.cq_off.tail);
+    m_CqMask = *reinterpret_cast<uint32*>(cq + params.cq_off.ring_mask);
+    m_Cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    // receive buffers, the count has to be a power of two
+    m_BufferCount = 1;
+    while (m_BufferCount < bufferCount && m_BufferCount < 32768)
+        m_BufferCount <<= 1;
+
+    m_BufRingSize = m_BufferCount * sizeof(io_uring_buf);
+    void* bufRing = mmap(NULL, m_BufRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (bufRing == MAP_FAILED)
+    {
+        sLog.outError("UringRunnable: mmap of the buffer ring failed errno = %s", ACE_OS::strerror(errno));
+        Release();
+        return false;
+    }
+
+    m_BufRing = static_cast<io_uring_buf*>(bufRing);
+    m_Buffers = new char[size_t(m_BufferCount) * URING_BUFFER_SIZE];
+
+    io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uintptr_t>(m_BufRing);
+    reg.ring_entries = m_BufferCount;
+    reg.bgid = URING_BUFFER_GROUP;
+
+    if (syscall(__NR_io_uring_register, m_RingFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+    {
+        sLog.outError("UringRunnable: registering the buffer ring failed errno = %s", ACE_OS::strerror(errno));
+        Release();
+        return false;
+    }
+
+    for (uint32 i = 0; i < m_BufferCount; ++i)
+        RecycleBuffer(uint16(i));
+
+    __atomic_store_n(&m_BufRing[0].resv, m_BufTail, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+void UringRunnable::Release()
+{
+    // closing the ring cancels the requests still running
+    if (m_RingFd >= 0)
+        close(m_RingFd);
+    m_RingFd = -1;
+
+    if (m_Sqes)
+        munmap(m_Sqes, m_SqesSize);
+    m_Sqes = NULL;
+
+    if (m_CqRing != MAP_FAILED && m_CqRing != m_SqRing)
+        munmap(m_CqRing, m_CqRingSize);
+    m_CqRing = MAP_FAILED;
+
+    if (m_SqRing != MAP_FAILED)
+        munmap(m_SqRing, m_SqRingSize);
+    m_SqRing = MAP_FAILED;
+
+    if (m_BufRing)
+        munmap(m_BufRing, m_BufRingSize);
+    m_BufRing = NULL;
+
+    delete[] m_Buffers;
+    m_Buffers = NULL;
+
+    for (SocketList::const_iterator itr = m_Sockets.begin(); itr != m_Sockets.end(); ++itr)
+    {
+        (*itr)->sock->CloseSocket();
+        (*itr)->sock->RemoveReference();
+        delete *itr;
+    }
+    m_Sockets.clear();
+
+    for (std::vector<WorldSocket*>::const_iterator itr = m_NewSockets.begin(); itr != m_NewSockets.end(); ++itr)
+    {
+        (*itr)->CloseSocket();
+        (*itr)->RemoveReference();
+    }
+    m_NewSockets.clear();
+}
+
+int UringRunnable::Start()
+{
+    if (m_ThreadId != -1)
+        return -1;
+
+    return (m_ThreadId = activate());
+}
+
+void UringRunnable::Stop()
+{
+    m_Stopping = 1;
+}
+
+int UringRunnable::AddSocket(WorldSocket* sock)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, Guard, m_NewSockets_Lock, -1);
+
+    ++m_Connections;
+    sock->AddReference();
+    m_NewSockets.push_back(sock);
+
+    return 0;
+}
+
+int UringRunnable::svc()
+{
+    DEBUG_LOG("Network Thread Starting (io_uring)");
+
+    WorldDatabase.ThreadStart();
+
+    // the sockets count their packets and writes
+    WorldSocketMgr::SetThreadStats(&m_Stats);
+
+    if (syscall(__NR_io_uring_register, m_RingFd, IORING_REGISTER_ENABLE_RINGS, NULL, 0) < 0)
+        sLog.outError("UringRunnable: enabling the ring failed errno = %s", ACE_OS::strerror(errno));
+    else
+    {
+        while (!m_Stopping.value())
+        {
+            AddNewSockets();
+            UpdateSockets();
+
+            if (Submit(true) == -1)
+                break;
+
+            ProcessCompletions();
+        }
+    }
+
+    WorldDatabase.ThreadEnd();
+
+    DEBUG_LOG("Network Thread Exitting (io_uring)");
+
+    return 0;
+}
+
+void UringRunnable::AddNewSockets()
+{
+    ACE_GUARD(ACE_Thread_Mutex, Guard, m_NewSockets_Lock);
+
+    for (std::vector<WorldSocket*>::const_iterator itr = m_NewSockets.begin(); itr != m_NewSockets.end(); ++itr)
+    {
+        SocketState* state = new SocketState;
+        memset(state, 0, sizeof(SocketState));
+        state->sock = *itr;
+        state->fd = (*itr)->get_handle();
+
+        m_Sockets.push_back(state);
+    }
+
+    m_NewSockets.clear();
+}
+
+void UringRunnable::UpdateSockets()
+{
+    for (size_t i = 0; i < m_Sockets.size();)
+    {
+        SocketState* state = m_Sockets[i];
+
+        if (!state->closing && state->sock->IsClosed())
+            StartClose(state);
+
+        if (state->closing)
+        {
+            if (state->recvArmed && !state->cancelQueued)
+                QueueCancel(state);
+
+            // the kernel may still use the output, keep the socket until all requests completed
+            if (state->inflight)
+            {
+                ++i;
+                continue;
+            }
+
+            state->sock->RemoveReference();
+            --m_Connections;
+            delete state;
+
+            m_Sockets[i] = m_Sockets.back();
+            m_Sockets.pop_back();
+            continue;
+        }
+
+        // multishot recv stops when no buffer was free
+        if (!state->recvArmed)
+            ArmRecv(state);
+
+        if (!state->sending)
+        {
+            int count = state->sock->PrepareUringOutput(state->iov);
+            if (count == -1)
+                StartClose(state);
+            else if (count > 0)
+                QueueSend(state, count);
+        }
+
+        ++i;
+    }
+}
+
+void UringRunnable::ProcessCompletions()
+{
+    uint32 head = *m_CqHead;
+    uint32 tail = __atomic_load_n(m_CqTail, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; ++head)
+    {
+        io_uring_cqe const& cqe = m_Cqes[head & m_CqMask];
+        HandleCompletion(cqe.user_data, cqe.res, cqe.flags);
+    }
+
+    __atomic_store_n(m_CqHead, head, __ATOMIC_RELEASE);
+
+    // give the buffers of the processed data back to the kernel
+    __atomic_store_n(&m_BufRing[0].resv, m_BufTail, __ATOMIC_RELEASE);
+}
+
+void UringRunnable::HandleCompletion(uint64 userData, int result, uint32 flags)
+{
+    // cancel requests
+    if (!userData)
+        return;
+
+    SocketState* state = reinterpret_cast<SocketState*>(uintptr_t(userData & ~uint64(URING_OP_MASK)));
+
+    switch (userData & URING_OP_MASK)
+    {
+        case URING_OP_RECV:
+        {
+            if (!(flags & IORING_CQE_F_MORE))
+            {
+                state->recvArmed = false;
+                --state->inflight;
+            }
+
+            if (result > 0)
+            {
+                uint16 bid = uint16(flags >> IORING_CQE_BUFFER_SHIFT);
+                ++m_Stats.receives;
+
+                if (!state->closing && state->sock->HandleUringInput(m_Buffers + size_t(bid) * URING_BUFFER_SIZE, size_t(result)) == -1)
+                    StartClose(state);
+
+                RecycleBuffer(bid);
+            }
+            // all buffers are in use, the recv is armed again after they are returned
+            else if (result == -ENOBUFS || result == -ECANCELED)
+                break;
+            else
+            {
+                if (result == 0)
+                    DEBUG_LOG("UringRunnable: Peer has closed connection");
+                else
+                    DEBUG_LOG("UringRunnable: Peer error closing connection errno = %s", ACE_OS::strerror(-result));
+
+                StartClose(state);
+            }
+            break;
+        }
+        case URING_OP_SEND:
+        {
+            state->sending = false;
+            --state->inflight;
+
+            if (!state->closing && state->sock->HandleUringOutput(result) == -1)
+                StartClose(state);
+            break;
+        }
+    }
+}
+
+void UringRunnable::ArmRecv(SocketState* state)
+{
+    io_uring_sqe* sqe = GetSqe();
+    if (!sqe)
+        return;
+
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = state->fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = MakeUserData(state, URING_OP_RECV);
+
+    state->recvArmed = true;
+    ++state->inflight;
+}
+
+void UringRunnable::QueueSend(SocketState* state, int count)
+{
+    io_uring_sqe* sqe = GetSqe();
+    if (!sqe)
+        return;
+
+    memset(&state->msg, 0, sizeof(state->msg));
+    state->msg.msg_iov = state->iov;
+    state->msg.msg_iovlen = count;
+
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = state->fd;
+    sqe->addr = reinterpret_cast<uintptr_t>(&state->msg);
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = MakeUserData(state, URING_OP_SEND);
+
+    state->sending = true;
+    ++state->inflight;
+}
+
+void UringRunnable::QueueCancel(SocketState* state)
+{
+    io_uring_sqe* sqe = GetSqe();
+    if (!sqe)
+        return;
+
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = MakeUserData(state, URING_OP_RECV);
+    sqe->user_data = 0;
+
+    state->cancelQueued = true;
+}
+
+void UringRunnable::StartClose(SocketState* state)
+{
+    state->closing = true;
+    state->sock->CloseSocket();
+}
+
+void UringRunnable::RecycleBuffer(uint16 bid)
+{
+    // io_uring_buf_ring::bufs is misplaced by the empty struct of __DECLARE_FLEX_ARRAY in C++
+    io_uring_buf& buf = m_BufRing[m_BufTail & (m_BufferCount - 1)];
+    buf.addr = reinterpret_cast<uintptr_t>(m_Buffers + size_t(bid) * URING_BUFFER_SIZE);
+    buf.len = URING_BUFFER_SIZE;
+    buf.bid = bid;
+
+    ++m_BufTail;
+}
+
+io_uring_sqe* UringRunnable::GetSqe()
+{
+    if (m_SqLocalTail - __atomic_load_n(m_SqHead, __ATOMIC_ACQUIRE) >= m_SqEntries)
+    {
+        Submit(false);
+
+        if (m_SqLocalTail - __atomic_load_n(m_SqHead, __ATOMIC_ACQUIRE) >= m_SqEntries)
+            return NULL;
+    }
+
+    io_uring_sqe* sqe = &m_Sqes[m_SqLocalTail & m_SqMask];
+    memset(sqe, 0, sizeof(io_uring_sqe));
+
+    ++m_SqLocalTail;
+    ++m_ToSubmit;
+    return sqe;
+}
+
+int UringRunnable::Submit(bool wait)
+{
+    __atomic_store_n(m_SqTail, m_SqLocalTail, __ATOMIC_RELEASE);
+
+    uint32 flags = 0;
+    uint32 minComplete = 0;
+    void* arg = NULL;
+    size_t argSize = 0;
+
+    __kernel_timespec ts;
+    io_uring_getevents_arg eventsArg;
+
+    if (wait)
+    {
+        ts.tv_sec = m_Timeout / 1000000;
+        ts.tv_nsec = (m_Timeout % 1000000) * 1000;
+
+        memset(&eventsArg, 0, sizeof(eventsArg));
+        eventsArg.ts = reinterpret_cast<uintptr_t>(&ts);
+
+        // completions are also run in this call, only wait if there are none yet
+        flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+        minComplete = *m_CqHead == __atomic_load_n(m_CqTail, __ATOMIC_ACQUIRE) ? 1 : 0;
+        arg = &eventsArg;
+        argSize = sizeof(eventsArg);
+    }
+    else if (!m_ToSubmit)
+        return 0;
+
+    int ret = syscall(__NR_io_uring_enter, m_RingFd, m_ToSubmit, minComplete, flags, arg, argSize);
+    ++m_Stats.syscalls;
+    if (ret < 0)
+    {
+        // timeout, signal, or the completion queue is full and has to be read first
+        if (errno == ETIME || errno == EINTR || errno == EBUSY || errno == EAGAIN)
+            return 0;
+
+        sLog.outError("UringRunnable: io_uring_enter failed errno = %s", ACE_OS::strerror(errno));
+        return -1;
+    }
+
+    m_ToSubmit -= uint32(ret);
+    return 0;
+}
+
+#endif
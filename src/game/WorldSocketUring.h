@@ -0,0 +1,147 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \addtogroup u2w User to World Communication
+ *  @{
+ *  \file WorldSocketUring.h
+ */
+
+#ifndef MANGOS_WORLDSOCKETURING_H
+#define MANGOS_WORLDSOCKETURING_H
+
+#ifdef USE_IO_URING
+
+#include <ace/Task.h>
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+
+#include "Common.h"
+#include "WorldSocketMgr.h"
+
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf;
+class WorldSocket;
+
+/**
+ * Network thread that runs its sockets on an io_uring instance instead of an ACE reactor (Linux 6.1+).
+ *
+ * Every socket has one multishot recv that receives into a ring of buffers provided to the kernel,
+ * so reading needs no syscall per socket. The output of all sockets is submitted as sendmsg requests
+ * in the same io_uring_enter call that waits for completions.
+ *
+ * Accepting through io_uring is not done: new connections are accepted by the acceptor reactor of
+ * WorldSocketMgr and handed over after WorldSocket::open, one accept per login does not show up next
+ * to the reads and writes of the connected sockets.
+ */
+class UringRunnable : protected ACE_Task_Base
+{
+    public:
+        UringRunnable();
+        virtual ~UringRunnable();
+
+        /// Create the ring and its receive buffers, false if the kernel does not support them
+        bool Initialize(uint32 bufferCount, int timeout);
+
+        int Start();
+        void Stop();
+        void Wait() { ACE_Task_Base::wait(); }
+
+        long Connections() { return static_cast<long>(m_Connections.value()); }
+
+        /// Read without lock, the values may be a moment old
+        NetworkThreadStats GetStats()
+        {
+            NetworkThreadStats stats = m_Stats;
+            stats.connections = uint32(Connections());
+            return stats;
+        }
+
+        /// Hand an opened socket to the thread
+        int AddSocket(WorldSocket* sock);
+
+    protected:
+        virtual int svc() override;
+
+    private:
+        struct SocketState;
+        typedef std::vector<SocketState*> SocketList;
+        typedef ACE_Atomic_Op<ACE_Thread_Mutex, long> AtomicInt;
+
+        void AddNewSockets();
+        void UpdateSockets();
+        void ProcessCompletions();
+        void HandleCompletion(uint64 userData, int result, uint32 flags);
+
+        void ArmRecv(SocketState* state);
+        void QueueSend(SocketState* state, int count);
+        void QueueCancel(SocketState* state);
+        void StartClose(SocketState* state);
+        void RecycleBuffer(uint16 bid);
+
+        io_uring_sqe* GetSqe();
+        int Submit(bool wait);
+        void Release();
+
+        int m_RingFd;
+        int m_ThreadId;
+        int m_Timeout;                                      // microseconds the thread waits without completions
+        AtomicInt m_Stopping;
+        AtomicInt m_Connections;
+
+        // submission queue, shared with the kernel
+        void* m_SqRing;
+        size_t m_SqRingSize;
+        uint32* m_SqHead;
+        uint32* m_SqTail;
+        uint32 m_SqMask;
+        uint32 m_SqEntries;
+        uint32 m_SqLocalTail;                               // written but not yet published entries end here
+        uint32 m_ToSubmit;
+        io_uring_sqe* m_Sqes;
+        size_t m_SqesSize;
+
+        // completion queue, shared with the kernel
+        void* m_CqRing;
+        size_t m_CqRingSize;
+        uint32* m_CqHead;
+        uint32* m_CqTail;
+        uint32 m_CqMask;
+        io_uring_cqe* m_Cqes;
+
+        // receive buffers provided to the kernel, the ring tail overlays the reserved field of the first entry
+        io_uring_buf* m_BufRing;
+        size_t m_BufRingSize;
+        char* m_Buffers;
+        uint32 m_BufferCount;
+        uint16 m_BufTail;
+
+        SocketList m_Sockets;
+
+        NetworkThreadStats m_Stats;
+
+        std::vector<WorldSocket*> m_NewSockets;
+        ACE_Thread_Mutex m_NewSockets_Lock;
+};
+
+#endif
+
+#endif
+/// @}
@@ -419,21 +419,39 @@ int Master::Run()
     return World::GetExitCode();
 }
 
+/// Connect the optional read-only replica of a database, read-only queries use the primary without it
+static void InitReplicaDatabase(Database& db, char const* name)
+{
+    std::string prefix = std::string(name) + "DatabaseReplica";
+    std::string dbstring = sConfig.GetStringDefault((prefix + "Info").c_str(), "");
+    if (dbstring.empty())
+        return;
+
+    int nConnections = sConfig.GetIntDefault((prefix + "Connections").c_str(), 1);
+    uint32 readClasses = uint32(sConfig.GetIntDefault((prefix + "Classes").c_str(), SQL_READ_DEFAULT));
+
+    if (db.InitializeReplica(dbstring.c_str(), nConnections, readClasses))
+        sLog.outString("%s Database replica connections: %i (read classes 0x%02X)", name, nConnections, readClasses);
+    else
+        sLog.outError("Cannot connect to %s database replica %s, its read-only queries use the primary database", name, dbstring.c_str());
+}
+
 /// Initialize connection to the databases
 bool Master::_StartDB()
 {
     ///- Get world database info from configuration file
     std::string dbstring = sConfig.GetStringDefault("WorldDatabaseInfo", "");
     int nConnections = sConfig.GetIntDefault("WorldDatabaseConnections", 1);
+    int nAsyncConnections = sConfig.GetIntDefault("WorldDatabaseAsyncConnections", 1);
     if (dbstring.empty())
     {
         sLog.outError("Database not specified in configuration file");
         return false;
     }
-    sLog.outString("World Database total connections: %i", nConnections + 1);
+    sLog.outString("World Database total connections: %i", nConnections + nAsyncConnections);
 
     ///- Initialise the world database
-    if (!WorldDatabase.Initialize(dbstring.c_str(), nConnections))
+    if (!WorldDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
     {
         sLog.outError("Cannot connect to world database %s", dbstring.c_str());
         return false;
@@ -448,6 +466,7 @@ bool Master::_StartDB()
 
     dbstring = sConfig.GetStringDefault("CharacterDatabaseInfo", "");
     nConnections = sConfig.GetIntDefault("CharacterDatabaseConnections", 1);
+    nAsyncConnections = sConfig.GetIntDefault("CharacterDatabaseAsyncConnections", 1);
     if (dbstring.empty())
     {
         sLog.outError("Character Database not specified in configuration file");
@@ -456,10 +475,10 @@ bool Master::_StartDB()
         WorldDatabase.HaltDelayThread();
         return false;
     }
-    sLog.outString("Character Database total connections: %i", nConnections + 1);
+    sLog.outString("Character Database total connections: %i", nConnections + nAsyncConnections);
 
     ///- Initialise the Character database
-    if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections))
+    if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
     {
         sLog.outError("Cannot connect to Character database %s", dbstring.c_str());
 
@@ -479,6 +498,7 @@ bool Master::_StartDB()
     ///- Get login database info from configuration file
     dbstring = sConfig.GetStringDefault("LoginDatabaseInfo", "");
     nConnections = sConfig.GetIntDefault("LoginDatabaseConnections", 1);
+    nAsyncConnections = sConfig.GetIntDefault("LoginDatabaseAsyncConnections", 1);
     if (dbstring.empty())
     {
         sLog.outError("Login database not specified in configuration file");
@@ -490,8 +510,8 @@ bool Master::_StartDB()
     }
 
     ///- Initialise the login database
-    sLog.outString("Login Database total connections: %i", nConnections + 1);
-    if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections))
+    sLog.outString("Login Database total connections: %i", nConnections + nAsyncConnections);
+    if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
     {
         sLog.outError("Cannot connect to login database %s", dbstring.c_str());
 
@@ -510,6 +530,11 @@ bool Master::_StartDB()
         return false;
     }
 
+    ///- Optional read-only replicas for bulk reads
+    InitReplicaDatabase(WorldDatabase, "World");
+    InitReplicaDatabase(CharacterDatabase, "Character");
+    InitReplicaDatabase(LoginDatabase, "Login");
+
     ///- Get the realm Id from the configuration file
     realmID = sConfig.GetIntDefault("RealmID", 0);
     if (!realmID)
@@ -403,6 +403,17 @@ bool StartDB()
         return false;
     }
 
+    ///- Optional read-only replica for the character counts of the realm list
+    dbstring = sConfig.GetStringDefault("LoginDatabaseReplicaInfo", "");
+    if (!dbstring.empty())
+    {
+        uint32 readClasses = uint32(sConfig.GetIntDefault("LoginDatabaseReplicaClasses", SQL_READ_REALM_COUNTS));
+        if (LoginDatabase.InitializeReplica(dbstring.c_str(), 1, readClasses))
+            sLog.outString("Login Database replica connections: 1");
+        else
+            sLog.outError("Cannot connect to database replica %s, the realm list uses the primary database", dbstring.c_str());
+    }
+
     return true;
 }
 
@@ -21,6 +21,7 @@
 
 AuthCrypt::AuthCrypt()
 {
+    _keyLen = 0;
     _initialized = false;
 }
 
@@ -35,37 +36,66 @@ void AuthCrypt::DecryptRecv(uint8* data, size_t len)
     if (!_initialized) return;
     if (len < CRYPTED_RECV_LEN) return;
 
-    for (size_t t = 0; t < CRYPTED_RECV_LEN; t++)
+    uint8 const* key = &_key[_recv_i];
+    uint8 j = _recv_j;
+
+    for (size_t t = 0; t < CRYPTED_RECV_LEN; ++t)
     {
-        _recv_i %= _key.size();
-        uint8 x = (data[t] - _recv_j) ^ _key[_recv_i];
-        ++_recv_i;
-        _recv_j = data[t];
+        uint8 x = (data[t] - j) ^ key[t];
+        j = data[t];
         data[t] = x;
     }
+
+    _recv_j = j;
+    _recv_i += CRYPTED_RECV_LEN;
+    if (_recv_i >= _keyLen)
+        _recv_i -= _keyLen;
 }
 
 void AuthCrypt::EncryptSend(uint8* data, size_t len)
 {
-    if (!_initialized) return;
     if (len < CRYPTED_SEND_LEN) return;
 
-    for (size_t t = 0; t < CRYPTED_SEND_LEN; t++)
+    EncryptSendHeaders(&data, 1);
+}
+
+void AuthCrypt::EncryptSendHeaders(uint8* const* headers, size_t count)
+{
+    if (!_initialized) return;
+
+    // every byte depends on the previous encrypted one, so the headers
+    // can only be done one after the other, but without a modulo per byte
+    uint8 const* key = &_key[0];
+    size_t i = _send_i;
+    uint8 j = _send_j;
+
+    for (size_t h = 0; h < count; ++h)
     {
-        _send_i %= _key.size();
-        uint8 x = (data[t] ^ _key[_send_i]) + _send_j;
-        ++_send_i;
-        data[t] = _send_j = x;
+        uint8* data = headers[h];
+
+        for (size_t t = 0; t < CRYPTED_SEND_LEN; ++t)
+            data[t] = j = (data[t] ^ key[i + t]) + j;
+
+        i += CRYPTED_SEND_LEN;
+        if (i >= _keyLen)
+            i -= _keyLen;
     }
+
+    _send_i = i;
+    _send_j = j;
 }
 
 void AuthCrypt::SetKey(uint8* key, size_t len)
 {
-    _key.resize(len);
+    MANGOS_ASSERT(len >= CRYPTED_RECV_LEN);
+
+    // repeat the start of the key, a header never wraps around the end
+    _keyLen = len;
+    _key.resize(len + CRYPTED_RECV_LEN);
     std::copy(key, key + len, _key.begin());
+    std::copy(key, key + CRYPTED_RECV_LEN, _key.begin() + len);
 }
 
-
 /*[-ZERO]
 void AuthCrypt::SetKey(BigNumber *bn)
 {
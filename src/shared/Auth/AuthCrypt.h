@@ -40,13 +40,19 @@ class AuthCrypt
         void DecryptRecv(uint8*, size_t);
         void EncryptSend(uint8*, size_t);
 
+        /// Encrypt count send headers of CRYPTED_SEND_LEN bytes in order, the same as
+        /// calling EncryptSend for each of them but with the cipher state kept in locals.
+        void EncryptSendHeaders(uint8* const* headers, size_t count);
+
         bool IsInitialized() { return _initialized; }
 
         static void GenerateKey(uint8*, BigNumber*);
 
     private:
-        std::vector<uint8> _key;
-        uint8 _send_i, _send_j, _recv_i, _recv_j;
+        std::vector<uint8> _key;                            // the key followed by its first CRYPTED_RECV_LEN bytes
+        size_t _keyLen;
+        size_t _send_i, _recv_i;                            // always less than _keyLen at the start of a header
+        uint8 _send_j, _recv_j;
         bool _initialized;
 };
 #endif
@@ -19,6 +19,7 @@
 #include "DatabaseEnv.h"
 #include "Config/Config.h"
 #include "Database/SqlOperations.h"
+#include "Timer.h"
 
 #include <ctime>
 #include <iostream>
@@ -27,6 +28,7 @@
 
 #define MIN_CONNECTION_POOL_SIZE 1
 #define MAX_CONNECTION_POOL_SIZE 16
+#define REPLICA_RETRY_DELAY (MINUTE * IN_MILLISECONDS)
 
 //////////////////////////////////////////////////////////////////////////
 SqlPreparedStatement* SqlConnection::CreateStatement(const std::string& fmt)
@@ -96,7 +98,7 @@ Database::~Database()
     StopServer();
 }
 
-bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
+bool Database::Initialize(const char* infoString, int nConns /*= 1*/, int nAsyncConns /*= 1*/)
 {
     // Enable logging of SQL commands (usually only GM commands)
     // (See method: PExecuteLog)
@@ -109,6 +111,10 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
     }
 
     m_pingIntervallms = sConfig.GetIntDefault("MaxPingTime", 30) * (MINUTE * 1000);
+    m_binaryResults = sConfig.GetBoolDefault("Database.BinaryResults", false);
+
+    int batchRows = sConfig.GetIntDefault("Database.InsertBatchRows", 100);
+    m_insertBatchRows = batchRows > 1 ? uint32(batchRows) : 1;
 
     // create DB connections
 
@@ -133,10 +139,25 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
         m_pQueryConnections.push_back(pConn);
     }
 
-    // create and initialize connection for async requests
-    m_pAsyncConn = CreateConnection();
-    if (!m_pAsyncConn->Initialize(infoString))
-        return false;
+    // create and initialize connections for async requests, one per delay thread
+    if (nAsyncConns < MIN_CONNECTION_POOL_SIZE)
+        nAsyncConns = MIN_CONNECTION_POOL_SIZE;
+    else if (nAsyncConns > MAX_CONNECTION_POOL_SIZE)
+        nAsyncConns = MAX_CONNECTION_POOL_SIZE;
+
+    for (int i = 0; i < nAsyncConns; ++i)
+    {
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+            return false;
+        }
+
+        m_pAsyncConns.push_back(pConn);
+    }
+
+    m_pAsyncConn = m_pAsyncConns[0];
 
     m_pResultQueue = new SqlResultQueue;
 
@@ -144,46 +165,114 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
     return true;
 }
 
+bool Database::InitializeReplica(const char* infoString, int nConns, uint32 readClasses)
+{
+    if (nConns < MIN_CONNECTION_POOL_SIZE)
+        nConns = MIN_CONNECTION_POOL_SIZE;
+    else if (nConns > MAX_CONNECTION_POOL_SIZE)
+        nConns = MAX_CONNECTION_POOL_SIZE;
+
+    SqlConnectionContainer connections;
+    for (int i = 0; i < nConns; ++i)
+    {
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+
+            for (size_t j = 0; j < connections.size(); ++j)
+                delete connections[j];
+
+            return false;
+        }
+
+        connections.push_back(pConn);
+    }
+
+    m_pReplicaConnections.swap(connections);
+    m_replicaReadClasses = readClasses;
+    return true;
+}
+
 void Database::StopServer()
 {
     HaltDelayThread();
 
     delete m_pResultQueue;
-    delete m_pAsyncConn;
 
     m_pResultQueue = NULL;
     m_pAsyncConn = NULL;
 
+    for (size_t i = 0; i < m_pAsyncConns.size(); ++i)
+        delete m_pAsyncConns[i];
+
+    m_pAsyncConns.clear();
+
     for (size_t i = 0; i < m_pQueryConnections.size(); ++i)
         delete m_pQueryConnections[i];
 
     m_pQueryConnections.clear();
+
+    m_replicaReadClasses = 0;
+
+    for (size_t i = 0; i < m_pReplicaConnections.size(); ++i)
+        delete m_pReplicaConnections[i];
+
+    m_pReplicaConnections.clear();
 }
 
-SqlDelayThread* Database::CreateDelayThread()
+SqlDelayThread* Database::CreateDelayThread(SqlConnection* conn, bool pingConnections)
 {
-    assert(m_pAsyncConn);
-    return new SqlDelayThread(this, m_pAsyncConn);
+    assert(conn && m_delayQueue);
+    return new SqlDelayThread(this, conn, m_delayQueue, pingConnections);
 }
 
 void Database::InitDelayThread()
 {
-    assert(!m_delayThread);
+    assert(!m_delayQueue && m_delayThreads.empty());
+
+    m_delayQueue = new SqlDelayQueue;
 
-    // New delay thread for delay execute
-    m_threadBody = CreateDelayThread();              // will deleted at m_delayThread delete
-    m_delayThread = new ACE_Based::Thread(m_threadBody);
+    // New delay threads for delay execute, the first one also pings all connections
+    for (size_t i = 0; i < m_pAsyncConns.size(); ++i)
+        m_delayThreads.push_back(new ACE_Based::Thread(CreateDelayThread(m_pAsyncConns[i], i == 0)));
 }
 
 void Database::HaltDelayThread()
 {
-    if (!m_threadBody || !m_delayThread) return;
+    if (!m_delayQueue) return;
 
-    m_threadBody->Stop();                                   // Stop event
-    m_delayThread->wait();                                  // Wait for flush to DB
-    delete m_delayThread;                                   // This also deletes m_threadBody
-    m_delayThread = NULL;
-    m_threadBody = NULL;
+    m_delayQueue->Stop();                                   // Stop event
+
+    for (size_t i = 0; i < m_delayThreads.size(); ++i)
+    {
+        m_delayThreads[i]->wait();                          // Wait for flush to DB
+        delete m_delayThreads[i];                           // This also deletes the SqlDelayThread
+    }
+
+    m_delayThreads.clear();
+
+    delete m_delayQueue;
+    m_delayQueue = NULL;
+}
+
+void Database::Delay(SqlOperation* op, uint64 ownerKey /*= 0*/, uint64 secondOwnerKey /*= 0*/)
+{
+    m_delayQueue->Add(op, ownerKey, secondOwnerKey);
+}
+
+void Database::GetAsyncStats(SqlDelayQueueStats& stats) const
+{
+    if (m_delayQueue)
+        m_delayQueue->GetStats(stats);
+    else
+        stats = SqlDelayQueueStats();
+}
+
+void Database::ResetAsyncStats()
+{
+    if (m_delayQueue)
+        m_delayQueue->ResetStats();
 }
 
 void Database::ThreadStart()
@@ -194,10 +283,10 @@ void Database::ThreadEnd()
 {
 }
 
-void Database::ProcessResultQueue()
+void Database::ProcessResultQueue(uint32 maxTime)
 {
     if (m_pResultQueue)
-        m_pResultQueue->Update();
+        m_pResultQueue->Update(maxTime);
 }
 
 void Database::escape_string(std::string& str)
@@ -224,12 +313,70 @@ SqlConnection* Database::getQueryConnection()
     return m_pQueryConnections[nCount % m_nQueryConnPoolSize];
 }
 
+SqlConnection* Database::getReplicaConnection()
+{
+    long nCount = ++m_nReplicaCounter;
+    if (nCount < 0)
+        m_nReplicaCounter = nCount = 0;
+
+    return m_pReplicaConnections[nCount % m_pReplicaConnections.size()];
+}
+
+bool Database::QueryReplica(const char* sql, QueryResult*& result)
+{
+    if (m_pReplicaConnections.empty())
+        return false;
+
+    uint32 failTime = uint32(m_replicaFailTime.value());
+    if (failTime && WorldTimer::getMSTimeDiff(failTime, WorldTimer::getMSTime()) < REPLICA_RETRY_DELAY)
+        return false;
+
+    SqlConnection::Lock guard(getReplicaConnection());
+    result = guard->Query(sql);
+
+    if (!guard->QueryFailed())
+    {
+        if (failTime)
+        {
+            m_replicaFailTime = 0;
+            sLog.outString("Replica answers again, read-only queries use it");
+        }
+
+        return true;
+    }
+
+    delete result;
+    result = NULL;
+
+    if (!failTime)
+        sLog.outError("Replica query failed, read-only queries use the primary database until the replica answers again");
+
+    m_replicaFailTime = long(WorldTimer::getMSTime() | 1); // never 0
+    return false;
+}
+
+QueryResult* Database::QueryRead(SqlReadClass readClass, const char* sql)
+{
+    QueryResult* result;
+    if (IsReplicaRead(readClass) && QueryReplica(sql, result))
+        return result;
+
+    return Query(sql);
+}
+
 void Database::Ping()
 {
     const char* sql = "SELECT 1";
 
+    for (size_t i = 0; i < m_pReplicaConnections.size(); ++i)
+    {
+        SqlConnection::Lock guard(m_pReplicaConnections[i]);
+        delete guard->Query(sql);
+    }
+
+    for (size_t i = 0; i < m_pAsyncConns.size(); ++i)
     {
-        SqlConnection::Lock guard(m_pAsyncConn);
+        SqlConnection::Lock guard(m_pAsyncConns[i]);
         delete guard->Query(sql);
     }
 
@@ -303,6 +450,25 @@ QueryResult* Database::PQuery(const char* format, ...)
     return Query(szQuery);
 }
 
+QueryResult* Database::PQueryRead(SqlReadClass readClass, const char* format, ...)
+{
+    if (!format) return NULL;
+
+    va_list ap;
+    char szQuery [MAX_QUERY_LEN];
+    va_start(ap, format);
+    int res = vsnprintf(szQuery, MAX_QUERY_LEN, format, ap);
+    va_end(ap);
+
+    if (res == -1)
+    {
+        sLog.outError("SQL Query truncated (and not execute) for format: %s", format);
+        return NULL;
+    }
+
+    return QueryRead(readClass, szQuery);
+}
+
 QueryNamedResult* Database::PQueryNamed(const char* format, ...)
 {
     if (!format) return NULL;
@@ -340,7 +506,7 @@ bool Database::Execute(const char* sql)
             return DirectExecute(sql);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPlainRequest(sql));
+        Delay(new SqlPlainRequest(sql));
     }
 
     return true;
@@ -386,14 +552,14 @@ bool Database::DirectPExecute(const char* format, ...)
     return DirectExecute(szQuery);
 }
 
-bool Database::BeginTransaction()
+bool Database::BeginTransaction(uint64 ownerKey /*= 0*/, uint64 secondOwnerKey /*= 0*/)
 {
     if (!m_pAsyncConn)
         return false;
 
     // initiate transaction on current thread
     // currently we do not support queued transactions
-    m_TransStorage->init();
+    m_TransStorage->init(ownerKey, secondOwnerKey);
     return true;
 }
 
@@ -411,10 +577,23 @@ bool Database::CommitTransaction()
         return CommitTransactionDirect();
 
     // add SqlTransaction to the async queue
-    m_threadBody->Delay(m_TransStorage->detach());
+    SqlTransaction* pTrans = m_TransStorage->detach();
+    Delay(pTrans, pTrans->GetOwnerKey(), pTrans->GetSecondOwnerKey());
     return true;
 }
 
+uint32 Database::GetTransactionSize()
+{
+    SqlTransaction* pTrans = m_TransStorage->get();
+    return pTrans ? pTrans->GetSize() : 0;
+}
+
+uint32 Database::GetTransactionDataSize()
+{
+    SqlTransaction* pTrans = m_TransStorage->get();
+    return pTrans ? pTrans->GetDataSize() : 0;
+}
+
 bool Database::CommitTransactionDirect()
 {
     if (!m_pAsyncConn)
@@ -426,12 +605,30 @@ bool Database::CommitTransactionDirect()
 
     // directly execute SqlTransaction
     SqlTransaction* pTrans = m_TransStorage->detach();
-    pTrans->Execute(m_pAsyncConn);
+    if (!pTrans->Execute(m_pAsyncConn))
+        AddFailedTransaction(pTrans->GetOwnerKey(), pTrans->GetSecondOwnerKey());
     delete pTrans;
 
     return true;
 }
 
+void Database::AddFailedTransaction(uint64 ownerKey, uint64 secondOwnerKey)
+{
+    if (!ownerKey)
+        return;
+
+    ACE_Guard<ACE_Thread_Mutex> guard(m_failedOwnersLock);
+    m_failedOwners.insert(ownerKey);
+    if (secondOwnerKey)
+        m_failedOwners.insert(secondOwnerKey);
+}
+
+bool Database::TakeFailedTransaction(uint64 ownerKey)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_failedOwnersLock);
+    return m_failedOwners.erase(ownerKey) != 0;
+}
+
 bool Database::RollbackTransaction()
 {
     if (!m_pAsyncConn)
@@ -552,7 +749,7 @@ bool Database::ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params)
             return DirectExecuteStmt(id, params);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPreparedRequest(id.ID(), params));
+        Delay(new SqlPreparedRequest(id.ID(), params));
     }
 
     return true;
@@ -618,10 +815,10 @@ Database::TransHelper::~TransHelper()
     reset();
 }
 
-SqlTransaction* Database::TransHelper::init()
+SqlTransaction* Database::TransHelper::init(uint64 ownerKey, uint64 secondOwnerKey)
 {
     MANGOS_ASSERT(!m_pTrans);   // if we will get a nested transaction request - we MUST fix code!!!
-    m_pTrans = new SqlTransaction;
+    m_pTrans = new SqlTransaction(ownerKey, secondOwnerKey);
     return m_pTrans;
 }
 
@@ -37,6 +37,33 @@ class Database;
 
 #define MAX_QUERY_LEN   (32*1024)
 
+// read-only query classes that can be sent to the replica connections of a database (see mangosd.conf "...DatabaseReplicaClasses")
+enum SqlReadClass
+{
+    SQL_READ_PRIMARY        = 0x00,                         // never sent to the replica
+    SQL_READ_CHAR_ENUM      = 0x01,                         // character list of the login screen
+    SQL_READ_GM_LOOKUP      = 0x02,                         // .lookup account/player commands
+    SQL_READ_PLAYER_DUMP    = 0x04,                         // .pdump write
+    SQL_READ_AHBOT          = 0x08,                         // AH bot item lists
+    SQL_READ_REALM_COUNTS   = 0x10,                         // character counts of the realmd realm list
+    SQL_READ_ALL            = 0x1F,
+    // the character list is read right after a create, delete or rename, a lagging replica would show the old list
+    SQL_READ_DEFAULT        = SQL_READ_ALL & ~SQL_READ_CHAR_ENUM
+};
+
+// owner key namespaces of the async transactions of entities without object guid,
+// kept apart from the raw object guids used as owner keys of players
+enum SqlOwnerKeyType
+{
+    SQL_OWNER_KEY_GUILD     = 0xFFF1,
+    SQL_OWNER_KEY_AUCTION   = 0xFFF2
+};
+
+inline uint64 MakeSqlOwnerKey(SqlOwnerKeyType type, uint32 id)
+{
+    return (uint64(type) << 48) | id;
+}
+
 //
 class MANGOS_DLL_SPEC SqlConnection
 {
@@ -64,6 +91,11 @@ class MANGOS_DLL_SPEC SqlConnection
         // methods to work with prepared statements
         bool ExecuteStmt(int nIndex, const SqlStmtParameters& id);
 
+        // last Query/QueryNamed failed (an empty result is no failure)
+        bool QueryFailed() const { return m_bQueryFailed; }
+        // last Execute/ExecuteStmt/CommitTransaction failed by a deadlock or lock wait timeout, the transaction can be run again
+        bool LockConflict() const { return m_bLockConflict; }
+
         // SqlConnection object lock
         class Lock
         {
@@ -81,13 +113,15 @@ class MANGOS_DLL_SPEC SqlConnection
         Database& DB() { return m_db; }
 
     protected:
-        SqlConnection(Database& db) : m_db(db) {}
+        SqlConnection(Database& db) : m_db(db), m_bQueryFailed(false), m_bLockConflict(false) {}
 
         virtual SqlPreparedStatement* CreateStatement(const std::string& fmt);
         // allocate prepared statement and return statement ID
         SqlPreparedStatement* GetStmt(uint32 nIndex);
 
         Database& m_db;
+        bool m_bQueryFailed;
+        bool m_bLockConflict;
 
         // free prepared statements objects
         void FreePreparedStatements();
@@ -105,10 +139,12 @@ class MANGOS_DLL_SPEC Database
     public:
         virtual ~Database();
 
-        virtual bool Initialize(const char* infoString, int nConns = 1);
-        // start worker thread for async DB request execution
+        virtual bool Initialize(const char* infoString, int nConns = 1, int nAsyncConns = 1);
+        // optional connections to a read-only replica, used by the read classes in the readClasses mask
+        bool InitializeReplica(const char* infoString, int nConns, uint32 readClasses);
+        // start worker threads for async DB request execution
         virtual void InitDelayThread();
-        // stop worker thread
+        // stop worker threads
         virtual void HaltDelayThread();
 
         /// Synchronous DB queries
@@ -127,6 +163,10 @@ class MANGOS_DLL_SPEC Database
         QueryResult* PQuery(const char* format, ...) ATTR_PRINTF(2, 3);
         QueryNamedResult* PQueryNamed(const char* format, ...) ATTR_PRINTF(2, 3);
 
+        /// Read-only queries, sent to the replica if it is configured for the class and available, else to the primary
+        QueryResult* QueryRead(SqlReadClass readClass, const char* sql);
+        QueryResult* PQueryRead(SqlReadClass readClass, const char* format, ...) ATTR_PRINTF(3, 4);
+
         inline bool DirectExecute(const char* sql)
         {
             if (!m_pAsyncConn)
@@ -163,6 +203,9 @@ class MANGOS_DLL_SPEC Database
         bool AsyncPQuery(Class* object, void (Class::*method)(QueryResult*, ParamType1), ParamType1 param1, const char* format, ...) ATTR_PRINTF(5, 6);
         template<class Class, typename ParamType1, typename ParamType2>
         bool AsyncPQuery(Class* object, void (Class::*method)(QueryResult*, ParamType1, ParamType2), ParamType1 param1, ParamType2 param2, const char* format, ...) ATTR_PRINTF(6, 7);
+        // PQuery / member, read-only query class (see QueryRead)
+        template<class Class, typename ParamType1>
+        bool AsyncPQueryRead(SqlReadClass readClass, Class* object, void (Class::*method)(QueryResult*, ParamType1), ParamType1 param1, const char* format, ...) ATTR_PRINTF(6, 7);
         template<class Class, typename ParamType1, typename ParamType2, typename ParamType3>
         bool AsyncPQuery(Class* object, void (Class::*method)(QueryResult*, ParamType1, ParamType2, ParamType3), ParamType1 param1, ParamType2 param2, ParamType3 param3, const char* format, ...) ATTR_PRINTF(7, 8);
         // PQuery / static
@@ -184,11 +227,23 @@ class MANGOS_DLL_SPEC Database
         // Writes SQL commands to a LOG file (see mangosd.conf "LogSQL")
         bool PExecuteLog(const char* format, ...) ATTR_PRINTF(2, 3);
 
-        bool BeginTransaction();
+        // transactions with the same owner key (e.g. player guid) are executed in order,
+        // transactions of different owners may be executed in parallel, 0 keeps the global order
+        // a transaction writing the data of two owners (trade, mail) is ordered with both of them
+        bool BeginTransaction(uint64 ownerKey = 0, uint64 secondOwnerKey = 0);
         bool CommitTransaction();
         bool RollbackTransaction();
+        // number of requests in the pending transaction of this thread
+        uint32 GetTransactionSize();
+        // approximate data size of the pending transaction of this thread
+        uint32 GetTransactionDataSize();
         // for sync transaction execution
         bool CommitTransactionDirect();
+        // true once after a transaction of the owner key failed, owners writing only the changes
+        // since their last save have to write everything again
+        bool TakeFailedTransaction(uint64 ownerKey);
+        // called by the executing thread for keyed transactions that were rolled back
+        void AddFailedTransaction(uint64 ownerKey, uint64 secondOwnerKey);
 
         // PREPARED STATEMENT API
 
@@ -208,26 +263,48 @@ class MANGOS_DLL_SPEC Database
         virtual void ThreadEnd();
 
         // set database-wide result queue. also we should use object-bases and not thread-based result queues
-        void ProcessResultQueue();
+        // callbacks are executed for up to maxTime milliseconds (0 - no limit), at least one per call
+        void ProcessResultQueue(uint32 maxTime = 0);
 
         bool CheckRequiredField(char const* table_name, char const* required_name);
         uint32 GetPingIntervall() { return m_pingIntervallms; }
 
+        // fetch query results through the binary protocol (see mangosd.conf "Database.BinaryResults")
+        bool UseBinaryResults() const { return m_binaryResults; }
+        void SetUseBinaryResults(bool binaryResults) { m_binaryResults = binaryResults; }
+
+        // rows sent per request by SqlBatchStatement (see mangosd.conf "Database.InsertBatchRows")
+        uint32 GetInsertBatchRows() const { return m_insertBatchRows; }
+        void SetInsertBatchRows(uint32 rows) { m_insertBatchRows = rows > 1 ? rows : 1; }
+
         // function to ping database connections
         void Ping();
 
+        // queries of the read class go to the replica
+        bool IsReplicaRead(SqlReadClass readClass) const { return (m_replicaReadClasses & readClass) != 0; }
+        // run a read-only query on the replica, returns false (query not done) if it is not available or fails
+        // after a failure the replica is tried again once per minute, the primary is used meanwhile
+        bool QueryReplica(const char* sql, QueryResult*& result);
+
         // set this to allow async transactions
         // you should call it explicitly after your server successfully started up
         // NO ASYNC TRANSACTIONS DURING SERVER STARTUP - ONLY DURING RUNTIME!!!
         void AllowAsyncTransactions() { m_bAllowAsyncTransactions = true; }
 
+        // counters of the async request queue
+        void GetAsyncStats(SqlDelayQueueStats& stats) const;
+        void ResetAsyncStats();
+        int GetAsyncConnectionCount() const { return int(m_pAsyncConns.size()); }
+
     protected:
         Database() :
-            m_nQueryConnPoolSize(1), m_pAsyncConn(NULL), m_pResultQueue(NULL),
-            m_threadBody(NULL), m_delayThread(NULL), m_bAllowAsyncTransactions(false),
-            m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0)
+            m_nQueryConnPoolSize(1), m_pAsyncConn(NULL), m_replicaReadClasses(0), m_pResultQueue(NULL),
+            m_delayQueue(NULL), m_bAllowAsyncTransactions(false),
+            m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0), m_binaryResults(false), m_insertBatchRows(1)
         {
             m_nQueryCounter = -1;
+            m_replicaFailTime = 0;
+            m_nReplicaCounter = 0;
         }
 
         void StopServer();
@@ -235,7 +312,10 @@ class MANGOS_DLL_SPEC Database
         // factory method to create SqlConnection objects
         virtual SqlConnection* CreateConnection() = 0;
         // factory method to create SqlDelayThread objects
-        virtual SqlDelayThread* CreateDelayThread();
+        virtual SqlDelayThread* CreateDelayThread(SqlConnection* conn, bool pingConnections);
+
+        // put async operation to the delay queue
+        void Delay(SqlOperation* op, uint64 ownerKey = 0, uint64 secondOwnerKey = 0);
 
         class MANGOS_DLL_SPEC TransHelper
         {
@@ -244,7 +324,7 @@ class MANGOS_DLL_SPEC Database
                 ~TransHelper();
 
                 // initializes new SqlTransaction object
-                SqlTransaction* init();
+                SqlTransaction* init(uint64 ownerKey, uint64 secondOwnerKey);
                 // gets pointer on current transaction object. Returns NULL if transaction was not initiated
                 SqlTransaction* get() const { return m_pTrans; }
                 // detaches SqlTransaction object allocated by init() function
@@ -266,8 +346,10 @@ class MANGOS_DLL_SPEC Database
 
         // round-robin connection selection
         SqlConnection* getQueryConnection();
-        // for now return one single connection for async requests
+        // connection for direct (sync) requests of the async API
         SqlConnection* getAsyncConnection() const { return m_pAsyncConn; }
+        // round-robin replica connection selection
+        SqlConnection* getReplicaConnection();
 
         friend class SqlStatement;
         // PREPARED STATEMENT API
@@ -283,15 +365,28 @@ class MANGOS_DLL_SPEC Database
         typedef std::vector< SqlConnection* > SqlConnectionContainer;
         SqlConnectionContainer m_pQueryConnections;
 
-        // only one single DB connection for transactions
+        // one DB connection per delay thread, the first one also used for direct transactions
+        SqlConnectionContainer m_pAsyncConns;
         SqlConnection* m_pAsyncConn;
 
+        // read-only replica, used for the read classes in m_replicaReadClasses
+        SqlConnectionContainer m_pReplicaConnections;
+        uint32 m_replicaReadClasses;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_replicaFailTime;   // ms time of the last failure, 0 if working
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_nReplicaCounter;
+
+        typedef std::vector<ACE_Based::Thread*> DelayThreadContainer;
+
         SqlResultQueue*     m_pResultQueue;                 ///< Transaction queues from diff. threads
-        SqlDelayThread*     m_threadBody;                   ///< Pointer to delay sql executer (owned by m_delayThread)
-        ACE_Based::Thread* m_delayThread;                   ///< Pointer to executer thread
+        SqlDelayQueue*      m_delayQueue;                   ///< Async requests, shared by the delay threads
+        DelayThreadContainer m_delayThreads;                ///< Executer threads (own their SqlDelayThread)
 
         bool m_bAllowAsyncTransactions;                     ///< flag which specifies if async transactions are enabled
 
+        typedef std::set<uint64> FailedOwnerSet;
+        ACE_Thread_Mutex m_failedOwnersLock;
+        FailedOwnerSet m_failedOwners;                      ///< owner keys of rolled back transactions, see TakeFailedTransaction
+
         // PREPARED STATEMENT REGISTRY
         typedef ACE_Thread_Mutex LOCK_TYPE;
         typedef ACE_Guard<LOCK_TYPE> LOCK_GUARD;
@@ -308,5 +403,7 @@ class MANGOS_DLL_SPEC Database
         bool m_logSQL;
         std::string m_logsDir;
         uint32 m_pingIntervallms;
+        bool m_binaryResults;
+        uint32 m_insertBatchRows;
 };
 #endif
@@ -25,6 +25,12 @@
 #include "DatabaseEnv.h"
 #include "Timer.h"
 
+#ifdef WIN32
+#include <mysql/mysqld_error.h>
+#else
+#include <mysqld_error.h>
+#endif
+
 size_t DatabaseMysql::db_count = 0;
 
 void DatabaseMysql::ThreadStart()
@@ -176,6 +182,8 @@ bool MySQLConnection::Initialize(const char* infoString)
 
 bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount)
 {
+    m_bQueryFailed = true;
+
     if (!mMysql)
         return 0;
 
@@ -196,6 +204,9 @@ bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD**
     *pRowCount = mysql_affected_rows(mMysql);
     *pFieldCount = mysql_field_count(mMysql);
 
+    // no result set is an error only for statements returning columns
+    m_bQueryFailed = !*pResult && *pFieldCount;
+
     if (!*pResult)
         return false;
 
@@ -209,6 +220,76 @@ bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD**
     return true;
 }
 
+bool MySQLConnection::_QueryBinary(const char* sql, QueryResultMysqlBinary** pResult, MYSQL_FIELD** pFields)
+{
+    *pResult = NULL;
+
+    if (!mMysql)
+    {
+        m_bQueryFailed = true;
+        return true;
+    }
+
+    uint32 _s = WorldTimer::getMSTime();
+
+    MYSQL_STMT* stmt = mysql_stmt_init(mMysql);
+    if (!stmt)
+        return false;
+
+    // statements without result set or not supported by the prepared statement protocol use the text protocol
+    if (mysql_stmt_prepare(stmt, sql, strlen(sql)) || !mysql_stmt_field_count(stmt))
+    {
+        mysql_stmt_close(stmt);
+        return false;
+    }
+
+    MYSQL_RES* metadata = mysql_stmt_result_metadata(stmt);
+    if (!metadata)
+    {
+        mysql_stmt_close(stmt);
+        return false;
+    }
+
+    // let mysql_stmt_store_result fill max_length so the string buffers can be sized once
+    my_bool updateMaxLength = 1;
+    mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
+
+    if (mysql_stmt_execute(stmt) || mysql_stmt_store_result(stmt))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("query ERROR: %s", mysql_stmt_error(stmt));
+        mysql_free_result(metadata);
+        mysql_stmt_close(stmt);
+        m_bQueryFailed = true;
+        return true;
+    }
+
+    m_bQueryFailed = false;
+
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL (binary): %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
+
+    uint64 rowCount = mysql_stmt_num_rows(stmt);
+    if (!rowCount)
+    {
+        mysql_free_result(metadata);
+        mysql_stmt_close(stmt);
+        return true;
+    }
+
+    QueryResultMysqlBinary* result = new QueryResultMysqlBinary(stmt, metadata, rowCount, mysql_num_fields(metadata));
+
+    // the statement was closed with the result, read the rows through the text protocol again
+    if (!result->IsBound())
+    {
+        delete result;
+        return false;
+    }
+
+    *pFields = mysql_fetch_fields(metadata);
+    *pResult = result;
+    return true;
+}
+
 QueryResult* MySQLConnection::Query(const char* sql)
 {
     MYSQL_RES* result = NULL;
@@ -216,6 +297,17 @@ QueryResult* MySQLConnection::Query(const char* sql)
     uint64 rowCount = 0;
     uint32 fieldCount = 0;
 
+    if (m_db.UseBinaryResults())
+    {
+        QueryResultMysqlBinary* binaryResult = NULL;
+        if (_QueryBinary(sql, &binaryResult, &fields))
+        {
+            if (binaryResult)
+                binaryResult->NextRow();
+            return binaryResult;
+        }
+    }
+
     if (!_Query(sql, &result, &fields, &rowCount, &fieldCount))
         return NULL;
 
@@ -232,6 +324,23 @@ QueryNamedResult* MySQLConnection::QueryNamed(const char* sql)
     uint64 rowCount = 0;
     uint32 fieldCount = 0;
 
+    if (m_db.UseBinaryResults())
+    {
+        QueryResultMysqlBinary* binaryResult = NULL;
+        if (_QueryBinary(sql, &binaryResult, &fields))
+        {
+            if (!binaryResult)
+                return NULL;
+
+            QueryFieldNames names(binaryResult->GetFieldCount());
+            for (uint32 i = 0; i < binaryResult->GetFieldCount(); ++i)
+                names[i] = fields[i].name;
+
+            binaryResult->NextRow();
+            return new QueryNamedResult(binaryResult, names);
+        }
+    }
+
     if (!_Query(sql, &result, &fields, &rowCount, &fieldCount))
         return NULL;
 
@@ -257,6 +366,7 @@ bool MySQLConnection::Execute(const char* sql)
         {
             sLog.outErrorDb("SQL: %s", sql);
             sLog.outErrorDb("SQL ERROR: %s", mysql_error(mMysql));
+            _SetExecuteError(mysql_errno(mMysql));
             return false;
         }
         else
@@ -266,6 +376,7 @@ bool MySQLConnection::Execute(const char* sql)
         // end guarded block
     }
 
+    _SetExecuteError(0);
     return true;
 }
 
@@ -275,15 +386,23 @@ bool MySQLConnection::_TransactionCmd(const char* sql)
     {
         sLog.outError("SQL: %s", sql);
         sLog.outError("SQL ERROR: %s", mysql_error(mMysql));
+        _SetExecuteError(mysql_errno(mMysql));
         return false;
     }
     else
     {
         DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "SQL: %s", sql);
     }
+    _SetExecuteError(0);
     return true;
 }
 
+void MySQLConnection::_SetExecuteError(unsigned int error)
+{
+    // the transaction was rolled back by InnoDB (deadlock) or is blocked by another one, running it again can succeed
+    m_bLockConflict = error == ER_LOCK_DEADLOCK || error == ER_LOCK_WAIT_TIMEOUT;
+}
+
 bool MySQLConnection::BeginTransaction()
 {
     return _TransactionCmd("START TRANSACTION");
@@ -463,13 +582,17 @@ bool MySqlPreparedStatement::execute()
     if (!isPrepared())
         return false;
 
+    MySQLConnection& conn = static_cast<MySQLConnection&>(m_pConn);
+
     if (mysql_stmt_execute(m_stmt))
     {
         sLog.outError("SQL: cannot execute '%s'", m_szFmt.c_str());
         sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+        conn._SetExecuteError(mysql_stmt_errno(m_stmt));
         return false;
     }
 
+    conn._SetExecuteError(0);
     return true;
 }
 
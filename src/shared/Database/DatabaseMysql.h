@@ -34,6 +34,8 @@
 #include <mysql.h>
 #endif
 
+class QueryResultMysqlBinary;
+
 // MySQL prepared statement class
 class MANGOS_DLL_SPEC MySqlPreparedStatement : public SqlPreparedStatement
 {
@@ -68,6 +70,8 @@ class MANGOS_DLL_SPEC MySqlPreparedStatement : public SqlPreparedStatement
 
 class MANGOS_DLL_SPEC MySQLConnection : public SqlConnection
 {
+        friend class MySqlPreparedStatement;
+
     public:
         MySQLConnection(Database& db) : SqlConnection(db), mMysql(NULL) {}
         ~MySQLConnection();
@@ -91,7 +95,10 @@ class MANGOS_DLL_SPEC MySQLConnection : public SqlConnection
 
     private:
         bool _TransactionCmd(const char* sql);
+        void _SetExecuteError(unsigned int error);
         bool _Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount);
+        // returns false if the query can not be run as prepared statement, the text protocol has to be used then
+        bool _QueryBinary(const char* sql, QueryResultMysqlBinary** pResult, MYSQL_FIELD** pFields);
 
         MYSQL* mMysql;
 };
@@ -99,6 +99,8 @@ bool PostgreSQLConnection::Initialize(const char* infoString)
 
 bool PostgreSQLConnection::_Query(const char* sql, PGresult** pResult, uint64* pRowCount, uint32* pFieldCount)
 {
+    m_bQueryFailed = true;
+
     if (!mPGconn)
         return false;
 
@@ -120,6 +122,8 @@ bool PostgreSQLConnection::_Query(const char* sql, PGresult** pResult, uint64* p
         DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
     }
 
+    m_bQueryFailed = false;
+
     *pRowCount = PQntuples(*pResult);
     *pFieldCount = PQnfields(*pResult);
     // end guarded block
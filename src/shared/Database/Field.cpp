@@ -16,4 +16,27 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
-//#include "DatabaseEnv.h"
+#include "DatabaseEnv.h"
+
+const char* Field::FormatBinary() const
+{
+    if (mText[0])
+        return mText;
+
+    switch (mBinaryType)
+    {
+        case BINARY_INT64:
+            snprintf(mText, sizeof(mText), SI64FMTD, *reinterpret_cast<const int64*>(mValue));
+            break;
+        case BINARY_UINT64:
+            snprintf(mText, sizeof(mText), UI64FMTD, *reinterpret_cast<const uint64*>(mValue));
+            break;
+        case BINARY_DOUBLE:
+            snprintf(mText, sizeof(mText), "%.15g", *reinterpret_cast<const double*>(mValue));
+            break;
+        default:
+            return mValue;
+    }
+
+    return mText;
+}
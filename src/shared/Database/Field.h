@@ -20,6 +20,7 @@
 #define FIELD_H
 
 #include "Common.h"
+#include "Utilities/SmallObjectPool.h"
 
 class Field
 {
@@ -34,30 +35,53 @@ class Field
             DB_TYPE_BOOL    = 0x04
         };
 
-        Field() : mValue(NULL), mType(DB_TYPE_UNKNOWN) {}
-        Field(const char* value, enum DataTypes type) : mValue(value), mType(type) {}
+        // storage of a value fetched through the binary protocol, the text form is built on demand
+        enum BinaryTypes
+        {
+            BINARY_NONE     = 0x00,                         // value is text
+            BINARY_INT64    = 0x01,
+            BINARY_UINT64   = 0x02,
+            BINARY_DOUBLE   = 0x03
+        };
+
+        Field() : mValue(NULL), mType(DB_TYPE_UNKNOWN), mBinaryType(BINARY_NONE) {}
+        Field(const char* value, enum DataTypes type) : mValue(value), mType(type), mBinaryType(BINARY_NONE) {}
 
         ~Field() {}
 
+        // row of a query result
+        static void* operator new[](size_t size) { return MaNGOS::SmallObjectPool::Allocate(size); }
+        static void operator delete[](void* ptr, size_t size) { MaNGOS::SmallObjectPool::Free(ptr, size); }
+
         enum DataTypes GetType() const { return mType; }
         bool IsNULL() const { return mValue == NULL; }
 
-        const char* GetString() const { return mValue; }
+        const char* GetString() const { return mBinaryType == BINARY_NONE || !mValue ? mValue : FormatBinary(); }
         std::string GetCppString() const
         {
-            return mValue ? mValue : "";                    // std::string s = 0 have undefine result in C++
+            const char* value = GetString();
+            return value ? value : "";                      // std::string s = 0 have undefine result in C++
+        }
+        float GetFloat() const { return static_cast<float>(GetDouble()); }
+        bool GetBool() const { return mBinaryType == BINARY_NONE ? (mValue ? atoi(mValue) > 0 : false) : GetBinaryInt64() > 0; }
+        double GetDouble() const
+        {
+            if (mBinaryType == BINARY_NONE)
+                return mValue ? static_cast<double>(atof(mValue)) : 0.0f;
+
+            return GetBinaryDouble();
         }
-        float GetFloat() const { return mValue ? static_cast<float>(atof(mValue)) : 0.0f; }
-        bool GetBool() const { return mValue ? atoi(mValue) > 0 : false; }
-        double GetDouble() const { return mValue ? static_cast<double>(atof(mValue)) : 0.0f; }
-        int8 GetInt8() const { return mValue ? static_cast<int8>(atol(mValue)) : int8(0); }
-        int32 GetInt32() const { return mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
-        uint8 GetUInt8() const { return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
-        uint16 GetUInt16() const { return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
-        int16 GetInt16() const { return mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
-        uint32 GetUInt32() const { return mValue ? static_cast<uint32>(atol(mValue)) : uint32(0); }
+        int8 GetInt8() const { return static_cast<int8>(GetLong()); }
+        int32 GetInt32() const { return static_cast<int32>(GetLong()); }
+        uint8 GetUInt8() const { return static_cast<uint8>(GetLong()); }
+        uint16 GetUInt16() const { return static_cast<uint16>(GetLong()); }
+        int16 GetInt16() const { return static_cast<int16>(GetLong()); }
+        uint32 GetUInt32() const { return static_cast<uint32>(GetLong()); }
         uint64 GetUInt64() const
         {
+            if (mBinaryType != BINARY_NONE)
+                return static_cast<uint64>(GetBinaryInt64());
+
             uint64 value = 0;
             if (!mValue || sscanf(mValue, UI64FMTD, &value) == -1)
                 return 0;
@@ -67,6 +91,9 @@ class Field
 
         uint64 GetInt64() const
         {
+            if (mBinaryType != BINARY_NONE)
+                return static_cast<uint64>(GetBinaryInt64());
+
             int64 value = 0;
             if (!mValue || sscanf(mValue, SI64FMTD, &value) == -1)
                 return 0;
@@ -77,13 +104,60 @@ class Field
         void SetType(enum DataTypes type) { mType = type; }
         // no need for memory allocations to store resultset field strings
         // all we need is to cache pointers returned by different DBMS APIs
-        void SetValue(const char* value) { mValue = value; };
+        void SetValue(const char* value) { mValue = value; mBinaryType = BINARY_NONE; };
+        // value points to a bound 8 byte int64/uint64/double buffer, NULL for a NULL column
+        void SetBinaryValue(const void* value, enum BinaryTypes type)
+        {
+            mValue = static_cast<const char*>(value);
+            mBinaryType = type;
+            mText[0] = '\0';
+        }
 
     private:
         Field(Field const&);
         Field& operator=(Field const&);
 
+        long GetLong() const
+        {
+            if (mBinaryType == BINARY_NONE)
+                return mValue ? atol(mValue) : 0;
+
+            return static_cast<long>(GetBinaryInt64());
+        }
+
+        int64 GetBinaryInt64() const
+        {
+            if (!mValue)
+                return 0;
+
+            switch (mBinaryType)
+            {
+                case BINARY_INT64:  return *reinterpret_cast<const int64*>(mValue);
+                case BINARY_UINT64: return static_cast<int64>(*reinterpret_cast<const uint64*>(mValue));
+                case BINARY_DOUBLE: return static_cast<int64>(*reinterpret_cast<const double*>(mValue));
+                default:            return 0;
+            }
+        }
+
+        double GetBinaryDouble() const
+        {
+            if (!mValue)
+                return 0.0;
+
+            switch (mBinaryType)
+            {
+                case BINARY_INT64:  return static_cast<double>(*reinterpret_cast<const int64*>(mValue));
+                case BINARY_UINT64: return static_cast<double>(*reinterpret_cast<const uint64*>(mValue));
+                case BINARY_DOUBLE: return *reinterpret_cast<const double*>(mValue);
+                default:            return 0.0;
+            }
+        }
+
+        const char* FormatBinary() const;
+
         const char* mValue;
         enum DataTypes mType;
+        enum BinaryTypes mBinaryType;
+        mutable char mText[32];                             // text form of a binary value, built by GetString
 };
 #endif
@@ -22,6 +22,7 @@
 #include "Common.h"
 #include "Errors.h"
 #include "Field.h"
+#include "Utilities/SmallObjectPool.h"
 
 class MANGOS_DLL_SPEC QueryResult
 {
@@ -31,6 +32,10 @@ class MANGOS_DLL_SPEC QueryResult
 
         virtual ~QueryResult() {}
 
+        // results of async queries are created by the delay threads and deleted by the callbacks
+        static void* operator new(size_t size) { return MaNGOS::SmallObjectPool::Allocate(size); }
+        static void operator delete(void* ptr, size_t size) { MaNGOS::SmallObjectPool::Free(ptr, size); }
+
         virtual bool NextRow() = 0;
 
         Field* Fetch() const { return mCurrentRow; }
@@ -69,7 +69,167 @@ void QueryResultMysql::EndQuery()
     }
 }
 
-enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType) const
+QueryResultMysqlBinary::QueryResultMysqlBinary(MYSQL_STMT* stmt, MYSQL_RES* metadata, uint64 rowCount, uint32 fieldCount) :
+    QueryResult(rowCount, fieldCount), mStmt(stmt), mMetadata(metadata)
+{
+    mCurrentRow = new Field[mFieldCount];
+    mBinds = new MYSQL_BIND[mFieldCount];
+    mLengths = new unsigned long[mFieldCount];
+    mNulls = new my_bool[mFieldCount];
+    mBinaryTypes = new Field::BinaryTypes[mFieldCount];
+    memset(mBinds, 0, sizeof(MYSQL_BIND) * mFieldCount);
+
+    MYSQL_FIELD* fields = mysql_fetch_fields(mMetadata);
+
+    // one buffer for the whole row, numeric columns first so they stay 8 byte aligned
+    size_t bufferSize = 0;
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        mBinaryTypes[i] = ConvertBinaryType(fields[i]);
+        if (mBinaryTypes[i] != Field::BINARY_NONE)
+            bufferSize += sizeof(uint64);
+    }
+
+    size_t stringOffset = bufferSize;
+    for (uint32 i = 0; i < mFieldCount; ++i)
+        if (mBinaryTypes[i] == Field::BINARY_NONE)
+            bufferSize += fields[i].max_length + 1;
+
+    mBuffer = new char[bufferSize ? bufferSize : 1];
+
+    size_t numericOffset = 0;
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        MYSQL_BIND& bind = mBinds[i];
+        bind.length = &mLengths[i];
+        bind.is_null = &mNulls[i];
+
+        switch (mBinaryTypes[i])
+        {
+            case Field::BINARY_INT64:
+            case Field::BINARY_UINT64:
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.is_unsigned = mBinaryTypes[i] == Field::BINARY_UINT64;
+                break;
+            case Field::BINARY_DOUBLE:
+                bind.buffer_type = MYSQL_TYPE_DOUBLE;
+                break;
+            default:
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = mBuffer + stringOffset;
+                bind.buffer_length = fields[i].max_length + 1;
+                stringOffset += bind.buffer_length;
+                break;
+        }
+
+        if (mBinaryTypes[i] != Field::BINARY_NONE)
+        {
+            bind.buffer = mBuffer + numericOffset;
+            bind.buffer_length = sizeof(uint64);
+            numericOffset += sizeof(uint64);
+        }
+
+        mCurrentRow[i].SetType(QueryResultMysql::ConvertNativeType(fields[i].type));
+    }
+
+    if (mysql_stmt_bind_result(mStmt, mBinds))
+    {
+        sLog.outErrorDb("SQL ERROR: mysql_stmt_bind_result() failed: %s", mysql_stmt_error(mStmt));
+        EndQuery();
+    }
+}
+
+QueryResultMysqlBinary::~QueryResultMysqlBinary()
+{
+    EndQuery();
+}
+
+bool QueryResultMysqlBinary::NextRow()
+{
+    if (!mStmt)
+        return false;
+
+    int res = mysql_stmt_fetch(mStmt);
+    if (res == 1 || res == MYSQL_NO_DATA)
+    {
+        EndQuery();
+        return false;
+    }
+
+    // the buffers are sized from max_length, MYSQL_DATA_TRUNCATED can only be reported for
+    // columns whose bound type is narrower than the server type and is not an error here
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        MYSQL_BIND const& bind = mBinds[i];
+
+        if (mNulls[i])
+        {
+            mCurrentRow[i].SetValue(NULL);
+            continue;
+        }
+
+        if (mBinaryTypes[i] != Field::BINARY_NONE)
+        {
+            mCurrentRow[i].SetBinaryValue(bind.buffer, mBinaryTypes[i]);
+            continue;
+        }
+
+        char* value = static_cast<char*>(bind.buffer);
+        value[mLengths[i] < bind.buffer_length ? mLengths[i] : bind.buffer_length - 1] = '\0';
+        mCurrentRow[i].SetValue(value);
+    }
+
+    return true;
+}
+
+void QueryResultMysqlBinary::EndQuery()
+{
+    delete[] mCurrentRow;
+    mCurrentRow = 0;
+
+    delete[] mBinds;
+    mBinds = 0;
+    delete[] mBuffer;
+    mBuffer = 0;
+    delete[] mLengths;
+    mLengths = 0;
+    delete[] mNulls;
+    mNulls = 0;
+    delete[] mBinaryTypes;
+    mBinaryTypes = 0;
+
+    if (mMetadata)
+    {
+        mysql_free_result(mMetadata);
+        mMetadata = 0;
+    }
+
+    if (mStmt)
+    {
+        mysql_stmt_close(mStmt);
+        mStmt = 0;
+    }
+}
+
+enum Field::BinaryTypes QueryResultMysqlBinary::ConvertBinaryType(MYSQL_FIELD const& field)
+{
+    switch (field.type)
+    {
+        case FIELD_TYPE_TINY:
+        case FIELD_TYPE_SHORT:
+        case FIELD_TYPE_LONG:
+        case FIELD_TYPE_INT24:
+        case FIELD_TYPE_LONGLONG:
+            return (field.flags & UNSIGNED_FLAG) ? Field::BINARY_UINT64 : Field::BINARY_INT64;
+        case FIELD_TYPE_FLOAT:
+        case FIELD_TYPE_DOUBLE:
+            return Field::BINARY_DOUBLE;
+        default:                                            // decimals, dates and enums come as text
+            return Field::BINARY_NONE;
+    }
+}
+
+enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType)
 {
     switch (mysqlType)
     {
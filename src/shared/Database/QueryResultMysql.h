@@ -39,11 +39,45 @@ class QueryResultMysql : public QueryResult
 
         bool NextRow() override;
 
+        static enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType);
+
     private:
-        enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType) const;
         void EndQuery();
 
         MYSQL_RES* mResult;
 };
+
+/**
+ * Result set fetched through the binary protocol of a prepared statement.
+ *
+ * Integer and floating point columns are bound as 8 byte values and read by Field without
+ * text parsing, other columns are bound as strings. All columns of a row share one buffer
+ * sized from the column max lengths reported by mysql_stmt_store_result.
+ */
+class QueryResultMysqlBinary : public QueryResult
+{
+    public:
+        QueryResultMysqlBinary(MYSQL_STMT* stmt, MYSQL_RES* metadata, uint64 rowCount, uint32 fieldCount);
+
+        ~QueryResultMysqlBinary();
+
+        bool NextRow() override;
+
+        /// false if the row buffers could not be bound to the statement, the result is unusable then
+        bool IsBound() const { return mStmt != NULL; }
+
+        static enum Field::BinaryTypes ConvertBinaryType(MYSQL_FIELD const& field);
+
+    private:
+        void EndQuery();
+
+        MYSQL_STMT* mStmt;
+        MYSQL_RES* mMetadata;
+        MYSQL_BIND* mBinds;
+        char* mBuffer;                                      // column values of the current row
+        unsigned long* mLengths;
+        my_bool* mNulls;
+        Field::BinaryTypes* mBinaryTypes;
+};
 #endif
 #endif
@@ -18,6 +18,115 @@
 
 #include "SQLStorage.h"
 
+// -----------------------------------  SQLStorageArena  --------------------------------------- //
+
+#define ARENA_RECORD_ALIGN  64                              // cache line
+#define ARENA_CHUNK_SIZE    (64 * 1024)
+
+SQLStorageArena::SQLStorageArena() :
+    m_recordBlock(NULL),
+    m_chunkPos(NULL),
+    m_chunkLeft(0),
+    m_recordBytes(0),
+    m_dataBytes(0),
+    m_chunkBytes(0),
+    m_strings(0),
+    m_internedStrings(0),
+    m_internedBytes(0)
+{}
+
+char* SQLStorageArena::AllocateRecords(size_t size)
+{
+    delete[] m_recordBlock;
+
+    m_recordBlock = new char[size + ARENA_RECORD_ALIGN - 1];
+    m_recordBytes = size;
+
+    char* records = (char*)((size_t(m_recordBlock) + ARENA_RECORD_ALIGN - 1) & ~size_t(ARENA_RECORD_ALIGN - 1));
+    memset(records, 0, size);
+    return records;
+}
+
+void* SQLStorageArena::Allocate(size_t size)
+{
+    // keep the blocks pointer aligned, strings are allocated byte aligned in InternString
+    size_t padding = size_t(m_chunkPos) % sizeof(void*) ? sizeof(void*) - size_t(m_chunkPos) % sizeof(void*) : 0;
+    if (m_chunkLeft < padding + size)
+    {
+        // big values get a chunk of their own, the current chunk stays in use
+        if (size > ARENA_CHUNK_SIZE / 4)
+        {
+            char* chunk = new char[size];
+            m_chunks.push_back(chunk);
+            m_chunkBytes += size;
+            m_dataBytes += size;
+            return chunk;
+        }
+
+        m_chunkPos = new char[ARENA_CHUNK_SIZE];
+        m_chunkLeft = ARENA_CHUNK_SIZE;
+        m_chunks.push_back(m_chunkPos);
+        m_chunkBytes += ARENA_CHUNK_SIZE;
+        padding = 0;
+    }
+
+    char* data = m_chunkPos + padding;
+    m_chunkPos += padding + size;
+    m_chunkLeft -= padding + size;
+    m_dataBytes += size;
+    return data;
+}
+
+char* SQLStorageArena::InternString(char const* str)
+{
+    std::set<char const*, StringLess>::const_iterator itr = m_interned.find(str);
+    size_t size = strlen(str) + 1;
+
+    if (itr != m_interned.end())
+    {
+        ++m_internedStrings;
+        m_internedBytes += size;
+        return const_cast<char*>(*itr);
+    }
+
+    char* copy;
+    if (m_chunkLeft >= size)
+    {
+        copy = m_chunkPos;
+        m_chunkPos += size;
+        m_chunkLeft -= size;
+        m_dataBytes += size;
+    }
+    else
+        copy = (char*)Allocate(size);
+
+    memcpy(copy, str, size);
+    m_interned.insert(copy);
+    ++m_strings;
+    return copy;
+}
+
+void SQLStorageArena::Free()
+{
+    delete[] m_recordBlock;
+    m_recordBlock = NULL;
+
+    for (std::vector<char*>::const_iterator itr = m_chunks.begin(); itr != m_chunks.end(); ++itr)
+        delete[] *itr;
+    m_chunks.clear();
+
+    m_chunkPos = NULL;
+    m_chunkLeft = 0;
+    EndInterning();
+
+    m_recordBytes = 0;
+    m_dataBytes = 0;
+    m_chunkBytes = 0;
+    m_strings = 0;
+    m_internedStrings = 0;
+    m_internedBytes = 0;
+}
+
 // -----------------------------------  SQLStorageBase  ---------------------------------------- //
 
 SQLStorageBase::SQLStorageBase() :
@@ -31,7 +140,24 @@ SQLStorageBase::SQLStorageBase() :
     m_maxEntry(0),
     m_recordSize(0),
     m_data(NULL)
-{}
+{
+    GetStorageList().push_back(this);
+}
+
+SQLStorageBase::~SQLStorageBase()
+{
+    Free();
+
+    StorageList& storages = GetStorageList();
+    storages.erase(std::remove(storages.begin(), storages.end(), this), storages.end());
+}
+
+SQLStorageBase::StorageList& SQLStorageBase::GetStorageList()
+{
+    // function static, the storages are global objects of other translation units
+    static StorageList storages;
+    return storages;
+}
 
 void SQLStorageBase::Initialize(const char* tableName, const char* entry_field, const char* src_format, const char* dst_format)
 {
@@ -58,61 +184,20 @@ void SQLStorageBase::prepareToLoad(uint32 maxEntry, uint32 recordCount, uint32 r
     m_maxEntry = maxEntry;
     m_recordSize = recordSize;
 
-    delete[] m_data;
-    m_data = new char[recordCount * m_recordSize];
-    memset(m_data, 0, recordCount * m_recordSize);
+    // strings of old records are released with them
+    m_arena.Free();
+    m_data = m_arena.AllocateRecords(recordCount * m_recordSize);
 
     m_recordCount = 0;
 }
 
-// Function to delete the data
+// Function to delete the data, strings and other data of the records are owned by the arena
 void SQLStorageBase::Free()
 {
     if (!m_data)
         return;
 
-    uint32 offset = 0;
-    for (uint32 x = 0; x < m_dstFieldCount; ++x)
-    {
-        switch (m_dst_format[x])
-        {
-            case FT_LOGIC:
-                offset += sizeof(bool);
-                break;
-            case FT_STRING:
-            {
-                for (uint32 recordItr = 0; recordItr < m_recordCount; ++recordItr)
-                    delete[] *(char**)((char*)(m_data + (recordItr * m_recordSize)) + offset);
-
-                offset += sizeof(char*);
-                break;
-            }
-            case FT_NA:
-            case FT_INT:
-                offset += sizeof(uint32);
-                break;
-            case FT_BYTE:
-            case FT_NA_BYTE:
-                offset += sizeof(char);
-                break;
-            case FT_FLOAT:
-            case FT_NA_FLOAT:
-                offset += sizeof(float);
-                break;
-            case FT_NA_POINTER:
-                // TODO- possible (and small) memleak here possible
-                offset += sizeof(char*);
-                break;
-            case FT_IND:
-            case FT_SORT:
-                assert(false && "SQL storage not have sort field types");
-                break;
-            default:
-                assert(false && "unknown format character");
-                break;
-        }
-    }
-    delete[] m_data;
+    m_arena.Free();
     m_data = NULL;
     m_recordCount = 0;
 }
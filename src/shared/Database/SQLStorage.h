@@ -22,12 +22,67 @@
 #include "Common.h"
 #include "Database/DatabaseEnv.h"
 #include "DBCFileLoader.h"
+#include "SQLStorageSnapshot.h"
+
+/**
+ * Memory of a storage: one cache line aligned block for the records and chunks for the strings
+ * and other data referenced by the records. While a table is loaded equal strings are stored once.
+ * Everything is released at once by Free, records never free their strings themselves.
+ */
+class SQLStorageArena
+{
+    public:
+        SQLStorageArena();
+        ~SQLStorageArena() { Free(); }
+
+        /// Zero filled block for the records, replaces the previous records block
+        char* AllocateRecords(size_t size);
+        /// Copy of str, the same pointer is returned for equal strings until EndInterning
+        char* InternString(char const* str);
+        /// Uninitialized data block, pointer aligned
+        void* Allocate(size_t size);
+
+        /// Drop the lookup of interned strings, called when the table is loaded
+        void EndInterning() { std::set<char const*, StringLess>().swap(m_interned); }
+        void Free();
+
+        size_t GetRecordBytes() const { return m_recordBytes; }
+        size_t GetDataBytes() const { return m_dataBytes; }     ///< strings and other data in use
+        size_t GetChunkBytes() const { return m_chunkBytes; }   ///< allocated for strings and other data
+        uint32 GetStringCount() const { return m_strings; }
+        uint32 GetInternedCount() const { return m_internedStrings; }
+        size_t GetInternedBytes() const { return m_internedBytes; } ///< saved by interning
+
+    private:
+        struct StringLess
+        {
+            bool operator()(char const* a, char const* b) const { return strcmp(a, b) < 0; }
+        };
+
+        char* m_recordBlock;                                // unaligned allocation of the records
+        std::vector<char*> m_chunks;
+        char* m_chunkPos;
+        size_t m_chunkLeft;
+        std::set<char const*, StringLess> m_interned;
+
+        size_t m_recordBytes;
+        size_t m_dataBytes;
+        size_t m_chunkBytes;
+        uint32 m_strings;
+        uint32 m_internedStrings;
+        size_t m_internedBytes;
+};
 
 class SQLStorageBase
 {
     template<class DerivedLoader, class StorageClass> friend class SQLStorageLoaderBase;
 
     public:
+        typedef std::vector<SQLStorageBase const*> StorageList;
+
+        /// All storages, for memory reports
+        static StorageList const& GetStorages() { return GetStorageList(); }
+
         char const* GetTableName() const { return m_tableName; }
         char const* EntryFieldName() const { return m_entry_field; }
 
@@ -39,6 +94,12 @@ class SQLStorageBase
         uint32 GetMaxEntry() const { return m_maxEntry; };
         uint32 GetRecordCount() const { return m_recordCount; };
 
+        /// Memory owned by the records, released with them (e.g. for data converted from a loaded string)
+        void* AllocateData(size_t size) { return m_arena.Allocate(size); }
+        SQLStorageArena const& GetArena() const { return m_arena; }
+        /// Memory of the lookup structure (index array or map)
+        virtual size_t GetIndexBytes() const = 0;
+
         template<typename T>
         class SQLSIterator
         {
@@ -66,7 +127,7 @@ class SQLStorageBase
 
     protected:
         SQLStorageBase();
-        virtual ~SQLStorageBase() { Free(); }
+        virtual ~SQLStorageBase();
 
         void Initialize(const char* tableName, const char* entry_field, const char* src_format, const char* dst_format);
 
@@ -79,6 +140,8 @@ class SQLStorageBase
         virtual void Free();
 
     private:
+        static StorageList& GetStorageList();
+
         char* createRecord(uint32 recordId);
 
         // Information about the table
@@ -96,6 +159,7 @@ class SQLStorageBase
 
         // Data Storage
         char* m_data;
+        SQLStorageArena m_arena;
 };
 
 class SQLStorage : public SQLStorageBase
@@ -121,6 +185,8 @@ class SQLStorage : public SQLStorageBase
 
         void EraseEntry(uint32 id);
 
+        size_t GetIndexBytes() const override { return m_Index ? GetMaxEntry() * sizeof(char*) : 0; }
+
     protected:
         void prepareToLoad(uint32 maxRecordId, uint32 recordCount, uint32 recordSize) override;
         void JustCreatedRecord(uint32 recordId, char* record) override
@@ -158,6 +224,9 @@ class SQLHashStorage : public SQLStorageBase
 
         void EraseEntry(uint32 id);
 
+        // approximation, a node per record and a bucket pointer
+        size_t GetIndexBytes() const override { return m_indexMap.size() * (sizeof(RecordMap::value_type) + 3 * sizeof(void*)); }
+
     protected:
         void prepareToLoad(uint32 maxRecordId, uint32 recordCount, uint32 recordSize) override;
         void JustCreatedRecord(uint32 recordId, char* record) override
@@ -231,6 +300,9 @@ class SQLMultiStorage : public SQLStorageBase
 
         void EraseEntry(uint32 id);
 
+        // approximation, a tree node per record
+        size_t GetIndexBytes() const override { return m_indexMultiMap.size() * (sizeof(RecordMultiMap::value_type) + 4 * sizeof(void*)); }
+
     protected:
         void prepareToLoad(uint32 maxRecordId, uint32 recordCount, uint32 recordSize) override;
         void JustCreatedRecord(uint32 recordId, char* record) override
@@ -244,10 +316,27 @@ class SQLMultiStorage : public SQLStorageBase
         RecordMultiMap m_indexMultiMap;
 };
 
+/// Source row of a storage record read from the database
+class SQLStorageQueryRow
+{
+    public:
+        explicit SQLStorageQueryRow(Field const* fields) : m_fields(fields) {}
+
+        uint32 GetUInt32(uint32 column) const { return m_fields[column].GetUInt32(); }
+        uint8 GetUInt8(uint32 column) const { return m_fields[column].GetUInt8(); }
+        float GetFloat(uint32 column) const { return m_fields[column].GetFloat(); }
+        char const* GetString(uint32 column) const { return m_fields[column].GetString(); }
+
+    private:
+        Field const* m_fields;
+};
+
 template <class DerivedLoader, class StorageClass>
 class SQLStorageLoaderBase
 {
     public:
+        SQLStorageLoaderBase() : m_arena(NULL) {}
+
         void Load(StorageClass& storage, bool error_at_empty = true);
 
         template<class S, class D>
@@ -267,12 +356,20 @@ class SQLStorageLoaderBase
         void convert_str_to_str(uint32 field_pos, char* src, char*& dst);
 
     private:
+        // Row is SQLStorageQueryRow or SQLStorageSnapshot
+        template<class Row>
+        void storeRecord(StorageClass& store, Row const& row);
+
         template<class V>
         void storeValue(V value, StorageClass& store, char* record, uint32 field_pos, uint32& offset);
         void storeValue(char const* value, StorageClass& store, char* record, uint32 field_pos, uint32& offset);
 
         // trap, no body
         void storeValue(char* value, StorageClass& store, char* record, uint32 field_pos, uint32& offset);
+
+    protected:
+        // strings of the loaded table, set by Load
+        SQLStorageArena* m_arena;
 };
 
 class SQLStorageLoader : public SQLStorageLoaderBase<SQLStorageLoader, SQLStorage>
@@ -33,25 +33,14 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::convert(uint32 /*field_p
 template<class DerivedLoader, class StorageClass>
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::convert_str_to_str(uint32 /*field_pos*/, char const* src, char*& dst)
 {
-    if (!src)
-    {
-        dst = new char[1];
-        *dst = 0;
-    }
-    else
-    {
-        uint32 l = strlen(src) + 1;
-        dst = new char[l];
-        memcpy(dst, src, l);
-    }
+    dst = m_arena->InternString(src ? src : "");
 }
 
 template<class DerivedLoader, class StorageClass>
 template<class S>                                           // S source-type
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::convert_to_str(uint32 /*field_pos*/, S /*src*/, char*& dst)
 {
-    dst = new char[1];
-    *dst = 0;
+    dst = m_arena->InternString("");
 }
 
 template<class DerivedLoader, class StorageClass>
@@ -71,8 +60,7 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::default_fill(uint32 /*fi
 template<class DerivedLoader, class StorageClass>
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::default_fill_to_str(uint32 /*field_pos*/, char const* /*src*/, char*& dst)
 {
-    dst = new char[1];
-    *dst = 0;
+    dst = m_arena->InternString("");
 }
 
 template<class DerivedLoader, class StorageClass>
@@ -164,9 +152,116 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::storeValue(char const* v
     }
 }
 
+template<class DerivedLoader, class StorageClass>
+template<class Row>
+void SQLStorageLoaderBase<DerivedLoader, StorageClass>::storeRecord(StorageClass& store, Row const& row)
+{
+    char* record = store.createRecord(row.GetUInt32(0));
+    uint32 offset = 0;
+
+    // dependend on dest-size
+    // iterate two indexes: x over dest, y over source
+    //                      y++ If and only If x != FT_NA*
+    //                      x++ If and only If a value is stored
+    for (uint32 x = 0, y = 0; x < store.GetDstFieldCount();)
+    {
+        switch (store.GetDstFormat(x))
+        {
+                // For default fill continue and do not increase y
+            case FT_NA:         storeValue((uint32)0, store, record, x, offset);         ++x; continue;
+            case FT_NA_BYTE:    storeValue((char)0, store, record, x, offset);           ++x; continue;
+            case FT_NA_FLOAT:   storeValue((float)0.0f, store, record, x, offset);       ++x; continue;
+            case FT_NA_POINTER: storeValue((char const*)NULL, store, record, x, offset); ++x; continue;
+            default:
+                break;
+        }
+
+        // It is required that the input has at least as many columns set as the output requires
+        if (y >= store.GetSrcFieldCount())
+            assert(false && "SQL storage has too few columns!");
+
+        switch (store.GetSrcFormat(y))
+        {
+            case FT_LOGIC:  storeValue((bool)(row.GetUInt32(y) > 0), store, record, x, offset);  ++x; break;
+            case FT_BYTE:   storeValue((char)row.GetUInt8(y), store, record, x, offset);         ++x; break;
+            case FT_INT:    storeValue((uint32)row.GetUInt32(y), store, record, x, offset);      ++x; break;
+            case FT_FLOAT:  storeValue((float)row.GetFloat(y), store, record, x, offset);        ++x; break;
+            case FT_STRING: storeValue((char const*)row.GetString(y), store, record, x, offset); ++x; break;
+            case FT_NA:
+            case FT_NA_BYTE:
+            case FT_NA_FLOAT:
+                // Do Not increase x
+                break;
+            case FT_IND:
+            case FT_SORT:
+            case FT_NA_POINTER:
+                assert(false && "SQL storage not have sort or pointer field types");
+                break;
+            default:
+                assert(false && "unknown format character");
+        }
+        ++y;
+    }
+}
+
 template<class DerivedLoader, class StorageClass>
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store, bool error_at_empty /*= true*/)
 {
+    // get struct size
+    uint32 recordsize = 0;
+    for (uint32 x = 0; x < store.GetDstFieldCount(); ++x)
+    {
+        switch (store.GetDstFormat(x))
+        {
+            case FT_LOGIC:
+                recordsize += sizeof(bool);   break;
+            case FT_BYTE:
+                recordsize += sizeof(char);   break;
+            case FT_INT:
+                recordsize += sizeof(uint32); break;
+            case FT_FLOAT:
+                recordsize += sizeof(float);  break;
+            case FT_STRING:
+                recordsize += sizeof(char*);  break;
+            case FT_NA:
+                recordsize += sizeof(uint32); break;
+            case FT_NA_BYTE:
+                recordsize += sizeof(char);   break;
+            case FT_NA_FLOAT:
+                recordsize += sizeof(float);  break;
+            case FT_NA_POINTER:
+                recordsize += sizeof(char*);  break;
+            case FT_IND:
+            case FT_SORT:
+                assert(false && "SQL storage not have sort field types");
+                break;
+            default:
+                assert(false && "unknown format character");
+                break;
+        }
+    }
+
+    m_arena = &store.m_arena;
+
+    // Use the snapshot of the table if its content did not change since it was written
+    SQLStorageSnapshot snapshot(store.GetTableName(), store.GetSrcFormat());
+    if (snapshot.Open())
+    {
+        store.prepareToLoad(snapshot.GetMaxRecordId(), snapshot.GetRecordCount(), recordsize);
+
+        BarGoLink bar(snapshot.GetRecordCount());
+        while (snapshot.NextRow())
+        {
+            bar.step();
+            storeRecord(store, snapshot);
+        }
+
+        store.m_arena.EndInterning();
+
+        sLog.outDetail("Table `%s` loaded from snapshot", store.GetTableName());
+        return;
+    }
+
     Field* fields = NULL;
     QueryResult* result  = WorldDatabase.PQuery("SELECT MAX(%s) FROM %s", store.EntryFieldName(), store.GetTableName());
     if (!result)
@@ -178,7 +273,6 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
 
     uint32 maxRecordId = (*result)[0].GetUInt32() + 1;
     uint32 recordCount = 0;
-    uint32 recordsize = 0;
     delete result;
 
     result = WorldDatabase.PQuery("SELECT COUNT(*) FROM %s", store.GetTableName());
@@ -211,42 +305,9 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         exit(1);                                            // Stop server at loading broken or non-compatible table.
     }
 
-    // get struct size
-    uint32 offset = 0;
-    for (uint32 x = 0; x < store.GetDstFieldCount(); ++x)
-    {
-        switch (store.GetDstFormat(x))
-        {
-            case FT_LOGIC:
-                recordsize += sizeof(bool);   break;
-            case FT_BYTE:
-                recordsize += sizeof(char);   break;
-            case FT_INT:
-                recordsize += sizeof(uint32); break;
-            case FT_FLOAT:
-                recordsize += sizeof(float);  break;
-            case FT_STRING:
-                recordsize += sizeof(char*);  break;
-            case FT_NA:
-                recordsize += sizeof(uint32); break;
-            case FT_NA_BYTE:
-                recordsize += sizeof(char);   break;
-            case FT_NA_FLOAT:
-                recordsize += sizeof(float);  break;
-            case FT_NA_POINTER:
-                recordsize += sizeof(char*);  break;
-            case FT_IND:
-            case FT_SORT:
-                assert(false && "SQL storage not have sort field types");
-                break;
-            default:
-                assert(false && "unknown format character");
-                break;
-        }
-    }
-
     // Prepare data storage and lookup storage
     store.prepareToLoad(maxRecordId, recordCount, recordsize);
+    snapshot.BeginWrite(maxRecordId);
 
     BarGoLink bar(recordCount);
     do
@@ -254,56 +315,15 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         fields = result->Fetch();
         bar.step();
 
-        char* record = store.createRecord(fields[0].GetUInt32());
-        offset = 0;
-
-        // dependend on dest-size
-        // iterate two indexes: x over dest, y over source
-        //                      y++ If and only If x != FT_NA*
-        //                      x++ If and only If a value is stored
-        for (uint32 x = 0, y = 0; x < store.GetDstFieldCount();)
-        {
-            switch (store.GetDstFormat(x))
-            {
-                    // For default fill continue and do not increase y
-                case FT_NA:         storeValue((uint32)0, store, record, x, offset);         ++x; continue;
-                case FT_NA_BYTE:    storeValue((char)0, store, record, x, offset);           ++x; continue;
-                case FT_NA_FLOAT:   storeValue((float)0.0f, store, record, x, offset);       ++x; continue;
-                case FT_NA_POINTER: storeValue((char const*)NULL, store, record, x, offset); ++x; continue;
-                default:
-                    break;
-            }
-
-            // It is required that the input has at least as many columns set as the output requires
-            if (y >= store.GetSrcFieldCount())
-                assert(false && "SQL storage has too few columns!");
-
-            switch (store.GetSrcFormat(y))
-            {
-                case FT_LOGIC:  storeValue((bool)(fields[y].GetUInt32() > 0), store, record, x, offset);  ++x; break;
-                case FT_BYTE:   storeValue((char)fields[y].GetUInt8(), store, record, x, offset);         ++x; break;
-                case FT_INT:    storeValue((uint32)fields[y].GetUInt32(), store, record, x, offset);      ++x; break;
-                case FT_FLOAT:  storeValue((float)fields[y].GetFloat(), store, record, x, offset);        ++x; break;
-                case FT_STRING: storeValue((char const*)fields[y].GetString(), store, record, x, offset); ++x; break;
-                case FT_NA:
-                case FT_NA_BYTE:
-                case FT_NA_FLOAT:
-                    // Do Not increase x
-                    break;
-                case FT_IND:
-                case FT_SORT:
-                case FT_NA_POINTER:
-                    assert(false && "SQL storage not have sort or pointer field types");
-                    break;
-                default:
-                    assert(false && "unknown format character");
-            }
-            ++y;
-        }
+        storeRecord(store, SQLStorageQueryRow(fields));
+        snapshot.WriteRow(fields);
     }
     while (result->NextRow());
 
     delete result;
+    store.m_arena.EndInterning();
+
+    snapshot.EndWrite();
 }
 
 #endif
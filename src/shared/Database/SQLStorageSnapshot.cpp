@@ -0,0 +1,110 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "SQLStorageSnapshot.h"
+#include "DatabaseEnv.h"
+#include "DBCFileLoader.h"
+
+SQLStorageSnapshot::SQLStorageSnapshot(char const* tableName, char const* srcFormat) :
+    m_file(tableName, srcFormat), m_srcFormat(srcFormat), m_srcFieldCount(strlen(srcFormat)),
+    m_maxRecordId(0), m_readRows(0), m_row(m_srcFieldCount)
+{
+}
+
+bool SQLStorageSnapshot::Open()
+{
+    if (!m_file.Open())
+        return false;
+
+    m_maxRecordId = m_file.ReadUInt32();
+    m_readRows = 0;
+    return !m_file.HasReadError();
+}
+
+bool SQLStorageSnapshot::NextRow()
+{
+    if (m_readRows >= m_file.GetRecordCount())
+        return false;
+
+    for (uint32 y = 0; y < m_srcFieldCount; ++y)
+    {
+        Value& value = m_row[y];
+        value.intValue = 0;
+        value.floatValue = 0.0f;
+        value.stringValue = NULL;
+
+        switch (m_srcFormat[y])
+        {
+            case FT_LOGIC:
+            case FT_INT:
+                value.intValue = m_file.ReadUInt32();
+                break;
+            case FT_BYTE:
+                value.intValue = m_file.ReadUInt8();
+                break;
+            case FT_FLOAT:
+                value.floatValue = m_file.ReadFloat();
+                break;
+            case FT_STRING:
+                value.stringValue = m_file.ReadString();
+                break;
+            default:                                        // ignored source columns are not stored
+                break;
+        }
+    }
+
+    ++m_readRows;
+    return !m_file.HasReadError();
+}
+
+void SQLStorageSnapshot::BeginWrite(uint32 maxRecordId)
+{
+    m_file.BeginWrite();
+    m_file.WriteUInt32(maxRecordId);
+}
+
+void SQLStorageSnapshot::WriteRow(Field const* fields)
+{
+    if (!m_file.IsWriting())
+        return;
+
+    for (uint32 y = 0; y < m_srcFieldCount; ++y)
+    {
+        switch (m_srcFormat[y])
+        {
+            case FT_LOGIC:
+            case FT_INT:
+                m_file.WriteUInt32(fields[y].GetUInt32());
+                break;
+            case FT_BYTE:
+                m_file.WriteUInt8(fields[y].GetUInt8());
+                break;
+            case FT_FLOAT:
+                m_file.WriteFloat(fields[y].GetFloat());
+                break;
+            case FT_STRING:
+                m_file.WriteString(fields[y].GetString());
+                break;
+            default:
+                break;
+        }
+    }
+
+    m_file.EndRecord();
+}
@@ -0,0 +1,80 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef SQLSTORAGE_SNAPSHOT_H
+#define SQLSTORAGE_SNAPSHOT_H
+
+#include "Common.h"
+#include "SnapshotFile.h"
+
+#include <vector>
+
+class Field;
+
+/**
+ * Snapshot of the rows of a SQLStorage table, used instead of the database at the next load.
+ *
+ * The snapshot stores the source columns of each row (after the SELECT, before the conversion
+ * of the storage loader), so loaders that convert values (script names to ids...) still run.
+ * See SnapshotFile for the key, the source format is part of it.
+ */
+class SQLStorageSnapshot
+{
+    public:
+        SQLStorageSnapshot(char const* tableName, char const* srcFormat);
+
+        /// Map the snapshot of the table if it exists and matches the current database
+        bool Open();
+
+        uint32 GetMaxRecordId() const { return m_maxRecordId; }
+        uint32 GetRecordCount() const { return m_file.GetRecordCount(); }
+
+        /// Move to the next row of an opened snapshot
+        bool NextRow();
+
+        // values of the current row, column index as in the source format
+        uint32 GetUInt32(uint32 column) const { return m_row[column].intValue; }
+        uint8 GetUInt8(uint32 column) const { return uint8(m_row[column].intValue); }
+        float GetFloat(uint32 column) const { return m_row[column].floatValue; }
+        char const* GetString(uint32 column) const { return m_row[column].stringValue; }
+
+        /// Start collecting the rows loaded from the database after a failed Open, does nothing if snapshots are disabled
+        void BeginWrite(uint32 maxRecordId);
+        void WriteRow(Field const* fields);
+        /// Write the collected rows to the snapshot file
+        void EndWrite() { m_file.EndWrite(); }
+
+    private:
+        struct Value
+        {
+            uint32 intValue;
+            float floatValue;
+            char const* stringValue;
+        };
+
+        SnapshotFile m_file;
+        char const* m_srcFormat;
+        uint32 m_srcFieldCount;
+
+        uint32 m_maxRecordId;
+        uint32 m_readRows;
+        std::vector<Value> m_row;
+};
+
+#endif
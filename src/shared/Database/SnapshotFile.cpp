@@ -0,0 +1,337 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "SnapshotFile.h"
+#include "DatabaseEnv.h"
+
+#include "ace/ACE.h"
+#include "ace/Dirent.h"
+#include "ace/OS_NS_stdio.h"
+#include "ace/OS_NS_sys_stat.h"
+#include "ace/OS_NS_unistd.h"
+
+#define SNAPSHOT_MAGIC      "SNAP"
+#define SNAPSHOT_VERSION    3
+#define SNAPSHOT_NULL       0xFFFFFFFF                      // length of a NULL string
+
+#define FNV_OFFSET_BASIS    UI64LIT(14695981039346656037)
+
+// magic, version, key, record count, payload hash
+#define SNAPSHOT_HEADER_SIZE (4 + sizeof(uint32) + sizeof(uint64) + sizeof(uint32) + sizeof(uint64))
+
+std::string SnapshotFile::m_directory;
+uint64 SnapshotFile::m_environment = 0;
+
+static void HashData(uint64& hash, char const* data, size_t size)
+{
+    // FNV-1a
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= uint8(data[i]);
+        hash *= UI64LIT(1099511628211);
+    }
+}
+
+static void HashString(uint64& hash, char const* str)
+{
+    // the terminating 0 is hashed too so "ab"+"c" differs from "a"+"bc"
+    HashData(hash, str, strlen(str) + 1);
+}
+
+static void HashField(uint64& hash, Field const& field)
+{
+    HashString(hash, field.IsNULL() ? "NULL" : field.GetString());
+}
+
+void SnapshotFile::SetDirectory(std::string const& dir)
+{
+#ifdef DO_POSTGRESQL
+    m_directory.clear();                                    // the key needs the MySQL information_schema columns
+#else
+    m_directory = dir;
+    if (!m_directory.empty() && m_directory[m_directory.length() - 1] != '/' && m_directory[m_directory.length() - 1] != '\\')
+        m_directory.append("/");
+#endif
+}
+
+void SnapshotFile::SetEnvironment(std::string const& build, std::string const& dataDir)
+{
+    uint64 hash = FNV_OFFSET_BASIS;
+    HashString(hash, build.c_str());
+
+    ACE_Dirent dir;
+    if (dir.open(dataDir.c_str()) == -1)
+    {
+        m_environment = hash;
+        return;
+    }
+
+    // the files are summed, the key must not depend on the order of the directory entries
+    uint64 files = 0;
+    while (ACE_DIRENT* entry = dir.read())
+    {
+        if (ACE::isdotdir(entry->d_name))
+            continue;
+
+        std::string fullpath = dataDir + entry->d_name;
+
+        ACE_stat stat_buf;
+        if (ACE_OS::stat(fullpath.c_str(), &stat_buf) == -1)
+            continue;
+
+        uint64 size = uint64(stat_buf.st_size);
+        uint64 mtime = uint64(stat_buf.st_mtime);
+
+        uint64 fileHash = FNV_OFFSET_BASIS;
+        HashString(fileHash, entry->d_name);
+        HashData(fileHash, (char const*)&size, sizeof(size));
+        HashData(fileHash, (char const*)&mtime, sizeof(mtime));
+        files += fileHash;
+    }
+
+    HashData(hash, (char const*)&files, sizeof(files));
+    m_environment = hash;
+}
+
+SnapshotFile::SnapshotFile(char const* name, char const* layout) :
+    m_name(name), m_layout(layout), m_key(0), m_hasKey(false), m_recordCount(0),
+    m_pos(NULL), m_end(NULL), m_readError(false), m_writing(false), m_writtenRecords(0)
+{
+}
+
+SnapshotFile::~SnapshotFile()
+{
+    m_map.close();
+}
+
+std::string SnapshotFile::GetFileName() const
+{
+    return m_directory + m_name + ".snapshot";
+}
+
+bool SnapshotFile::ComputeKey()
+{
+    uint64 hash = FNV_OFFSET_BASIS;
+    HashString(hash, m_name);
+    HashString(hash, m_layout);
+    HashData(hash, (char const*)&m_environment, sizeof(m_environment));
+
+    // the column names of db_version hold the last applied update
+    if (QueryNamedResult* result = WorldDatabase.QueryNamed("SELECT * FROM db_version LIMIT 1"))
+    {
+        QueryFieldNames const& names = result->GetFieldNames();
+        Field* fields = result->Fetch();
+        for (uint32 i = 0; i < result->GetFieldCount(); ++i)
+        {
+            HashString(hash, names[i].c_str());
+            HashField(hash, fields[i]);
+        }
+        delete result;
+    }
+
+    // InnoDB keeps UPDATE_TIME in memory only, it is NULL after a server restart (always before MySQL 5.7) and MAX
+    // ignores NULLs, so a table without UPDATE_TIME can change unseen: no snapshot is used until all tables have one.
+    // MySQL 8 caches the information_schema values for a day without the hint, older servers ignore it.
+    QueryResult* result = WorldDatabase.Query("SELECT /*+ SET_VAR(information_schema_stats_expiry = 0) */ COUNT(*), MAX(UPDATE_TIME), MAX(CREATE_TIME), "
+                          "MAX(UPDATE_TIME) >= NOW() - INTERVAL 2 SECOND, COUNT(UPDATE_TIME) FROM information_schema.TABLES "
+                          "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_TYPE = 'BASE TABLE'");
+    if (!result)
+        return false;
+
+    Field* fields = result->Fetch();
+    HashField(hash, fields[0]);
+    HashField(hash, fields[1]);
+    HashField(hash, fields[2]);
+
+    // a change in the current second may be followed by another one with the same UPDATE_TIME
+    bool changing = !fields[3].IsNULL() && fields[3].GetBool();
+    bool unknownTimes = fields[4].GetUInt32() != fields[0].GetUInt32();
+    delete result;
+
+    if (unknownTimes)
+    {
+        DETAIL_LOG("Snapshot of `%s` not used, the update time of some world database tables is unknown.", m_name);
+        return false;
+    }
+
+    if (changing)
+        return false;
+
+    m_key = hash;
+    m_hasKey = true;
+    return true;
+}
+
+bool SnapshotFile::Open()
+{
+    // computed again at every load, a reload has to see the changes since the server start
+    m_hasKey = false;
+    if (!IsEnabled() || !ComputeKey())
+        return false;
+
+    std::string fileName = GetFileName();
+    if (m_map.map(fileName.c_str(), static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_SHARED) == -1)
+        return false;
+
+    char const* data = static_cast<char const*>(m_map.addr());
+    size_t size = m_map.size();
+
+    if (size < SNAPSHOT_HEADER_SIZE || memcmp(data, SNAPSHOT_MAGIC, 4) != 0)
+    {
+        m_map.close();
+        return false;
+    }
+
+    uint32 version;
+    uint64 key;
+    uint64 payloadHash;
+    memcpy(&version, data + 4, sizeof(uint32));
+    memcpy(&key, data + 8, sizeof(uint64));
+    memcpy(&m_recordCount, data + 16, sizeof(uint32));
+    memcpy(&payloadHash, data + 20, sizeof(uint64));
+
+    if (version != SNAPSHOT_VERSION || key != m_key)
+    {
+        m_map.close();
+        return false;                                       // database changed, rebuilt at this load
+    }
+
+    m_pos = data + SNAPSHOT_HEADER_SIZE;
+    m_end = data + size;
+    m_readError = false;
+
+    // a truncated or damaged snapshot is rebuilt
+    uint64 hash = FNV_OFFSET_BASIS;
+    HashData(hash, m_pos, m_end - m_pos);
+    if (hash != payloadHash)
+    {
+        sLog.outError("Snapshot %s is damaged, loading `%s` from the database.", fileName.c_str(), m_name);
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void SnapshotFile::Close()
+{
+    m_map.close();
+    m_pos = NULL;
+    m_end = NULL;
+}
+
+void SnapshotFile::Read(void* data, size_t size)
+{
+    if (m_readError || size_t(m_end - m_pos) < size)
+    {
+        m_readError = true;
+        memset(data, 0, size);
+        return;
+    }
+
+    memcpy(data, m_pos, size);
+    m_pos += size;
+}
+
+char const* SnapshotFile::ReadString()
+{
+    uint32 length = ReadUInt32();
+    if (m_readError || length == SNAPSHOT_NULL)
+        return NULL;
+
+    // stored with the terminating 0, so the value can be used from the mapped file
+    if (size_t(m_end - m_pos) < size_t(length) + 1 || m_pos[length] != '\0')
+    {
+        m_readError = true;
+        return NULL;
+    }
+
+    char const* value = m_pos;
+    m_pos += length + 1;
+    return value;
+}
+
+void SnapshotFile::BeginWrite()
+{
+    // the key was computed by Open, no key means snapshots are disabled or the database is changing
+    if (!m_hasKey)
+        return;
+
+    m_writing = true;
+    m_writtenRecords = 0;
+
+    m_writeBuffer.clear();
+    m_writeBuffer.resize(SNAPSHOT_HEADER_SIZE);             // set by EndWrite
+}
+
+void SnapshotFile::WriteString(char const* value)
+{
+    uint32 length = value ? strlen(value) : SNAPSHOT_NULL;
+    WriteUInt32(length);
+    if (value)
+        Write(value, length + 1);
+}
+
+void SnapshotFile::EndWrite()
+{
+    if (!m_writing)
+        return;
+
+    m_writing = false;
+
+    uint32 version = SNAPSHOT_VERSION;
+    uint64 payloadHash = FNV_OFFSET_BASIS;
+    HashData(payloadHash, &m_writeBuffer[SNAPSHOT_HEADER_SIZE], m_writeBuffer.size() - SNAPSHOT_HEADER_SIZE);
+
+    memcpy(&m_writeBuffer[0], SNAPSHOT_MAGIC, 4);
+    memcpy(&m_writeBuffer[4], &version, sizeof(uint32));
+    memcpy(&m_writeBuffer[8], &m_key, sizeof(uint64));
+    memcpy(&m_writeBuffer[16], &m_writtenRecords, sizeof(uint32));
+    memcpy(&m_writeBuffer[20], &payloadHash, sizeof(uint64));
+
+    // write a file of this process first and replace the snapshot by renaming it, servers sharing
+    // the directory never see a partial snapshot and never write into the same temporary file
+    std::string fileName = GetFileName();
+    char tmpSuffix[32];
+    snprintf(tmpSuffix, sizeof(tmpSuffix), ".%d.tmp", int(ACE_OS::getpid()));
+    std::string tmpName = fileName + tmpSuffix;
+
+    FILE* file = ACE_OS::fopen(tmpName.c_str(), "wb");
+    if (!file)
+    {
+        sLog.outError("Can't create snapshot %s, check SnapshotDir.", tmpName.c_str());
+        std::vector<char>().swap(m_writeBuffer);
+        return;
+    }
+
+    bool written = fwrite(&m_writeBuffer[0], 1, m_writeBuffer.size(), file) == m_writeBuffer.size();
+    written = ACE_OS::fclose(file) == 0 && written;
+
+    std::vector<char>().swap(m_writeBuffer);
+
+    // ACE_OS::rename replaces an existing snapshot at Windows too
+    if (!written || ACE_OS::rename(tmpName.c_str(), fileName.c_str()) != 0)
+    {
+        sLog.outError("Can't write snapshot %s.", fileName.c_str());
+        ACE_OS::unlink(tmpName.c_str());
+        return;
+    }
+
+    sLog.outDetail("`%s` written to snapshot %s (%u records)", m_name, fileName.c_str(), m_writtenRecords);
+}
@@ -0,0 +1,118 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef SNAPSHOT_FILE_H
+#define SNAPSHOT_FILE_H
+
+#include "Common.h"
+#include "ace/Mem_Map.h"
+
+#include <vector>
+
+/**
+ * File copy of data loaded from the world database, used instead of the database at the next load.
+ *
+ * A snapshot is keyed by the db_version row, the table count and the newest create and update
+ * time of the world database tables, the build and the client data files (see SetEnvironment)
+ * and the name and layout given by the user. Any change of the world database rebuilds all
+ * snapshots at the next load, no table is read to build the key. No snapshot is read or written
+ * while a table has no update time (InnoDB after a MySQL restart), its changes would be missed.
+ *
+ * The file content is a list of records written with the Write functions, the records are read
+ * back in the same order with the Read functions. A damaged file is detected by Open.
+ */
+class SnapshotFile
+{
+    public:
+        /// Directory of the snapshot files, empty disables snapshots
+        static void SetDirectory(std::string const& dir);
+        static bool IsEnabled() { return !m_directory.empty(); }
+
+        /// Build and client data the loaded data depends on, dataDir files are keyed by name, size and modification time
+        static void SetEnvironment(std::string const& build, std::string const& dataDir);
+
+        /// layout changes when the record format of the user changes
+        SnapshotFile(char const* name, char const* layout);
+        ~SnapshotFile();
+
+        /// Map the snapshot if it exists and matches the current database
+        bool Open();
+        /// Unmap an opened snapshot, for users that fall back to the database after a failed read
+        void Close();
+
+        uint32 GetRecordCount() const { return m_recordCount; }
+
+        // reading of an opened snapshot, values read past the end or after an error are 0
+        bool IsEnd() const { return m_pos >= m_end; }
+        bool HasReadError() const { return m_readError; }
+
+        uint8 ReadUInt8() { uint8 value = 0; Read(&value, sizeof(value)); return value; }
+        uint32 ReadUInt32() { uint32 value = 0; Read(&value, sizeof(value)); return value; }
+        int32 ReadInt32() { int32 value = 0; Read(&value, sizeof(value)); return value; }
+        float ReadFloat() { float value = 0.0f; Read(&value, sizeof(value)); return value; }
+        /// String of the mapped file, valid until the snapshot is closed, NULL for NULL strings
+        char const* ReadString();
+        void Read(void* data, size_t size);
+
+        /// Start collecting the records after a failed Open, does nothing if snapshots are disabled
+        void BeginWrite();
+        bool IsWriting() const { return m_writing; }
+
+        void WriteUInt8(uint8 value) { Write(&value, sizeof(value)); }
+        void WriteUInt32(uint32 value) { Write(&value, sizeof(value)); }
+        void WriteInt32(int32 value) { Write(&value, sizeof(value)); }
+        void WriteFloat(float value) { Write(&value, sizeof(value)); }
+        void WriteString(char const* value);
+        void Write(void const* data, size_t size)
+        {
+            if (m_writing)
+                m_writeBuffer.insert(m_writeBuffer.end(), (char const*)data, (char const*)data + size);
+        }
+        void EndRecord() { ++m_writtenRecords; }
+
+        /// Write the collected records to the snapshot file
+        void EndWrite();
+
+    private:
+        bool ComputeKey();
+        std::string GetFileName() const;
+
+        static std::string m_directory;
+        static uint64 m_environment;
+
+        char const* m_name;
+        char const* m_layout;
+        uint64 m_key;
+        bool m_hasKey;
+
+        uint32 m_recordCount;
+
+        // reading
+        ACE_Mem_Map m_map;
+        char const* m_pos;
+        char const* m_end;
+        bool m_readError;
+
+        // writing
+        bool m_writing;
+        uint32 m_writtenRecords;
+        std::vector<char> m_writeBuffer;
+};
+
+#endif
@@ -19,15 +19,157 @@
 #include "Database/SqlDelayThread.h"
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
+#include "Timer.h"
 
-SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true)
+SqlDelayQueue::SqlDelayQueue() : m_cond(m_mutex), m_running(0), m_barrierRunning(false), m_stopped(false)
 {
 }
 
-SqlDelayThread::~SqlDelayThread()
+void SqlDelayQueue::Add(SqlOperation* op, uint64 ownerKey, uint64 secondOwnerKey)
+{
+    if (!ownerKey || ownerKey == secondOwnerKey)
+    {
+        ownerKey = secondOwnerKey;
+        secondOwnerKey = 0;
+    }
+
+    SqlDelayedOperation delayed;
+    delayed.op = op;
+    delayed.ownerKey = ownerKey;
+    delayed.secondOwnerKey = secondOwnerKey;
+    delayed.queueTime = WorldTimer::getMSTime();
+
+    ACE_Guard<ACE_Thread_Mutex> guard(m_mutex);
+
+    m_queue.push_back(delayed);
+
+    if (m_queue.size() > m_stats.maxDepth)
+        m_stats.maxDepth = m_queue.size();
+
+    m_cond.signal();
+}
+
+bool SqlDelayQueue::IsOwnerFree(uint64 ownerKey, OwnerSet const& waiting) const
+{
+    return !ownerKey || (m_runningOwners.find(ownerKey) == m_runningOwners.end() && waiting.find(ownerKey) == waiting.end());
+}
+
+bool SqlDelayQueue::TakeRunnable(SqlDelayedOperation& op)
+{
+    if (m_barrierRunning)
+        return false;
+
+    // owners of the skipped operations, their later operations have to wait too
+    OwnerSet waiting;
+
+    for (OperationQueue::iterator itr = m_queue.begin(); itr != m_queue.end(); ++itr)
+    {
+        if (!itr->ownerKey)
+        {
+            // barrier, only starts alone and nothing after it may pass
+            if (itr != m_queue.begin() || m_running)
+                return false;
+
+            m_barrierRunning = true;
+        }
+        else if (!IsOwnerFree(itr->ownerKey, waiting) || !IsOwnerFree(itr->secondOwnerKey, waiting))
+        {
+            // keep the order of the operations of both owners
+            waiting.insert(itr->ownerKey);
+            if (itr->secondOwnerKey)
+                waiting.insert(itr->secondOwnerKey);
+            continue;
+        }
+        else
+        {
+            m_runningOwners.insert(itr->ownerKey);
+            if (itr->secondOwnerKey)
+                m_runningOwners.insert(itr->secondOwnerKey);
+        }
+
+        op = *itr;
+        m_queue.erase(itr);
+        ++m_running;
+        return true;
+    }
+
+    return false;
+}
+
+bool SqlDelayQueue::Next(SqlDelayedOperation& op, uint32 waitMs)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_mutex);
+
+    if (TakeRunnable(op))
+        return true;
+
+    if (m_stopped && m_queue.empty())
+        return false;
+
+    ACE_Time_Value timeout = ACE_OS::gettimeofday() + ACE_Time_Value(0, waitMs * 1000);
+    m_cond.wait(&timeout);
+
+    return TakeRunnable(op);
+}
+
+void SqlDelayQueue::Done(SqlDelayedOperation const& op, uint32 execTime)
+{
+    uint32 waitTime = WorldTimer::getMSTimeDiff(op.queueTime, WorldTimer::getMSTime()) - execTime;
+
+    ACE_Guard<ACE_Thread_Mutex> guard(m_mutex);
+
+    if (op.ownerKey)
+    {
+        m_runningOwners.erase(op.ownerKey);
+        if (op.secondOwnerKey)
+            m_runningOwners.erase(op.secondOwnerKey);
+    }
+    else
+        m_barrierRunning = false;
+
+    --m_running;
+
+    ++m_stats.executed;
+    m_stats.totalWait += waitTime;
+    m_stats.totalExec += execTime;
+    if (waitTime > m_stats.maxWait)
+        m_stats.maxWait = waitTime;
+    if (execTime > m_stats.maxExec)
+        m_stats.maxExec = execTime;
+
+    // operations of this owner or behind the barrier may run now
+    m_cond.broadcast();
+}
+
+void SqlDelayQueue::Stop()
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_mutex);
+    m_stopped = true;
+    m_cond.broadcast();
+}
+
+bool SqlDelayQueue::IsFinished() const
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_mutex);
+    return m_stopped && m_queue.empty();
+}
+
+void SqlDelayQueue::GetStats(SqlDelayQueueStats& stats) const
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_mutex);
+    stats = m_stats;
+    stats.depth = m_queue.size();
+}
+
+void SqlDelayQueue::ResetStats()
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_mutex);
+    m_stats = SqlDelayQueueStats();
+}
+
+SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn, SqlDelayQueue* queue, bool pingConnections) :
+    m_sqlQueue(queue), m_dbEngine(db), m_dbConnection(conn), m_pingConnections(pingConnections)
 {
-    // process all requests which might have been queued while thread was stopping
-    ProcessRequests();
 }
 
 void SqlDelayThread::run()
@@ -36,22 +178,26 @@ void SqlDelayThread::run()
     mysql_thread_init();
 #endif
 
-    const uint32 loopSleepms = 10;
+    const uint32 waitms = 10;
 
-    const uint32 pingEveryLoop = m_dbEngine->GetPingIntervall() / loopSleepms;
+    uint32 lastPing = WorldTimer::getMSTime();
 
-    uint32 loopCounter = 0;
-    while (m_running)
+    // when stopped, the queue is emptied before exiting
+    while (!m_sqlQueue->IsFinished())
     {
-        // if the running state gets turned off while sleeping
-        // empty the queue before exiting
-        ACE_Based::Thread::Sleep(loopSleepms);
-
-        ProcessRequests();
+        SqlDelayedOperation delayed;
+        if (m_sqlQueue->Next(delayed, waitms))
+        {
+            uint32 startTime = WorldTimer::getMSTime();
+            if (!delayed.op->Execute(m_dbConnection))
+                m_dbEngine->AddFailedTransaction(delayed.ownerKey, delayed.secondOwnerKey);
+            delete delayed.op;
+            m_sqlQueue->Done(delayed, WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()));
+        }
 
-        if ((loopCounter++) >= pingEveryLoop)
+        if (m_pingConnections && WorldTimer::getMSTimeDiff(lastPing, WorldTimer::getMSTime()) >= m_dbEngine->GetPingIntervall())
         {
-            loopCounter = 0;
+            lastPing = WorldTimer::getMSTime();
             m_dbEngine->Ping();
         }
     }
@@ -63,15 +209,5 @@ void SqlDelayThread::run()
 
 void SqlDelayThread::Stop()
 {
-    m_running = false;
-}
-
-void SqlDelayThread::ProcessRequests()
-{
-    SqlOperation* s = NULL;
-    while (m_sqlQueue.next(s))
-    {
-        s->Execute(m_dbConnection);
-        delete s;
-    }
+    m_sqlQueue->Stop();
 }
@@ -19,34 +19,101 @@
 #ifndef __SQLDELAYTHREAD_H
 #define __SQLDELAYTHREAD_H
 
+#include "Common.h"
 #include "ace/Thread_Mutex.h"
-#include "LockedQueue.h"
+#include "ace/Condition_Thread_Mutex.h"
 #include "Threading.h"
 
+#include <deque>
+#include <set>
 
 class Database;
 class SqlOperation;
 class SqlConnection;
 
-class SqlDelayThread : public ACE_Based::Runnable
+/// Async operation waiting in the delay queue
+struct SqlDelayedOperation
+{
+    SqlOperation* op;
+    uint64 ownerKey;                                        ///< entity the operation writes, 0 for none
+    uint64 secondOwnerKey;                                  ///< other entity written by the same operation (trade, mail), 0 for none
+    uint32 queueTime;                                       ///< getMSTime() at queueing
+};
+
+/// Counters of a delay queue, times in milliseconds
+struct SqlDelayQueueStats
 {
-        typedef ACE_Based::LockedQueue<SqlOperation*, ACE_Thread_Mutex> SqlQueue;
+    SqlDelayQueueStats() : depth(0), maxDepth(0), executed(0), totalWait(0), maxWait(0), totalExec(0), maxExec(0) {}
+
+    uint32 depth;                                           ///< operations waiting right now
+    uint32 maxDepth;
+    uint32 executed;
+    uint64 totalWait;                                       ///< time between queueing and execution start
+    uint32 maxWait;
+    uint64 totalExec;
+    uint32 maxExec;
+};
+
+/**
+ * Queue of async SQL operations shared by all delay threads of a database.
+ *
+ * Operations with the same owner key (e.g. a player's guid) are executed in queue order, one at a time.
+ * Operations of different owners may run in parallel on different connections. An operation may have
+ * a second owner (e.g. the other player of a trade), it then waits only for the earlier operations of
+ * both owners and holds back the later ones of both. An operation without owner key (0) is a barrier:
+ * it waits until all earlier operations are done and no later operation starts before it is done, so
+ * unkeyed requests keep the order of the old single delay thread.
+ */
+class SqlDelayQueue
+{
+    public:
+        SqlDelayQueue();
+
+        void Add(SqlOperation* op, uint64 ownerKey, uint64 secondOwnerKey = 0);
+
+        /// Take the next operation allowed to run, waits up to waitMs. Must be followed by Done(op)
+        bool Next(SqlDelayedOperation& op, uint32 waitMs);
+        /// Release the owner of an operation taken by Next
+        void Done(SqlDelayedOperation const& op, uint32 execTime);
+
+        /// Wake up waiting threads, Next keeps returning operations until the queue is empty
+        void Stop();
+        /// Stopped and nothing left to execute
+        bool IsFinished() const;
+
+        void GetStats(SqlDelayQueueStats& stats) const;
+        void ResetStats();
 
     private:
-        SqlQueue m_sqlQueue;                                ///< Queue of SQL statements
+        typedef std::deque<SqlDelayedOperation> OperationQueue;
+        typedef std::set<uint64> OwnerSet;
+
+        bool TakeRunnable(SqlDelayedOperation& op);
+        bool IsOwnerFree(uint64 ownerKey, OwnerSet const& waiting) const;
+
+        mutable ACE_Thread_Mutex m_mutex;
+        ACE_Condition_Thread_Mutex m_cond;
+
+        OperationQueue m_queue;
+        OwnerSet m_runningOwners;                           ///< owner keys of the executing operations
+        uint32 m_running;                                   ///< executing operations
+        bool m_barrierRunning;
+        bool m_stopped;
+
+        SqlDelayQueueStats m_stats;
+};
+
+/// Executes operations of the delay queue on its own connection
+class SqlDelayThread : public ACE_Based::Runnable
+{
+    private:
+        SqlDelayQueue* m_sqlQueue;                          ///< Queue of SQL statements, shared by all delay threads
         Database* m_dbEngine;                               ///< Pointer to used Database engine
         SqlConnection* m_dbConnection;                      ///< Pointer to DB connection
-        volatile bool m_running;
-
-        // process all enqueued requests
-        void ProcessRequests();
+        bool m_pingConnections;                             ///< this thread keeps the database connections alive
 
     public:
-        SqlDelayThread(Database* db, SqlConnection* conn);
-        ~SqlDelayThread();
-
-        ///< Put sql statement to delay queue
-        bool Delay(SqlOperation* sql) { m_sqlQueue.add(sql); return true; }
+        SqlDelayThread(Database* db, SqlConnection* conn, SqlDelayQueue* queue, bool pingConnections);
 
         virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
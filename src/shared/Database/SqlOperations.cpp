@@ -20,9 +20,13 @@
 #include "SqlDelayThread.h"
 #include "DatabaseEnv.h"
 #include "DatabaseImpl.h"
+#include "Timer.h"
 
 #define LOCK_DB_CONN(conn) SqlConnection::Lock guard(conn)
 
+// runs of a transaction after the first one failed by a deadlock or lock wait timeout
+static const uint32 MAX_TRANSACTION_RETRIES = 3;
+
 /// ---- ASYNC STATEMENTS / TRANSACTIONS ----
 
 bool SqlPlainRequest::Execute(SqlConnection* conn)
@@ -48,6 +52,23 @@ bool SqlTransaction::Execute(SqlConnection* conn)
 
     LOCK_DB_CONN(conn);
 
+    // keyed transactions run at the same time on several connections, one chosen as deadlock victim
+    // by InnoDB or timed out waiting for a lock of another one is run again before it counts as failed
+    for (uint32 attempt = 0;; ++attempt)
+    {
+        bool lockConflict = false;
+        if (ExecuteOnce(conn, lockConflict))
+            return true;
+
+        if (!lockConflict || attempt >= MAX_TRANSACTION_RETRIES)
+            return false;
+
+        sLog.outErrorDb("SQL: transaction hit a lock conflict, running it again (%u/%u)", attempt + 1, MAX_TRANSACTION_RETRIES);
+    }
+}
+
+bool SqlTransaction::ExecuteOnce(SqlConnection* conn, bool& lockConflict)
+{
     conn->BeginTransaction();
 
     const int nItems = m_queue.size();
@@ -57,12 +78,27 @@ bool SqlTransaction::Execute(SqlConnection* conn)
 
         if (!pStmt->Execute(conn))
         {
+            // read before the rollback resets the error of the connection
+            lockConflict = conn->LockConflict();
             conn->RollbackTransaction();
             return false;
         }
     }
 
-    return conn->CommitTransaction();
+    if (conn->CommitTransaction())
+        return true;
+
+    lockConflict = conn->LockConflict();
+    return false;
+}
+
+uint32 SqlTransaction::GetDataSize() const
+{
+    uint32 size = 0;
+    for (std::vector<SqlOperation* >::const_iterator itr = m_queue.begin(); itr != m_queue.end(); ++itr)
+        size += (*itr)->GetDataSize();
+
+    return size;
 }
 
 SqlPreparedRequest::SqlPreparedRequest(int nIndex, SqlStmtParameters* arg) : m_nIndex(nIndex), m_param(arg)
@@ -80,6 +116,16 @@ bool SqlPreparedRequest::Execute(SqlConnection* conn)
     return conn->ExecuteStmt(m_nIndex, *m_param);
 }
 
+uint32 SqlPreparedRequest::GetDataSize() const
+{
+    uint32 size = 0;
+    SqlStmtParameters::ParameterContainer const& params = m_param->params();
+    for (SqlStmtParameters::ParameterContainer::const_iterator itr = params.begin(); itr != params.end(); ++itr)
+        size += itr->size();
+
+    return size;
+}
+
 /// ---- ASYNC QUERIES ----
 
 bool SqlQuery::Execute(SqlConnection* conn)
@@ -87,35 +133,68 @@ bool SqlQuery::Execute(SqlConnection* conn)
     if (!m_callback || !m_queue)
         return false;
 
-    LOCK_DB_CONN(conn);
     /// execute the query and store the result in the callback
-    m_callback->SetResult(conn->Query(m_sql));
+    QueryResult* result = NULL;
+    if (!m_replica || !conn->DB().QueryReplica(m_sql, result))
+    {
+        LOCK_DB_CONN(conn);
+        result = conn->Query(m_sql);
+    }
+
+    m_callback->SetResult(result);
     /// add the callback to the sql result queue of the thread it originated from
     m_queue->add(m_callback);
 
     return true;
 }
 
-void SqlResultQueue::Update()
+void SqlResultQueue::add(MaNGOS::IQueryCallback* callback)
 {
-    /// execute the callbacks waiting in the synchronization queue
-    MaNGOS::IQueryCallback* callback = NULL;
-    while (next(callback))
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    m_ready.push_back(callback);
+}
+
+void SqlResultQueue::Update(uint32 maxTime)
+{
+    /// take the callbacks waiting in the synchronization queue, after the ones left by the last call
     {
+        ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+
+        if (m_next >= m_processing.size())
+        {
+            m_processing.clear();
+            m_next = 0;
+            m_processing.swap(m_ready);
+        }
+        else
+        {
+            m_processing.insert(m_processing.end(), m_ready.begin(), m_ready.end());
+            m_ready.clear();
+        }
+    }
+
+    /// execute them without holding the lock, new results are added meanwhile
+    uint32 startTime = WorldTimer::getMSTime();
+    while (m_next < m_processing.size())
+    {
+        MaNGOS::IQueryCallback* callback = m_processing[m_next++];
         callback->Execute();
         delete callback;
+
+        if (maxTime && WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()) >= maxTime)
+            break;
     }
 }
 
-bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue)
+bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, SqlDelayQueue* delayQueue, SqlResultQueue* queue)
 {
-    if (!callback || !thread || !queue)
+    if (!callback || !delayQueue || !queue)
         return false;
 
     /// delay the execution of the queries, sync them with the delay thread
     /// which will in turn resync on execution (via the queue) and call back
     SqlQueryHolderEx* holderEx = new SqlQueryHolderEx(this, callback, queue);
-    thread->Delay(holderEx);
+    delayQueue->Add(holderEx, 0);
     return true;
 }
 
@@ -30,7 +30,7 @@
 
 class Database;
 class SqlConnection;
-class SqlDelayThread;
+class SqlDelayQueue;
 class SqlStmtParameters;
 
 class SqlOperation
@@ -38,6 +38,8 @@ class SqlOperation
     public:
         virtual void OnRemove() { delete this; }
         virtual bool Execute(SqlConnection* conn) = 0;
+        // approximate amount of data sent to the DB server
+        virtual uint32 GetDataSize() const { return 0; }
         virtual ~SqlOperation() {}
 };
 
@@ -51,20 +53,31 @@ class SqlPlainRequest : public SqlOperation
         SqlPlainRequest(const char* sql) : m_sql(mangos_strdup(sql)) {}
         ~SqlPlainRequest() { char* tofree = const_cast<char*>(m_sql); delete[] tofree; }
         bool Execute(SqlConnection* conn) override;
+        uint32 GetDataSize() const override { return strlen(m_sql); }
 };
 
 class SqlTransaction : public SqlOperation
 {
     private:
         std::vector<SqlOperation* > m_queue;
+        uint64 m_ownerKey;
+        uint64 m_secondOwnerKey;
 
     public:
-        SqlTransaction() {}
+        explicit SqlTransaction(uint64 ownerKey = 0, uint64 secondOwnerKey = 0) : m_ownerKey(ownerKey), m_secondOwnerKey(secondOwnerKey) {}
         ~SqlTransaction();
 
+        uint64 GetOwnerKey() const { return m_ownerKey; }
+        uint64 GetSecondOwnerKey() const { return m_secondOwnerKey; }
+        uint32 GetSize() const { return m_queue.size(); }
+
         void DelayExecute(SqlOperation* sql) { m_queue.push_back(sql); }
 
         bool Execute(SqlConnection* conn) override;
+        uint32 GetDataSize() const override;
+
+    private:
+        bool ExecuteOnce(SqlConnection* conn, bool& lockConflict);
 };
 
 class SqlPreparedRequest : public SqlOperation
@@ -74,6 +87,7 @@ class SqlPreparedRequest : public SqlOperation
         ~SqlPreparedRequest();
 
         bool Execute(SqlConnection* conn) override;
+        uint32 GetDataSize() const override;
 
     private:
         const int m_nIndex;
@@ -88,11 +102,25 @@ class SqlResultQueue;                                       /// queue for thread
 class SqlQueryHolder;                                       /// groups several async quries
 class SqlQueryHolderEx;                                     /// points to a holder, added to the delay thread
 
-class SqlResultQueue : public ACE_Based::LockedQueue<MaNGOS::IQueryCallback* , ACE_Thread_Mutex>
+// callbacks of finished queries, added by the delay threads and executed by the thread owning the queue
+class SqlResultQueue
 {
     public:
-        SqlResultQueue() {}
-        void Update();
+        SqlResultQueue() : m_next(0) {}
+
+        void add(MaNGOS::IQueryCallback* callback);
+
+        // takes all ready callbacks with one lock and executes them for up to maxTime milliseconds (0 - no limit)
+        // callbacks left by the time limit are executed first at the next call
+        void Update(uint32 maxTime = 0);
+
+    private:
+        typedef std::vector<MaNGOS::IQueryCallback*> CallbackList;
+
+        ACE_Thread_Mutex m_lock;
+        CallbackList m_ready;                               // guarded by m_lock
+        CallbackList m_processing;                          // taken from m_ready, owner thread only
+        size_t m_next;                                      // next callback to execute in m_processing
 };
 
 class SqlQuery : public SqlOperation
@@ -101,9 +129,10 @@ class SqlQuery : public SqlOperation
         const char* m_sql;
         MaNGOS::IQueryCallback* m_callback;
         SqlResultQueue* m_queue;
+        bool m_replica;                                     // try the replica of the database first
     public:
-        SqlQuery(const char* sql, MaNGOS::IQueryCallback* callback, SqlResultQueue* queue)
-            : m_sql(mangos_strdup(sql)), m_callback(callback), m_queue(queue) {}
+        SqlQuery(const char* sql, MaNGOS::IQueryCallback* callback, SqlResultQueue* queue, bool replica = false)
+            : m_sql(mangos_strdup(sql)), m_callback(callback), m_queue(queue), m_replica(replica) {}
         ~SqlQuery() { char* tofree = const_cast<char*>(m_sql); delete[] tofree; }
         bool Execute(SqlConnection* conn) override;
 };
@@ -122,7 +151,7 @@ class SqlQueryHolder
         void SetSize(size_t size);
         QueryResult* GetResult(size_t index);
         void SetResult(size_t index, QueryResult* result);
-        bool Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue);
+        bool Execute(MaNGOS::IQueryCallback* callback, SqlDelayQueue* delayQueue, SqlResultQueue* queue);
 };
 
 class SqlQueryHolderEx : public SqlOperation
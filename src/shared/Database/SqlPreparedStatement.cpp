@@ -81,6 +81,98 @@ bool SqlStatement::DirectExecute()
     return m_pDB->DirectExecuteStmt(m_index, args);
 }
 
+//////////////////////////////////////////////////////////////////////////
+SqlBatchStatement::SqlBatchStatement(Database& db, const char* fmt) : m_db(db), m_nArguments(0), m_nBound(0), m_nRows(0)
+{
+    std::string szFmt = fmt;
+
+    // row values are the first parenthesized part after VALUES
+    std::string szUpper = szFmt;
+    std::transform(szUpper.begin(), szUpper.end(), szUpper.begin(), toupper);
+
+    size_t nValues = szUpper.find("VALUES");
+    size_t nOpen = nValues != std::string::npos ? szFmt.find('(', nValues) : std::string::npos;
+    size_t nClose = nOpen;
+    for (int depth = 0; nClose != std::string::npos && nClose < szFmt.length(); ++nClose)
+    {
+        if (szFmt[nClose] == '(')
+            ++depth;
+        else if (szFmt[nClose] == ')' && --depth == 0)
+            break;
+    }
+
+    if (nOpen == std::string::npos || nClose >= szFmt.length())
+    {
+        sLog.outError("SQL ERROR: batch statement without row values: %s", fmt);
+        MANGOS_ASSERT(false);
+        return;
+    }
+
+    m_szPrefix = szFmt.substr(0, nOpen);
+    m_szSuffix = szFmt.substr(nClose + 1);
+
+    std::string szRow = szFmt.substr(nOpen, nClose - nOpen + 1);
+    size_t nLastPos = 0;
+    for (size_t nPos = szRow.find('?'); nPos != std::string::npos; nPos = szRow.find('?', nLastPos))
+    {
+        m_rowParts.push_back(szRow.substr(nLastPos, nPos - nLastPos));
+        nLastPos = nPos + 1;
+    }
+    m_rowParts.push_back(szRow.substr(nLastPos));
+
+    m_nArguments = m_rowParts.size() - 1;
+}
+
+void SqlBatchStatement::addParam(const SqlStmtFieldData& data)
+{
+    if (m_nBound == 0)
+    {
+        if (m_nRows)
+            m_szRows += ',';
+        m_szRows += m_rowParts[0];
+    }
+
+    std::ostringstream fmt;
+    SqlPlainPreparedStatement::DataToString(data, fmt, m_db);
+    m_szRows += fmt.str();
+    m_szRows += m_rowParts[++m_nBound];
+
+    if (m_nBound < m_nArguments)
+        return;
+
+    m_nBound = 0;
+    ++m_nRows;
+
+    if (m_nRows >= m_db.GetInsertBatchRows() || m_szRows.length() >= MAX_QUERY_LEN)
+        Flush();
+}
+
+bool SqlBatchStatement::Flush()
+{
+    // verify amount of bound parameters
+    if (m_nBound)
+    {
+        sLog.outError("SQL ERROR: wrong amount of parameters (%u instead of %u)", m_nBound, m_nArguments);
+        sLog.outError("SQL ERROR: batch statement: %s(...)%s", m_szPrefix.c_str(), m_szSuffix.c_str());
+        MANGOS_ASSERT(false);
+        return false;
+    }
+
+    if (!m_nRows)
+        return true;
+
+    std::string szRequest;
+    szRequest.reserve(m_szPrefix.length() + m_szRows.length() + m_szSuffix.length());
+    szRequest += m_szPrefix;
+    szRequest += m_szRows;
+    szRequest += m_szSuffix;
+
+    m_szRows.clear();
+    m_nRows = 0;
+
+    return m_db.Execute(szRequest.c_str());
+}
+
 //////////////////////////////////////////////////////////////////////////
 SqlPlainPreparedStatement::SqlPlainPreparedStatement(const std::string& fmt, SqlConnection& conn) : SqlPreparedStatement(fmt, conn)
 {
@@ -111,7 +203,7 @@ void SqlPlainPreparedStatement::bind(const SqlStmtParameters& holder)
         const SqlStmtFieldData& data = (*iter);
 
         std::ostringstream fmt;
-        DataToString(data, fmt);
+        DataToString(data, fmt, m_pConn.DB());
 
         nLastPos = m_szPlainRequest.find('?', nLastPos);
         if (nLastPos != std::string::npos)
@@ -131,7 +223,7 @@ bool SqlPlainPreparedStatement::execute()
     return m_pConn.Execute(m_szPlainRequest.c_str());
 }
 
-void SqlPlainPreparedStatement::DataToString(const SqlStmtFieldData& data, std::ostringstream& fmt)
+void SqlPlainPreparedStatement::DataToString(const SqlStmtFieldData& data, std::ostringstream& fmt, Database& db)
 {
     switch (data.type())
     {
@@ -149,7 +241,7 @@ void SqlPlainPreparedStatement::DataToString(const SqlStmtFieldData& data, std::
         case FIELD_STRING:
         {
             std::string tmp = data.toStr();
-            m_pConn.DB().escape_string(tmp);
+            db.escape_string(tmp);
             fmt << "'" << tmp << "'";
             break;
         }
@@ -294,6 +294,88 @@ class MANGOS_DLL_SPEC SqlStatement
         SqlStmtParameters* m_pParams;
 };
 
+// multi-row INSERT built from the format of a single row statement:
+// "INSERT INTO table (a, b) VALUES (?, ?)", optionally followed by e.g. "ON DUPLICATE KEY UPDATE ..."
+// bound rows are sent as one request per "Database.InsertBatchRows" rows, the rest by Flush() or the destructor
+// rows are executed like plain requests: in the current transaction of the thread, if any
+class MANGOS_DLL_SPEC SqlBatchStatement
+{
+    public:
+        SqlBatchStatement(Database& db, const char* fmt);
+        ~SqlBatchStatement() { Flush(); }
+
+        uint32 arguments() const { return m_nArguments; }
+        // amount of complete rows not yet sent
+        uint32 pendingRows() const { return m_nRows; }
+
+        // send the pending rows as one request
+        bool Flush();
+
+        // templates to simplify 1-4 parameter rows
+        template<typename ParamType1>
+        void AddRow(ParamType1 param1)
+        {
+            arg(param1);
+        }
+
+        template<typename ParamType1, typename ParamType2>
+        void AddRow(ParamType1 param1, ParamType2 param2)
+        {
+            arg(param1);
+            arg(param2);
+        }
+
+        template<typename ParamType1, typename ParamType2, typename ParamType3>
+        void AddRow(ParamType1 param1, ParamType2 param2, ParamType3 param3)
+        {
+            arg(param1);
+            arg(param2);
+            arg(param3);
+        }
+
+        template<typename ParamType1, typename ParamType2, typename ParamType3, typename ParamType4>
+        void AddRow(ParamType1 param1, ParamType2 param2, ParamType3 param3, ParamType4 param4)
+        {
+            arg(param1);
+            arg(param2);
+            arg(param3);
+            arg(param4);
+        }
+
+        // bind parameters with specified type, a row is complete when all its parameters are bound
+        void addBool(bool var) { arg(var); }
+        void addUInt8(uint8 var) { arg(var); }
+        void addInt8(int8 var) { arg(var); }
+        void addUInt16(uint16 var) { arg(var); }
+        void addInt16(int16 var) { arg(var); }
+        void addUInt32(uint32 var) { arg(var); }
+        void addInt32(int32 var) { arg(var); }
+        void addUInt64(uint64 var) { arg(var); }
+        void addInt64(int64 var) { arg(var); }
+        void addFloat(float var) { arg(var); }
+        void addDouble(double var) { arg(var); }
+        void addString(const char* var) { arg(var); }
+        void addString(const std::string& var) { arg(var.c_str()); }
+
+    private:
+        SqlBatchStatement(const SqlBatchStatement&);
+        SqlBatchStatement& operator=(const SqlBatchStatement&);
+
+        template<typename ParamType>
+        void arg(ParamType val) { addParam(SqlStmtFieldData(val)); }
+
+        void addParam(const SqlStmtFieldData& data);
+
+        Database& m_db;
+        std::string m_szPrefix;                             // statement up to the row values
+        std::string m_szSuffix;                             // statement after the row values
+        std::vector<std::string> m_rowParts;                // row format split at the '?' placeholders
+        std::string m_szRows;                               // values of the bound rows
+        uint32 m_nArguments;
+        uint32 m_nBound;                                    // parameters of the current row
+        uint32 m_nRows;
+};
+
 // base prepared statement class
 class MANGOS_DLL_SPEC SqlPreparedStatement
 {
@@ -344,8 +426,10 @@ class MANGOS_DLL_SPEC SqlPlainPreparedStatement : public SqlPreparedStatement
 
         virtual bool execute() override;
 
+        // append the parameter as quoted SQL value
+        static void DataToString(const SqlStmtFieldData& data, std::ostringstream& fmt, Database& db);
+
     protected:
-        void DataToString(const SqlStmtFieldData& data, std::ostringstream& fmt);
 
         std::string m_szPlainRequest;
 };
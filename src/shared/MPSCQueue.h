@@ -0,0 +1,161 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <cstddef>
+
+#if defined(_MSC_VER)
+#  include <windows.h>
+#endif
+
+namespace ACE_Based
+{
+    /**
+     * Unbounded lock-free queue for many producer threads and one consumer thread.
+     *
+     * Producers only swap the head pointer, the consumer owns the tail and never blocks
+     * producers. A value added while the consumer reads may become visible at the next call.
+     * Has the add/next interface of LockedQueue, the consumer may also peek at the front
+     * without taking it, so next(result, checker) needs no lock.
+     */
+    template <class T>
+    class MPSCQueue
+    {
+        private:
+            struct Node
+            {
+                Node() : next(NULL) {}
+                explicit Node(T const& item) : next(NULL), value(item) {}
+
+                Node* volatile next;
+                T value;
+            };
+
+            static Node* Exchange(Node* volatile* target, Node* value)
+            {
+#if defined(_MSC_VER)
+                return (Node*)InterlockedExchangePointer((PVOID volatile*)target, value);
+#else
+                return __sync_lock_test_and_set(target, value);
+#endif
+            }
+
+            static void StoreRelease(Node* volatile* target, Node* value)
+            {
+#if defined(_MSC_VER)
+                *target = value;                            // volatile stores have release semantics
+#else
+                __sync_synchronize();
+                *target = value;
+#endif
+            }
+
+            static Node* LoadAcquire(Node* volatile const* source)
+            {
+#if defined(_MSC_VER)
+                return *source;                             // volatile loads have acquire semantics
+#else
+                Node* value = *source;
+                __sync_synchronize();
+                return value;
+#endif
+            }
+
+            //! Producers' end, last added node.
+            Node* volatile _head;
+
+            //! Consumer's end, its next node holds the front value.
+            Node* _tail;
+
+            MPSCQueue(MPSCQueue const&);
+            MPSCQueue& operator=(MPSCQueue const&);
+
+        public:
+
+            //! Create an empty queue.
+            MPSCQueue() : _head(new Node()), _tail(_head)
+            {
+            }
+
+            //! Destroy the queue, values left in it are not released.
+            ~MPSCQueue()
+            {
+                while (_tail)
+                {
+                    Node* node = _tail;
+                    _tail = node->next;
+                    delete node;
+                }
+            }
+
+            //! Adds an item to the queue, safe to call from any thread.
+            void add(T const& item)
+            {
+                Node* node = new Node(item);
+                Node* prev = Exchange(&_head, node);
+                StoreRelease(&prev->next, node);
+            }
+
+            //! Gets the next result in the queue, if any. Consumer thread only.
+            bool next(T& result)
+            {
+                Node* front = LoadAcquire(&_tail->next);
+                if (!front)
+                    return false;
+
+                result = front->value;
+                pop(front);
+                return true;
+            }
+
+            //! Gets the next result if the checker accepts it. Consumer thread only.
+            template<class Checker>
+            bool next(T& result, Checker& check)
+            {
+                Node* front = LoadAcquire(&_tail->next);
+                if (!front)
+                    return false;
+
+                result = front->value;
+                if (!check.Process(result))
+                    return false;
+
+                pop(front);
+                return true;
+            }
+
+            //! Checks if we're empty or not. Consumer thread only.
+            bool empty() const
+            {
+                return LoadAcquire(&_tail->next) == NULL;
+            }
+
+        private:
+            //! Front node becomes the new tail, its value was already taken
+            void pop(Node* front)
+            {
+                delete _tail;
+                _tail = front;
+                _tail->value = T();
+            }
+    };
+}
+
+#endif
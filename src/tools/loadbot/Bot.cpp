@@ -0,0 +1,1242 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup loadbot
+*/
+
+#include "Bot.h"
+#include "BotMgr.h"
+#include "Log.h"
+#include "Util.h"
+#include "SharedDefines.h"
+#include "Auth/BigNumber.h"
+#include "Auth/Sha1.h"
+
+#include <ace/Reactor.h>
+#include <ace/SOCK_Connector.h>
+#include <ace/os_include/netinet/os_tcp.h>
+
+#define BOT_RECV_BUFFER         4096
+#define BOT_HEARTBEAT_INTERVAL  500                         // milliseconds between MSG_MOVE_HEARTBEAT while walking
+#define BOT_WALK_SPEED          7.0f                        // yards per second of running players
+#define BOT_PING_INTERVAL       30000                       // the server counts pings in less than 27 seconds as overspeed
+
+#define BOT_NEVER               uint64(-1)
+
+/// Commands of the realmd protocol used by the bots
+enum BotRealmCommands
+{
+    BOT_CMD_AUTH_LOGON_CHALLENGE    = 0x00,
+    BOT_CMD_AUTH_LOGON_PROOF        = 0x01,
+    BOT_CMD_REALM_LIST              = 0x10
+};
+
+#define BOT_CHALLENGE_REPLY_SIZE    119                     // cmd, error, result, B, g, N, s, unk3, security flags
+#define BOT_PROOF_REPLY_SIZE        26                      // cmd, error, M2, unk2 of 1.12.x
+
+#define BOT_MOVEFLAG_FORWARD        0x00000001
+
+void BotCrypt::Init(uint8 const* key, size_t len)
+{
+    m_key.assign(key, key + len);
+    m_sendI = m_sendJ = m_recvI = m_recvJ = 0;
+    m_initialized = true;
+}
+
+void BotCrypt::EncryptSend(uint8* data, size_t len)
+{
+    if (!m_initialized)
+        return;
+
+    for (size_t t = 0; t < len; ++t)
+    {
+        m_sendI %= m_key.size();
+        uint8 x = (data[t] ^ m_key[m_sendI]) + m_sendJ;
+        ++m_sendI;
+        data[t] = m_sendJ = x;
+    }
+}
+
+void BotCrypt::DecryptRecv(uint8* data, size_t len)
+{
+    if (!m_initialized)
+        return;
+
+    for (size_t t = 0; t < len; ++t)
+    {
+        m_recvI %= m_key.size();
+        uint8 x = (data[t] - m_recvJ) ^ m_key[m_recvI];
+        ++m_recvI;
+        m_recvJ = data[t];
+        data[t] = x;
+    }
+}
+
+Bot::Bot(BotRunnable& owner, BotConfig const& config, uint32 index, std::string const& account, std::string const& password, bool monitor) :
+    m_Owner(owner), m_Config(config), m_Index(index), m_Account(account), m_Password(password), m_Monitor(monitor),
+    m_State(BOT_STATE_IDLE), m_StateTime(0), m_RetryTime(0), m_Attempts(0),
+    m_Registered(false), m_Connecting(false), m_OutActive(false),
+    m_A(NULL), m_M(NULL), m_K(NULL), m_WorldPort(0),
+    m_HeaderDecrypted(false), m_Seed(0),
+    m_Guid(0), m_MapId(0), m_HomeX(0.0f), m_HomeY(0.0f), m_X(0.0f), m_Y(0.0f), m_Z(0.0f), m_O(0.0f),
+    m_MoveFlags(0), m_MoveStartTime(0), m_LastMoveUpdate(0), m_ChatCounter(0),
+    m_NextMove(BOT_NEVER), m_NextHeartbeat(BOT_NEVER), m_NextChat(BOT_NEVER), m_NextCast(BOT_NEVER),
+    m_NextWho(BOT_NEVER), m_NextAuction(BOT_NEVER), m_NextPing(BOT_NEVER), m_NextReport(BOT_NEVER), m_PingCounter(0)
+{
+    reactor(owner.GetReactor());
+
+    // character name from the index, the server only accepts letters
+    m_Name = config.namePrefix;
+    char letters[6];
+    uint32 value = index;
+    for (int i = 4; i >= 0; --i)
+    {
+        letters[i] = 'a' + value % 26;
+        value /= 26;
+    }
+    letters[5] = '\0';
+    m_Name += letters;
+}
+
+Bot::~Bot()
+{
+    CloseConnection();
+
+    delete m_A;
+    delete m_M;
+    delete m_K;
+}
+
+ACE_HANDLE Bot::get_handle() const
+{
+    return m_Peer.get_handle();
+}
+
+void Bot::SetState(BotState state)
+{
+    m_State = state;
+    m_StateTime = BotMgr::GetMicroTime();
+}
+
+bool Bot::Connect(std::string const& address, uint16 port, BotState state)
+{
+    SetState(state);
+
+    ACE_INET_Addr addr(port, address.c_str());
+    ACE_SOCK_Connector connector;
+
+    // connect without blocking, completed at the first write event
+    if (connector.connect(m_Peer, addr, &ACE_Time_Value::zero) == -1)
+    {
+        if (errno != EWOULDBLOCK && errno != EINPROGRESS)
+            return false;
+
+        m_Connecting = true;
+    }
+
+    if (reactor()->register_handler(this, ACE_Event_Handler::READ_MASK | ACE_Event_Handler::WRITE_MASK) == -1)
+    {
+        m_Peer.close();
+        m_Connecting = false;
+        return false;
+    }
+
+    m_Registered = true;
+    m_OutActive = true;
+
+    if (!m_Connecting)
+        return handle_output() == 0;
+
+    return true;
+}
+
+void Bot::CloseConnection()
+{
+    if (m_Registered)
+    {
+        reactor()->remove_handler(this, ACE_Event_Handler::DONT_CALL | ACE_Event_Handler::ALL_EVENTS_MASK);
+        m_Registered = false;
+    }
+
+    m_Peer.close();
+    m_Connecting = false;
+    m_OutActive = false;
+    m_InBuffer.clear();
+    m_OutBuffer.clear();
+    m_HeaderDecrypted = false;
+    m_Crypt.Reset();
+    m_Requests.clear();
+    m_MoveFlags = 0;
+}
+
+void Bot::Fail(char const* reason)
+{
+    if (m_State == BOT_STATE_IN_WORLD)
+        ++m_Owner.GetStats().disconnects;
+    else
+        ++m_Owner.GetStats().failures;
+
+    ++m_Attempts;
+    if (m_Monitor)
+        sLog.outError("Monitor %s: %s (attempt %u)", m_Account.c_str(), reason, m_Attempts);
+    else
+        DETAIL_LOG("Bot %s: %s (attempt %u)", m_Account.c_str(), reason, m_Attempts);
+
+    CloseConnection();
+
+    if (!m_Config.reconnectDelay)
+    {
+        SetState(BOT_STATE_STOPPED);
+        return;
+    }
+
+    SetState(BOT_STATE_IDLE);
+    m_RetryTime = m_StateTime + uint64(m_Config.reconnectDelay + urand(0, m_Config.reconnectDelay)) * 1000;
+}
+
+void Bot::Stop()
+{
+    CloseConnection();
+    SetState(BOT_STATE_STOPPED);
+}
+
+void Bot::Send(uint8 const* data, size_t size)
+{
+    m_Owner.GetStats().sentBytes += size;
+
+    // keep the order behind the data still waiting for the socket
+    if (m_OutBuffer.empty() && !m_Connecting)
+    {
+        ssize_t n = m_Peer.send(data, size);
+        if (n == ssize_t(size))
+            return;
+
+        // a broken connection is noticed by the next read
+        if (n < 0)
+        {
+            if (errno != EWOULDBLOCK && errno != EAGAIN)
+                return;
+
+            n = 0;
+        }
+
+        data += n;
+        size -= n;
+    }
+
+    m_OutBuffer.insert(m_OutBuffer.end(), data, data + size);
+
+    if (!m_OutActive && m_Registered)
+    {
+        if (reactor()->schedule_wakeup(this, ACE_Event_Handler::WRITE_MASK) != -1)
+            m_OutActive = true;
+    }
+}
+
+int Bot::FlushOutput()
+{
+    if (!m_OutBuffer.empty())
+    {
+        ssize_t n = m_Peer.send(&m_OutBuffer[0], m_OutBuffer.size());
+        if (n < 0)
+        {
+            if (errno != EWOULDBLOCK && errno != EAGAIN)
+                return -1;
+
+            return 0;
+        }
+
+        m_OutBuffer.erase(m_OutBuffer.begin(), m_OutBuffer.begin() + n);
+        if (!m_OutBuffer.empty())
+            return 0;
+    }
+
+    if (m_OutActive && reactor()->cancel_wakeup(this, ACE_Event_Handler::WRITE_MASK) != -1)
+        m_OutActive = false;
+
+    return 0;
+}
+
+int Bot::handle_output(ACE_HANDLE)
+{
+    if (m_Connecting)
+    {
+        ACE_SOCK_Connector connector;
+        if (connector.complete(m_Peer, NULL, &ACE_Time_Value::zero) == -1)
+        {
+            if (errno == EWOULDBLOCK || errno == EAGAIN)
+                return 0;
+
+            Fail(m_State == BOT_STATE_REALM_CONNECT ? "can't connect to realmd" : "can't connect to mangosd");
+            return 0;
+        }
+
+        m_Connecting = false;
+    }
+
+    if (m_State == BOT_STATE_REALM_CONNECT || m_State == BOT_STATE_WORLD_CONNECT)
+    {
+        m_Peer.enable(ACE_NONBLOCK);
+
+        int ndelay = 1;
+        m_Peer.set_option(ACE_IPPROTO_TCP, TCP_NODELAY, &ndelay, sizeof(ndelay));
+
+        if (m_State == BOT_STATE_REALM_CONNECT)
+            SendLogonChallenge();
+        else
+            SetState(BOT_STATE_WORLD_AUTH);                 // the server sends SMSG_AUTH_CHALLENGE
+    }
+
+    if (FlushOutput() == -1)
+        Fail("send error");
+
+    return 0;
+}
+
+int Bot::handle_input(ACE_HANDLE)
+{
+    // failed connections are reported as readable too, the answer may already wait when it completes
+    if (m_Connecting)
+    {
+        handle_output();
+        if (m_Connecting || !m_Registered)
+            return 0;
+    }
+
+    uint8 buf[BOT_RECV_BUFFER];
+    for (;;)
+    {
+        ssize_t n = m_Peer.recv(buf, sizeof(buf));
+        if (n > 0)
+        {
+            m_Owner.GetStats().recvBytes += n;
+            m_InBuffer.insert(m_InBuffer.end(), buf, buf + n);
+            if (size_t(n) < sizeof(buf))
+                break;
+
+            continue;
+        }
+
+        if (n < 0 && (errno == EWOULDBLOCK || errno == EAGAIN))
+            break;
+
+        Fail(n == 0 ? "connection closed by the server" : "receive error");
+        return 0;
+    }
+
+    bool result;
+    try
+    {
+        if (m_State >= BOT_STATE_REALM_CHALLENGE && m_State <= BOT_STATE_REALM_LIST)
+            result = HandleRealmInput();
+        else
+            result = HandleWorldInput();
+    }
+    catch (ByteBufferException&)
+    {
+        result = false;
+    }
+
+    if (!result)
+        Fail("protocol error");
+
+    return 0;
+}
+
+int Bot::handle_close(ACE_HANDLE, ACE_Reactor_Mask)
+{
+    // the bots are owned by their BotRunnable, connections are closed by CloseConnection
+    return 0;
+}
+
+void Bot::SendLogonChallenge()
+{
+    ByteBuffer pkt(64);
+    pkt << uint8(BOT_CMD_AUTH_LOGON_CHALLENGE);
+    pkt << uint8(3);                                        // error
+    pkt << uint16(30 + m_Account.size());                   // size of the remaining packet
+    pkt.append("WoW", 4);                                   // game name, with the terminating zero
+    pkt << uint8(1) << uint8(12) << uint8(1);               // version 1.12.1
+    pkt << uint16(m_Config.build);
+    pkt.append("68x", 4);                                   // platform, reversed
+    pkt.append("niW", 4);                                   // os, reversed
+    pkt.append("SUne", 4);                                  // country, reversed
+    pkt << uint32(0);                                       // timezone bias
+    pkt << uint32(0);                                       // ip
+    pkt << uint8(m_Account.size());
+    pkt.append(m_Account.c_str(), m_Account.size());
+
+    SetState(BOT_STATE_REALM_CHALLENGE);
+    AddRequest(BOT_REQ_REALM_LOGIN, BOT_CMD_AUTH_LOGON_PROOF);
+    Send(pkt.contents(), pkt.size());
+}
+
+bool Bot::HandleRealmInput()
+{
+    while (!m_InBuffer.empty())
+    {
+        size_t size = m_InBuffer.size();
+
+        bool result;
+        switch (m_State)
+        {
+            case BOT_STATE_REALM_CHALLENGE: result = HandleLogonChallenge(); break;
+            case BOT_STATE_REALM_PROOF:     result = HandleLogonProof();     break;
+            case BOT_STATE_REALM_LIST:      result = HandleRealmList();      break;
+            default:                        return true;    // the realm connection was closed
+        }
+
+        if (!result)
+            return false;
+
+        // wait for the rest of the answer
+        if (m_InBuffer.size() == size)
+            break;
+    }
+
+    return true;
+}
+
+bool Bot::HandleLogonChallenge()
+{
+    if (m_InBuffer.size() < 3)
+        return true;
+
+    if (m_InBuffer[0] != BOT_CMD_AUTH_LOGON_CHALLENGE)
+        return false;
+
+    if (m_InBuffer[2] != 0)
+    {
+        char reason[64];
+        snprintf(reason, sizeof(reason), "logon challenge failed with result %u", m_InBuffer[2]);
+        Fail(reason);
+        return true;
+    }
+
+    if (m_InBuffer.size() < BOT_CHALLENGE_REPLY_SIZE)
+        return true;
+
+    uint8 const* data = &m_InBuffer[0];
+
+    // security flags would need more data, the bot accounts can't use them
+    if (data[118] != 0 || data[35] != 1 || data[37] != 32)
+        return false;
+
+    BigNumber B, g, N, s;
+    B.SetBinary(data + 3, 32);
+    g.SetBinary(data + 36, 1);
+    N.SetBinary(data + 38, 32);
+    s.SetBinary(data + 70, 32);
+
+    m_InBuffer.erase(m_InBuffer.begin(), m_InBuffer.begin() + BOT_CHALLENGE_REPLY_SIZE);
+
+    // x = H(s, H(I:P)), the same as realmd computes its verifier from sha_pass_hash
+    Sha1Hash sha;
+    sha.UpdateData(m_Account);
+    sha.UpdateData(":");
+    sha.UpdateData(m_Password);
+    sha.Finalize();
+
+    uint8 p[SHA_DIGEST_LENGTH];
+    memcpy(p, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateData(s.AsByteArray(), s.GetNumBytes());
+    sha.UpdateData(p, SHA_DIGEST_LENGTH);
+    sha.Finalize();
+
+    BigNumber x;
+    x.SetBinary(sha.GetDigest(), sha.GetLength());
+
+    // A is sent in 32 bytes, AsByteArray would shift a shorter value instead of padding it
+    BigNumber a;
+    delete m_A;
+    m_A = new BigNumber();
+    do
+    {
+        a.SetRand(19 * 8);
+        *m_A = g.ModExp(a, N);
+    }
+    while (m_A->GetNumBytes() < 32);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(m_A, &B, NULL);
+    sha.Finalize();
+
+    BigNumber u;
+    u.SetBinary(sha.GetDigest(), 20);
+
+    // S = (B - k * g^x) ^ (a + u * x) with k = 3
+    BigNumber gx = (g.ModExp(x, N) * 3) % N;
+    BigNumber base = (B + N - gx) % N;
+    BigNumber S = base.ModExp(a + u * x, N);
+
+    uint8 t[32];
+    uint8 t1[16];
+    uint8 vK[40];
+    memcpy(t, S.AsByteArray(32), 32);
+    for (int i = 0; i < 16; ++i)
+        t1[i] = t[i * 2];
+
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        vK[i * 2] = sha.GetDigest()[i];
+
+    for (int i = 0; i < 16; ++i)
+        t1[i] = t[i * 2 + 1];
+
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        vK[i * 2 + 1] = sha.GetDigest()[i];
+
+    delete m_K;
+    m_K = new BigNumber();
+    m_K->SetBinary(vK, 40);
+
+    uint8 hash[20];
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&N, NULL);
+    sha.Finalize();
+    memcpy(hash, sha.GetDigest(), 20);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&g, NULL);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        hash[i] ^= sha.GetDigest()[i];
+
+    BigNumber t3;
+    t3.SetBinary(hash, 20);
+
+    sha.Initialize();
+    sha.UpdateData(m_Account);
+    sha.Finalize();
+
+    uint8 t4[SHA_DIGEST_LENGTH];
+    memcpy(t4, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&t3, NULL);
+    sha.UpdateData(t4, SHA_DIGEST_LENGTH);
+    sha.UpdateBigNumbers(&s, m_A, &B, m_K, NULL);
+    sha.Finalize();
+
+    delete m_M;
+    m_M = new BigNumber();
+    m_M->SetBinary(sha.GetDigest(), 20);
+
+    ByteBuffer pkt(75);
+    pkt << uint8(BOT_CMD_AUTH_LOGON_PROOF);
+    pkt.append(m_A->AsByteArray(32), 32);
+    pkt.append(m_M->AsByteArray(20), 20);
+    for (int i = 0; i < 20; ++i)
+        pkt << uint8(0);                                    // crc_hash, not checked by realmd
+    pkt << uint8(0);                                        // number_of_keys
+    pkt << uint8(0);                                        // securityFlags
+
+    SetState(BOT_STATE_REALM_PROOF);
+    Send(pkt.contents(), pkt.size());
+    return true;
+}
+
+bool Bot::HandleLogonProof()
+{
+    if (m_InBuffer.size() < 2)
+        return true;
+
+    if (m_InBuffer[0] != BOT_CMD_AUTH_LOGON_PROOF)
+        return false;
+
+    if (m_InBuffer[1] != 0)
+    {
+        char reason[64];
+        snprintf(reason, sizeof(reason), "logon proof failed with error %u", m_InBuffer[1]);
+        Fail(reason);
+        return true;
+    }
+
+    if (m_InBuffer.size() < BOT_PROOF_REPLY_SIZE)
+        return true;
+
+    Sha1Hash sha;
+    sha.UpdateBigNumbers(m_A, m_M, m_K, NULL);
+    sha.Finalize();
+
+    if (memcmp(sha.GetDigest(), &m_InBuffer[2], 20))
+    {
+        Fail("wrong server proof");
+        return true;
+    }
+
+    m_InBuffer.erase(m_InBuffer.begin(), m_InBuffer.begin() + BOT_PROOF_REPLY_SIZE);
+    CompleteRequest(BOT_CMD_AUTH_LOGON_PROOF);
+
+    ByteBuffer pkt(5);
+    pkt << uint8(BOT_CMD_REALM_LIST);
+    pkt << uint32(0);
+
+    SetState(BOT_STATE_REALM_LIST);
+    AddRequest(BOT_REQ_REALM_LIST, BOT_CMD_REALM_LIST);
+    Send(pkt.contents(), pkt.size());
+    return true;
+}
+
+bool Bot::HandleRealmList()
+{
+    if (m_InBuffer.size() < 3)
+        return true;
+
+    if (m_InBuffer[0] != BOT_CMD_REALM_LIST)
+        return false;
+
+    size_t size = m_InBuffer[1] | (m_InBuffer[2] << 8);
+    if (size < 5)
+        return false;
+
+    if (m_InBuffer.size() < size + 3)
+        return true;
+
+    ByteBuffer pkt(size);
+    pkt.append(&m_InBuffer[3], size);
+    m_InBuffer.erase(m_InBuffer.begin(), m_InBuffer.begin() + size + 3);
+
+    CompleteRequest(BOT_CMD_REALM_LIST);
+
+    uint32 unused;
+    uint8 count;
+    pkt >> unused >> count;
+
+    std::string address;
+    for (uint8 i = 0; i < count; ++i)
+    {
+        uint32 icon;
+        uint8 flags, characters, timezone, unk;
+        std::string name, realmAddress;
+        float population;
+
+        pkt >> icon >> flags >> name >> realmAddress >> population >> characters >> timezone >> unk;
+
+        // names of realms with REALM_FLAG_SPECIFYBUILD have the version appended
+        if (!m_Config.realmName.empty() && name.compare(0, m_Config.realmName.size(), m_Config.realmName) != 0)
+            continue;
+
+        if (flags & 0x02)                                   // REALM_FLAG_OFFLINE
+        {
+            Fail("realm is offline");
+            return true;
+        }
+
+        address = realmAddress;
+        break;
+    }
+
+    if (address.empty())
+    {
+        Fail("realm not found in the realm list");
+        return true;
+    }
+
+    if (!m_Config.worldAddress.empty())
+        address = m_Config.worldAddress;
+
+    std::string::size_type pos = address.find(':');
+    m_WorldAddress = address.substr(0, pos);
+    m_WorldPort = pos != std::string::npos ? uint16(atoi(address.c_str() + pos + 1)) : 8085;
+
+    // the world connection is made by the next update, outside of the reactor dispatch of this socket
+    CloseConnection();
+    SetState(BOT_STATE_WORLD_CONNECT);
+    return true;
+}
+
+void Bot::SendPacket(uint16 opcode, ByteBuffer const& data)
+{
+    std::vector<uint8> buf(6 + data.size());
+
+    uint16 size = uint16(data.size() + 4);
+    buf[0] = uint8(size >> 8);
+    buf[1] = uint8(size);
+    buf[2] = uint8(opcode);
+    buf[3] = uint8(opcode >> 8);
+    buf[4] = 0;
+    buf[5] = 0;
+    m_Crypt.EncryptSend(&buf[0], 6);
+
+    if (data.size())
+        memcpy(&buf[6], data.contents(), data.size());
+
+    ++m_Owner.GetStats().sentPackets;
+    Send(&buf[0], buf.size());
+}
+
+bool Bot::HandleWorldInput()
+{
+    size_t pos = 0;
+    bool result = true;
+
+    while (m_InBuffer.size() - pos >= 4)
+    {
+        uint8* header = &m_InBuffer[pos];
+        if (!m_HeaderDecrypted)
+        {
+            m_Crypt.DecryptRecv(header, 4);
+            m_HeaderDecrypted = true;
+        }
+
+        uint16 size = uint16((header[0] << 8) | header[1]);
+        uint16 opcode = uint16(header[2] | (header[3] << 8));
+        if (size < 2)
+        {
+            result = false;
+            break;
+        }
+
+        if (m_InBuffer.size() - pos < size_t(size) + 2)
+            break;
+
+        ByteBuffer packet(size - 2);
+        if (size > 2)
+            packet.append(header + 4, size - 2);
+
+        pos += size + 2;
+        m_HeaderDecrypted = false;
+        ++m_Owner.GetStats().recvPackets;
+
+        if (!HandlePacket(opcode, packet))
+        {
+            result = false;
+            break;
+        }
+
+        // closed by the packet handler
+        if (!m_Registered)
+            return true;
+    }
+
+    m_InBuffer.erase(m_InBuffer.begin(), m_InBuffer.begin() + pos);
+    return result;
+}
+
+bool Bot::HandlePacket(uint16 opcode, ByteBuffer& data)
+{
+    switch (opcode)
+    {
+        case SMSG_AUTH_CHALLENGE:
+            if (m_State != BOT_STATE_WORLD_AUTH)
+                return false;
+            HandleAuthChallenge(data);
+            break;
+        case SMSG_AUTH_RESPONSE:
+            HandleAuthResponse(data);
+            break;
+        case SMSG_CHAR_ENUM:
+            HandleCharEnum(data);
+            break;
+        case SMSG_CHAR_CREATE:
+            HandleCharCreate(data);
+            break;
+        case SMSG_LOGIN_VERIFY_WORLD:
+            HandleLoginVerifyWorld(data);
+            break;
+        case SMSG_CHARACTER_LOGIN_FAILED:
+            Fail("character login failed");
+            break;
+        case SMSG_MESSAGECHAT:
+            HandleMessageChat(data);
+            break;
+        case SMSG_CAST_FAILED:
+            HandleCastResult(data);
+            break;
+        case SMSG_PONG:
+        case SMSG_WHO:
+        case SMSG_AUCTION_LIST_RESULT:
+            CompleteRequest(opcode);
+            break;
+        default:
+            break;
+    }
+
+    return true;
+}
+
+void Bot::HandleAuthChallenge(ByteBuffer& data)
+{
+    data >> m_Seed;
+
+    uint32 clientSeed = urand(1, 0xFFFFFFFE);
+    uint32 t = 0;
+
+    Sha1Hash sha;
+    sha.UpdateData(m_Account);
+    sha.UpdateData((uint8*)&t, 4);
+    sha.UpdateData((uint8*)&clientSeed, 4);
+    sha.UpdateData((uint8*)&m_Seed, 4);
+    sha.UpdateBigNumbers(m_K, NULL);
+    sha.Finalize();
+
+    ByteBuffer pkt(64);
+    pkt << uint32(m_Config.build);
+    pkt << uint32(0);
+    pkt << m_Account;
+    pkt << uint32(clientSeed);
+    pkt.append(sha.GetDigest(), 20);
+    pkt << uint32(0);                                       // no addon data
+
+    AddRequest(BOT_REQ_AUTH_SESSION, SMSG_AUTH_RESPONSE);
+    SendPacket(CMSG_AUTH_SESSION, pkt);
+
+    // everything after CMSG_AUTH_SESSION has encrypted headers
+    uint8 key[40];
+    memset(key, 0, sizeof(key));
+    memcpy(key, m_K->AsByteArray(), std::min(m_K->GetNumBytes(), 40));
+    m_Crypt.Init(key, sizeof(key));
+}
+
+void Bot::HandleAuthResponse(ByteBuffer& data)
+{
+    CompleteRequest(SMSG_AUTH_RESPONSE);
+
+    uint8 code;
+    data >> code;
+
+    switch (code)
+    {
+        case AUTH_OK:
+        {
+            ByteBuffer pkt(0);
+            SetState(BOT_STATE_CHAR_ENUM);
+            AddRequest(BOT_REQ_CHAR_ENUM, SMSG_CHAR_ENUM);
+            SendPacket(CMSG_CHAR_ENUM, pkt);
+            break;
+        }
+        case AUTH_WAIT_QUEUE:
+        {
+            uint32 position;
+            data >> position;
+            DETAIL_LOG("Bot %s: queued at position %u", m_Account.c_str(), position);
+            SetState(BOT_STATE_WORLD_QUEUE);
+            break;
+        }
+        default:
+        {
+            char reason[64];
+            snprintf(reason, sizeof(reason), "world login failed with response %u", code);
+            Fail(reason);
+            break;
+        }
+    }
+}
+
+void Bot::HandleCharEnum(ByteBuffer& data)
+{
+    if (m_State != BOT_STATE_CHAR_ENUM)
+        return;
+
+    CompleteRequest(SMSG_CHAR_ENUM);
+
+    uint8 count;
+    data >> count;
+
+    if (!count)
+    {
+        uint8 const outfit[7] = { 0, 0, 0, 0, 0, 0, 0 };     // gender, skin, face, hair style, hair color, facial hair, outfit
+
+        ByteBuffer pkt(32);
+        pkt << m_Name;
+        pkt << uint8(m_Config.race);
+        pkt << uint8(m_Config.class_);
+        pkt.append(outfit, sizeof(outfit));
+
+        SetState(BOT_STATE_CHAR_CREATE);
+        AddRequest(BOT_REQ_CHAR_CREATE, SMSG_CHAR_CREATE);
+        SendPacket(CMSG_CHAR_CREATE, pkt);
+        return;
+    }
+
+    // the first character of the account, a bot only creates one
+    data >> m_Guid;
+    data >> m_Name;
+
+    ByteBuffer pkt(8);
+    pkt << uint64(m_Guid);
+
+    SetState(BOT_STATE_PLAYER_LOGIN);
+    AddRequest(BOT_REQ_PLAYER_LOGIN, SMSG_LOGIN_VERIFY_WORLD);
+    SendPacket(CMSG_PLAYER_LOGIN, pkt);
+}
+
+void Bot::HandleCharCreate(ByteBuffer& data)
+{
+    if (m_State != BOT_STATE_CHAR_CREATE)
+        return;
+
+    CompleteRequest(SMSG_CHAR_CREATE);
+
+    uint8 code;
+    data >> code;
+
+    if (code != CHAR_CREATE_SUCCESS)
+    {
+        char reason[64];
+        snprintf(reason, sizeof(reason), "creating character %s failed with response %u", m_Name.c_str(), code);
+        Fail(reason);
+        return;
+    }
+
+    ByteBuffer pkt(0);
+    SetState(BOT_STATE_CHAR_ENUM);
+    AddRequest(BOT_REQ_CHAR_ENUM, SMSG_CHAR_ENUM);
+    SendPacket(CMSG_CHAR_ENUM, pkt);
+}
+
+void Bot::HandleLoginVerifyWorld(ByteBuffer& data)
+{
+    if (m_State != BOT_STATE_PLAYER_LOGIN)
+        return;
+
+    CompleteRequest(SMSG_LOGIN_VERIFY_WORLD);
+
+    data >> m_MapId >> m_X >> m_Y >> m_Z >> m_O;
+    m_HomeX = m_X;
+    m_HomeY = m_Y;
+
+    EnterWorld();
+}
+
+void Bot::EnterWorld()
+{
+    SetState(BOT_STATE_IN_WORLD);
+    ++m_Owner.GetStats().logins;
+    m_Attempts = 0;
+
+    uint64 now = m_StateTime;
+    m_MoveFlags = 0;
+    m_NextMove = NextTime(now, m_Config.moveInterval);
+    m_NextHeartbeat = BOT_NEVER;
+    m_NextChat = NextTime(now, m_Config.chatInterval);
+    m_NextCast = NextTime(now, m_Config.castInterval);
+    m_NextWho = NextTime(now, m_Config.whoInterval);
+    m_NextAuction = NextTime(now, m_Config.auctionInterval);
+    m_NextPing = now + uint64(BOT_PING_INTERVAL) * 1000;
+
+    if (m_Monitor)
+    {
+        SendChat(".server perf reset");
+        m_NextReport = now + uint64(m_Config.reportInterval) * 1000000;
+    }
+}
+
+void Bot::HandleMessageChat(ByteBuffer& data)
+{
+    uint8 type;
+    uint32 language;
+    data >> type >> language;
+
+    // the layout depends on the type, only own messages and command answers are of interest
+    if (type != CHAT_MSG_SAY && type != CHAT_MSG_SYSTEM)
+        return;
+
+    uint64 sender;
+    data >> sender;
+    if (type == CHAT_MSG_SAY)
+        data.read_skip<uint64>();
+
+    uint32 length;
+    std::string message;
+    data >> length >> message;
+
+    if (type == CHAT_MSG_SAY)
+    {
+        // our own message, the other ones are from bots around
+        if (sender == m_Guid)
+            CompleteRequest(SMSG_MESSAGECHAT);
+    }
+    else if (m_Monitor)
+        m_Owner.AddServerReport(message);
+}
+
+void Bot::HandleCastResult(ByteBuffer& data)
+{
+    uint32 spellId;
+    uint8 status;
+    data >> spellId >> status;
+
+    CompleteRequest(SMSG_CAST_FAILED, spellId);
+}
+
+void Bot::Update(uint64 now)
+{
+    ExpireRequests(now);
+
+    switch (m_State)
+    {
+        case BOT_STATE_STOPPED:
+        case BOT_STATE_WORLD_QUEUE:
+            return;
+        case BOT_STATE_IDLE:
+            if (now >= m_RetryTime && !Connect(m_Config.realmAddress, m_Config.realmPort, BOT_STATE_REALM_CONNECT))
+                Fail("can't connect to realmd");
+            return;
+        case BOT_STATE_WORLD_CONNECT:
+            if (!m_Registered)
+            {
+                if (!Connect(m_WorldAddress, m_WorldPort, BOT_STATE_WORLD_CONNECT))
+                    Fail("can't connect to mangosd");
+                return;
+            }
+            break;
+        case BOT_STATE_IN_WORLD:
+            break;
+        default:
+            break;
+    }
+
+    if (m_State != BOT_STATE_IN_WORLD)
+    {
+        if (now >= m_StateTime + uint64(m_Config.requestTimeout) * 1000)
+        {
+            char reason[64];
+            snprintf(reason, sizeof(reason), "login timed out in state %u", m_State);
+            Fail(reason);
+        }
+        return;
+    }
+
+    UpdateMovement(now);
+
+    if (now >= m_NextChat)
+    {
+        char text[64];
+        snprintf(text, sizeof(text), "Hello from %s, message %u", m_Name.c_str(), ++m_ChatCounter);
+        SendChat(text);
+        AddRequest(BOT_REQ_CHAT, SMSG_MESSAGECHAT);
+        m_NextChat = NextTime(now, m_Config.chatInterval);
+    }
+
+    if (now >= m_NextCast)
+    {
+        SendCastSpell();
+        m_NextCast = NextTime(now, m_Config.castInterval);
+    }
+
+    if (now >= m_NextWho)
+    {
+        SendWho();
+        m_NextWho = NextTime(now, m_Config.whoInterval);
+    }
+
+    if (now >= m_NextAuction)
+    {
+        SendAuctionSearch();
+        m_NextAuction = NextTime(now, m_Config.auctionInterval);
+    }
+
+    if (now >= m_NextPing)
+    {
+        SendPing();
+        m_NextPing = now + uint64(BOT_PING_INTERVAL) * 1000;
+    }
+
+    if (now >= m_NextReport)
+    {
+        SendChat(".server perf");
+        m_NextReport = now + uint64(m_Config.reportInterval) * 1000000;
+    }
+}
+
+void Bot::UpdateMovement(uint64 now)
+{
+    if (!(m_MoveFlags & BOT_MOVEFLAG_FORWARD))
+    {
+        if (now < m_NextMove)
+            return;
+
+        // walk towards a random point around the login position
+        float angle = frand(0.0f, 2 * M_PI_F);
+        float dist = frand(0.0f, m_Config.moveRadius);
+        float x = m_HomeX + dist * cos(angle);
+        float y = m_HomeY + dist * sin(angle);
+
+        m_O = atan2(y - m_Y, x - m_X);
+        if (m_O < 0.0f)
+            m_O += 2 * M_PI_F;
+
+        m_MoveFlags = BOT_MOVEFLAG_FORWARD;
+        m_MoveStartTime = now;
+        m_LastMoveUpdate = now;
+        m_NextHeartbeat = now + uint64(BOT_HEARTBEAT_INTERVAL) * 1000;
+        SendMovement(MSG_MOVE_START_FORWARD, now);
+        return;
+    }
+
+    float dist = BOT_WALK_SPEED * float(now - m_LastMoveUpdate) / 1000000.0f;
+    m_X += dist * cos(m_O);
+    m_Y += dist * sin(m_O);
+    m_LastMoveUpdate = now;
+
+    float dx = m_X - m_HomeX;
+    float dy = m_Y - m_HomeY;
+    if (now - m_MoveStartTime >= uint64(m_Config.moveTime) * 1000 || dx * dx + dy * dy > m_Config.moveRadius * m_Config.moveRadius)
+    {
+        m_MoveFlags = 0;
+        m_NextHeartbeat = BOT_NEVER;
+        m_NextMove = NextTime(now, m_Config.moveInterval);
+        SendMovement(MSG_MOVE_STOP, now);
+        return;
+    }
+
+    if (now >= m_NextHeartbeat)
+    {
+        m_NextHeartbeat = now + uint64(BOT_HEARTBEAT_INTERVAL) * 1000;
+        SendMovement(MSG_MOVE_HEARTBEAT, now);
+    }
+}
+
+void Bot::SendMovement(uint16 opcode, uint64 now)
+{
+    ByteBuffer pkt(28);
+    pkt << uint32(m_MoveFlags);
+    pkt << uint32(now / 1000);
+    pkt << m_X << m_Y << m_Z << m_O;
+    pkt << uint32(0);                                       // fall time
+
+    SendPacket(opcode, pkt);
+}
+
+void Bot::SendChat(char const* text)
+{
+    // alliance races speak common, the horde orcish
+    uint32 language = (m_Config.race == RACE_HUMAN || m_Config.race == RACE_DWARF || m_Config.race == RACE_NIGHTELF ||
+                       m_Config.race == RACE_GNOME) ? LANG_COMMON : LANG_ORCISH;
+
+    ByteBuffer pkt(64);
+    pkt << uint32(CHAT_MSG_SAY);
+    pkt << uint32(language);
+    pkt << text;
+
+    SendPacket(CMSG_MESSAGECHAT, pkt);
+}
+
+void Bot::SendCastSpell()
+{
+    if (!m_Config.castSpell)
+        return;
+
+    ByteBuffer pkt(6);
+    pkt << uint32(m_Config.castSpell);
+    pkt << uint16(0);                                       // TARGET_FLAG_SELF
+
+    AddRequest(BOT_REQ_CAST, SMSG_CAST_FAILED, m_Config.castSpell);
+    SendPacket(CMSG_CAST_SPELL, pkt);
+}
+
+void Bot::SendWho()
+{
+    ByteBuffer pkt(32);
+    pkt << uint32(0);                                       // minimal level
+    pkt << uint32(60);                                      // maximal level
+    pkt << "";                                              // player name
+    pkt << "";                                              // guild name
+    pkt << uint32(0xFFFFFFFF);                              // race mask
+    pkt << uint32(0xFFFFFFFF);                              // class mask
+    pkt << uint32(0);                                       // zones count
+    pkt << uint32(0);                                       // strings count
+
+    AddRequest(BOT_REQ_WHO, SMSG_WHO);
+    SendPacket(CMSG_WHO, pkt);
+}
+
+void Bot::SendAuctionSearch()
+{
+    // the own guid as auctioneer, the way of .auction, only accepted for accounts allowed to use the command
+    ByteBuffer pkt(32);
+    pkt << uint64(m_Guid);
+    pkt << uint32(0);                                       // list from
+    pkt << "";                                              // searched name
+    pkt << uint8(0) << uint8(0);                            // levels
+    pkt << uint32(0xFFFFFFFF);                              // slot
+    pkt << uint32(0xFFFFFFFF);                              // main category
+    pkt << uint32(0xFFFFFFFF);                              // sub category
+    pkt << uint32(0xFFFFFFFF);                              // quality
+    pkt << uint8(0);                                        // usable
+
+    AddRequest(BOT_REQ_AUCTION, SMSG_AUCTION_LIST_RESULT);
+    SendPacket(CMSG_AUCTION_LIST_ITEMS, pkt);
+}
+
+void Bot::SendPing()
+{
+    ByteBuffer pkt(8);
+    pkt << uint32(++m_PingCounter);
+    pkt << uint32(0);                                       // latency
+
+    AddRequest(BOT_REQ_PING, SMSG_PONG);
+    SendPacket(CMSG_PING, pkt);
+}
+
+uint64 Bot::NextTime(uint64 now, uint32 interval) const
+{
+    if (!interval)
+        return BOT_NEVER;
+
+    // spread the bots, the average stays the configured interval
+    return now + uint64(interval / 2 + urand(0, interval)) * 1000;
+}
+
+void Bot::AddRequest(BotRequest request, uint16 response, uint32 param)
+{
+    PendingRequest pending;
+    pending.request = request;
+    pending.response = response;
+    pending.param = param;
+    pending.sentTime = BotMgr::GetMicroTime();
+    m_Requests.push_back(pending);
+}
+
+bool Bot::CompleteRequest(uint16 response, uint32 param)
+{
+    for (PendingRequests::iterator itr = m_Requests.begin(); itr != m_Requests.end(); ++itr)
+    {
+        if (itr->response != response || itr->param != param)
+            continue;
+
+        uint64 time = BotMgr::GetMicroTime() - itr->sentTime;
+        m_Owner.GetStats().requests[itr->request].Add(time > 0xFFFFFFFF ? 0xFFFFFFFF : uint32(time));
+        m_Requests.erase(itr);
+        return true;
+    }
+
+    return false;
+}
+
+void Bot::ExpireRequests(uint64 now)
+{
+    uint64 timeout = uint64(m_Config.requestTimeout) * 1000;
+
+    while (!m_Requests.empty() && now >= m_Requests.front().sentTime + timeout)
+    {
+        m_Owner.GetStats().requests[m_Requests.front().request].AddTimeout();
+        m_Requests.pop_front();
+    }
+}
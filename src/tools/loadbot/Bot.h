@@ -0,0 +1,244 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup loadbot
+/// @{
+/// \file
+
+#ifndef MANGOS_BOT_H
+#define MANGOS_BOT_H
+
+#include "Common.h"
+#include "ByteBuffer.h"
+#include "BotStats.h"
+
+#include <ace/Event_Handler.h>
+#include <ace/SOCK_Stream.h>
+#include <ace/INET_Addr.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+class BigNumber;
+class BotRunnable;
+struct BotConfig;
+
+/// Opcodes used by the bots, values of game/Opcodes.h that can't be included without the game library
+enum BotOpcodes
+{
+    CMSG_CHAR_CREATE                = 0x036,
+    CMSG_CHAR_ENUM                  = 0x037,
+    SMSG_CHAR_CREATE                = 0x03A,
+    SMSG_CHAR_ENUM                  = 0x03B,
+    CMSG_PLAYER_LOGIN               = 0x03D,
+    SMSG_CHARACTER_LOGIN_FAILED     = 0x041,
+    CMSG_WHO                        = 0x062,
+    SMSG_WHO                        = 0x063,
+    CMSG_MESSAGECHAT                = 0x095,
+    SMSG_MESSAGECHAT                = 0x096,
+    MSG_MOVE_START_FORWARD          = 0x0B5,
+    MSG_MOVE_STOP                   = 0x0B7,
+    MSG_MOVE_HEARTBEAT              = 0x0EE,
+    CMSG_CAST_SPELL                 = 0x12E,
+    SMSG_CAST_FAILED                = 0x130,
+    CMSG_PING                       = 0x1DC,
+    SMSG_PONG                       = 0x1DD,
+    SMSG_AUTH_CHALLENGE             = 0x1EC,
+    CMSG_AUTH_SESSION               = 0x1ED,
+    SMSG_AUTH_RESPONSE              = 0x1EE,
+    SMSG_LOGIN_VERIFY_WORLD         = 0x236,
+    CMSG_AUCTION_LIST_ITEMS         = 0x258,
+    SMSG_AUCTION_LIST_RESULT        = 0x25C,
+};
+
+enum BotState
+{
+    BOT_STATE_IDLE,                                         // waiting for the next login attempt
+    BOT_STATE_REALM_CONNECT,
+    BOT_STATE_REALM_CHALLENGE,
+    BOT_STATE_REALM_PROOF,
+    BOT_STATE_REALM_LIST,
+    BOT_STATE_WORLD_CONNECT,
+    BOT_STATE_WORLD_AUTH,                                   // until SMSG_AUTH_RESPONSE
+    BOT_STATE_WORLD_QUEUE,                                  // in the login queue of the server
+    BOT_STATE_CHAR_ENUM,
+    BOT_STATE_CHAR_CREATE,
+    BOT_STATE_PLAYER_LOGIN,
+    BOT_STATE_IN_WORLD,
+    BOT_STATE_STOPPED
+};
+
+/// Header encryption of the client side, the reverse of AuthCrypt
+class BotCrypt
+{
+    public:
+        BotCrypt() : m_sendI(0), m_sendJ(0), m_recvI(0), m_recvJ(0), m_initialized(false) {}
+
+        void Init(uint8 const* key, size_t len);
+        void Reset() { m_initialized = false; }
+
+        void EncryptSend(uint8* data, size_t len);
+        void DecryptRecv(uint8* data, size_t len);
+
+    private:
+        std::vector<uint8> m_key;
+        uint8 m_sendI, m_sendJ, m_recvI, m_recvJ;
+        bool m_initialized;
+};
+
+/**
+ * Headless client of one account.
+ *
+ * Logs in at realmd with SRP6, then at mangosd, creates its character when the account has none and
+ * enters the world. In the world it moves around its login position, talks, casts a spell and searches
+ * players and auctions at the configured intervals, and measures the round trip of every request.
+ * All methods are called by the thread of its BotRunnable.
+ */
+class Bot : public ACE_Event_Handler
+{
+    public:
+        Bot(BotRunnable& owner, BotConfig const& config, uint32 index, std::string const& account, std::string const& password, bool monitor);
+        virtual ~Bot();
+
+        /// Timers, behaviour and request timeouts, now in microseconds
+        void Update(uint64 now);
+
+        /// Leave the world and don't log in again
+        void Stop();
+
+        BotState GetState() const { return m_State; }
+
+        /// ACE_Event_Handler
+        virtual ACE_HANDLE get_handle() const;
+        virtual int handle_input(ACE_HANDLE = ACE_INVALID_HANDLE);
+        virtual int handle_output(ACE_HANDLE = ACE_INVALID_HANDLE);
+        virtual int handle_close(ACE_HANDLE = ACE_INVALID_HANDLE, ACE_Reactor_Mask = ACE_Event_Handler::ALL_EVENTS_MASK);
+
+    private:
+        /// A request waiting for its answer
+        struct PendingRequest
+        {
+            BotRequest request;
+            uint16 response;                                // opcode or realm command that answers it
+            uint32 param;                                   // spell of casts
+            uint64 sentTime;
+        };
+
+        typedef std::deque<PendingRequest> PendingRequests;
+
+        // connection
+        bool Connect(std::string const& address, uint16 port, BotState state);
+        void CloseConnection();
+        void Fail(char const* reason);
+        void Send(uint8 const* data, size_t size);
+        int FlushOutput();
+        void SetState(BotState state);
+
+        // realmd
+        void SendLogonChallenge();
+        bool HandleRealmInput();
+        bool HandleLogonChallenge();
+        bool HandleLogonProof();
+        bool HandleRealmList();
+
+        // mangosd
+        void SendPacket(uint16 opcode, ByteBuffer const& data);
+        bool HandleWorldInput();
+        bool HandlePacket(uint16 opcode, ByteBuffer& data);
+        void HandleAuthChallenge(ByteBuffer& data);
+        void HandleAuthResponse(ByteBuffer& data);
+        void HandleCharEnum(ByteBuffer& data);
+        void HandleCharCreate(ByteBuffer& data);
+        void HandleLoginVerifyWorld(ByteBuffer& data);
+        void HandleMessageChat(ByteBuffer& data);
+        void HandleCastResult(ByteBuffer& data);
+        void EnterWorld();
+
+        // behaviour
+        void UpdateMovement(uint64 now);
+        void SendMovement(uint16 opcode, uint64 now);
+        void SendChat(char const* text);
+        void SendCastSpell();
+        void SendWho();
+        void SendAuctionSearch();
+        void SendPing();
+        uint64 NextTime(uint64 now, uint32 interval) const;
+
+        // round trips
+        void AddRequest(BotRequest request, uint16 response, uint32 param = 0);
+        bool CompleteRequest(uint16 response, uint32 param = 0);
+        void ExpireRequests(uint64 now);
+
+        BotRunnable& m_Owner;
+        BotConfig const& m_Config;
+        uint32 m_Index;
+        std::string m_Account;                              // upper case, as sent by the client
+        std::string m_Password;
+        bool m_Monitor;                                     // reports the server performance statistics
+
+        BotState m_State;
+        uint64 m_StateTime;                                 // timeouts of the login steps start here
+        uint64 m_RetryTime;
+        uint32 m_Attempts;
+
+        ACE_SOCK_Stream m_Peer;
+        bool m_Registered;
+        bool m_Connecting;
+        std::vector<uint8> m_InBuffer;
+        std::vector<uint8> m_OutBuffer;
+        bool m_OutActive;                                   // registered for output
+
+        // SRP6
+        BigNumber* m_A;
+        BigNumber* m_M;
+        BigNumber* m_K;
+        std::string m_WorldAddress;
+        uint16 m_WorldPort;
+
+        BotCrypt m_Crypt;
+        bool m_HeaderDecrypted;                             // the header in m_InBuffer was already decrypted
+        uint32 m_Seed;
+
+        // character
+        uint64 m_Guid;
+        std::string m_Name;
+        uint32 m_MapId;
+        float m_HomeX, m_HomeY;
+        float m_X, m_Y, m_Z, m_O;
+        uint32 m_MoveFlags;
+        uint64 m_MoveStartTime;
+        uint64 m_LastMoveUpdate;
+        uint32 m_ChatCounter;
+
+        // behaviour timers, microseconds
+        uint64 m_NextMove;
+        uint64 m_NextHeartbeat;
+        uint64 m_NextChat;
+        uint64 m_NextCast;
+        uint64 m_NextWho;
+        uint64 m_NextAuction;
+        uint64 m_NextPing;
+        uint64 m_NextReport;
+        uint32 m_PingCounter;
+
+        PendingRequests m_Requests;
+};
+
+#endif
+/// @}
@@ -0,0 +1,405 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup loadbot
+*/
+
+#include "BotMgr.h"
+#include "Bot.h"
+#include "Config/Config.h"
+#include "Log.h"
+#include "Policies/Singleton.h"
+
+#include <ace/ACE.h>
+#include <ace/OS_NS_unistd.h>
+#include <ace/High_Res_Timer.h>
+#include <ace/Reactor.h>
+#include <ace/Reactor_Impl.h>
+#include <ace/TP_Reactor.h>
+#include <ace/Dev_Poll_Reactor.h>
+
+INSTANTIATE_SINGLETON_1(BotMgr);
+
+#define BOT_MONITOR_INDEX       (26 * 26 * 26 * 26 * 26 - 1) // character name suffix "zzzzz", out of the range of the bots
+#define BOT_PUBLISH_INTERVAL    1000000                     // microseconds between the stats updates of a thread
+
+BotRunnable::BotRunnable() :
+    m_Reactor(NULL), m_ThreadId(-1), m_Bots(0), m_BotsInWorld(0), m_NextPublish(0)
+{
+    ACE_Reactor_Impl* imp = 0;
+
+#if defined (ACE_HAS_EVENT_POLL) || defined (ACE_HAS_DEV_POLL)
+
+    imp = new ACE_Dev_Poll_Reactor();
+
+    imp->max_notify_iterations(128);
+    imp->restart(1);
+
+#else
+
+    imp = new ACE_TP_Reactor();
+    imp->max_notify_iterations(128);
+
+#endif
+
+    m_Reactor = new ACE_Reactor(imp, 1);
+}
+
+BotRunnable::~BotRunnable()
+{
+    Stop();
+    Wait();
+
+    // bots the thread never took
+    for (BotList::const_iterator itr = m_NewBots.begin(); itr != m_NewBots.end(); ++itr)
+        delete *itr;
+
+    delete m_Reactor;
+}
+
+int BotRunnable::Start()
+{
+    if (m_ThreadId != -1)
+        return -1;
+
+    return (m_ThreadId = activate());
+}
+
+void BotRunnable::Stop()
+{
+    m_Reactor->end_reactor_event_loop();
+}
+
+void BotRunnable::AddBot(Bot* bot)
+{
+    ACE_GUARD(ACE_Thread_Mutex, Guard, m_NewBotsLock);
+
+    ++m_Bots;
+    m_NewBots.push_back(bot);
+}
+
+void BotRunnable::AddNewBots()
+{
+    ACE_GUARD(ACE_Thread_Mutex, Guard, m_NewBotsLock);
+
+    if (m_NewBots.empty())
+        return;
+
+    m_BotList.insert(m_BotList.end(), m_NewBots.begin(), m_NewBots.end());
+    m_NewBots.clear();
+}
+
+void BotRunnable::PublishStats()
+{
+    long inWorld = 0;
+    for (BotList::const_iterator itr = m_BotList.begin(); itr != m_BotList.end(); ++itr)
+        if ((*itr)->GetState() == BOT_STATE_IN_WORLD)
+            ++inWorld;
+
+    m_BotsInWorld = inWorld;
+
+    ACE_GUARD(ACE_Thread_Mutex, Guard, m_StatsLock);
+
+    m_SharedStats.Merge(m_Stats);
+    m_Stats.Reset();
+}
+
+void BotRunnable::CollectStats(BotStats& stats)
+{
+    ACE_GUARD(ACE_Thread_Mutex, Guard, m_StatsLock);
+
+    stats.Merge(m_SharedStats);
+    m_SharedStats.Reset();
+}
+
+void BotRunnable::AddServerReport(std::string const& line)
+{
+    ACE_GUARD(ACE_Thread_Mutex, Guard, m_StatsLock);
+
+    m_ServerReport.push_back(line);
+}
+
+void BotRunnable::CollectServerReport(std::vector<std::string>& lines)
+{
+    ACE_GUARD(ACE_Thread_Mutex, Guard, m_StatsLock);
+
+    lines.insert(lines.end(), m_ServerReport.begin(), m_ServerReport.end());
+    m_ServerReport.clear();
+}
+
+int BotRunnable::svc()
+{
+    DEBUG_LOG("Bot Thread Starting");
+
+    MANGOS_ASSERT(m_Reactor);
+
+    while (!m_Reactor->reactor_event_loop_done())
+    {
+        // the run_reactor_event_loop will modify interval
+        ACE_Time_Value interval(0, 10000);
+
+        if (m_Reactor->run_reactor_event_loop(interval) == -1)
+            break;
+
+        AddNewBots();
+
+        uint64 now = BotMgr::GetMicroTime();
+        for (BotList::const_iterator itr = m_BotList.begin(); itr != m_BotList.end(); ++itr)
+            (*itr)->Update(now);
+
+        if (now >= m_NextPublish)
+        {
+            PublishStats();
+            m_NextPublish = now + BOT_PUBLISH_INTERVAL;
+        }
+    }
+
+    for (BotList::const_iterator itr = m_BotList.begin(); itr != m_BotList.end(); ++itr)
+    {
+        (*itr)->Stop();
+        delete *itr;
+    }
+
+    m_BotList.clear();
+    PublishStats();
+
+    DEBUG_LOG("Bot Thread Exitting");
+
+    return 0;
+}
+
+BotMgr::BotMgr() :
+    m_Threads(NULL), m_ThreadCount(0), m_Started(0), m_StartTime(0), m_LastReport(0)
+{
+}
+
+BotMgr::~BotMgr()
+{
+    delete[] m_Threads;
+}
+
+uint64 BotMgr::GetMicroTime()
+{
+    ACE_Time_Value now = ACE_High_Res_Timer::gettimeofday_hr();
+
+    uint64 usec;
+    now.to_usec(usec);
+    return usec;
+}
+
+void BotMgr::LoadConfig()
+{
+    m_Config.realmAddress = sConfig.GetStringDefault("Realm.Address", "127.0.0.1");
+    m_Config.realmPort = uint16(sConfig.GetIntDefault("Realm.Port", 3724));
+    m_Config.realmName = sConfig.GetStringDefault("Realm.Name", "");
+    m_Config.worldAddress = sConfig.GetStringDefault("World.Address", "");
+
+    m_Config.build = sConfig.GetIntDefault("Client.Build", 5875);
+    m_Config.accountPrefix = sConfig.GetStringDefault("Account.Prefix", "BOT");
+    m_Config.password = sConfig.GetStringDefault("Account.Password", "BOT");
+    m_Config.firstIndex = sConfig.GetIntDefault("Account.First", 1);
+    m_Config.count = sConfig.GetIntDefault("Bots.Count", 500);
+    m_Config.namePrefix = sConfig.GetStringDefault("Character.NamePrefix", "Bot");
+    m_Config.race = uint8(sConfig.GetIntDefault("Character.Race", 1));
+    m_Config.class_ = uint8(sConfig.GetIntDefault("Character.Class", 8));
+
+    m_Config.threads = sConfig.GetIntDefault("Bots.Threads", 4);
+    m_Config.loginRate = sConfig.GetIntDefault("Bots.LoginRate", 20);
+    m_Config.reconnectDelay = sConfig.GetIntDefault("Bots.ReconnectDelay", 5000);
+    m_Config.requestTimeout = sConfig.GetIntDefault("Bots.RequestTimeout", 30000);
+
+    m_Config.moveInterval = sConfig.GetIntDefault("Behaviour.MoveInterval", 5000);
+    m_Config.moveTime = sConfig.GetIntDefault("Behaviour.MoveTime", 3000);
+    m_Config.moveRadius = sConfig.GetFloatDefault("Behaviour.MoveRadius", 20.0f);
+    m_Config.chatInterval = sConfig.GetIntDefault("Behaviour.ChatInterval", 30000);
+    m_Config.castInterval = sConfig.GetIntDefault("Behaviour.CastInterval", 15000);
+    m_Config.castSpell = sConfig.GetIntDefault("Behaviour.CastSpell", 168);
+    m_Config.whoInterval = sConfig.GetIntDefault("Behaviour.WhoInterval", 60000);
+    m_Config.auctionInterval = sConfig.GetIntDefault("Behaviour.AuctionInterval", 0);
+
+    m_Config.monitorAccount = sConfig.GetStringDefault("Monitor.Account", "");
+    m_Config.monitorPassword = sConfig.GetStringDefault("Monitor.Password", "");
+
+    m_Config.reportInterval = sConfig.GetIntDefault("Report.Interval", 10);
+    m_Config.duration = sConfig.GetIntDefault("Run.Duration", 0);
+
+    // the client sends account and password in upper case
+    std::transform(m_Config.accountPrefix.begin(), m_Config.accountPrefix.end(), m_Config.accountPrefix.begin(), ::toupper);
+    std::transform(m_Config.password.begin(), m_Config.password.end(), m_Config.password.begin(), ::toupper);
+    std::transform(m_Config.monitorAccount.begin(), m_Config.monitorAccount.end(), m_Config.monitorAccount.begin(), ::toupper);
+    std::transform(m_Config.monitorPassword.begin(), m_Config.monitorPassword.end(), m_Config.monitorPassword.begin(), ::toupper);
+
+    if (!m_Config.threads)
+        m_Config.threads = 1;
+
+    if (!m_Config.reportInterval)
+        m_Config.reportInterval = 10;
+
+    if (!m_Config.requestTimeout)
+        m_Config.requestTimeout = 30000;
+
+    if (m_Config.firstIndex + m_Config.count >= BOT_MONITOR_INDEX)
+    {
+        sLog.outError("Account.First + Bots.Count must be below %u, reduced.", BOT_MONITOR_INDEX);
+        m_Config.count = m_Config.firstIndex < BOT_MONITOR_INDEX ? BOT_MONITOR_INDEX - m_Config.firstIndex - 1 : 0;
+    }
+}
+
+bool BotMgr::Initialize(uint32 count)
+{
+    LoadConfig();
+
+    if (count)
+        m_Config.count = count;
+
+    if (!m_Config.count)
+    {
+        sLog.outError("No bots to start, Bots.Count is 0.");
+        return false;
+    }
+
+    // every bot has one socket open at a time
+    ACE::set_handle_limit();
+    if (uint32(ACE::max_handles()) < m_Config.count + 32)
+        sLog.outError("Only %d open files allowed, not enough for %u bots. Raise the limit with ulimit -n.", ACE::max_handles(), m_Config.count);
+
+    m_ThreadCount = std::min(m_Config.threads, m_Config.count);
+    m_Threads = new BotRunnable[m_ThreadCount];
+
+    for (uint32 i = 0; i < m_ThreadCount; ++i)
+    {
+        if (m_Threads[i].Start() == -1)
+        {
+            sLog.outError("Can't start bot thread %u.", i);
+            return false;
+        }
+    }
+
+    sLog.outString("Starting %u bots in %u threads, %u logins per second, against %s:%u.",
+                   m_Config.count, m_ThreadCount, m_Config.loginRate, m_Config.realmAddress.c_str(), m_Config.realmPort);
+
+    if (!m_Config.monitorAccount.empty())
+    {
+        m_Threads[0].AddBot(new Bot(m_Threads[0], m_Config, BOT_MONITOR_INDEX, m_Config.monitorAccount, m_Config.monitorPassword, true));
+        sLog.outString("Server statistics are requested by account %s.", m_Config.monitorAccount.c_str());
+    }
+
+    return true;
+}
+
+void BotMgr::StartBots(uint64 now)
+{
+    uint32 target = m_Config.count;
+    if (m_Config.loginRate)
+        target = std::min(target, uint32((now - m_StartTime) * m_Config.loginRate / 1000000) + 1);
+
+    for (; m_Started < target; ++m_Started)
+    {
+        uint32 index = m_Config.firstIndex + m_Started;
+
+        char account[32];
+        snprintf(account, sizeof(account), "%s%u", m_Config.accountPrefix.c_str(), index);
+
+        BotRunnable& thread = m_Threads[m_Started % m_ThreadCount];
+        thread.AddBot(new Bot(thread, m_Config, index, account, m_Config.password, false));
+    }
+}
+
+void BotMgr::Run(bool const& stopEvent)
+{
+    m_StartTime = GetMicroTime();
+    m_LastReport = m_StartTime;
+
+    uint64 reportInterval = uint64(m_Config.reportInterval) * 1000000;
+    uint64 duration = uint64(m_Config.duration) * 1000000;
+
+    while (!stopEvent)
+    {
+        uint64 now = GetMicroTime();
+
+        StartBots(now);
+
+        if (now >= m_LastReport + reportInterval)
+            Report(false, now);
+
+        if (duration && now >= m_StartTime + duration)
+            break;
+
+        ACE_OS::sleep(ACE_Time_Value(0, 100000));
+    }
+
+    for (uint32 i = 0; i < m_ThreadCount; ++i)
+        m_Threads[i].Stop();
+
+    for (uint32 i = 0; i < m_ThreadCount; ++i)
+        m_Threads[i].Wait();
+
+    Report(true, GetMicroTime());
+}
+
+void BotMgr::Report(bool final, uint64 now)
+{
+    long bots = 0;
+    long inWorld = 0;
+    std::vector<std::string> serverLines;
+
+    for (uint32 i = 0; i < m_ThreadCount; ++i)
+    {
+        m_Threads[i].CollectStats(m_IntervalStats);
+        m_Threads[i].CollectServerReport(serverLines);
+        bots += m_Threads[i].Bots();
+        inWorld += m_Threads[i].BotsInWorld();
+    }
+
+    std::vector<std::string> lines;
+
+    uint32 seconds = uint32((now - m_LastReport + 500000) / 1000000);
+    uint32 elapsed = uint32((now - m_StartTime) / 1000000);
+    m_LastReport = now;
+
+    m_TotalStats.Merge(m_IntervalStats);
+
+    if (!final)
+    {
+        char buf[128];
+        snprintf(buf, sizeof(buf), "=== %u s: %ld bots started, %ld in the world, last %u s ===", elapsed, bots, inWorld, seconds);
+        lines.push_back(buf);
+
+        BuildBotReport(lines, m_IntervalStats, seconds);
+    }
+    else
+    {
+        char buf[128];
+        snprintf(buf, sizeof(buf), "=== Total of %u s with %ld bots ===", elapsed, bots);
+        lines.push_back(buf);
+
+        BuildBotReport(lines, m_TotalStats, elapsed);
+    }
+
+    m_IntervalStats.Reset();
+
+    if (!serverLines.empty())
+    {
+        lines.push_back("Server:");
+        lines.insert(lines.end(), serverLines.begin(), serverLines.end());
+    }
+
+    for (std::vector<std::string>::const_iterator itr = lines.begin(); itr != lines.end(); ++itr)
+        sLog.outString("%s", itr->c_str());
+}
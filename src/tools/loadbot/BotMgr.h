@@ -0,0 +1,171 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup loadbot
+/// @{
+/// \file
+
+#ifndef MANGOS_BOTMGR_H
+#define MANGOS_BOTMGR_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "BotStats.h"
+
+#include <ace/Task.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Atomic_Op.h>
+
+#include <string>
+#include <vector>
+
+class ACE_Reactor;
+class Bot;
+
+/// Settings of loadbot.conf shared by all bots
+struct BotConfig
+{
+    std::string realmAddress;
+    uint16 realmPort;
+    std::string realmName;                                  // empty for the first realm of the list
+    std::string worldAddress;                               // overrides the address of the realm list
+
+    uint32 build;
+    std::string accountPrefix;
+    std::string password;
+    uint32 firstIndex;
+    uint32 count;
+    std::string namePrefix;
+    uint8 race;
+    uint8 class_;
+
+    uint32 threads;
+    uint32 loginRate;                                       // login attempts per second
+    uint32 reconnectDelay;                                  // milliseconds, 0 to not reconnect
+    uint32 requestTimeout;                                  // milliseconds
+
+    uint32 moveInterval;                                    // milliseconds between walks, 0 disables
+    uint32 moveTime;                                        // milliseconds of a walk
+    float moveRadius;
+    uint32 chatInterval;
+    uint32 castInterval;
+    uint32 castSpell;
+    uint32 whoInterval;
+    uint32 auctionInterval;
+
+    std::string monitorAccount;
+    std::string monitorPassword;
+
+    uint32 reportInterval;                                  // seconds
+    uint32 duration;                                        // seconds, 0 until stopped
+};
+
+/// Thread running a group of bots on its own reactor
+class BotRunnable : protected ACE_Task_Base
+{
+    public:
+        BotRunnable();
+        virtual ~BotRunnable();
+
+        int Start();
+        void Stop();
+        void Wait() { ACE_Task_Base::wait(); }
+
+        ACE_Reactor* GetReactor() { return m_Reactor; }
+
+        /// Hand a new bot to the thread, it is deleted by the thread
+        void AddBot(Bot* bot);
+        long Bots() { return static_cast<long>(m_Bots.value()); }
+        long BotsInWorld() { return static_cast<long>(m_BotsInWorld.value()); }
+
+        /// Counters of the bots, only used by the thread
+        BotStats& GetStats() { return m_Stats; }
+
+        /// Move the counters collected since the last call to stats
+        void CollectStats(BotStats& stats);
+
+        /// Report lines of the monitor bot, taken by BotMgr
+        void AddServerReport(std::string const& line);
+        void CollectServerReport(std::vector<std::string>& lines);
+
+    protected:
+        virtual int svc();
+
+    private:
+        typedef std::vector<Bot*> BotList;
+        typedef ACE_Atomic_Op<ACE_Thread_Mutex, long> AtomicInt;
+
+        void AddNewBots();
+        void PublishStats();
+
+        ACE_Reactor* m_Reactor;
+        int m_ThreadId;
+
+        AtomicInt m_Bots;
+        AtomicInt m_BotsInWorld;                            // counted by PublishStats
+        uint64 m_NextPublish;
+
+        BotList m_BotList;
+        BotList m_NewBots;
+        ACE_Thread_Mutex m_NewBotsLock;
+
+        BotStats m_Stats;
+        BotStats m_SharedStats;                             // published by the thread for CollectStats
+        std::vector<std::string> m_ServerReport;
+        ACE_Thread_Mutex m_StatsLock;
+};
+
+/// Starts the bots at the login rate and prints the reports
+class BotMgr
+{
+    public:
+        BotMgr();
+        ~BotMgr();
+
+        /// Start the threads, count overrides Bots.Count when not 0
+        bool Initialize(uint32 count);
+        void Run(bool const& stopEvent);
+
+        BotConfig const& GetConfig() const { return m_Config; }
+
+        /// Microseconds of a monotonic clock
+        static uint64 GetMicroTime();
+
+        /// Read the settings, also done by Initialize
+        void LoadConfig();
+
+    private:
+        void StartBots(uint64 now);
+        void Report(bool final, uint64 now);
+
+        BotConfig m_Config;
+
+        BotRunnable* m_Threads;
+        uint32 m_ThreadCount;
+        uint32 m_Started;                                   // bots handed to the threads
+
+        uint64 m_StartTime;
+        uint64 m_LastReport;
+        BotStats m_IntervalStats;
+        BotStats m_TotalStats;
+};
+
+#define sBotMgr MaNGOS::Singleton<BotMgr>::Instance()
+
+#endif
+/// @}
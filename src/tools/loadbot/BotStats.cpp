@@ -0,0 +1,175 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup loadbot
+*/
+
+#include "BotStats.h"
+
+static char const* const botRequestNames[MAX_BOT_REQUESTS] =
+{
+    "realm login",
+    "realm list",
+    "CMSG_AUTH_SESSION",
+    "CMSG_CHAR_ENUM",
+    "CMSG_CHAR_CREATE",
+    "CMSG_PLAYER_LOGIN",
+    "CMSG_PING",
+    "CMSG_MESSAGECHAT",
+    "CMSG_CAST_SPELL",
+    "CMSG_WHO",
+    "CMSG_AUCTION_LIST_ITEMS",
+};
+
+char const* GetBotRequestName(BotRequest request)
+{
+    return request < MAX_BOT_REQUESTS ? botRequestNames[request] : "<unknown>";
+}
+
+uint32 BotLatency::GetBucket(uint32 time)
+{
+    if (time < BOT_LATENCY_LINEAR)
+        return time;
+
+    uint32 exponent = 4;
+    while (exponent < 31 && (time >> (exponent + 1)))
+        ++exponent;
+
+    uint32 sub = (time >> (exponent - 3)) & (BOT_LATENCY_SUBBUCKETS - 1);
+    return BOT_LATENCY_LINEAR + (exponent - 4) * BOT_LATENCY_SUBBUCKETS + sub;
+}
+
+uint32 BotLatency::GetBucketBound(uint32 bucket)
+{
+    if (bucket < BOT_LATENCY_LINEAR)
+        return bucket;
+
+    uint32 exponent = (bucket - BOT_LATENCY_LINEAR) / BOT_LATENCY_SUBBUCKETS + 4;
+    uint32 sub = (bucket - BOT_LATENCY_LINEAR) % BOT_LATENCY_SUBBUCKETS;
+
+    // highest value that still falls into the bucket
+    uint64 bound = (uint64(BOT_LATENCY_SUBBUCKETS + sub + 1) << (exponent - 3)) - 1;
+    return bound > 0xFFFFFFFF ? 0xFFFFFFFF : uint32(bound);
+}
+
+void BotLatency::Add(uint32 time)
+{
+    ++m_buckets[GetBucket(time)];
+    ++m_count;
+    m_total += time;
+    if (time > m_max)
+        m_max = time;
+}
+
+void BotLatency::Merge(BotLatency const& other)
+{
+    for (uint32 i = 0; i < BOT_LATENCY_BUCKETS; ++i)
+        m_buckets[i] += other.m_buckets[i];
+
+    m_count += other.m_count;
+    m_timeouts += other.m_timeouts;
+    m_total += other.m_total;
+    if (other.m_max > m_max)
+        m_max = other.m_max;
+}
+
+void BotLatency::Reset()
+{
+    memset(m_buckets, 0, sizeof(m_buckets));
+    m_count = 0;
+    m_timeouts = 0;
+    m_max = 0;
+    m_total = 0;
+}
+
+uint32 BotLatency::GetPercentile(uint32 percent) const
+{
+    if (!m_count)
+        return 0;
+
+    uint32 needed = uint32((uint64(m_count) * percent + 99) / 100);
+    uint32 found = 0;
+    for (uint32 bucket = 0; bucket < BOT_LATENCY_BUCKETS; ++bucket)
+    {
+        found += m_buckets[bucket];
+        if (found >= needed)
+            return std::min(GetBucketBound(bucket), m_max);
+    }
+
+    return m_max;
+}
+
+void BotStats::Merge(BotStats const& other)
+{
+    for (uint32 i = 0; i < MAX_BOT_REQUESTS; ++i)
+        requests[i].Merge(other.requests[i]);
+
+    sentPackets += other.sentPackets;
+    sentBytes += other.sentBytes;
+    recvPackets += other.recvPackets;
+    recvBytes += other.recvBytes;
+    logins += other.logins;
+    failures += other.failures;
+    disconnects += other.disconnects;
+}
+
+void BotStats::Reset()
+{
+    for (uint32 i = 0; i < MAX_BOT_REQUESTS; ++i)
+        requests[i].Reset();
+
+    sentPackets = 0;
+    sentBytes = 0;
+    recvPackets = 0;
+    recvBytes = 0;
+    logins = 0;
+    failures = 0;
+    disconnects = 0;
+}
+
+void BuildBotReport(std::vector<std::string>& lines, BotStats const& stats, uint32 seconds)
+{
+    char buf[256];
+
+    if (!seconds)
+        seconds = 1;
+
+    snprintf(buf, sizeof(buf), "Logins: %u entered the world, %u failed, %u disconnects",
+             stats.logins, stats.failures, stats.disconnects);
+    lines.push_back(buf);
+
+    snprintf(buf, sizeof(buf), "Traffic: sent %u packets/s %u KB/s, received %u packets/s %u KB/s",
+             uint32(stats.sentPackets / seconds), uint32(stats.sentBytes / seconds / 1024),
+             uint32(stats.recvPackets / seconds), uint32(stats.recvBytes / seconds / 1024));
+    lines.push_back(buf);
+
+    lines.push_back("  request                    count  timeouts      avg      p50      p90      p99      max  (ms)");
+    for (uint32 i = 0; i < MAX_BOT_REQUESTS; ++i)
+    {
+        BotLatency const& latency = stats.requests[i];
+        if (!latency.GetCount() && !latency.GetTimeouts())
+            continue;
+
+        snprintf(buf, sizeof(buf), "  %-24s %8u %9u %8.1f %8.1f %8.1f %8.1f %8.1f", GetBotRequestName(BotRequest(i)),
+                 latency.GetCount(), latency.GetTimeouts(), latency.GetAverage() / 1000.0f,
+                 latency.GetPercentile(50) / 1000.0f, latency.GetPercentile(90) / 1000.0f,
+                 latency.GetPercentile(99) / 1000.0f, latency.GetMax() / 1000.0f);
+        lines.push_back(buf);
+    }
+}
@@ -0,0 +1,106 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup loadbot
+/// @{
+/// \file
+
+#ifndef MANGOS_BOTSTATS_H
+#define MANGOS_BOTSTATS_H
+
+#include "Common.h"
+
+#include <string>
+#include <vector>
+
+/// Requests whose round trip is measured, a request is answered by one known server opcode
+enum BotRequest
+{
+    BOT_REQ_REALM_LOGIN,                                    // logon challenge until the proof answer
+    BOT_REQ_REALM_LIST,
+    BOT_REQ_AUTH_SESSION,
+    BOT_REQ_CHAR_ENUM,
+    BOT_REQ_CHAR_CREATE,
+    BOT_REQ_PLAYER_LOGIN,
+    BOT_REQ_PING,
+    BOT_REQ_CHAT,
+    BOT_REQ_CAST,
+    BOT_REQ_WHO,
+    BOT_REQ_AUCTION,
+    MAX_BOT_REQUESTS
+};
+
+char const* GetBotRequestName(BotRequest request);
+
+#define BOT_LATENCY_LINEAR      16                          // exact buckets for the smallest values
+#define BOT_LATENCY_SUBBUCKETS  8                           // buckets per power of two above, 12.5% precision
+#define BOT_LATENCY_BUCKETS     (BOT_LATENCY_LINEAR + (32 - 4) * BOT_LATENCY_SUBBUCKETS)
+
+/// Round trip times of one request kind in microseconds, log-linear buckets
+class BotLatency
+{
+    public:
+        BotLatency() { Reset(); }
+
+        void Add(uint32 time);
+        void AddTimeout() { ++m_timeouts; }
+        void Merge(BotLatency const& other);
+        void Reset();
+
+        uint32 GetCount() const { return m_count; }
+        uint32 GetTimeouts() const { return m_timeouts; }
+        uint32 GetMax() const { return m_max; }
+        uint32 GetAverage() const { return m_count ? uint32(m_total / m_count) : 0; }
+        uint32 GetPercentile(uint32 percent) const;
+
+    private:
+        static uint32 GetBucket(uint32 time);
+        static uint32 GetBucketBound(uint32 bucket);
+
+        uint32 m_buckets[BOT_LATENCY_BUCKETS];
+        uint32 m_count;
+        uint32 m_timeouts;
+        uint32 m_max;
+        uint64 m_total;
+};
+
+/// Counters of a group of bots, collected by their thread and merged for the report
+struct BotStats
+{
+    BotStats() { Reset(); }
+
+    void Merge(BotStats const& other);
+    void Reset();
+
+    BotLatency requests[MAX_BOT_REQUESTS];
+
+    uint64 sentPackets;
+    uint64 sentBytes;
+    uint64 recvPackets;
+    uint64 recvBytes;
+
+    uint32 logins;                                          // characters that entered the world
+    uint32 failures;                                        // login attempts that failed
+    uint32 disconnects;                                     // connections lost in the world
+};
+
+/// Report lines of the stats, seconds is the time they were collected in
+void BuildBotReport(std::vector<std::string>& lines, BotStats const& stats, uint32 seconds);
+
+#endif
+/// @}
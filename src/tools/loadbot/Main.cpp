@@ -0,0 +1,213 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup loadbot Load generator
+/// @{
+/// \file
+
+#include "Common.h"
+#include "BotMgr.h"
+
+#include "Config/Config.h"
+#include "Log.h"
+#include "SystemConfig.h"
+#include "revision.h"
+#include "revision_nr.h"
+#include "Util.h"
+#include "Auth/Sha1.h"
+
+#include <ace/Get_Opt.h>
+
+void UnhookSignals();
+void HookSignals();
+
+bool stopEvent = false;                                     ///< Setting it to true stops the bots
+
+/// Print out the usage string for this program on the console.
+void usage(const char* prog)
+{
+    sLog.outString("Usage: \n %s [<options>]\n"
+                   "    -v, --version            print version and exit\n\r"
+                   "    -c config_file           use config_file as configuration file\n\r"
+                   "    -n count                 number of bots, overrides Bots.Count\n\r"
+                   "    -a                       print the SQL creating the bot accounts and exit\n\r"
+                   , prog);
+}
+
+/// Print the statements creating the accounts of the bots, the same way as AccountMgr::CreateAccount
+void PrintAccountsSql(BotConfig const& config)
+{
+    printf("-- accounts %s%u to %s%u, password %s\n", config.accountPrefix.c_str(), config.firstIndex,
+           config.accountPrefix.c_str(), config.firstIndex + config.count - 1, config.password.c_str());
+
+    for (uint32 i = 0; i < config.count; ++i)
+    {
+        char account[32];
+        snprintf(account, sizeof(account), "%s%u", config.accountPrefix.c_str(), config.firstIndex + i);
+
+        Sha1Hash sha;
+        sha.UpdateData(account);
+        sha.UpdateData(":");
+        sha.UpdateData(config.password);
+        sha.Finalize();
+
+        std::string hash;
+        hexEncodeByteArray(sha.GetDigest(), sha.GetLength(), hash);
+
+        printf("INSERT IGNORE INTO account(username,sha_pass_hash,joindate) VALUES('%s','%s',NOW());\n", account, hash.c_str());
+    }
+
+    printf("INSERT INTO realmcharacters (realmid, acctid, numchars) SELECT realmlist.id, account.id, 0 FROM realmlist,account LEFT JOIN realmcharacters ON acctid=account.id WHERE acctid IS NULL;\n");
+}
+
+/// Launch the load generator
+extern int main(int argc, char** argv)
+{
+    ///- Command line parsing
+    char const* cfg_file = _LOADBOT_CONFIG;
+
+    char const* options = ":c:n:a";
+
+    ACE_Get_Opt cmd_opts(argc, argv, options);
+    cmd_opts.long_option("version", 'v');
+
+    uint32 count = 0;
+    bool printSql = false;
+
+    int option;
+    while ((option = cmd_opts()) != EOF)
+    {
+        switch (option)
+        {
+            case 'c':
+                cfg_file = cmd_opts.opt_arg();
+                break;
+            case 'n':
+                count = atoi(cmd_opts.opt_arg());
+                break;
+            case 'a':
+                printSql = true;
+                break;
+            case 'v':
+                printf("%s\n", _FULLVERSION(REVISION_DATE, REVISION_TIME, REVISION_NR, REVISION_ID));
+                return 0;
+            case ':':
+                sLog.outError("Runtime-Error: -%c option requires an input argument", cmd_opts.opt_opt());
+                usage(argv[0]);
+                return 1;
+            default:
+                sLog.outError("Runtime-Error: bad format of commandline arguments");
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (!sConfig.SetSource(cfg_file))
+    {
+        sLog.outError("Could not find configuration file %s.", cfg_file);
+        return 1;
+    }
+
+    if (printSql)
+    {
+        sBotMgr.LoadConfig();
+
+        BotConfig config = sBotMgr.GetConfig();
+        if (count)
+            config.count = count;
+
+        PrintAccountsSql(config);
+        return 0;
+    }
+
+    sLog.Initialize();
+
+    sLog.outString("%s [load generator]", _FULLVERSION(REVISION_DATE, REVISION_TIME, REVISION_NR, REVISION_ID));
+    sLog.outString("<Ctrl-C> to stop.\n");
+    sLog.outString("Using configuration file %s.", cfg_file);
+
+    ///- Check the version of the configuration file
+    uint32 confVersion = sConfig.GetIntDefault("ConfVersion", 0);
+    if (confVersion < _LOADBOTCONFVERSION)
+    {
+        sLog.outError("*****************************************************************************");
+        sLog.outError(" WARNING: Your loadbot.conf version indicates your conf file is out of date!");
+        sLog.outError("          Please check for updates, as your current default values may cause");
+        sLog.outError("          strange behavior.");
+        sLog.outError("*****************************************************************************");
+    }
+
+    DETAIL_LOG("Using ACE: %s", ACE_VERSION);
+
+    if (!sBotMgr.Initialize(count))
+        return 1;
+
+    ///- Catch termination signals
+    HookSignals();
+
+    ///- Run until the duration of the test passed or a termination signal
+    sBotMgr.Run(stopEvent);
+
+    ///- Remove signal handling before leaving
+    UnhookSignals();
+
+    sLog.outString("Halting process...");
+    return 0;
+}
+
+/// Handle termination signals
+/** Put the global variable stopEvent to 'true' if a termination signal is caught **/
+void OnSignal(int s)
+{
+    switch (s)
+    {
+        case SIGINT:
+        case SIGTERM:
+            stopEvent = true;
+            break;
+#ifdef _WIN32
+        case SIGBREAK:
+            stopEvent = true;
+            break;
+#endif
+    }
+
+    signal(s, OnSignal);
+}
+
+/// Define hook 'OnSignal' for all termination signals
+void HookSignals()
+{
+    signal(SIGINT, OnSignal);
+    signal(SIGTERM, OnSignal);
+#ifdef _WIN32
+    signal(SIGBREAK, OnSignal);
+#endif
+}
+
+/// Unhook the signals before leaving
+void UnhookSignals()
+{
+    signal(SIGINT, 0);
+    signal(SIGTERM, 0);
+#ifdef _WIN32
+    signal(SIGBREAK, 0);
+#endif
+}
+
+/// @}
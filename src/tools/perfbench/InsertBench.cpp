@@ -0,0 +1,99 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup perfbench
+/// @{
+/// \file
+
+
+#include "PerfBench.h"
+#include "Database/DatabaseEnv.h"
+#include "Database/SqlPreparedStatement.h"
+
+namespace
+{
+    /// One save of rows inserted in a transaction, committed like the save queue does
+    void SaveRows(DatabaseType& db, uint32 rows, uint32 save)
+    {
+        db.BeginTransaction();
+
+        {
+            SqlBatchStatement stmt(db, "INSERT INTO perfbench_insert (guid, slot, item, data) VALUES (?, ?, ?, ?)");
+            for (uint32 i = 0; i < rows; ++i)
+                stmt.AddRow(save, i, save * rows + i, "perfbench row");
+        }
+
+        db.CommitTransactionDirect();
+    }
+}
+
+void BenchInsertBatch(BenchOptions const& options)
+{
+    DatabaseType db;
+    if (!db.Initialize(options.database.c_str()))
+    {
+        sLog.outError("insert     can not connect to the database");
+        return;
+    }
+
+    if (!db.DirectExecute("CREATE TABLE IF NOT EXISTS perfbench_insert (guid INT UNSIGNED NOT NULL, slot INT UNSIGNED NOT NULL, "
+                          "item INT UNSIGNED NOT NULL, data VARCHAR(64) NOT NULL, PRIMARY KEY (guid, slot))"))
+    {
+        sLog.outError("insert     can not create the table perfbench_insert");
+        db.HaltDelayThread();
+        return;
+    }
+
+    uint32 const saves = options.GetIterations(200);
+
+    // spells or auras of a save, and a full inventory
+    uint32 const rowCounts[] = { 10, 100 };
+    uint32 const batchRows[] = { 1, 10, 100 };
+
+    for (size_t r = 0; r < countof(rowCounts); ++r)
+    {
+        for (size_t b = 0; b < countof(batchRows); ++b)
+        {
+            db.SetInsertBatchRows(batchRows[b]);
+
+            // the best pass, the first one may also measure the server growing the table
+            uint64 best = 0;
+            for (uint32 pass = 0; pass < options.passes; ++pass)
+            {
+                db.DirectExecute("TRUNCATE TABLE perfbench_insert");
+
+                uint64 start = BenchNow();
+                for (uint32 save = 0; save < saves; ++save)
+                    SaveRows(db, rowCounts[r], save);
+                uint64 elapsed = BenchNow() - start;
+
+                if (!pass || elapsed < best)
+                    best = elapsed;
+            }
+
+            char variant[64];
+            snprintf(variant, sizeof(variant), "%u rows, %u requests", rowCounts[r], (rowCounts[r] + batchRows[b] - 1) / batchRows[b]);
+            PrintBenchResult("insert", variant, uint64(saves) * rowCounts[r], best);
+        }
+    }
+
+    db.DirectExecute("DROP TABLE perfbench_insert");
+    db.HaltDelayThread();
+}
+
+/// @}
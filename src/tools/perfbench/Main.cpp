@@ -0,0 +1,184 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup perfbench Micro benchmarks
+/// @{
+/// \file
+
+#include "Common.h"
+#include "PerfBench.h"
+
+#include "Log.h"
+#include "SystemConfig.h"
+#include "revision.h"
+#include "revision_nr.h"
+
+#include <ace/Get_Opt.h>
+
+volatile uint64 benchSink = 0;
+
+/// A benchmark selectable on the command line
+struct BenchEntry
+{
+    char const* name;
+    BenchFunction* function;
+    bool needsDatabase;
+    char const* description;
+};
+
+static BenchEntry const benchEntries[] =
+{
+    { "field",      &BenchFieldDecode,  false, "decode of a character row, text vs binary fields" },
+    { "query",      &BenchQueryLoad,    true,  "full table reads of the startup loaders, text vs binary protocol" },
+    { "queue",      &BenchRecvQueue,    false, "session receive queue, -t producers and one consumer, LockedQueue vs MPSCQueue" },
+    { "updatemask", &BenchUpdateMask,   false, "values update mask of a player for other players, per field vs block scan" },
+    { "insert",     &BenchInsertBatch,  true,  "save transactions of 10 and 100 rows, single row vs multi-row INSERT requests" },
+    { "results",    &BenchResultQueue,  false, "async query results, -t delay threads and the world thread, per callback lock vs batched drain" },
+};
+
+static BenchEntry const* FindBench(char const* name)
+{
+    for (size_t i = 0; i < countof(benchEntries); ++i)
+        if (strcmp(benchEntries[i].name, name) == 0)
+            return &benchEntries[i];
+
+    return NULL;
+}
+
+void PrintBenchResult(char const* bench, char const* variant, uint64 ops, uint64 elapsedNs)
+{
+    double nsPerOp = ops ? double(elapsedNs) / ops : 0.0;
+    double opsPerSec = elapsedNs ? double(ops) * 1000000000.0 / elapsedNs : 0.0;
+
+    // the width of UI64FMTD can not be given in the format, the count is printed first
+    char opsText[24];
+    snprintf(opsText, sizeof(opsText), UI64FMTD, ops);
+
+    printf("%-10s %-24s %12s ops %12.1f ns/op %14.0f ops/s\n", bench, variant, opsText, nsPerOp, opsPerSec);
+}
+
+/// Print out the usage string for this program on the console.
+void usage(const char* prog)
+{
+    sLog.outString("Usage: \n %s [<options>] [benchmark...]\n"
+                   "    -v, --version            print version and exit\n\r"
+                   "    -l                       list the benchmarks and exit\n\r"
+                   "    -n count                 iterations, default depends on the benchmark\n\r"
+                   "    -t count                 threads of the contention benchmarks (default 4)\n\r"
+                   "    -p count                 runs of the database benchmarks, the best is shown (default 3)\n\r"
+                   "    -d \"host;port;user;password;database\"\n\r"
+                   "                             database of the database benchmarks, they are skipped without\n\r"
+                   "    -q table[,table...]      tables read by the query benchmark\n\r"
+                   , prog);
+}
+
+/// Run the benchmarks
+extern int main(int argc, char** argv)
+{
+    ///- Command line parsing
+    char const* options = ":n:t:p:d:q:l";
+
+    ACE_Get_Opt cmd_opts(argc, argv, options);
+    cmd_opts.long_option("version", 'v');
+
+    BenchOptions benchOptions;
+    bool list = false;
+
+    int option;
+    while ((option = cmd_opts()) != EOF)
+    {
+        switch (option)
+        {
+            case 'n':
+                benchOptions.iterations = atoi(cmd_opts.opt_arg());
+                break;
+            case 't':
+                benchOptions.threads = atoi(cmd_opts.opt_arg());
+                break;
+            case 'p':
+                benchOptions.passes = atoi(cmd_opts.opt_arg());
+                break;
+            case 'd':
+                benchOptions.database = cmd_opts.opt_arg();
+                break;
+            case 'q':
+                benchOptions.tables = cmd_opts.opt_arg();
+                break;
+            case 'l':
+                list = true;
+                break;
+            case 'v':
+                printf("%s\n", _FULLVERSION(REVISION_DATE, REVISION_TIME, REVISION_NR, REVISION_ID));
+                return 0;
+            case ':':
+                sLog.outError("Runtime-Error: -%c option requires an input argument", cmd_opts.opt_opt());
+                usage(argv[0]);
+                return 1;
+            default:
+                sLog.outError("Runtime-Error: bad format of commandline arguments");
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (list)
+    {
+        for (size_t i = 0; i < countof(benchEntries); ++i)
+            printf("%-10s %s%s\n", benchEntries[i].name, benchEntries[i].description, benchEntries[i].needsDatabase ? " (needs -d)" : "");
+        return 0;
+    }
+
+    if (!benchOptions.threads)
+        benchOptions.threads = 1;
+    if (!benchOptions.passes)
+        benchOptions.passes = 1;
+
+    ///- Selected benchmarks, all without names
+    std::vector<BenchEntry const*> selected;
+    for (int i = cmd_opts.opt_ind(); i < argc; ++i)
+    {
+        BenchEntry const* entry = FindBench(argv[i]);
+        if (!entry)
+        {
+            sLog.outError("Unknown benchmark %s, -l lists them", argv[i]);
+            return 1;
+        }
+        selected.push_back(entry);
+    }
+
+    if (selected.empty())
+        for (size_t i = 0; i < countof(benchEntries); ++i)
+            selected.push_back(&benchEntries[i]);
+
+    sLog.outString("%s [micro benchmarks]", _FULLVERSION(REVISION_DATE, REVISION_TIME, REVISION_NR, REVISION_ID));
+
+    for (size_t i = 0; i < selected.size(); ++i)
+    {
+        if (selected[i]->needsDatabase && benchOptions.database.empty())
+        {
+            sLog.outString("%-10s skipped, no database (-d)", selected[i]->name);
+            continue;
+        }
+
+        selected[i]->function(benchOptions);
+    }
+
+    return 0;
+}
+
+/// @}
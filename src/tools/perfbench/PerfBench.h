@@ -0,0 +1,66 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup perfbench Micro benchmarks
+/// @{
+/// \file
+
+#ifndef _PERFBENCH_H
+#define _PERFBENCH_H
+
+#include "Common.h"
+
+#include <ace/OS_NS_time.h>
+
+/// Command line settings shared by all benchmarks
+struct BenchOptions
+{
+    BenchOptions() : iterations(0), threads(4), passes(3) {}
+
+    uint32 iterations;                                      ///< 0 - default of the benchmark
+    uint32 threads;                                         ///< producer threads of the contention benchmarks
+    uint32 passes;                                          ///< runs of a database benchmark, the best one is reported
+    std::string database;                                   ///< "host;port;user;password;database", empty skips database benchmarks
+    std::string tables;                                     ///< comma separated tables read by the query benchmark
+
+    uint32 GetIterations(uint32 def) const { return iterations ? iterations : def; }
+};
+
+typedef void BenchFunction(BenchOptions const& options);
+
+/// Nanosecond clock of the benchmarks
+inline uint64 BenchNow()
+{
+    return uint64(ACE_OS::gethrtime());
+}
+
+/// Print one measured variant: "<bench> <variant> <ops> <ns/op> <ops/s>"
+void PrintBenchResult(char const* bench, char const* variant, uint64 ops, uint64 elapsedNs);
+
+/// Keeps computed values alive so the compiler does not drop the measured code
+extern volatile uint64 benchSink;
+
+void BenchFieldDecode(BenchOptions const& options);
+void BenchQueryLoad(BenchOptions const& options);
+void BenchRecvQueue(BenchOptions const& options);
+void BenchUpdateMask(BenchOptions const& options);
+void BenchInsertBatch(BenchOptions const& options);
+void BenchResultQueue(BenchOptions const& options);
+
+#endif
+/// @}
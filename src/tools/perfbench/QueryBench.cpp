@@ -0,0 +1,222 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup perfbench
+/// @{
+/// \file
+
+#include "PerfBench.h"
+#include "Database/DatabaseEnv.h"
+#include "Util.h"
+
+namespace
+{
+    // column layout of the characters row read by Player::LoadFromDB
+    enum BenchColumn
+    {
+        COLUMN_UINT32,
+        COLUMN_UINT64,
+        COLUMN_FLOAT,
+        COLUMN_STRING
+    };
+
+    BenchColumn const characterRow[] =
+    {
+        COLUMN_UINT32, COLUMN_UINT32, COLUMN_STRING, COLUMN_UINT32, COLUMN_UINT32, COLUMN_UINT32, COLUMN_UINT32,
+        COLUMN_UINT32, COLUMN_UINT32, COLUMN_UINT32, COLUMN_UINT32, COLUMN_UINT32, COLUMN_UINT32, COLUMN_FLOAT,
+        COLUMN_FLOAT, COLUMN_FLOAT, COLUMN_UINT32, COLUMN_FLOAT, COLUMN_STRING, COLUMN_STRING, COLUMN_UINT32,
+        COLUMN_UINT32, COLUMN_UINT32, COLUMN_UINT64, COLUMN_UINT32, COLUMN_FLOAT, COLUMN_UINT32, COLUMN_FLOAT,
+        COLUMN_FLOAT, COLUMN_FLOAT, COLUMN_FLOAT, COLUMN_UINT32, COLUMN_UINT32, COLUMN_UINT64, COLUMN_UINT64,
+        COLUMN_UINT32, COLUMN_UINT32, COLUMN_UINT32, COLUMN_UINT32, COLUMN_STRING,
+    };
+
+    size_t const characterColumns = countof(characterRow);
+
+    /// One column in both forms a query result can hold
+    struct BenchValue
+    {
+        char text[32];
+        union
+        {
+            uint64 integer;
+            double real;
+        } binary;
+    };
+
+    void FillRow(BenchValue* values)
+    {
+        for (size_t i = 0; i < characterColumns; ++i)
+        {
+            switch (characterRow[i])
+            {
+                case COLUMN_UINT32:
+                    values[i].binary.integer = urand(0, 200000);
+                    snprintf(values[i].text, sizeof(values[i].text), UI64FMTD, values[i].binary.integer);
+                    break;
+                case COLUMN_UINT64:
+                    values[i].binary.integer = uint64(urand(0, 200000)) * 100000;
+                    snprintf(values[i].text, sizeof(values[i].text), UI64FMTD, values[i].binary.integer);
+                    break;
+                case COLUMN_FLOAT:
+                    values[i].binary.real = frand(-5000.0f, 5000.0f);
+                    snprintf(values[i].text, sizeof(values[i].text), "%f", values[i].binary.real);
+                    break;
+                case COLUMN_STRING:
+                    snprintf(values[i].text, sizeof(values[i].text), "column %u", uint32(i));
+                    values[i].binary.integer = 0;
+                    break;
+            }
+        }
+    }
+
+    /// Read a row the way the loaders do: every column once with its typed getter
+    uint64 ReadRow(Field const* fields)
+    {
+        uint64 sum = 0;
+        for (size_t i = 0; i < characterColumns; ++i)
+        {
+            switch (characterRow[i])
+            {
+                case COLUMN_UINT32: sum += fields[i].GetUInt32(); break;
+                case COLUMN_UINT64: sum += fields[i].GetUInt64(); break;
+                case COLUMN_FLOAT:  sum += uint64(fields[i].GetFloat()); break;
+                case COLUMN_STRING: sum += fields[i].GetCppString().size(); break;
+            }
+        }
+        return sum;
+    }
+
+    /// Read all rows of a table, every column with the getter of its result type
+    uint64 ReadTable(DatabaseType& db, std::string const& table, uint64& rows)
+    {
+        rows = 0;
+
+        QueryResult* result = db.PQuery("SELECT * FROM `%s`", table.c_str());
+        if (!result)
+            return 0;
+
+        uint64 sum = 0;
+        uint32 fieldCount = result->GetFieldCount();
+        do
+        {
+            Field* fields = result->Fetch();
+            for (uint32 i = 0; i < fieldCount; ++i)
+            {
+                switch (fields[i].GetType())
+                {
+                    case Field::DB_TYPE_INTEGER: sum += fields[i].GetUInt64(); break;
+                    case Field::DB_TYPE_FLOAT:   sum += uint64(fields[i].GetFloat()); break;
+                    default:                     sum += fields[i].IsNULL() ? 0 : strlen(fields[i].GetString()); break;
+                }
+            }
+            ++rows;
+        }
+        while (result->NextRow());
+
+        delete result;
+        return sum;
+    }
+}
+
+void BenchFieldDecode(BenchOptions const& options)
+{
+    uint32 const iterations = options.GetIterations(1000000);
+
+    // a few different rows so the text parsing does not see the same digits every time
+    uint32 const rowVariants = 64;
+    std::vector<BenchValue> values(rowVariants * characterColumns);
+    for (uint32 i = 0; i < rowVariants; ++i)
+        FillRow(&values[i * characterColumns]);
+
+    Field row[characterColumns];
+    uint64 sum = 0;
+
+    // text protocol: the result holds the column strings, every getter parses them
+    uint64 start = BenchNow();
+    for (uint32 i = 0; i < iterations; ++i)
+    {
+        BenchValue const* source = &values[(i % rowVariants) * characterColumns];
+        for (size_t c = 0; c < characterColumns; ++c)
+            row[c].SetValue(source[c].text);
+
+        sum += ReadRow(row);
+    }
+    PrintBenchResult("field", "text row", iterations, BenchNow() - start);
+
+    // binary protocol: numbers are bound as 8 byte values, strings stay text
+    start = BenchNow();
+    for (uint32 i = 0; i < iterations; ++i)
+    {
+        BenchValue const* source = &values[(i % rowVariants) * characterColumns];
+        for (size_t c = 0; c < characterColumns; ++c)
+        {
+            switch (characterRow[c])
+            {
+                case COLUMN_UINT32:
+                case COLUMN_UINT64: row[c].SetBinaryValue(&source[c].binary, Field::BINARY_UINT64); break;
+                case COLUMN_FLOAT:  row[c].SetBinaryValue(&source[c].binary, Field::BINARY_DOUBLE); break;
+                case COLUMN_STRING: row[c].SetValue(source[c].text); break;
+            }
+        }
+
+        sum += ReadRow(row);
+    }
+    PrintBenchResult("field", "binary row", iterations, BenchNow() - start);
+
+    benchSink += sum;
+}
+
+void BenchQueryLoad(BenchOptions const& options)
+{
+    DatabaseType db;
+    if (!db.Initialize(options.database.c_str()))
+    {
+        sLog.outError("query      can not connect to the database");
+        return;
+    }
+
+    std::string tables = options.tables.empty() ? "creature,gameobject,creature_loot_template,item_template,quest_template" : options.tables;
+    Tokens tableList = StrSplit(tables, ",");
+
+    for (Tokens::const_iterator itr = tableList.begin(); itr != tableList.end(); ++itr)
+    {
+        for (int binary = 0; binary < 2; ++binary)
+        {
+            db.SetUseBinaryResults(binary != 0);
+
+            // the best pass, the first one may also measure the server reading the table from disk
+            uint64 best = 0;
+            uint64 rows = 0;
+            for (uint32 pass = 0; pass < options.passes; ++pass)
+            {
+                uint64 start = BenchNow();
+                benchSink += ReadTable(db, *itr, rows);
+                uint64 elapsed = BenchNow() - start;
+                if (!pass || elapsed < best)
+                    best = elapsed;
+            }
+
+            std::string variant = *itr + (binary ? " binary" : " text");
+            PrintBenchResult("query", variant.c_str(), rows, best);
+        }
+    }
+
+    db.HaltDelayThread();
+}
+
+/// @}
@@ -0,0 +1,122 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup perfbench
+/// @{
+/// \file
+
+
+#include "PerfBench.h"
+#include "LockedQueue.h"
+#include "MPSCQueue.h"
+
+#include <ace/Barrier.h>
+#include <ace/Task.h>
+
+namespace
+{
+    /// Network thread adding packets to a session receive queue
+    template<class Queue>
+    class QueueProducer : public ACE_Task_Base
+    {
+        public:
+            QueueProducer(Queue& queue, ACE_Barrier& barrier, uint32 count) : m_queue(queue), m_barrier(barrier), m_count(count) {}
+
+            virtual int svc()
+            {
+                m_barrier.wait();
+
+                for (uint32 i = 1; i <= m_count; ++i)
+                    m_queue.add(i);
+
+                return 0;
+            }
+
+        private:
+            Queue& m_queue;
+            ACE_Barrier& m_barrier;
+            uint32 m_count;
+    };
+
+    /// Accepts every value, like WorldSessionFilter for packets that are not map bound
+    struct QueueChecker
+    {
+        bool Process(uint32 value) { return value != 0; }
+    };
+
+    /// Producers add while the calling thread takes the values out, until all were taken
+    template<class Queue>
+    void RunQueueBench(char const* variant, uint32 producers, uint32 perProducer, bool filtered)
+    {
+        Queue queue;
+        ACE_Barrier barrier(producers + 1);
+
+        std::vector<QueueProducer<Queue>*> threads;
+        for (uint32 i = 0; i < producers; ++i)
+        {
+            threads.push_back(new QueueProducer<Queue>(queue, barrier, perProducer));
+            threads.back()->activate();
+        }
+
+        QueueChecker checker;
+        uint64 const total = uint64(producers) * perProducer;
+        uint64 received = 0;
+        uint64 sum = 0;
+        uint32 value;
+
+        barrier.wait();
+        uint64 start = BenchNow();
+
+        while (received < total)
+        {
+            if (filtered ? queue.next(value, checker) : queue.next(value))
+            {
+                sum += value;
+                ++received;
+            }
+        }
+
+        uint64 elapsed = BenchNow() - start;
+
+        for (size_t i = 0; i < threads.size(); ++i)
+        {
+            threads[i]->wait();
+            delete threads[i];
+        }
+
+        PrintBenchResult("queue", variant, total, elapsed);
+        benchSink += sum;
+    }
+}
+
+void BenchRecvQueue(BenchOptions const& options)
+{
+    uint32 const perProducer = options.GetIterations(1000000) / options.threads;
+
+    typedef ACE_Based::LockedQueue<uint32, ACE_Thread_Mutex> LockedQueueType;
+    typedef ACE_Based::MPSCQueue<uint32> MPSCQueueType;
+
+    RunQueueBench<LockedQueueType>("LockedQueue", options.threads, perProducer, false);
+    RunQueueBench<MPSCQueueType>("MPSCQueue", options.threads, perProducer, false);
+
+    // the map update threads take the packets with a checker
+    RunQueueBench<LockedQueueType>("LockedQueue filtered", options.threads, perProducer, true);
+    RunQueueBench<MPSCQueueType>("MPSCQueue filtered", options.threads, perProducer, true);
+}
+
+/// @}
@@ -0,0 +1,156 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup perfbench
+/// @{
+/// \file
+
+
+#include "PerfBench.h"
+#include "Database/DatabaseEnv.h"
+#include "Database/SqlOperations.h"
+#include "LockedQueue.h"
+
+#include <ace/Barrier.h>
+#include <ace/Task.h>
+
+#define RESULT_ROW_FIELDS 8                                 // columns of a small login query
+
+namespace
+{
+    uint64 executedCallbacks = 0;                           // consumer thread only
+
+    /// Callback and row from the global allocator, like before the pool
+    class PlainCallback
+    {
+        public:
+            explicit PlainCallback(uint32 value) : m_row(::new Field[RESULT_ROW_FIELDS]), m_value(value) {}
+            virtual ~PlainCallback() { ::delete[] m_row; }
+
+            virtual void Execute() { executedCallbacks += m_value; }
+
+        private:
+            Field* m_row;
+            uint32 m_value;
+    };
+
+    /// Callback and row from MaNGOS::SmallObjectPool, like the async query callbacks
+    class PooledCallback : public MaNGOS::IQueryCallback
+    {
+        public:
+            explicit PooledCallback(uint32 value) : m_row(new Field[RESULT_ROW_FIELDS]), m_value(value) {}
+            ~PooledCallback() { delete[] m_row; }
+
+            void Execute() override { executedCallbacks += m_value; }
+            void SetResult(QueryResult* /*result*/) override {}
+            QueryResult* GetResult() override { return NULL; }
+
+        private:
+            Field* m_row;
+            uint32 m_value;
+    };
+
+    typedef ACE_Based::LockedQueue<PlainCallback*, ACE_Thread_Mutex> PlainResultQueue;
+
+    void AddResult(PlainResultQueue& queue, uint32 value) { queue.add(new PlainCallback(value)); }
+    void AddResult(SqlResultQueue& queue, uint32 value) { queue.add(new PooledCallback(value)); }
+
+    /// Before: every callback taken with its own lock
+    void DrainResults(PlainResultQueue& queue)
+    {
+        PlainCallback* callback;
+        while (queue.next(callback))
+        {
+            callback->Execute();
+            delete callback;
+        }
+    }
+
+    /// After: the ready list is taken with one lock
+    void DrainResults(SqlResultQueue& queue)
+    {
+        queue.Update();
+    }
+
+    /// Delay thread finishing queries
+    template<class Queue>
+    class ResultProducer : public ACE_Task_Base
+    {
+        public:
+            ResultProducer(Queue& queue, ACE_Barrier& barrier, uint32 count) : m_queue(queue), m_barrier(barrier), m_count(count) {}
+
+            virtual int svc()
+            {
+                m_barrier.wait();
+
+                for (uint32 i = 0; i < m_count; ++i)
+                    AddResult(m_queue, 1);
+
+                return 0;
+            }
+
+        private:
+            Queue& m_queue;
+            ACE_Barrier& m_barrier;
+            uint32 m_count;
+    };
+
+    /// Producers add results while the calling thread, the world thread, executes them
+    template<class Queue>
+    void RunResultQueueBench(char const* variant, uint32 producers, uint32 perProducer)
+    {
+        Queue queue;
+        ACE_Barrier barrier(producers + 1);
+
+        std::vector<ResultProducer<Queue>*> threads;
+        for (uint32 i = 0; i < producers; ++i)
+        {
+            threads.push_back(new ResultProducer<Queue>(queue, barrier, perProducer));
+            threads.back()->activate();
+        }
+
+        uint64 const total = uint64(producers) * perProducer;
+        executedCallbacks = 0;
+
+        barrier.wait();
+        uint64 start = BenchNow();
+
+        while (executedCallbacks < total)
+            DrainResults(queue);
+
+        uint64 elapsed = BenchNow() - start;
+
+        for (size_t i = 0; i < threads.size(); ++i)
+        {
+            threads[i]->wait();
+            delete threads[i];
+        }
+
+        PrintBenchResult("results", variant, total, elapsed);
+    }
+}
+
+void BenchResultQueue(BenchOptions const& options)
+{
+    uint32 const perProducer = options.GetIterations(1000000) / options.threads;
+
+    RunResultQueueBench<PlainResultQueue>("LockedQueue, new", options.threads, perProducer);
+    RunResultQueueBench<SqlResultQueue>("batched, pooled", options.threads, perProducer);
+}
+
+/// @}
@@ -0,0 +1,121 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup perfbench
+/// @{
+/// \file
+
+
+#include "PerfBench.h"
+#include "UpdateMask.h"
+#include "Util.h"
+
+#if defined(UPDATEMASK_AVX2)
+#  define UPDATEMASK_SCAN_NAME "avx2"
+#elif defined(UPDATEMASK_SSE2)
+#  define UPDATEMASK_SCAN_NAME "sse2"
+#else
+#  define UPDATEMASK_SCAN_NAME "scalar"
+#endif
+
+namespace
+{
+    /// Values update of one player for other players: changed fields masked by the visible fields
+    void RunUpdateMaskBench(uint32 iterations, uint32 changedFields, UpdateMask const& visualBits, std::vector<uint32> const& values)
+    {
+        // a few different change sets, like players changing different fields between ticks
+        uint32 const changeSets = 16;
+        std::vector<std::vector<bool> > changedFlags(changeSets, std::vector<bool>(PLAYER_END, false));
+        std::vector<UpdateMask> changedMasks(changeSets);
+        for (uint32 i = 0; i < changeSets; ++i)
+        {
+            changedMasks[i].SetCount(PLAYER_END);
+            for (uint32 j = 0; j < changedFields; ++j)
+            {
+                uint32 index = urand(0, PLAYER_END - 1);
+                changedFlags[i][index] = true;
+                changedMasks[i].SetBit(index);
+            }
+        }
+
+        UpdateMask updateMask;
+        updateMask.SetCount(PLAYER_END);
+        uint64 sum = 0;
+
+        // per field: every field tested in the changed flags and again in the update mask
+        uint64 start = BenchNow();
+        for (uint32 i = 0; i < iterations; ++i)
+        {
+            std::vector<bool> const& changed = changedFlags[i % changeSets];
+
+            updateMask.Clear();
+            for (uint32 index = 0; index < PLAYER_END; ++index)
+                if (changed[index])
+                    updateMask.SetBit(index);
+            updateMask &= visualBits;
+
+            for (uint32 index = 0; index < PLAYER_END; ++index)
+                if (updateMask.GetBit(index))
+                    sum += values[index];
+        }
+
+        char variant[64];
+        snprintf(variant, sizeof(variant), "%u fields, per field", changedFields);
+        PrintBenchResult("updatemask", variant, iterations, BenchNow() - start);
+
+        // blocks: the changed mask is ORed and ANDed by blocks, only the set bits are visited
+        start = BenchNow();
+        for (uint32 i = 0; i < iterations; ++i)
+        {
+            updateMask.Clear();
+            updateMask |= changedMasks[i % changeSets];
+            updateMask &= visualBits;
+
+            for (uint32 index = updateMask.FindFirstSetBit(); index < PLAYER_END; index = updateMask.FindNextSetBit(index + 1))
+                sum += values[index];
+        }
+
+        snprintf(variant, sizeof(variant), "%u fields, blocks " UPDATEMASK_SCAN_NAME, changedFields);
+        PrintBenchResult("updatemask", variant, iterations, BenchNow() - start);
+
+        benchSink += sum;
+    }
+}
+
+void BenchUpdateMask(BenchOptions const& options)
+{
+    uint32 const iterations = options.GetIterations(200000);
+
+    // about a quarter of the player fields is visible to other players
+    UpdateMask visualBits;
+    visualBits.SetCount(PLAYER_END);
+    for (uint32 index = 0; index < PLAYER_END; ++index)
+        if (urand(0, 3) == 0)
+            visualBits.SetBit(index);
+
+    std::vector<uint32> values(PLAYER_END);
+    for (uint32 index = 0; index < PLAYER_END; ++index)
+        values[index] = urand(0, 100000);
+
+    // a movement or health tick, a stat recalculation and a login with many changes
+    RunUpdateMaskBench(iterations, 4, visualBits, values);
+    RunUpdateMaskBench(iterations, 40, visualBits, values);
+    RunUpdateMaskBench(iterations, 400, visualBits, values);
+}
+
+/// @}